@@ -6,6 +6,7 @@ local mainStats = nil
 local dispatcherStats = nil
 local render = nil
 local atlas = nil
+local drawCalls = nil
 local adaptiveRender = nil
 local slowMain = nil
 local slowRender = nil
@@ -43,6 +44,7 @@ function init()
 	dispatcherStats = debugInfoWindow:recursiveGetChildById("dispatcherStats")
 	render = debugInfoWindow:recursiveGetChildById("render")
 	atlas = debugInfoWindow:recursiveGetChildById("atlas")
+	drawCalls = debugInfoWindow:recursiveGetChildById("drawCalls")
 	packets = debugInfoWindow:recursiveGetChildById("packets")
 	adaptiveRender = debugInfoWindow:recursiveGetChildById("adaptiveRender")
 	slowMain = debugInfoWindow:recursiveGetChildById("slowMain")
@@ -137,6 +139,7 @@ function update()
 		debugInfoWindow.debugPanel.luaRamUsage:setText("Ram usage by lua: " .. gcinfo() .. " kb")
 	elseif iter == 1 then
 		atlas:setText("Atlas: " .. g_atlas.getStats())
+		drawCalls:setText("Draw calls: " .. g_graphics.getDrawCallStats())
 		render:setText(g_stats.get(2, 10, true))
 		mainStats:setText(g_stats.get(1, 5, true))
 		dispatcherStats:setText(g_stats.get(3, 5, true))
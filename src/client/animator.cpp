@@ -58,6 +58,40 @@ void Animator::unserializeAppearance(const appearances::SpriteAnimation& animati
     assert(m_animationPhases == static_cast<int>(m_phaseDurations.size()));
     assert(m_startPhase >= -1 && m_startPhase < m_animationPhases);
 }
+
+void Animator::serializeSnapshot(const FileStreamPtr& fout) const
+{
+    fout->addU8(m_async ? 1 : 0);
+    fout->add8(m_loopCount);
+    fout->add8(m_startPhase);
+    fout->add8(static_cast<int8_t>(m_loopType));
+
+    fout->addU16(static_cast<uint16_t>(m_phaseDurations.size()));
+    for (const auto& [min, max] : m_phaseDurations) {
+        fout->addU16(min);
+        fout->addU16(max);
+    }
+}
+
+void Animator::unserializeSnapshot(const FileStreamPtr& fin)
+{
+    m_async = fin->getU8() == 1;
+    m_loopCount = fin->get8();
+    m_startPhase = fin->get8();
+    m_loopType = static_cast<appearances::ANIMATION_LOOP_TYPE>(fin->get8());
+
+    m_animationPhases = fin->getU16();
+    m_phaseDurations.resize(m_animationPhases);
+    for (auto& [min, max] : m_phaseDurations) {
+        min = fin->getU16();
+        max = fin->getU16();
+    }
+
+    if (m_startPhase < -1 || m_startPhase >= m_animationPhases)
+        throw Exception("invalid animation start phase {}", m_startPhase);
+
+    m_phase = getStartPhase();
+}
 #endif
 
 void Animator::unserialize(const int animationPhases, const FileStreamPtr& fin)
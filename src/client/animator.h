@@ -49,6 +49,8 @@ class Animator : public std::enable_shared_from_this<Animator>
 public:
 #ifdef FRAMEWORK_PROTOBUF
     void unserializeAppearance(const appearances::SpriteAnimation& animation);
+    void serializeSnapshot(const FileStreamPtr& fout) const;
+    void unserializeSnapshot(const FileStreamPtr& fin);
 #endif
     void unserialize(int animationPhases, const FileStreamPtr& fin);
     void serialize(const FileStreamPtr& fin) const;
@@ -619,6 +619,11 @@ void Game::loginWorld(const std::string_view account, const std::string_view pas
 }
 
 void Game::playRecord(const std::string_view& file)
+{
+    playRecordPlayer(std::make_shared<PacketPlayer>(file));
+}
+
+void Game::playRecordPlayer(const PacketPlayerPtr& packetPlayer)
 {
     if (m_protocolGame || isOnline())
         throw Exception("Unable to login into a world while already online or logging.");
@@ -626,8 +631,7 @@ void Game::playRecord(const std::string_view& file)
     if (m_protocolVersion == 0)
         throw Exception("Must set a valid game protocol version before logging.");
 
-    auto packetPlayer = std::make_shared<PacketPlayer>(file);
-    if (!packetPlayer)
+    if (!packetPlayer || !packetPlayer->isOpen())
         throw Exception("Invalid record file.");
 
     // reset the new game state
@@ -164,6 +164,7 @@ public:
     // login related
     void loginWorld(std::string_view account, std::string_view password, std::string_view worldName, std::string_view worldHost, int worldPort, std::string_view characterName, std::string_view authenticatorToken, std::string_view sessionKey, const std::string_view& recordTo);
     void playRecord(const std::string_view& file);
+    void playRecordPlayer(const PacketPlayerPtr& packetPlayer);
     void cancelLogin();
     void forceLogout();
     void safeLogout();
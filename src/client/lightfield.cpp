@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "lightfield.h"
+
+#include "framework/util/simd.h"
+
+namespace {
+    uint64_t mixSignature(uint64_t h)
+    {
+        // splitmix64 finalizer, tile signatures are sums of these so the bits need to be spread
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+
+    struct LightKernel
+    {
+        float x, y;
+        float intensity;
+        float radiusSq;
+        float invTileSize;
+        float r, g, b;
+        uint32_t index;
+    };
+
+    // lights the tiles [x0, x1] of a row, tiles shaded after the light was added are left untouched
+    void shadeRow(const LightKernel& light, uint8_t* pixels, const uint32_t* shades, int x0, const int x1, const float centerOffset, const float centerY, const float tileSize)
+    {
+        const float dy = centerY - light.y;
+
+#ifdef OTC_SIMD_SSE2
+        const __m128 lightX = _mm_set1_ps(light.x);
+        const __m128 dy2 = _mm_set1_ps(dy * dy);
+        const __m128 radiusSq = _mm_set1_ps(light.radiusSq);
+        const __m128 lightIntensity = _mm_set1_ps(light.intensity);
+        const __m128 invTileSize = _mm_set1_ps(light.invTileSize);
+        const __m128 falloff = _mm_set1_ps(0.2f);
+        const __m128 minIntensity = _mm_set1_ps(0.01f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.f);
+        const __m128 red = _mm_set1_ps(light.r);
+        const __m128 green = _mm_set1_ps(light.g);
+        const __m128 blue = _mm_set1_ps(light.b);
+        const __m128i lightIndex = _mm_set1_epi32(static_cast<int>(light.index));
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        const __m128 step = _mm_set1_ps(tileSize * 4);
+
+        const float firstCenter = static_cast<float>(x0) * tileSize + centerOffset;
+        __m128 centers = _mm_setr_ps(firstCenter, firstCenter + tileSize, firstCenter + tileSize * 2, firstCenter + tileSize * 3);
+
+        for (; x0 + 3 <= x1; x0 += 4) {
+            const __m128 dx = _mm_sub_ps(centers, lightX);
+            const __m128 distanceSq = _mm_add_ps(_mm_mul_ps(dx, dx), dy2);
+            __m128 intensity = _mm_mul_ps(_mm_sub_ps(lightIntensity, _mm_mul_ps(_mm_sqrt_ps(distanceSq), invTileSize)), falloff);
+            const __m128 lit = _mm_and_ps(_mm_cmple_ps(distanceSq, radiusSq), _mm_cmpge_ps(intensity, minIntensity));
+            intensity = _mm_min_ps(intensity, one);
+
+            // same rounding as Color::from8bit(color) * intensity converted back to 8 bits
+            const __m128i r = _mm_cvttps_epi32(_mm_mul_ps(_mm_mul_ps(red, intensity), scale));
+            const __m128i g = _mm_cvttps_epi32(_mm_mul_ps(_mm_mul_ps(green, intensity), scale));
+            const __m128i b = _mm_cvttps_epi32(_mm_mul_ps(_mm_mul_ps(blue, intensity), scale));
+            __m128i color = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_or_si128(_mm_slli_epi32(b, 16), alpha));
+
+            const __m128i shaded = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(shades + x0)), lightIndex);
+            color = _mm_andnot_si128(shaded, _mm_and_si128(color, _mm_castps_si128(lit)));
+
+            auto* dest = reinterpret_cast<__m128i*>(pixels + x0 * 4);
+            _mm_storeu_si128(dest, _mm_max_epu8(_mm_loadu_si128(dest), color));
+
+            centers = _mm_add_ps(centers, step);
+        }
+#endif
+
+        for (; x0 <= x1; ++x0) {
+            if (shades[x0] > light.index)
+                continue;
+
+            const float dx = static_cast<float>(x0) * tileSize + centerOffset - light.x;
+            const float distanceSq = dx * dx + dy * dy;
+            if (distanceSq > light.radiusSq)
+                continue;
+
+            float intensity = (light.intensity - std::sqrt(distanceSq) * light.invTileSize) * 0.2f;
+            if (intensity < 0.01f)
+                continue;
+
+            intensity = std::min<float>(intensity, 1.0f);
+
+            auto* dest = pixels + x0 * 4;
+            dest[0] = std::max<uint8_t>(dest[0], static_cast<uint8_t>(light.r * intensity * 255.f));
+            dest[1] = std::max<uint8_t>(dest[1], static_cast<uint8_t>(light.g * intensity * 255.f));
+            dest[2] = std::max<uint8_t>(dest[2], static_cast<uint8_t>(light.b * intensity * 255.f));
+        }
+    }
+}
+
+void LightField::resize(const Size& mapSize, const uint16_t tileSize)
+{
+    m_mapSize = mapSize;
+    m_tileSize = tileSize;
+
+    m_lights.clear();
+    m_shades.assign(mapSize.area(), 0);
+    m_signatures.clear();
+    m_prevSignatures.clear();
+}
+
+void LightField::clear()
+{
+    m_lights.clear();
+    std::ranges::fill(m_shades, 0);
+}
+
+bool LightField::mergeLast(const Point& pos, const Light& light)
+{
+    if (m_lights.empty())
+        return false;
+
+    auto& prevLight = m_lights.back();
+    if (prevLight.pos != pos || prevLight.color != light.color)
+        return false;
+
+    prevLight.intensity = std::max<uint8_t>(prevLight.intensity, light.intensity);
+    return true;
+}
+
+void LightField::addLight(const Point& pos, const Light& light, const float brightness)
+{
+    m_lights.emplace_back(pos, light.intensity, light.color, brightness);
+}
+
+void LightField::resetShade(const Point& pos)
+{
+    const size_t index = (pos.y / m_tileSize) * m_mapSize.width() + (pos.x / m_tileSize);
+    if (index >= m_shades.size()) return;
+    m_shades[index] = static_cast<uint32_t>(m_lights.size());
+}
+
+void LightField::computeBounds()
+{
+    const int maxX = m_mapSize.width() - 1;
+    const int maxY = m_mapSize.height() - 1;
+
+    m_bounds.resize(m_lights.size());
+    for (size_t i = 0; i < m_lights.size(); ++i) {
+        const auto& light = m_lights[i];
+        auto& bounds = m_bounds[i];
+
+        // Color::from8bit maps these to a transparent color, they can't brighten anything
+        if (light.color <= 0 || light.color >= 216) {
+            bounds = { 0, 0, -1, -1, 0 };
+            continue;
+        }
+
+        // one tile of margin on each side covers the rounding of the tile centers
+        const int radius = light.intensity * m_tileSize;
+        bounds.left = std::max<int>(0, (light.pos.x - radius) / m_tileSize - 1);
+        bounds.top = std::max<int>(0, (light.pos.y - radius) / m_tileSize - 1);
+        bounds.right = std::min<int>(maxX, (light.pos.x + radius) / m_tileSize + 1);
+        bounds.bottom = std::min<int>(maxY, (light.pos.y + radius) / m_tileSize + 1);
+
+        const uint64_t pos = static_cast<uint64_t>(static_cast<uint32_t>(light.pos.x)) << 32 | static_cast<uint32_t>(light.pos.y);
+        bounds.signature = mixSignature(pos ^ mixSignature(static_cast<uint64_t>(light.intensity) << 8 | light.color));
+    }
+}
+
+void LightField::update(uint8_t* pixels, const uint8_t* previousPixels, const Color& globalLight)
+{
+    const int width = m_mapSize.width();
+    const int height = m_mapSize.height();
+    const size_t area = m_mapSize.area();
+    if (area == 0)
+        return;
+
+    computeBounds();
+
+    // what reaches each tile, the same signature as last time means the same color
+    m_signatures.assign(area, 0);
+    for (size_t i = 0; i < m_bounds.size(); ++i) {
+        const auto& bounds = m_bounds[i];
+        for (int y = bounds.top; y <= bounds.bottom; ++y) {
+            const size_t row = static_cast<size_t>(y) * width;
+            for (int x = bounds.left; x <= bounds.right; ++x) {
+                if (m_shades[row + x] <= i)
+                    m_signatures[row + x] += bounds.signature;
+            }
+        }
+    }
+
+    const bool full = !previousPixels || m_prevSignatures.size() != area;
+    if (!full)
+        std::memcpy(pixels, previousPixels, area * 4);
+
+    const std::array<uint8_t, 4> ambient{ globalLight.r(), globalLight.g(), globalLight.b(), 255 };
+    int dirtyLeft = width, dirtyTop = height, dirtyRight = -1, dirtyBottom = -1;
+    size_t dirtyTiles = 0;
+
+    for (int y = 0; y < height; ++y) {
+        const size_t row = static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            const size_t index = row + x;
+            if (!full && m_signatures[index] == m_prevSignatures[index])
+                continue;
+
+            std::memcpy(pixels + index * 4, ambient.data(), 4);
+            dirtyLeft = std::min<int>(dirtyLeft, x);
+            dirtyTop = std::min<int>(dirtyTop, y);
+            dirtyRight = std::max<int>(dirtyRight, x);
+            dirtyBottom = std::max<int>(dirtyBottom, y);
+            ++dirtyTiles;
+        }
+    }
+
+    m_prevSignatures.swap(m_signatures);
+    m_lastDirtyTiles = dirtyTiles;
+
+    if (dirtyTiles > 0)
+        accumulate(pixels, Rect(Point(dirtyLeft, dirtyTop), Point(dirtyRight, dirtyBottom)));
+}
+
+void LightField::accumulate(uint8_t* pixels, const Rect& area) const
+{
+    const int width = m_mapSize.width();
+    const float tileSize = m_tileSize;
+    const float centerOffset = static_cast<float>(m_tileSize / 2);
+
+    // clean tiles inside the area already hold the max of their lights, lighting them again is a no-op
+    for (size_t i = 0; i < m_bounds.size(); ++i) {
+        const auto& bounds = m_bounds[i];
+        const int left = std::max<int>(bounds.left, area.left());
+        const int top = std::max<int>(bounds.top, area.top());
+        const int right = std::min<int>(bounds.right, area.right());
+        const int bottom = std::min<int>(bounds.bottom, area.bottom());
+        if (left > right || top > bottom)
+            continue;
+
+        const auto& light = m_lights[i];
+        const auto& color = Color::from8bit(light.color);
+        const float radius = static_cast<float>(light.intensity * m_tileSize);
+        const LightKernel kernel{
+            static_cast<float>(light.pos.x), static_cast<float>(light.pos.y),
+            static_cast<float>(light.intensity), radius * radius, 1.0f / m_tileSize,
+            color.rF(), color.gF(), color.bF(), static_cast<uint32_t>(i)
+        };
+
+        for (int y = top; y <= bottom; ++y) {
+            const size_t row = static_cast<size_t>(y) * width;
+            shadeRow(kernel, pixels + row * 4, m_shades.data() + row, left, right, centerOffset, y * tileSize + centerOffset, tileSize);
+        }
+    }
+}
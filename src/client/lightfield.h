@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "staticdata.h"
+
+// Per tile light accumulation of the LightView, kept apart from the drawing so it can run on plain buffers.
+// Lights are scattered over the tiles covered by their radius instead of testing every light against
+// every tile, and a per tile signature of the lights reaching it lets an update keep the tiles
+// that did not change from the previous result.
+class LightField
+{
+public:
+    void resize(const Size& mapSize, uint16_t tileSize);
+    void clear();
+
+    // raises the intensity of the last light instead when it is on the same spot with the same color
+    bool mergeLast(const Point& pos, const Light& light);
+    void addLight(const Point& pos, const Light& light, float brightness);
+    // tiles only receive the lights added after their last reset
+    void resetShade(const Point& pos);
+
+    // writes the RGBA color of every tile, previousPixels is the last result for the same view and
+    // global light (nullptr recomputes every tile)
+    void update(uint8_t* pixels, const uint8_t* previousPixels, const Color& globalLight);
+
+    const Size& getMapSize() const { return m_mapSize; }
+    size_t getLightCount() const { return m_lights.size(); }
+    size_t getLastDirtyTiles() const { return m_lastDirtyTiles; }
+
+private:
+    struct TileLight : Light
+    {
+        Point pos;
+        float brightness{ 1.f };
+
+        TileLight(const Point& pos, const uint8_t intensity, const uint8_t color, const float brightness) : Light(intensity, color), pos(pos), brightness(brightness) {}
+    };
+
+    // tiles a light can reach, empty (right < left) when it does not light anything
+    struct LightBounds
+    {
+        int left, top, right, bottom;
+        uint64_t signature;
+    };
+
+    void computeBounds();
+    void accumulate(uint8_t* pixels, const Rect& area) const;
+
+    Size m_mapSize;
+    uint16_t m_tileSize{ 32 };
+
+    std::vector<TileLight> m_lights;
+    std::vector<uint32_t> m_shades;
+    std::vector<LightBounds> m_bounds;
+
+    std::vector<uint64_t> m_signatures;
+    std::vector<uint64_t> m_prevSignatures;
+    size_t m_lastDirtyTiles{ 0 };
+};
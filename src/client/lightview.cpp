@@ -45,11 +45,11 @@ void LightView::resize(const Size& size, const uint16_t tileSize) {
     m_tileSize = tileSize;
     m_pool->setScaleFactor(tileSize / g_gameConfig.getSpriteSize());
 
-    m_lightData.tiles.resize(size.area());
-    m_lightData.lights.clear();
+    m_lightField.resize(size, tileSize);
 
     for (auto& pixels : m_pixels)
         pixels.resize(size.area() * 4);
+    m_pixelsSrc = {};
 
     if (m_texture)
         m_texture->setupSize(m_mapSize);
@@ -59,13 +59,8 @@ void LightView::addLightSource(const Point& pos, const Light& light, const float
 {
     if (!isDark() || light.intensity == 0) return;
 
-    if (!m_lightData.lights.empty()) {
-        auto& prevLight = m_lightData.lights.back();
-        if (prevLight.pos == pos && prevLight.color == light.color) {
-            prevLight.intensity = std::max<uint8_t>(prevLight.intensity, light.intensity);
-            return;
-        }
-    }
+    if (m_lightField.mergeLast(pos, light))
+        return;
 
     size_t hash = pos.hash();
     stdext::hash_combine(hash, light.intensity);
@@ -76,15 +71,13 @@ void LightView::addLightSource(const Point& pos, const Light& light, const float
 
     if (m_pool->getHashController().put(hash)) {
         const float effectiveBrightness = std::min<float>(brightness, g_drawPool.getOpacity());
-        m_lightData.lights.emplace_back(pos, light.intensity, light.color, effectiveBrightness);
+        m_lightField.addLight(pos, light, effectiveBrightness);
     }
 }
 
 void LightView::resetShade(const Point& pos)
 {
-    const size_t index = (pos.y / m_tileSize) * m_mapSize.width() + (pos.x / m_tileSize);
-    if (index >= m_lightData.tiles.size()) return;
-    m_lightData.tiles[index] = m_lightData.lights.size();
+    m_lightField.resetShade(pos);
 }
 
 void LightView::draw(const Rect& dest, const Rect& src)
@@ -94,7 +87,7 @@ void LightView::draw(const Rect& dest, const Rect& src)
     m_pool->getHashController().put(src.hash());
     m_pool->getHashController().put(m_globalLightColor.hash());
     if (m_pool->getHashController().wasModified()) {
-        updatePixels();
+        updatePixels(src);
 
         SpinLock::Guard guard(m_pool->getThreadLock());
         m_pixels[0].swap(m_pixels[1]);
@@ -135,55 +128,12 @@ void LightView::updateCoords(const Rect& dest, const Rect& src) {
                      static_cast<float>(size.width()) / m_tileSize, static_cast<float>(size.height()) / m_tileSize));
 }
 
-void LightView::updatePixels()
+void LightView::updatePixels(const Rect& src)
 {
-    const auto lightSize = m_lightData.lights.size();
-    const auto mapWidth = m_mapSize.width();
-    const auto mapHeight = m_mapSize.height();
-    const auto tileCenterOffset = m_tileSize / 2;
-    const auto invTileSize = 1.0f / m_tileSize;
-
-    auto* pixelData = m_pixels[0].data();
-
-    for (int y = 0; y < mapHeight; ++y) {
-        for (int x = 0; x < mapWidth; ++x) {
-            const auto centerX = x * m_tileSize + tileCenterOffset;
-            const auto centerY = y * m_tileSize + tileCenterOffset;
-            const auto index = y * mapWidth + x;
-
-            auto r = m_globalLightColor.r();
-            auto g = m_globalLightColor.g();
-            auto b = m_globalLightColor.b();
-
-            for (auto i = m_lightData.tiles[index]; i < lightSize; ++i) {
-                const auto& light = m_lightData.lights[i];
-
-                const auto dx = centerX - light.pos.x;
-                const auto dy = centerY - light.pos.y;
-                const auto distanceSq = dx * dx + dy * dy;
-
-                const auto lightRadiusSq = (light.intensity * m_tileSize) * (light.intensity * m_tileSize);
-                if (distanceSq > lightRadiusSq) continue;
+    // the previous result can only be patched while the view and the ambient light stay the same
+    const bool reuse = m_pixelsSrc == src && m_pixelsGlobalLight == m_globalLightColor.hash();
+    m_lightField.update(m_pixels[0].data(), reuse ? m_pixels[1].data() : nullptr, m_globalLightColor);
 
-                const auto distanceNorm = std::sqrt(distanceSq) * invTileSize;
-                float intensity = (-distanceNorm + light.intensity) * 0.2f;
-                if (intensity < 0.01f) continue;
-
-                intensity = std::min<float>(intensity, 1.0f);
-
-                const auto& lightColor = Color::from8bit(light.color) * intensity;
-
-                r = std::max<int>(r, lightColor.r());
-                g = std::max<int>(g, lightColor.g());
-                b = std::max<int>(b, lightColor.b());
-            }
-
-            const auto colorIndex = index * 4;
-
-            pixelData[colorIndex] = r;
-            pixelData[colorIndex + 1] = g;
-            pixelData[colorIndex + 2] = b;
-            pixelData[colorIndex + 3] = 255;
-        }
-    }
-}
\ No newline at end of file
+    m_pixelsSrc = src;
+    m_pixelsGlobalLight = m_globalLightColor.hash();
+}
@@ -24,6 +24,7 @@
 
 #include "framework/graphics/coordsbuffer.h"
 #include "framework/luaengine/luaobject.h"
+#include "lightfield.h"
 #include "staticdata.h"
 #include <framework/graphics/declarations.h>
 
@@ -48,28 +49,11 @@ public:
     bool isDark() const { return m_isDark; }
     bool isEnabled() const;
     void setEnabled(const bool v);
-    void clear() {
-        m_lightData.lights.clear();
-        m_lightData.tiles.assign(m_mapSize.area(), {});
-    }
+    void clear() { m_lightField.clear(); }
 
 private:
-    struct TileLight : Light
-    {
-        Point pos;
-        float brightness{ 1.f };
-
-        TileLight(const Point& pos, const uint8_t intensity, const uint8_t color, const float brightness) : Light(intensity, color), pos(pos), brightness(brightness) {}
-    };
-
-    struct LightData
-    {
-        std::vector<size_t> tiles;
-        std::vector<TileLight> lights;
-    };
-
     void updateCoords(const Rect& dest, const Rect& src);
-    void updatePixels();
+    void updatePixels(const Rect& src);
 
     bool m_isDark{ false };
 
@@ -82,6 +66,10 @@ private:
     Rect m_dest, m_src;
     CoordsBuffer m_coords;
     TexturePtr m_texture;
-    LightData m_lightData;
+    LightField m_lightField;
     std::array<std::vector<uint8_t>, 2> m_pixels;
+
+    // view and global light of m_pixels[1], only the tiles whose lights changed are redone while they hold
+    Rect m_pixelsSrc;
+    size_t m_pixelsGlobalLight{ 0 };
 };
@@ -228,6 +228,8 @@ void LocalPlayer::stopAutoWalk()
 
     if (m_autoWalkContinueEvent)
         m_autoWalkContinueEvent->cancel();
+
+    g_map.cancelPathSearch();
 }
 
 void LocalPlayer::terminateWalk()
@@ -76,6 +76,8 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_things", "loadAppearances", &ThingTypeManager::loadAppearances, &g_things);
     g_lua.bindSingletonFunction("g_things", "loadStaticData", &ThingTypeManager::loadStaticData, &g_things);
     g_lua.bindSingletonFunction("g_things", "resolveProficienciesFile", &ThingTypeManager::resolveProficienciesFile, &g_things);
+    g_lua.bindSingletonFunction("g_things", "setSnapshotDir", &ThingTypeManager::setSnapshotDir, &g_things);
+    g_lua.bindSingletonFunction("g_things", "getSnapshotDir", &ThingTypeManager::getSnapshotDir, &g_things);
     g_lua.bindSingletonFunction("g_things", "loadDat", &ThingTypeManager::loadDat, &g_things);
     g_lua.bindSingletonFunction("g_things", "loadOtml", &ThingTypeManager::loadOtml, &g_things);
     g_lua.bindSingletonFunction("g_things", "isDatLoaded", &ThingTypeManager::isDatLoaded, &g_things);
@@ -84,10 +86,17 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_things", "getThingType", &ThingTypeManager::getThingType, &g_things);
     g_lua.bindSingletonFunction("g_things", "getThingTypes", &ThingTypeManager::getThingTypes, &g_things);
     g_lua.bindSingletonFunction("g_things", "findThingTypeByAttr", &ThingTypeManager::findThingTypeByAttr, &g_things);
+    g_lua.bindSingletonFunction("g_things", "findThingTypeByAttrPage", &ThingTypeManager::findThingTypeByAttrPage, &g_things);
+    g_lua.bindSingletonFunction("g_things", "countThingTypesByAttr", &ThingTypeManager::countThingTypesByAttr, &g_things);
+    g_lua.bindSingletonFunction("g_things", "findThingTypeByName", &ThingTypeManager::findThingTypeByName, &g_things);
+    g_lua.bindSingletonFunction("g_things", "findThingTypesByString", &ThingTypeManager::findThingTypesByString, &g_things);
+    g_lua.bindSingletonFunction("g_things", "countThingTypesByString", &ThingTypeManager::countThingTypesByString, &g_things);
     g_lua.bindSingletonFunction("g_things", "getProficiencyThings", &ThingTypeManager::getProficiencyThings, &g_things);
     g_lua.bindSingletonFunction("g_things", "getCyclopediaItemName", &ThingTypeManager::getCyclopediaItemName, &g_things);
     g_lua.bindSingletonFunction("g_things", "getRaceData", &ThingTypeManager::getRaceData, &g_things);
     g_lua.bindSingletonFunction("g_things", "getRacesByName", &ThingTypeManager::getRacesByName, &g_things);
+    g_lua.bindSingletonFunction("g_things", "getRacesByNamePage", &ThingTypeManager::getRacesByNamePage, &g_things);
+    g_lua.bindSingletonFunction("g_things", "countRacesByName", &ThingTypeManager::countRacesByName, &g_things);
     g_lua.bindSingletonFunction("g_things", "getProficienciesFile", &ThingTypeManager::getProficienciesFile, &g_things);
 
 #ifdef FRAMEWORK_EDITOR
@@ -138,6 +147,12 @@ void Client::registerLuaFunctions()
     g_lua.registerSingletonClass("g_spriteAppearances");
     g_lua.bindSingletonFunction("g_spriteAppearances", "saveSpriteToFile", &SpriteAppearances::saveSpriteToFile, &g_spriteAppearances);
     g_lua.bindSingletonFunction("g_spriteAppearances", "saveSheetToFileBySprite", &SpriteAppearances::saveSheetToFileBySprite, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "setCacheBudget", &SpriteAppearances::setCacheBudget, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getCacheBudget", &SpriteAppearances::getCacheBudget, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getCacheStats", &SpriteAppearances::getCacheStats, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "clearCache", &SpriteAppearances::clearCache, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "setDiskCache", &SpriteAppearances::setDiskCache, &g_spriteAppearances);
+    g_lua.bindSingletonFunction("g_spriteAppearances", "getDiskCacheDir", &SpriteAppearances::getDiskCacheDir, &g_spriteAppearances);
 
     g_lua.registerSingletonClass("g_map");
     g_lua.bindSingletonFunction("g_map", "isLookPossible", &Map::isLookPossible, &g_map);
@@ -162,6 +177,14 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_map", "getSpectatorsInRange", &Map::getSpectatorsInRange, &g_map);
     g_lua.bindSingletonFunction("g_map", "getSpectatorsInRangeEx", &Map::getSpectatorsInRangeEx, &g_map);
     g_lua.bindSingletonFunction("g_map", "findPath", &Map::findPath, &g_map);
+    // the script must hold a reference to the callback until it is called, as with g_dispatcher
+    g_lua.bindClassStaticFunction("g_map", "findLongPath", [](const Position& start, const Position& goal, const int maxComplexity,
+                                                              const std::function<void(std::vector<Otc::Direction>, Otc::PathFindResult)>& callback) {
+        g_map.findLongPathAsync(start, goal, maxComplexity, [callback](const PathFindResult_ptr& result) {
+            if (callback)
+                callback(result->path, result->status);
+        });
+    });
     g_lua.bindSingletonFunction("g_map", "createTile", &Map::createTile, &g_map);
     g_lua.bindSingletonFunction("g_map", "setWidth", &Map::setWidth, &g_map);
     g_lua.bindSingletonFunction("g_map", "setHeight", &Map::setHeight, &g_map);
@@ -200,6 +223,7 @@ void Client::registerLuaFunctions()
 
     g_lua.bindSingletonFunction("g_map", "getMinimapColor", &Map::getMinimapColor, &g_map);
     g_lua.bindSingletonFunction("g_map", "isSightClear", &Map::isSightClear, &g_map);
+    g_lua.bindSingletonFunction("g_map", "checkSightLines", &Map::checkSightLines, &g_map);
 
     g_lua.bindSingletonFunction("g_map", "findEveryPath", &Map::findEveryPath, &g_map);
     g_lua.bindSingletonFunction("g_map", "getSpectatorsByPattern", &Map::getSpectatorsByPattern, &g_map);
@@ -218,6 +242,8 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_satelliteMap", "hasChunksForFloor", &SatelliteMap::hasChunksForFloor, &g_satelliteMap);
     g_lua.bindSingletonFunction("g_satelliteMap", "hasChunksForView", &SatelliteMap::hasChunksForView, &g_satelliteMap);
     g_lua.bindSingletonFunction("g_satelliteMap", "hasMinimapChunksForFloor", &SatelliteMap::hasMinimapChunksForFloor, &g_satelliteMap);
+    g_lua.bindSingletonFunction("g_satelliteMap", "setMemoryBudget", &SatelliteMap::setMemoryBudget, &g_satelliteMap);
+    g_lua.bindSingletonFunction("g_satelliteMap", "getMemoryBudget", &SatelliteMap::getMemoryBudget, &g_satelliteMap);
 
 #ifdef FRAMEWORK_EDITOR
     g_lua.registerSingletonClass("g_creatures");
@@ -484,6 +510,10 @@ void Client::registerLuaFunctions()
 
     g_lua.registerClass<ProtocolGame, Protocol>();
     g_lua.bindClassStaticFunction<ProtocolGame>("create", [] { return std::make_shared<ProtocolGame>(); });
+    g_lua.bindClassStaticFunction<ProtocolGame>("setOpcodeHook", &ProtocolGame::setLuaOpcodeHook);
+    g_lua.bindClassStaticFunction<ProtocolGame>("hasOpcodeHook", &ProtocolGame::hasLuaOpcodeHook);
+    g_lua.bindClassStaticFunction<ProtocolGame>("getOpcodeHookStats", &ProtocolGame::getLuaOpcodeHookStats);
+    g_lua.bindClassStaticFunction<ProtocolGame>("resetOpcodeHookStats", &ProtocolGame::resetLuaOpcodeHookStats);
     g_lua.bindClassMemberFunction<ProtocolGame>("sendExtendedOpcode", &ProtocolGame::sendExtendedOpcode);
 
     g_lua.registerClass<Container>();
@@ -1037,15 +1067,19 @@ void Client::registerLuaFunctions()
     g_lua.bindClassMemberFunction<LocalPlayer>("isSerene", &LocalPlayer::isSerene);
 
     g_lua.registerClass<Tile, AttachableObject>();
-    g_lua.bindClassMemberFunction<Tile>("clean", &Tile::clean);
-    g_lua.bindClassMemberFunction<Tile>("addThing", &Tile::addThing);
+    // through the map, so its creature index and map views follow the tiles it holds
+    g_lua.registerClassMemberFunction(stdext::demangle_class<Tile>(), "clean",
+        luabinder::bind_fun([](const TilePtr& tile) { g_map.cleanTileThings(tile); }));
+    g_lua.registerClassMemberFunction(stdext::demangle_class<Tile>(), "addThing",
+        luabinder::bind_fun([](const TilePtr& tile, const ThingPtr& thing, const int stackPos) { g_map.addThingToTile(tile, thing, stackPos); }));
     g_lua.bindClassMemberFunction<Tile>("getThing", &Tile::getThing);
     g_lua.bindClassMemberFunction<Tile>("getThings", &Tile::getThings);
     g_lua.bindClassMemberFunction<Tile>("getItems", &Tile::getItems);
     g_lua.bindClassMemberFunction<Tile>("getThingStackPos", &Tile::getThingStackPos);
     g_lua.bindClassMemberFunction<Tile>("getThingCount", &Tile::getThingCount);
     g_lua.bindClassMemberFunction<Tile>("getTopThing", &Tile::getTopThing);
-    g_lua.bindClassMemberFunction<Tile>("removeThing", &Tile::removeThing);
+    g_lua.registerClassMemberFunction(stdext::demangle_class<Tile>(), "removeThing",
+        luabinder::bind_fun([](const TilePtr& tile, const ThingPtr& thing) { return g_map.removeThingFromTile(tile, thing); }));
     g_lua.bindClassMemberFunction<Tile>("getTopLookThing", &Tile::getTopLookThing);
     g_lua.bindClassMemberFunction<Tile>("getTopUseThing", &Tile::getTopUseThing);
     g_lua.bindClassMemberFunction<Tile>("getTopCreature", &Tile::getTopCreature);
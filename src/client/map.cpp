@@ -40,6 +40,7 @@
 #include "framework/graphics/drawpoolmanager.h"
 #include "framework/graphics/painter.h"
 #include <framework/ui/uiwidget.h>
+#include <framework/util/stats.h>
 
 namespace
 {
@@ -54,6 +55,53 @@ namespace
             ++it;
         }
     }
+
+    // steps the line between both positions on the upper of their floors, asking blocked(pos) for every cell
+    // it crosses, then goes down to the lower one asking occupied(pos) on every floor in between
+    template<typename Blocked, typename Occupied>
+    bool traceSightLine(const Position& fromPos, const Position& toPos, const Blocked& blocked, const Occupied& occupied)
+    {
+        if (fromPos == toPos) {
+            return true;
+        }
+
+        Position start(fromPos.z > toPos.z ? toPos : fromPos);
+        const Position destination(fromPos.z > toPos.z ? fromPos : toPos);
+
+        const int8_t mx = start.x < destination.x ? 1 : start.x == destination.x ? 0 : -1;
+        const int8_t my = start.y < destination.y ? 1 : start.y == destination.y ? 0 : -1;
+
+        const int32_t A = destination.y - start.y;
+        const int32_t B = start.x - destination.x;
+        const int32_t C = -(A * destination.x + B * destination.y);
+
+        while (start.x != destination.x || start.y != destination.y) {
+            const int32_t move_hor = std::abs(A * (start.x + mx) + B * (start.y) + C);
+            const int32_t move_ver = std::abs(A * (start.x) + B * (start.y + my) + C);
+            const int32_t move_cross = std::abs(A * (start.x + mx) + B * (start.y + my) + C);
+
+            if (start.y != destination.y && (start.x == destination.x || move_hor > move_ver || move_hor > move_cross)) {
+                start.y += my;
+            }
+
+            if (start.x != destination.x && (start.y == destination.y || move_ver > move_hor || move_ver > move_cross)) {
+                start.x += mx;
+            }
+
+            if (blocked(start)) {
+                return false;
+            }
+        }
+
+        while (start.z != destination.z) {
+            if (occupied(start)) {
+                return false;
+            }
+            start.z++;
+        }
+
+        return true;
+    }
 }
 
 #ifdef FRAMEWORK_EDITOR
@@ -63,7 +111,7 @@ namespace
 #include <framework/platform/platformwindow.h>
 #include <framework/core/graphicalapplication.h>
 
-const static TilePtr m_nulltile;
+const TilePtr Map::m_nulltile;
 
 Map g_map;
 
@@ -131,8 +179,14 @@ void Map::clean()
 {
     cleanDynamicThings();
 
-    for (auto i = -1; ++i <= g_gameConfig.getMapMaxZ();)
+    for (auto i = -1; ++i <= g_gameConfig.getMapMaxZ();) {
         m_floors[i].tileBlocks.clear();
+        m_floors[i].creatureCells.clear();
+    }
+    resetTileBlockTracking();
+
+    cancelPathSearch();
+    m_pathFinder.clear();
 
 #ifdef FRAMEWORK_EDITOR
     m_waypoints.clear();
@@ -171,7 +225,9 @@ void Map::cleanDynamicThings()
     for (auto& floor : m_floors) {
         floor.missiles.clear();
         floor.tileBlocks.clear();
+        floor.creatureCells.clear();
     }
+    resetTileBlockTracking();
 
     cleanTexts();
 
@@ -194,11 +250,78 @@ void Map::addThing(const ThingPtr& thing, const Position& pos, const int16_t sta
     }
 
     if (const auto& tile = getOrCreateTile(pos)) {
-        if (m_floatingEffect || !thing->isEffect() || tile->getGround()) {
-            tile->addThing(thing, stackPos);
-            notificateTileUpdate(pos, thing, Otc::OPERATION_ADD);
-        }
+        if (m_floatingEffect || !thing->isEffect() || tile->getGround())
+            placeThing(tile, thing, stackPos);
+    }
+}
+
+void Map::placeThing(const TilePtr& tile, const ThingPtr& thing, const int16_t stackPos)
+{
+    const auto& pos = tile->getPosition();
+
+    // a full tile drops its last thing, which can be a creature
+    const bool full = !thing->isEffect() && tile->getThingCount() > g_gameConfig.getTileMaxThings();
+    std::vector<CreaturePtr> creatures;
+    if (full && tile->hasCreatures())
+        creatures = tile->getCreatures();
+
+    tile->addThing(thing, stackPos);
+
+    for (const auto& creature : creatures) {
+        if (tile->getThingStackPos(creature) < 0)
+            unindexCreature(creature, pos);
     }
+
+    if (thing->isCreature() && (!full || tile->getThingStackPos(thing) >= 0))
+        indexCreature(thing->static_self_cast<Creature>(), pos);
+    notificateTileUpdate(pos, thing, Otc::OPERATION_ADD);
+}
+
+bool Map::isMapTile(const TilePtr& tile)
+{
+    return tile && getTile(tile->getPosition()) == tile;
+}
+
+void Map::addThingToTile(const TilePtr& tile, const ThingPtr& thing, const int stackPos)
+{
+    if (!tile || !thing)
+        return;
+
+    if (!isMapTile(tile)) {
+        tile->addThing(thing, stackPos);
+        return;
+    }
+
+    placeThing(tile, thing, static_cast<int16_t>(stackPos));
+}
+
+bool Map::removeThingFromTile(const TilePtr& tile, const ThingPtr& thing)
+{
+    if (!tile || !isMapTile(tile))
+        return tile && tile->removeThing(thing);
+
+    if (!tile->removeThing(thing))
+        return false;
+
+    if (thing->isCreature())
+        unindexCreature(thing->static_self_cast<Creature>(), tile->getPosition());
+    notificateTileUpdate(tile->getPosition(), thing, Otc::OPERATION_REMOVE);
+    return true;
+}
+
+void Map::cleanTileThings(const TilePtr& tile)
+{
+    if (!tile)
+        return;
+
+    if (!isMapTile(tile)) {
+        tile->clean();
+        return;
+    }
+
+    unindexCreatures(tile);
+    tile->clean();
+    notificateTileUpdate(tile->getPosition(), nullptr, Otc::OPERATION_CLEAN);
 }
 
 void Map::addStaticText(const StaticTextPtr& txt, const Position& pos) {
@@ -281,6 +404,8 @@ bool Map::removeThing(const ThingPtr& thing)
 
     if (const auto& tile = thing->getTile()) {
         if (tile->removeThing(thing)) {
+            if (thing->isCreature())
+                unindexCreature(thing->static_self_cast<Creature>(), tile->getPosition());
             notificateTileUpdate(thing->getServerPosition(), thing, Otc::OPERATION_REMOVE);
             return true;
         }
@@ -362,8 +487,83 @@ StaticTextPtr Map::getStaticText(const Position& pos) const
     return nullptr;
 }
 
-const TilePtr& Map::createTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks[getBlockIndex(pos)].create(pos) : m_nulltile; }
-const TilePtr& Map::getOrCreateTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks[getBlockIndex(pos)].getOrCreate(pos) : m_nulltile; }
+const TilePtr& Map::createTile(const Position& pos) { return pos.isMapPosition() ? getOrCreateTileBlock(pos).create(pos) : m_nulltile; }
+const TilePtr& Map::getOrCreateTile(const Position& pos) { return pos.isMapPosition() ? getOrCreateTileBlock(pos).getOrCreate(pos) : m_nulltile; }
+
+TileBlock& Map::getOrCreateTileBlock(const Position& pos)
+{
+    if (const auto block = findTileBlock(pos))
+        return *block;
+
+    // unordered_map nodes don't move, the window can keep pointing at the block until it is erased
+    auto& block = m_floors[pos.z].tileBlocks[getBlockIndex(pos)];
+
+    const int blockX = static_cast<uint32_t>(pos.x) / BLOCK_SIZE;
+    const int blockY = static_cast<uint32_t>(pos.y) / BLOCK_SIZE;
+    if (isInBlockWindow(blockX, blockY))
+        m_floors[pos.z].blockWindow[getBlockWindowSlot(blockX, blockY)] = &block;
+
+    // the eviction only looks at the strips leaving the aware area, a block outside of it would never be visited
+    if (const auto& aware = m_floors[pos.z].awareRect; aware.isValid() && !aware.contains(Point(pos.x, pos.y)))
+        queueEviction(pos.z, Rect(pos.x - pos.x % BLOCK_SIZE, pos.y - pos.y % BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE));
+
+    return block;
+}
+
+void Map::unlinkTileBlock(const uint8_t z, const uint32_t blockIndex)
+{
+    const int blockX = blockIndex % (65536 / BLOCK_SIZE);
+    const int blockY = blockIndex / (65536 / BLOCK_SIZE);
+    if (isInBlockWindow(blockX, blockY))
+        m_floors[z].blockWindow[getBlockWindowSlot(blockX, blockY)] = nullptr;
+}
+
+void Map::updateBlockWindow()
+{
+    const int factor = g_game.getFeature(Otc::GameMapCache) ? 4 : 1;
+
+    // one extra block since the range rarely starts at a block boundary
+    const Size size(std::bit_ceil<uint32_t>((m_awareRange.left + m_awareRange.right) * factor / BLOCK_SIZE + 2),
+                    std::bit_ceil<uint32_t>((m_awareRange.top + m_awareRange.bottom) * factor / BLOCK_SIZE + 2));
+    const Point origin(std::max<int>(0, m_centralPosition.x - m_awareRange.left * factor) / BLOCK_SIZE,
+                       std::max<int>(0, m_centralPosition.y - m_awareRange.top * factor) / BLOCK_SIZE);
+
+    const bool resized = size != m_blockWindowSize;
+    if (!resized && origin == m_blockWindowOrigin)
+        return;
+
+    const Point oldOrigin = m_blockWindowOrigin;
+    const Size oldSize = m_blockWindowSize;
+    m_blockWindowOrigin = origin;
+    m_blockWindowSize = size;
+    m_blockWindowShift = static_cast<uint8_t>(std::countr_zero<uint32_t>(size.width()));
+
+    for (auto& floor : m_floors) {
+        if (resized)
+            floor.blockWindow.assign(size.area(), nullptr);
+
+        for (int blockY = origin.y; blockY < origin.y + size.height(); ++blockY) {
+            for (int blockX = origin.x; blockX < origin.x + size.width(); ++blockX) {
+                // blocks still inside the window keep their slot, only the entering rows/columns are looked up
+                if (!resized && blockX - oldOrigin.x >= 0 && blockX - oldOrigin.x < oldSize.width()
+                    && blockY - oldOrigin.y >= 0 && blockY - oldOrigin.y < oldSize.height())
+                    continue;
+
+                const auto it = floor.tileBlocks.find(blockY * (65536 / BLOCK_SIZE) + blockX);
+                floor.blockWindow[getBlockWindowSlot(blockX, blockY)] = it != floor.tileBlocks.end() ? &it->second : nullptr;
+            }
+        }
+    }
+}
+
+void Map::resetTileBlockTracking()
+{
+    for (auto& floor : m_floors) {
+        std::ranges::fill(floor.blockWindow, nullptr);
+        floor.awareRect = {};
+    }
+    m_pendingEvictions.clear();
+}
 
 template <typename... Items>
 const TilePtr& Map::createTileEx(const Position& pos, const Items&... items)
@@ -378,20 +578,6 @@ const TilePtr& Map::createTileEx(const Position& pos, const Items&... items)
     return tile;
 }
 
-const TilePtr& Map::getTile(const Position& pos)
-{
-    if (!pos.isMapPosition())
-        return m_nulltile;
-
-    auto& tileBlocks = m_floors[pos.z].tileBlocks;
-
-    const auto it = tileBlocks.find(getBlockIndex(pos));
-    if (it != tileBlocks.end())
-        return it->second.get(pos);
-
-    return m_nulltile;
-}
-
 TileList Map::getTiles(const int8_t floor/* = -1*/)
 {
     TileList tiles;
@@ -425,10 +611,10 @@ void Map::cleanTile(const Position& pos)
     if (!pos.isMapPosition())
         return;
 
-    const auto it = m_floors[pos.z].tileBlocks.find(getBlockIndex(pos));
-    if (it != m_floors[pos.z].tileBlocks.end()) {
-        auto& block = it->second;
+    if (const auto blockPtr = findTileBlock(pos)) {
+        auto& block = *blockPtr;
         if (const auto& tile = block.get(pos)) {
+            unindexCreatures(tile);
             tile->clean();
             if (tile->canErase())
                 block.remove(pos);
@@ -546,6 +732,69 @@ void Map::removeCreatureById(const uint32_t  id)
         m_knownCreatures.erase(it);
 }
 
+void Map::indexCreature(const CreaturePtr& creature, const Position& pos)
+{
+    m_floors[pos.z].creatureCells[getCreatureCellIndex(pos.x, pos.y)].push_back({ pos, creature });
+}
+
+void Map::unindexCreature(const CreaturePtr& creature, const Position& pos)
+{
+    auto& cells = m_floors[pos.z].creatureCells;
+    const auto it = cells.find(getCreatureCellIndex(pos.x, pos.y));
+    if (it == cells.end())
+        return;
+
+    auto& entries = it->second;
+    const auto entry = std::ranges::find_if(entries, [&](const CreatureCellEntry& e) { return e.creature == creature && e.position == pos; });
+    if (entry == entries.end())
+        return;
+
+    *entry = std::move(entries.back());
+    entries.pop_back();
+    if (entries.empty())
+        cells.erase(it);
+}
+
+void Map::unindexCreatures(const TilePtr& tile)
+{
+    if (!tile->hasCreatures())
+        return;
+
+    for (const auto& creature : tile->getCreatures())
+        unindexCreature(creature, tile->getPosition());
+}
+
+void Map::collectCreatureTiles(const uint8_t z, const Rect& area, std::vector<Position>& positions)
+{
+    const auto& cells = m_floors[z].creatureCells;
+    if (cells.empty() || !area.isValid())
+        return;
+
+    const auto firstIndex = positions.size();
+    const int firstX = std::max<int>(0, area.left()) / CREATURE_CELL_SIZE;
+    const int firstY = std::max<int>(0, area.top()) / CREATURE_CELL_SIZE;
+    const int lastX = std::min<int>(UINT16_MAX, area.right()) / CREATURE_CELL_SIZE;
+    const int lastY = std::min<int>(UINT16_MAX, area.bottom()) / CREATURE_CELL_SIZE;
+
+    for (int cellY = firstY; cellY <= lastY; ++cellY) {
+        for (int cellX = firstX; cellX <= lastX; ++cellX) {
+            const auto it = cells.find(getCreatureCellIndex(cellX * CREATURE_CELL_SIZE, cellY * CREATURE_CELL_SIZE));
+            if (it == cells.end())
+                continue;
+
+            for (const auto& entry : it->second) {
+                if (area.contains(Point(entry.position.x, entry.position.y)))
+                    positions.emplace_back(entry.position);
+            }
+        }
+    }
+
+    // row by row like a scan of the area, each tile once even with several creatures on it
+    const auto begin = positions.begin() + firstIndex;
+    std::sort(begin, positions.end(), [](const Position& a, const Position& b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+    positions.erase(std::unique(begin, positions.end()), positions.end());
+}
+
 void Map::removeUnawareThings()
 {
     // remove creatures from tiles that we are not aware of anymore
@@ -565,42 +814,145 @@ void Map::removeUnawareThings()
         }
     });
 
-    if (!g_game.getFeature(Otc::GameKeepUnawareTiles)) {
-        const auto& customAwareRange = g_game.getFeature(Otc::GameMapCache) ? AwareRange{
-            .left = static_cast<uint8_t>(m_awareRange.left * 4),
-            .top = static_cast<uint8_t>(m_awareRange.top * 4),
-            .right = static_cast<uint8_t>(m_awareRange.right * 4),
-            .bottom = static_cast<uint8_t>(m_awareRange.bottom * 4),
-        } : m_awareRange;
+    if (g_game.getFeature(Otc::GameKeepUnawareTiles)) {
+        // nothing to track, the next pass without the feature starts over with every block
+        for (auto& floor : m_floors)
+            floor.awareRect = {};
+        m_pendingEvictions.clear();
+        return;
+    }
 
-        // remove tiles that we are not aware anymore
-        for (auto z = -1; ++z <= g_gameConfig.getMapMaxZ();) {
-            auto& tileBlocks = m_floors[z].tileBlocks;
-            for (auto it = tileBlocks.begin(); it != tileBlocks.end();) {
-                auto& block = it->second;
-                bool blockEmpty = true;
-                for (const auto& tile : block.getTiles()) {
-                    if (!tile) continue;
+    // queue only the strips of each floor that just left the aware area
+    const auto& range = getTileCacheRange();
+    for (uint8_t z = 0; z < m_floors.size(); ++z) {
+        auto& floor = m_floors[z];
+        const Rect aware = getAwareRect(z, range);
+        const Rect previous = floor.awareRect;
+        if (aware == previous)
+            continue;
 
-                    const auto& pos = tile->getPosition();
-                    if (isAwareOfPosition(pos, customAwareRange)) {
-                        blockEmpty = false;
-                        continue;
-                    }
+        floor.awareRect = aware;
+
+        if (!previous.isValid()) {
+            for (const auto& [index, block] : floor.tileBlocks) {
+                const int blockX = index % (65536 / BLOCK_SIZE);
+                const int blockY = index / (65536 / BLOCK_SIZE);
+                queueEviction(z, Rect(blockX * BLOCK_SIZE, blockY * BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE));
+            }
+            continue;
+        }
+
+        const Rect kept = aware.isValid() ? previous.intersection(aware) : Rect();
+        if (!kept.isValid()) {
+            queueEviction(z, previous);
+            continue;
+        }
+
+        queueEviction(z, Rect(Point(previous.left(), previous.top()), Point(previous.right(), kept.top() - 1)));
+        queueEviction(z, Rect(Point(previous.left(), kept.bottom() + 1), Point(previous.right(), previous.bottom())));
+        queueEviction(z, Rect(Point(previous.left(), kept.top()), Point(kept.left() - 1, kept.bottom())));
+        queueEviction(z, Rect(Point(kept.right() + 1, kept.top()), Point(previous.right(), kept.bottom())));
+    }
+
+    evictUnawareTiles();
+}
+
+AwareRange Map::getTileCacheRange() const
+{
+    if (!g_game.getFeature(Otc::GameMapCache))
+        return m_awareRange;
+
+    return {
+        .left = static_cast<uint8_t>(m_awareRange.left * 4),
+        .top = static_cast<uint8_t>(m_awareRange.top * 4),
+        .right = static_cast<uint8_t>(m_awareRange.right * 4),
+        .bottom = static_cast<uint8_t>(m_awareRange.bottom * 4),
+    };
+}
+
+Rect Map::getAwareRect(const uint8_t z, const AwareRange& range) const
+{
+    if (!m_centralPosition.isMapPosition())
+        return {};
+
+    if ((z < getFirstAwareFloor() || z > getLastAwareFloor()) && range == m_awareRange)
+        return {};
+
+    // isAwareOfPosition grounds the position on the central floor, one tile diagonally per floor
+    const int offset = z - m_centralPosition.z;
+    return Rect(Point(m_centralPosition.x - range.left - offset, m_centralPosition.y - range.top - offset),
+                Point(m_centralPosition.x + range.right - offset, m_centralPosition.y + range.bottom - offset));
+}
+
+void Map::queueEviction(const uint8_t z, const Rect& area)
+{
+    if (!area.isValid())
+        return;
+
+    // one strip per block, so each one is a single block lookup
+    const int firstX = std::max<int>(0, area.left()) / BLOCK_SIZE;
+    const int firstY = std::max<int>(0, area.top()) / BLOCK_SIZE;
+    const int lastX = std::min<int>(UINT16_MAX, area.right()) / BLOCK_SIZE;
+    const int lastY = std::min<int>(UINT16_MAX, area.bottom()) / BLOCK_SIZE;
+
+    for (int blockY = firstY; blockY <= lastY; ++blockY) {
+        for (int blockX = firstX; blockX <= lastX; ++blockX) {
+            const Rect strip = area.intersection(Rect(blockX * BLOCK_SIZE, blockY * BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE));
+            if (strip.isValid())
+                m_pendingEvictions.push_back({ z, strip });
+        }
+    }
+}
+
+void Map::evictUnawareTiles()
+{
+    AutoStat s(TRACE_ZONE(STATS_MAIN, "Map::evictUnawareTiles"));
+
+    const auto& range = getTileCacheRange();
+    size_t budget = EVICTION_BUDGET;
+
+    while (!m_pendingEvictions.empty() && budget > 0) {
+        const auto [z, area] = m_pendingEvictions.front();
+        m_pendingEvictions.pop_front();
+        budget -= std::min<size_t>(budget, static_cast<size_t>(area.width()) * area.height());
+
+        auto& tileBlocks = m_floors[z].tileBlocks;
+        const uint32_t blockIndex = getBlockIndex(Position(area.left(), area.top(), z));
+        const auto it = tileBlocks.find(blockIndex);
+        if (it == tileBlocks.end())
+            continue;
 
-                    if (!tile->isEmpty())
-                        tile->clean();
+        auto& block = it->second;
+        for (int y = area.top(); y <= area.bottom(); ++y) {
+            for (int x = area.left(); x <= area.right(); ++x) {
+                const Position pos(x, y, z);
+                const auto& tile = block.get(pos);
+                if (!tile || isAwareOfPosition(pos, range))
+                    continue;
 
-                    block.remove(pos);
-                    notificateTileUpdate(pos, nullptr, Otc::OPERATION_CLEAN);
+                if (!tile->isEmpty()) {
+                    unindexCreatures(tile);
+                    tile->clean();
                 }
 
-                if (blockEmpty)
-                    it = tileBlocks.erase(it);
-                else
-                    ++it;
+                block.remove(pos);
+                notificateTileUpdate(pos, nullptr, Otc::OPERATION_CLEAN);
             }
         }
+
+        // by key, a tile update callback may have inserted blocks in the meantime
+        if (block.empty()) {
+            unlinkTileBlock(z, blockIndex);
+            tileBlocks.erase(blockIndex);
+        }
+    }
+
+    if (!m_pendingEvictions.empty() && !m_evictionScheduled) {
+        m_evictionScheduled = true;
+        g_dispatcher.addEvent([this] {
+            m_evictionScheduled = false;
+            evictUnawareTiles();
+        });
     }
 }
 
@@ -611,6 +963,7 @@ void Map::setCentralPosition(const Position& centralPosition)
 
     m_centralPosition = centralPosition;
 
+    updateBlockWindow();
     removeUnawareThings();
 
     // this fixes local player position when the local player is removed from the map,
@@ -670,24 +1023,22 @@ std::vector<CreaturePtr> Map::getSpectatorsInRangeEx(const Position& centerPos,
     const int startX = centerPos.x - minXRange;
     const int endX = centerPos.x + maxXRange;
 
-    const auto appendSpectatorsFromLayer = [&](const int z) {
-        for (int y = startY; y <= endY; ++y) {
-            for (int x = startX; x <= endX; ++x) {
-                const auto tile = getTile(Position(x, y, z));
-                if (!tile || !tile->hasCreatures()) {
-                    continue;
-                }
+    // only the tiles holding a creature are visited, in the same z, y, x order a full scan of the area would use
+    std::vector<Position> positions;
+    const Rect area(Point(startX, startY), Point(endX, endY));
+    for (int z = std::max<int>(0, startZ); z <= endZ && z < static_cast<int>(m_floors.size()); ++z)
+        collectCreatureTiles(z, area, positions);
 
-                const auto sizeBeforeAppend = creatures.size();
-                tile->appendSpectators(creatures);
-                cleanNewSpectators(creatures, seenIds, sizeBeforeAppend);
-            }
-        }
-    };
+    for (const auto& pos : positions) {
+        const auto& tile = getTile(pos);
+        if (!tile || !tile->hasCreatures())
+            continue;
 
-    for (int z = startZ; z <= endZ; ++z) {
-        appendSpectatorsFromLayer(z);
+        const auto sizeBeforeAppend = creatures.size();
+        tile->appendSpectators(creatures);
+        cleanNewSpectators(creatures, seenIds, sizeBeforeAppend);
     }
+
     return creatures;
 }
 
@@ -800,6 +1151,7 @@ bool Map::isAwareOfPosition(const Position& pos, const AwareRange& awareRange) c
 void Map::setAwareRange(const AwareRange& range)
 {
     m_awareRange = range;
+    updateBlockWindow();
     removeUnawareThings();
 }
 
@@ -1009,160 +1361,60 @@ void Map::resetLastCamera() const
         mapView->resetLastCamera();
 }
 
-PathFindResult_ptr Map::newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>
-                                    & visibleNodes)
+void Map::findPathAsync(const Position& start, const Position& goal, const std::function<void(PathFindResult_ptr)>&
+                        callback)
 {
-    auto ret = std::make_shared<PathFindResult>();
-    ret->start = start;
-    ret->destination = goal;
-
-    if (start == goal) {
-        ret->status = Otc::PathFindResultSamePosition;
-        return ret;
-    }
-
-    if (goal.z != start.z) {
-        return ret;
-    }
-
-    // check the goal pos is walkable
-    if (g_map.isAwareOfPosition(goal)) {
-        const auto& goalTile = getTile(goal);
-        if (!goalTile || (!goalTile->isWalkable())) {
-            return ret;
-        }
-    } else {
-        const auto& goalTile = g_minimap.getTile(goal);
-        if (goalTile.hasFlag(MinimapTileNotWalkable)) {
-            return ret;
-        }
-    }
-
-    struct LessNode
-    {
-        bool operator()(const Node* a, const Node* b) const
-        {
-            return b->totalCost < a->totalCost;
-        }
-    };
-
-    stdext::map<Position, Node*, Position::Hasher> nodes;
-    std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
-
-    if (visibleNodes) {
-        for (auto& node : *visibleNodes)
-            nodes.emplace(node->pos, node);
-    }
-
-    const auto& initNode = new Node{ .cost = 1, .totalCost = 0, .pos = start, .prev = nullptr, .distance = 0, .unseen = 0 };
-    nodes[start] = initNode;
-    searchList.push(initNode);
-
-    int limit = 50000;
-    const float distance = start.distance(goal);
-
-    const Node* dstNode = nullptr;
-    while (!searchList.empty() && --limit) {
-        Node* node = searchList.top();
-        searchList.pop();
-        if (node->pos == goal) {
-            dstNode = node;
-            break;
-        }
-        if (node->pos.distance(goal) > distance + 10000)
-            continue;
-        for (int i = -1; i <= 1; ++i) {
-            for (int j = -1; j <= 1; ++j) {
-                if (i == 0 && j == 0)
-                    continue;
-                Position neighbor = node->pos.translated(i, j);
-                if (neighbor.x < 0 || neighbor.y < 0) continue;
-                auto it = nodes.find(neighbor);
-                if (it == nodes.end()) {
-                    const auto& [block, tile] = g_minimap.threadGetTile(neighbor);
-                    const bool wasSeen = tile.hasFlag(MinimapTileWasSeen);
-                    const bool isNotWalkable = tile.hasFlag(MinimapTileNotWalkable);
-                    const bool isNotPathable = tile.hasFlag(MinimapTileNotPathable);
-                    const bool isEmpty = tile.hasFlag(MinimapTileEmpty);
-                    float speed = tile.getSpeed();
-                    if ((isNotWalkable || isNotPathable || isEmpty) && neighbor != goal) {
-                        it = nodes.emplace(neighbor, nullptr).first;
-                    } else {
-                        if (!wasSeen)
-                            speed = 2000;
-                        it = nodes.emplace(neighbor, new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = neighbor, .prev =
-                                               node,
-                                               .distance = node->distance + 1, .unseen = wasSeen ? 0 : 1 }).first;
-                    }
-                }
-                if (!it->second) // no way
-                    continue;
-
-                if (it->second->unseen > 50)
-                    continue;
-
-                float diagonal = ((i == 0 || j == 0) ? 1.0f : g_gameConfig.getPlayerDiagonalWalkSpeed());
-                float cost = it->second->cost * diagonal;
-                cost += diagonal * (50.0f * std::max<float>(5.0f, it->second->pos.distance(goal))); // heuristic
-                if (node->totalCost + cost + 50 < it->second->totalCost) {
-                    it->second->totalCost = node->totalCost + cost;
-                    it->second->prev = node;
-                    if (it->second->unseen)
-                        it->second->unseen = node->unseen + 1;
-                    it->second->distance = node->distance + 1;
-                    searchList.push(it->second);
-                }
-            }
-        }
+    cancelPathSearch();
+
+    // the map and the minimap are only read here, the pool thread gets its own copy
+    const auto snapshot = start != goal && start.z == goal.z ? m_pathFinder.createSnapshot(start, goal) : nullptr;
+    if (!snapshot) {
+        auto ret = std::make_shared<PathFindResult>();
+        ret->start = start;
+        ret->destination = goal;
+        if (start == goal)
+            ret->status = Otc::PathFindResultSamePosition;
+        else if (start.z == goal.z && !PathFinder::isInSnapshotRange(start, goal))
+            ret->status = Otc::PathFindResultTooFar;
+
+        g_dispatcher.addEvent([=] { callback(ret); });
+        return;
     }
 
-    if (dstNode) {
-        while (dstNode && dstNode->prev) {
-            if (dstNode->unseen) {
-                ret->path.clear();
-            } else {
-                ret->path.push_back(dstNode->prev->pos.getDirectionFromPosition(dstNode->pos));
-            }
-            dstNode = dstNode->prev;
-        }
-        std::reverse(ret->path.begin(), ret->path.end());
-        ret->status = Otc::PathFindResultOk;
-    }
-    ret->complexity = 50000 - limit;
+    const auto cancelled = m_pathSearchCancelled = std::make_shared<std::atomic_bool>(false);
+    g_asyncDispatcher->detach_task([=] {
+        const auto ret = PathFinder::findPath(*snapshot, start, goal, cancelled.get());
+        if (!ret)
+            return;
 
-    for (const auto& node : nodes) {
-        delete node.second;
-    }
+        g_dispatcher.addEvent([=] {
+            if (!*cancelled)
+                callback(ret);
+        });
+    });
+}
 
-    return ret;
+void Map::findLongPathAsync(const Position& start, const Position& goal, const int maxComplexity,
+                            const std::function<void(PathFindResult_ptr)>& callback)
+{
+    // a cold search builds the graph of every block it crosses, which takes far longer than a frame
+    g_asyncDispatcher->detach_task([this, start, goal, maxComplexity, callback] {
+        const auto ret = std::make_shared<PathFindResult>();
+        ret->start = start;
+        ret->destination = goal;
+        std::tie(ret->path, ret->status) = m_pathFinder.findLongPath(start, goal, maxComplexity);
+
+        g_dispatcher.addEvent([=] { callback(ret); });
+    });
 }
 
-void Map::findPathAsync(const Position& start, const Position& goal, const std::function<void(PathFindResult_ptr)>&
-                        callback)
+void Map::cancelPathSearch()
 {
-    const auto visibleNodes = std::make_shared<std::list<Node*>>();
-    for (const auto& tile : getTiles(start.z)) {
-        if (tile->getPosition() == start)
-            continue;
-        const bool isNotWalkable = !tile->isWalkable(false);
-        const bool isNotPathable = !tile->isPathable();
-        const float speed = tile->getGroundSpeed();
-        if ((isNotWalkable || isNotPathable) && tile->getPosition() != goal) {
-            visibleNodes->push_back(new Node{ .cost = speed, .totalCost = 0, .pos = tile->getPosition(), .prev = nullptr, .distance =
-                0,
-                .unseen = 0
-            });
-        } else {
-            visibleNodes->push_back(new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = tile->getPosition(), .prev =
-                nullptr, .distance = 0, .unseen = 0
-            });
-        }
-    }
+    if (!m_pathSearchCancelled)
+        return;
 
-    g_asyncDispatcher->detach_task([=] {
-        const auto ret = g_map.newFindPath(start, goal, visibleNodes);
-        g_dispatcher.addEvent(std::bind(callback, ret));
-    });
+    *m_pathSearchCancelled = true;
+    m_pathSearchCancelled = nullptr;
 }
 
 int Map::getMinimapColor(const Position& pos)
@@ -1180,48 +1432,90 @@ int Map::getMinimapColor(const Position& pos)
 
 bool Map::isSightClear(const Position& fromPos, const Position& toPos)
 {
-    if (fromPos == toPos) {
-        return true;
-    }
+    const auto getBlock = [this](const Position& pos) -> const TileBlock* {
+        if (static_cast<uint32_t>(pos.x) >= UINT16_MAX || static_cast<uint32_t>(pos.y) >= UINT16_MAX || pos.z >= m_floors.size())
+            return nullptr;
+        return findTileBlock(pos);
+    };
+
+    return traceSightLine(fromPos, toPos,
+                          [&](const Position& pos) { const auto block = getBlock(pos); return block && block->blocksSight(pos); },
+                          [&](const Position& pos) { const auto block = getBlock(pos); return block && block->hasThings(pos); });
+}
 
-    Position start(fromPos.z > toPos.z ? toPos : fromPos);
-    const Position destination(fromPos.z > toPos.z ? fromPos : toPos);
+void Map::updateTileSight(Tile& tile)
+{
+    const auto& pos = tile.getPosition();
+    if (static_cast<uint32_t>(pos.x) >= UINT16_MAX || static_cast<uint32_t>(pos.y) >= UINT16_MAX || pos.z >= m_floors.size())
+        return;
 
-    const int8_t mx = start.x < destination.x ? 1 : start.x == destination.x ? 0 : -1;
-    const int8_t my = start.y < destination.y ? 1 : start.y == destination.y ? 0 : -1;
+    if (const auto block = findTileBlock(pos))
+        block->updateSight(tile);
+}
 
-    const int32_t A = destination.y - start.y;
-    const int32_t B = start.x - destination.x;
-    const int32_t C = -(A * destination.x + B * destination.y);
+std::vector<bool> Map::checkSightLines(const Position& fromPos, const std::vector<Position>& toPositions)
+{
+    std::vector<bool> ret(toPositions.size(), false);
 
-    while (start.x != destination.x || start.y != destination.y) {
-        const int32_t move_hor = std::abs(A * (start.x + mx) + B * (start.y) + C);
-        const int32_t move_ver = std::abs(A * (start.x) + B * (start.y + my) + C);
-        const int32_t move_cross = std::abs(A * (start.x + mx) + B * (start.y + my) + C);
+    const auto isValid = [this](const Position& pos) {
+        return static_cast<uint32_t>(pos.x) < UINT16_MAX && static_cast<uint32_t>(pos.y) < UINT16_MAX && pos.z < m_floors.size();
+    };
 
-        if (start.y != destination.y && (start.x == destination.x || move_hor > move_ver || move_hor > move_cross)) {
-            start.y += my;
-        }
+    if (!isValid(fromPos)) {
+        for (size_t i = 0; i < toPositions.size(); ++i)
+            ret[i] = isSightClear(fromPos, toPositions[i]);
+        return ret;
+    }
 
-        if (start.x != destination.x && (start.y == destination.y || move_ver > move_hor || move_ver > move_cross)) {
-            start.x += mx;
-        }
+    // targets past the aware range around the origin are checked one by one, so a far one cannot blow up the box
+    const auto isBatched = [&](const Position& pos) {
+        return isValid(pos)
+            && pos.x >= fromPos.x - m_awareRange.left && pos.x <= fromPos.x + m_awareRange.right
+            && pos.y >= fromPos.y - m_awareRange.top && pos.y <= fromPos.y + m_awareRange.bottom
+            && pos.z >= std::min(fromPos.z, getFirstAwareFloor()) && pos.z <= std::max(fromPos.z, getLastAwareFloor());
+    };
 
-        const auto tile = getTile(Position(start.x, start.y, start.z));
-        if (tile && !tile->isLookPossible()) {
-            return false;
-        }
+    // every line stays inside the box around the origin and the targets
+    int left = fromPos.x, top = fromPos.y, right = fromPos.x, bottom = fromPos.y;
+    uint8_t firstZ = fromPos.z, lastZ = fromPos.z;
+    for (const auto& pos : toPositions) {
+        if (!isBatched(pos))
+            continue;
+
+        left = std::min<int>(left, pos.x);
+        top = std::min<int>(top, pos.y);
+        right = std::max<int>(right, pos.x);
+        bottom = std::max<int>(bottom, pos.y);
+        firstZ = std::min(firstZ, pos.z);
+        lastZ = std::max(lastZ, pos.z);
     }
 
-    while (start.z != destination.z) {
-        const auto tile = getTile(Position(start.x, start.y, start.z));
-        if (tile && tile->getThingCount() > 0) {
-            return false;
+    const int firstBlockX = left / BLOCK_SIZE;
+    const int firstBlockY = top / BLOCK_SIZE;
+    const int blocksPerRow = right / BLOCK_SIZE - firstBlockX + 1;
+    const int blocksPerFloor = blocksPerRow * (bottom / BLOCK_SIZE - firstBlockY + 1);
+
+    std::vector<const TileBlock*> blocks;
+    blocks.reserve(static_cast<size_t>(blocksPerFloor) * (lastZ - firstZ + 1));
+    for (int z = firstZ; z <= lastZ; ++z) {
+        for (int blockY = firstBlockY; blockY <= bottom / BLOCK_SIZE; ++blockY) {
+            for (int blockX = firstBlockX; blockX <= right / BLOCK_SIZE; ++blockX)
+                blocks.emplace_back(findTileBlock(Position(blockX * BLOCK_SIZE, blockY * BLOCK_SIZE, z)));
         }
-        start.z++;
     }
 
-    return true;
+    const auto getBlock = [&](const Position& pos) {
+        return blocks[(pos.z - firstZ) * blocksPerFloor + (pos.y / BLOCK_SIZE - firstBlockY) * blocksPerRow + (pos.x / BLOCK_SIZE - firstBlockX)];
+    };
+    const auto blocked = [&](const Position& pos) { const auto block = getBlock(pos); return block && block->blocksSight(pos); };
+    const auto occupied = [&](const Position& pos) { const auto block = getBlock(pos); return block && block->hasThings(pos); };
+
+    for (size_t i = 0; i < toPositions.size(); ++i) {
+        const auto& toPos = toPositions[i];
+        ret[i] = isBatched(toPos) ? traceSightLine(fromPos, toPos, blocked, occupied) : isSightClear(fromPos, toPos);
+    }
+
+    return ret;
 }
 
 bool Map::isWidgetAttached(const UIWidgetPtr& widget) const {
@@ -1515,40 +1809,60 @@ std::vector<CreaturePtr> Map::getSpectatorsByPattern(const Position& centerPos,
         return creatures;
     }
 
-    p = 0;
     std::unordered_set<uint32_t> seenIds;
     seenIds.reserve(m_knownCreatures.size());
-    for (int y = centerPos.y - height / 2, endy = centerPos.y + height / 2; y <= endy; ++y) {
-        for (int x = centerPos.x - width / 2, endx = centerPos.x + width / 2; x <= endx; ++x) {
-            const auto enabled = finalPattern[p];
-            ++p;
-            if (!enabled) {
-                continue;
-            }
 
-            const auto tile = getTile(Position(x, y, centerPos.z));
-            if (!tile || !tile->hasCreatures()) {
-                continue;
-            }
+    const int left = centerPos.x - width / 2;
+    const int top = centerPos.y - height / 2;
+    std::vector<Position> positions;
+    if (centerPos.z < m_floors.size())
+        collectCreatureTiles(centerPos.z, Rect(left, top, width, height), positions);
 
-            const auto sizeBeforeAppend = creatures.size();
-            tile->appendSpectators(creatures);
-            cleanNewSpectators(creatures, seenIds, sizeBeforeAppend);
+    for (const auto& pos : positions) {
+        if (!finalPattern[(pos.y - top) * width + (pos.x - left)]) {
+            continue;
         }
+
+        const auto tile = getTile(pos);
+        if (!tile || !tile->hasCreatures()) {
+            continue;
+        }
+
+        const auto sizeBeforeAppend = creatures.size();
+        tile->appendSpectators(creatures);
+        cleanNewSpectators(creatures, seenIds, sizeBeforeAppend);
     }
     return creatures;
 }
 
 const TilePtr& TileBlock::create(const Position& pos)
 {
-    auto& tile = m_tiles[getTileIndex(pos)];
+    const uint32_t index = getTileIndex(pos);
+    auto& tile = m_tiles[index];
+    if (!tile)
+        ++m_tileCount;
     tile = std::make_shared<Tile>(pos);
+    m_blocksSight.reset(index);
+    m_hasThings.reset(index);
     return tile;
 }
 const TilePtr& TileBlock::getOrCreate(const Position& pos)
 {
     auto& tile = m_tiles[getTileIndex(pos)];
-    if (!tile)
+    if (!tile) {
         tile = std::make_shared<Tile>(pos);
+        ++m_tileCount;
+    }
     return tile;
 }
+
+void TileBlock::updateSight(Tile& tile)
+{
+    const uint32_t index = getTileIndex(tile.getPosition());
+    // a tile no longer held by the block keeps its things to itself
+    if (m_tiles[index].get() != &tile)
+        return;
+
+    m_blocksSight[index] = !tile.isLookPossible();
+    m_hasThings[index] = tile.getThingCount() > 0;
+}
@@ -22,6 +22,7 @@
 
 #pragma once
 #include "declarations.h"
+#include "pathfinding.h"
 #include "staticdata.h"
 #include "framework/core/inputevent.h"
 #include "framework/ui/declarations.h"
@@ -34,26 +35,35 @@ public:
     const TilePtr& create(const Position& pos);
     const TilePtr& getOrCreate(const Position& pos);
     const TilePtr& get(const Position& pos) { return m_tiles[getTileIndex(pos)]; }
-    void remove(const Position& pos) { m_tiles[getTileIndex(pos)] = nullptr; }
+    void remove(const Position& pos)
+    {
+        const uint32_t index = getTileIndex(pos);
+        if (auto& tile = m_tiles[index]) {
+            tile = nullptr;
+            m_blocksSight.reset(index);
+            m_hasThings.reset(index);
+            --m_tileCount;
+        }
+    }
+
+    bool empty() const { return m_tileCount == 0; }
 
-    uint32_t getTileIndex(const Position& pos) { return ((pos.y % BLOCK_SIZE) * BLOCK_SIZE) + (pos.x % BLOCK_SIZE); }
+    // line of sight flags of the tile at pos, refreshed by the tile whenever its things change
+    void updateSight(Tile& tile);
+    bool blocksSight(const Position& pos) const { return m_blocksSight[getTileIndex(pos)]; }
+    bool hasThings(const Position& pos) const { return m_hasThings[getTileIndex(pos)]; }
+
+    uint32_t getTileIndex(const Position& pos) const { return ((static_cast<uint32_t>(pos.y) % BLOCK_SIZE) * BLOCK_SIZE) + (static_cast<uint32_t>(pos.x) % BLOCK_SIZE); }
 
     const std::array<TilePtr, BLOCK_SIZE* BLOCK_SIZE>& getTiles() const { return m_tiles; }
 
 private:
     std::array<TilePtr, BLOCK_SIZE* BLOCK_SIZE> m_tiles;
+    std::bitset<BLOCK_SIZE* BLOCK_SIZE> m_blocksSight;
+    std::bitset<BLOCK_SIZE* BLOCK_SIZE> m_hasThings;
+    uint16_t m_tileCount{ 0 };
 };
 
-struct PathFindResult
-{
-    Otc::PathFindResult status = Otc::PathFindResultNoWay;
-    std::vector<Otc::Direction> path;
-    int complexity = 0;
-    Position start;
-    Position destination;
-};
-using PathFindResult_ptr = std::shared_ptr<PathFindResult>;
-
 struct Node
 {
     float cost;
@@ -129,6 +139,12 @@ public:
     bool removeThing(const ThingPtr& thing);
     bool removeThingByPos(const Position& pos, int16_t stackPos);
 
+    // tile:addThing, tile:removeThing and tile:clean from Lua; a tile the map holds keeps its creatures
+    // indexed and notifies the map views, any other tile is changed directly
+    void addThingToTile(const TilePtr& tile, const ThingPtr& thing, int stackPos);
+    bool removeThingFromTile(const TilePtr& tile, const ThingPtr& thing);
+    void cleanTileThings(const TilePtr& tile);
+
     void addStaticText(const StaticTextPtr& txt, const Position& pos);
     bool removeStaticText(const StaticTextPtr& txt);
 
@@ -150,7 +166,17 @@ public:
     template <typename... Items>
     const TilePtr& createTileEx(const Position& pos, const Items&... items);
     const TilePtr& getOrCreateTile(const Position& pos);
-    const TilePtr& getTile(const Position& pos);
+    const TilePtr& getTile(const Position& pos)
+    {
+        // Position::isMapPosition, with the floor bound taken from m_floors so it stays inline
+        if (static_cast<uint32_t>(pos.x) >= UINT16_MAX || static_cast<uint32_t>(pos.y) >= UINT16_MAX || pos.z >= m_floors.size())
+            return m_nulltile;
+
+        if (const auto block = findTileBlock(pos))
+            return block->get(pos);
+
+        return m_nulltile;
+    }
     TileList getTiles(int8_t floor = -1);
     void cleanTile(const Position& pos);
 
@@ -217,9 +243,14 @@ public:
 
     std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> findPath(const Position& start, const Position& goal,
                                                                           int maxComplexity, int flags = 0);
-    PathFindResult_ptr newFindPath(const Position& start, const Position& goal, const std::shared_ptr<std::list<Node*>>& visibleNodes);
+    // searches a snapshot of the floor on the thread pool, a new request cancels the pending one
     void findPathAsync(const Position& start, const Position& goal,
                        const std::function<void(PathFindResult_ptr)>& callback);
+    void cancelPathSearch();
+    // routes across the explored minimap on the thread pool, see PathFinder::findLongPath;
+    // the callback runs on the main thread
+    void findLongPathAsync(const Position& start, const Position& goal, int maxComplexity,
+                           const std::function<void(PathFindResult_ptr)>& callback);
 
     void setFloatingEffect(const bool enable) { m_floatingEffect = enable; }
     bool isDrawingFloatingEffects() { return m_floatingEffect; }
@@ -229,22 +260,99 @@ public:
 
     int getMinimapColor(const Position& pos);
     bool isSightClear(const Position& fromPos, const Position& toPos);
+    // isSightClear from one position to each of the others, the blocks the lines cross are looked up once
+    std::vector<bool> checkSightLines(const Position& fromPos, const std::vector<Position>& toPositions);
+    // called by the tile whenever a thing is added to it or removed from it
+    void updateTileSight(Tile& tile);
 
     const auto& getCreatures() const { return m_knownCreatures; }
 
 private:
+    struct CreatureCellEntry
+    {
+        Position position;
+        CreaturePtr creature;
+    };
+
     struct FloorData
     {
         std::vector<MissilePtr> missiles;
         std::unordered_map<uint32_t, TileBlock > tileBlocks;
+        // toroidal grid over the blocks around the central position, pointing into tileBlocks
+        std::vector<TileBlock*> blockWindow;
+        // tiles kept at the last eviction pass, the ones outside it are already queued for eviction
+        Rect awareRect;
+        // creatures placed through addThing, bucketed by CREATURE_CELL_SIZE cells
+        std::unordered_map<uint32_t, std::vector<CreatureCellEntry>> creatureCells;
     };
 
+    // part of a single block whose tiles may have left the aware area
+    struct EvictionStrip
+    {
+        uint8_t z;
+        Rect area;
+    };
+
+    // tiles checked per eviction pass, what is left over continues on the next dispatcher poll
+    static constexpr size_t EVICTION_BUDGET = 8192;
+
     void removeUnawareThings();
+    AwareRange getTileCacheRange() const;
+    Rect getAwareRect(uint8_t z, const AwareRange& range) const;
+    void queueEviction(uint8_t z, const Rect& area);
+    void evictUnawareTiles();
 
-    uint16_t getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
+    uint32_t getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
+
+    // blocks inside the window are found without hashing, the ones cached further away fall back to tileBlocks
+    TileBlock* findTileBlock(const Position& pos)
+    {
+        auto& floor = m_floors[pos.z];
+        const int blockX = static_cast<uint32_t>(pos.x) / BLOCK_SIZE;
+        const int blockY = static_cast<uint32_t>(pos.y) / BLOCK_SIZE;
+        if (isInBlockWindow(blockX, blockY))
+            return floor.blockWindow[getBlockWindowSlot(blockX, blockY)];
+
+        const auto it = floor.tileBlocks.find(getBlockIndex(pos));
+        return it != floor.tileBlocks.end() ? &it->second : nullptr;
+    }
+
+    bool isInBlockWindow(const int blockX, const int blockY) const
+    {
+        return static_cast<unsigned>(blockX - m_blockWindowOrigin.x) < static_cast<unsigned>(m_blockWindowSize.width())
+            && static_cast<unsigned>(blockY - m_blockWindowOrigin.y) < static_cast<unsigned>(m_blockWindowSize.height());
+    }
+
+    size_t getBlockWindowSlot(const int blockX, const int blockY) const
+    {
+        // power of two sides, wrapping is a mask instead of a division
+        return static_cast<size_t>(blockY & (m_blockWindowSize.height() - 1)) << m_blockWindowShift | (blockX & (m_blockWindowSize.width() - 1));
+    }
+
+    static constexpr int CREATURE_CELL_SIZE = 8;
+
+    static uint32_t getCreatureCellIndex(const int x, const int y) { return ((y / CREATURE_CELL_SIZE) * (65536 / CREATURE_CELL_SIZE)) + (x / CREATURE_CELL_SIZE); }
+
+    bool isMapTile(const TilePtr& tile);
+    void placeThing(const TilePtr& tile, const ThingPtr& thing, int16_t stackPos);
+
+    void indexCreature(const CreaturePtr& creature, const Position& pos);
+    void unindexCreature(const CreaturePtr& creature, const Position& pos);
+    void unindexCreatures(const TilePtr& tile);
+    void collectCreatureTiles(uint8_t z, const Rect& area, std::vector<Position>& positions);
+
+    TileBlock& getOrCreateTileBlock(const Position& pos);
+    void unlinkTileBlock(uint8_t z, uint32_t blockIndex);
+    void updateBlockWindow();
+    void resetTileBlockTracking();
+
+    static const TilePtr m_nulltile;
 
     std::vector<FloorData> m_floors;
 
+    PathFinder m_pathFinder;
+    std::shared_ptr<std::atomic_bool> m_pathSearchCancelled;
+
     std::vector<AnimatedTextPtr> m_animatedTexts;
     std::vector<StaticTextPtr> m_staticTexts;
     std::vector<MapViewPtr> m_mapViews;
@@ -275,6 +383,14 @@ private:
 
     AwareRange m_awareRange;
 
+    // in blocks, covers the aware range (and the GameMapCache margin) around m_centralPosition
+    Point m_blockWindowOrigin;
+    Size m_blockWindowSize{ 0, 0 };
+    uint8_t m_blockWindowShift{ 0 };
+
+    std::deque<EvictionStrip> m_pendingEvictions;
+    bool m_evictionScheduled{ false };
+
     bool m_floatingEffect{ true };
 };
 
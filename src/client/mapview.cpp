@@ -449,14 +449,38 @@ void MapView::updateVisibleTiles()
     m_updateVisibleTiles = false;
     m_resetCoveredCache = false;
     updateHighlightTile(m_mousePosition);
+    prefetchVisibleSheets();
 }
 
-void MapView::updateRect(const Rect& rect) {
-    if (m_posInfo.camera != getCameraPosition()) {
-        m_posInfo.camera = getCameraPosition();
-        requestUpdateVisibleTiles();
-        requestUpdateMapPosInfo();
+void MapView::prefetchVisibleSheets()
+{
+    if (!g_game.isUsingProtobuf())
+        return;
+
+    // sheets of the things closest to the camera are decoded first
+    const auto& camera = m_posInfo.camera;
+    for (int z = m_floorMin; z <= m_floorMax; ++z) {
+        for (const auto& tile : m_floors[z].cachedVisibleTiles.tiles) {
+            const auto& pos = tile->getPosition();
+            const int priority = -(std::abs(pos.x - camera.x) + std::abs(pos.y - camera.y) + std::abs(pos.z - camera.z) * 8);
+            for (const auto& thing : tile->getThings())
+                thing->prefetchSpriteSheets(priority);
+        }
     }
+}
+
+void MapView::updateCamera()
+{
+    if (m_posInfo.camera == getCameraPosition())
+        return;
+
+    m_posInfo.camera = getCameraPosition();
+    requestUpdateVisibleTiles();
+    requestUpdateMapPosInfo();
+}
+
+void MapView::updateRect(const Rect& rect) {
+    updateCamera();
 
     if (m_posInfo.rect != rect || m_updateMapPosInfo) {
         m_updateMapPosInfo = false;
@@ -502,7 +526,9 @@ void MapView::updateGeometry(const Size& visibleDimension)
     const auto& drawDimension = visibleDimension + 3;
     const auto& bufferSize = drawDimension * tileSize;
 
-    if (bufferSize.width() > g_graphics.getMaxTextureSize() || bufferSize.height() > g_graphics.getMaxTextureSize()) {
+    // without a GL context (headless tools) the max texture size is unknown, so it does not limit the view
+    const int maxTextureSize = g_graphics.getMaxTextureSize();
+    if (maxTextureSize > 0 && (bufferSize.width() > maxTextureSize || bufferSize.height() > maxTextureSize)) {
         g_logger.traceError("reached max zoom out");
         return;
     }
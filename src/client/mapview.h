@@ -151,6 +151,7 @@ protected:
     friend class UIMap;
     friend class Tile;
     friend class LightView;
+    friend class ReplayBenchmark;
 
 private:
     enum class FadeType
@@ -185,6 +186,8 @@ private:
     void updateViewportDirectionCache();
     void updateGeometry(const Size& visibleDimension);
     void updateVisibleTiles();
+    void prefetchVisibleSheets();
+    void updateCamera();
     void updateRect(const Rect& rect);
     void updateViewport(const Otc::Direction dir = Otc::InvalidDirection) { m_viewport = m_viewPortDirection[dir]; }
     void requestUpdateVisibleTiles() { m_updateVisibleTiles = true; }
@@ -72,10 +72,15 @@ void MinimapBlock::update()
 
 void MinimapBlock::updateTile(const int x, const int y, const MinimapTile& tile)
 {
-    if (m_tiles[getTileIndex(x, y)].color != tile.color)
+    auto& current = m_tiles[getTileIndex(x, y)];
+    if (current == tile)
+        return;
+
+    if (current.color != tile.color)
         m_mustUpdate = true;
 
-    m_tiles[getTileIndex(x, y)] = tile;
+    current = tile;
+    m_revision = ++s_lastRevision;
 }
 
 void Minimap::init() {
@@ -195,12 +200,20 @@ void Minimap::updateTile(const Position& pos, const TilePtr& tile)
         minimapTile.flags |= MinimapTileNotWalkable | MinimapTileNotPathable;
     }
 
-    if (minimapTile != nulltile) {
-        MinimapBlock& block = getBlock(pos);
-        const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
-        block.updateTile(pos.x - offsetPos.x, pos.y - offsetPos.y, minimapTile);
-        block.justSaw();
-    }
+    updateTile(pos, minimapTile);
+}
+
+void Minimap::updateTile(const Position& pos, const MinimapTile& tile)
+{
+    if (tile == nulltile)
+        return;
+
+    MinimapBlock& block = getBlock(pos);
+    const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
+
+    SpinLock::Guard lock(m_lock);
+    block.updateTile(pos.x - offsetPos.x, pos.y - offsetPos.y, tile);
+    block.justSaw();
 }
 
 const MinimapTile& Minimap::getTile(const Position& pos)
@@ -227,6 +240,17 @@ std::pair<MinimapBlock_ptr, MinimapTile> Minimap::threadGetTile(const Position&
     return std::make_pair(nullptr, nulltile);
 }
 
+MinimapBlock_ptr Minimap::findBlock(const Position& pos)
+{
+    SpinLock::Guard lock(m_lock);
+
+    if (pos.z >= m_tileBlocks.size())
+        return nullptr;
+
+    const auto it = m_tileBlocks[pos.z].find(getBlockIndex(pos));
+    return it != m_tileBlocks[pos.z].end() ? it->second : nullptr;
+}
+
 bool Minimap::loadImage(const std::string& fileName, const Position& topLeft, float colorFactor)
 {
     // non pathable colors
@@ -288,6 +312,8 @@ bool Minimap::loadImage(const std::string& fileName, const Position& topLeft, fl
                 Position pos(topLeft.x + x, topLeft.y + y, topLeft.z);
                 MinimapBlock& block = getBlock(pos);
                 const auto& offsetPos = getBlockOffset(Point(pos.x, pos.y));
+
+                SpinLock::Guard lock(m_lock);
                 MinimapTile& tile = block.getTile(pos.x - offsetPos.x, pos.y - offsetPos.y);
                 if (!(tile.flags & MinimapTileWasSeen)) {
                     tile.color = c;
@@ -361,6 +387,7 @@ bool Minimap::loadOtmm(const std::string& fileName)
             if (ret != Z_OK || destLen != blockSize)
                 break;
 
+            SpinLock::Guard lock(m_lock);
             memcpy(&block.getTiles(), decompressBuffer.data(), blockSize);
             block.mustUpdate();
             block.justSaw();
@@ -50,6 +50,9 @@ struct MinimapTile
     bool operator!=(const MinimapTile& other) const { return !(*this == other); }
 };
 
+#pragma pack(pop)
+
+// tiles are only written on the main thread, holding the lock of the minimap, see Minimap::threadReadBlock
 class MinimapBlock
 {
 public:
@@ -61,10 +64,14 @@ public:
     uint32_t getTileIndex(const int x, const int y) { return ((y % MMBLOCK_SIZE) * MMBLOCK_SIZE) + (x % MMBLOCK_SIZE); }
     const TexturePtr& getTexture() { return m_texture; }
     std::array<MinimapTile, MMBLOCK_SIZE* MMBLOCK_SIZE>& getTiles() { return m_tiles; }
-    void mustUpdate() { m_mustUpdate = true; }
+    void mustUpdate() { m_mustUpdate = true; m_revision = ++s_lastRevision; }
     void justSaw() { m_wasSeen = true; }
     bool wasSeen() const { return m_wasSeen; }
+    // changes whenever a tile of the block changes, unique across blocks
+    uint32_t getRevision() const { return m_revision; }
 private:
+    inline static std::atomic_uint32_t s_lastRevision{ 0 };
+
     TexturePtr m_texture;
     ImagePtr m_image;
 
@@ -74,10 +81,9 @@ private:
 
     bool m_mustUpdate{ true };
     bool m_wasSeen{ false };
+    std::atomic_uint32_t m_revision{ ++s_lastRevision };
 };
 
-#pragma pack(pop)
-
 using MinimapBlock_ptr = std::shared_ptr<MinimapBlock>;
 
 class Minimap
@@ -94,8 +100,17 @@ public:
     Rect getTileRect(const Position& pos, const Rect& screenRect, const Position& mapCenter, float scale);
 
     void updateTile(const Position& pos, const TilePtr& tile);
+    void updateTile(const Position& pos, const MinimapTile& tile);
     const MinimapTile& getTile(const Position& pos);
     std::pair<MinimapBlock_ptr, MinimapTile> threadGetTile(const Position& pos);
+    MinimapBlock_ptr findBlock(const Position& pos);
+    // calls fn with the tiles of the block kept from changing, for reading them off the main thread
+    template<typename Fn>
+    auto threadReadBlock(MinimapBlock& block, Fn&& fn)
+    {
+        SpinLock::Guard lock(m_lock);
+        return fn(block);
+    }
 
     bool loadImage(const std::string& fileName, const Position& topLeft, float colorFactor);
     void saveImage(const std::string& fileName, const Rect& mapRect);
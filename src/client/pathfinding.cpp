@@ -0,0 +1,836 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "pathfinding.h"
+
+#include "gameconfig.h"
+#include "map.h"
+#include "tile.h"
+
+#include <framework/util/stats.h>
+
+namespace
+{
+    // cost of a cell never seen, on the minimap or on screen
+    constexpr float UNSEEN_SPEED = 2000.f;
+    constexpr int MAX_UNSEEN_STEPS = 50;
+    constexpr int CANCEL_CHECK_INTERVAL = 256;
+
+    struct PathNode
+    {
+        float cost;
+        float totalCost;
+        Position pos;
+        int32_t prev;
+        int distance;
+        int unseen;
+    };
+
+    struct OpenEntry
+    {
+        float totalCost;
+        int32_t node;
+
+        bool operator<(const OpenEntry& other) const { return totalCost > other.totalCost; }
+    };
+
+    // reused by every search of the thread, nodes live in one vector instead of one allocation each
+    struct SearchArena
+    {
+        // snapshot areas larger than this look their cells up in a hash map instead of a dense array
+        static constexpr size_t MAX_DENSE_CELLS = 512 * 512;
+        // nodes kept allocated between searches, a larger search gives its memory back when done
+        static constexpr size_t MAX_KEPT_NODES = 64 * 1024;
+
+        std::vector<PathNode> nodes;
+        std::vector<OpenEntry> open;
+
+        // node index of every cell of the snapshot area, -1 for cells that cannot be walked; only the
+        // cells stamped by the current search are valid, so nothing is cleared between searches
+        std::vector<int32_t> slots;
+        std::vector<uint32_t> stamps;
+        uint32_t stamp{ 0 };
+
+        // the same for areas too large for the dense arrays, only holds the cells the search reached
+        stdext::map<size_t, int32_t> sparseSlots;
+        bool sparse{ false };
+
+        void reset(const size_t cells)
+        {
+            nodes.clear();
+            open.clear();
+
+            sparse = cells > MAX_DENSE_CELLS;
+            if (sparse) {
+                sparseSlots.clear();
+                return;
+            }
+
+            if (stamps.size() < cells) {
+                stamps.resize(cells);
+                slots.resize(cells);
+            }
+
+            if (++stamp == 0) {
+                std::ranges::fill(stamps, 0);
+                stamp = 1;
+            }
+        }
+
+        // node index of a cell and whether the current search reaches it for the first time
+        std::pair<int32_t&, bool> getSlot(const size_t cell)
+        {
+            if (sparse) {
+                const auto [it, inserted] = sparseSlots.try_emplace(cell, -1);
+                return { it->second, inserted };
+            }
+
+            if (stamps[cell] == stamp)
+                return { slots[cell], false };
+
+            stamps[cell] = stamp;
+            slots[cell] = -1;
+            return { slots[cell], true };
+        }
+
+        void trim()
+        {
+            if (nodes.capacity() > MAX_KEPT_NODES) {
+                nodes = {};
+                open = {};
+            }
+
+            if (sparseSlots.size() > MAX_KEPT_NODES)
+                sparseSlots = {};
+        }
+    };
+
+    uint32_t getPositionKey(const Position& pos) { return static_cast<uint32_t>(pos.y) << 16 | pos.x; }
+
+    constexpr int CLUSTER_CELLS = MMBLOCK_SIZE * MMBLOCK_SIZE;
+    constexpr float UNREACHABLE = std::numeric_limits<float>::max();
+
+    using ClusterCells = std::bitset<CLUSTER_CELLS>;
+
+    // distances of the last exploration of a block, only used from the main thread
+    struct ClusterSearch
+    {
+        using Entry = std::pair<float, uint16_t>;
+
+        std::array<float, CLUSTER_CELLS> distance;
+        std::array<int16_t, CLUSTER_CELLS> prev;
+        // cells reached by a straight and by a diagonal step, each one is pushed in increasing distance
+        // so both work as plain queues and the closest cell is at the front of one of them
+        std::vector<Entry> straight;
+        std::vector<Entry> diagonal;
+    };
+
+    // Dijkstra over the walkable cells of one minimap block, until every target cell is settled
+    const ClusterSearch& exploreCluster(const ClusterCells& walkable, const uint16_t from, const float diagonalCost, ClusterCells targets)
+    {
+        static ClusterSearch search;
+        search.distance.fill(UNREACHABLE);
+        search.prev.fill(-1);
+        search.straight.clear();
+        search.diagonal.clear();
+
+        size_t remaining = targets.count();
+        search.distance[from] = 0;
+        search.straight.emplace_back(0.f, from);
+
+        size_t nextStraight = 0, nextDiagonal = 0;
+        while (remaining > 0) {
+            const bool hasStraight = nextStraight < search.straight.size();
+            const bool hasDiagonal = nextDiagonal < search.diagonal.size();
+            if (!hasStraight && !hasDiagonal)
+                break;
+
+            const bool takeStraight = hasStraight && (!hasDiagonal || search.straight[nextStraight].first <= search.diagonal[nextDiagonal].first);
+            const auto [distance, cell] = takeStraight ? search.straight[nextStraight++] : search.diagonal[nextDiagonal++];
+            if (distance > search.distance[cell])
+                continue;
+
+            if (targets[cell]) {
+                targets[cell] = false;
+                --remaining;
+            }
+
+            const int x = cell % MMBLOCK_SIZE;
+            const int y = cell / MMBLOCK_SIZE;
+            for (int dy = -1; dy <= 1; ++dy) {
+                const int ny = y + dy;
+                if (ny < 0 || ny >= MMBLOCK_SIZE)
+                    continue;
+
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const int nx = x + dx;
+                    if ((dx == 0 && dy == 0) || nx < 0 || nx >= MMBLOCK_SIZE)
+                        continue;
+
+                    const auto next = static_cast<uint16_t>(ny * MMBLOCK_SIZE + nx);
+                    if (!walkable[next])
+                        continue;
+
+                    const bool isStraight = dx == 0 || dy == 0;
+                    const float cost = distance + (isStraight ? 1.f : diagonalCost);
+                    if (cost < search.distance[next]) {
+                        search.distance[next] = cost;
+                        search.prev[next] = static_cast<int16_t>(cell);
+                        (isStraight ? search.straight : search.diagonal).emplace_back(cost, next);
+                    }
+                }
+            }
+        }
+
+        return search;
+    }
+
+    const ClusterCells& getBorderCells()
+    {
+        static const ClusterCells cells = [] {
+            ClusterCells border;
+            for (int i = 0; i < MMBLOCK_SIZE; ++i) {
+                border.set(i);
+                border.set((MMBLOCK_SIZE - 1) * MMBLOCK_SIZE + i);
+                border.set(i * MMBLOCK_SIZE);
+                border.set(i * MMBLOCK_SIZE + MMBLOCK_SIZE - 1);
+            }
+            return border;
+        }();
+        return cells;
+    }
+
+    // lower bound of the walk between two cells, a diagonal step never costs more than two straight ones
+    float getWalkEstimate(const Position& from, const Position& to, const float diagonalCost)
+    {
+        const int dx = std::abs(from.x - to.x);
+        const int dy = std::abs(from.y - to.y);
+        return std::max(dx, dy) - std::min(dx, dy) + std::min(dx, dy) * std::min(diagonalCost, 2.f);
+    }
+
+    Point getBlockPoint(const Position& pos) { return { pos.x / MMBLOCK_SIZE, pos.y / MMBLOCK_SIZE }; }
+    uint16_t getClusterCell(const Position& pos) { return static_cast<uint16_t>(pos.y % MMBLOCK_SIZE * MMBLOCK_SIZE + pos.x % MMBLOCK_SIZE); }
+    Position getCellPosition(const Point& block, const uint16_t cell, const uint8_t z)
+    {
+        return { block.x * MMBLOCK_SIZE + cell % MMBLOCK_SIZE, block.y * MMBLOCK_SIZE + cell / MMBLOCK_SIZE, z };
+    }
+}
+
+PathSnapshot::Cell PathSnapshot::getCell(const int x, const int y) const
+{
+    if (!m_area.contains(Point(x, y)))
+        return { .blocked = true, .seen = false, .speed = 0 };
+
+    if (m_liveArea.contains(Point(x, y))) {
+        const size_t index = static_cast<size_t>(y - m_liveArea.top()) * m_liveArea.width() + (x - m_liveArea.left());
+        if (m_liveKnown[index])
+            return { .blocked = m_liveBlocked[index], .seen = true, .speed = static_cast<float>(m_liveSpeed[index]) };
+    }
+
+    const auto& block = m_blocks[static_cast<size_t>(y / MMBLOCK_SIZE - m_firstBlock.y) * m_blocksPerRow + (x / MMBLOCK_SIZE - m_firstBlock.x)];
+    if (!block)
+        return { .blocked = false, .seen = false, .speed = UNSEEN_SPEED };
+
+    const size_t index = (y % MMBLOCK_SIZE) * MMBLOCK_SIZE + (x % MMBLOCK_SIZE);
+    return { .blocked = block->blocked[index], .seen = block->seen[index], .speed = block->speed[index] * 10.f };
+}
+
+void PathFinder::clear()
+{
+    m_blockCache.clear();
+
+    std::scoped_lock lock(m_longPathMutex);
+    m_clusters.clear();
+}
+
+PathSnapshot::BlockPtr PathFinder::getPackedBlock(const uint8_t z, const Position& blockPos)
+{
+    if (m_blockCache.size() <= z)
+        m_blockCache.resize(z + 1);
+
+    auto& cache = m_blockCache[z];
+    const uint32_t key = getPositionKey(blockPos);
+
+    const auto source = g_minimap.findBlock(blockPos);
+    if (!source) {
+        cache.erase(key);
+        return nullptr;
+    }
+
+    // at most half of the limit was used recently, the rest goes
+    if (cache.size() >= MAX_CACHED_BLOCKS) {
+        const uint32_t oldest = m_blockUse - MAX_CACHED_BLOCKS / 2;
+        for (auto it = cache.begin(); it != cache.end();) {
+            if (static_cast<int32_t>(it->second.lastUse - oldest) < 0)
+                cache.erase(it++);
+            else
+                ++it;
+        }
+    }
+
+    auto& [packed, lastUse] = cache[key];
+    lastUse = ++m_blockUse;
+    if (!packed || packed->revision != source->getRevision())
+        packed = packBlock(*source);
+
+    return packed;
+}
+
+PathSnapshot::BlockPtr PathFinder::packBlock(MinimapBlock& source)
+{
+    const auto block = std::make_shared<PathSnapshot::Block>();
+    block->revision = source.getRevision();
+
+    const auto& tiles = source.getTiles();
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        const auto& tile = tiles[i];
+        block->speed[i] = tile.speed;
+        block->blocked[i] = tile.hasFlag(MinimapTileNotWalkable) || tile.hasFlag(MinimapTileNotPathable) || tile.hasFlag(MinimapTileEmpty);
+        block->seen[i] = tile.hasFlag(MinimapTileWasSeen);
+    }
+
+    return block;
+}
+
+bool PathFinder::isInSnapshotRange(const Position& start, const Position& goal)
+{
+    return std::abs(start.x / MMBLOCK_SIZE - goal.x / MMBLOCK_SIZE) <= MAX_SNAPSHOT_SPAN
+        && std::abs(start.y / MMBLOCK_SIZE - goal.y / MMBLOCK_SIZE) <= MAX_SNAPSHOT_SPAN;
+}
+
+PathSnapshotPtr PathFinder::createSnapshot(const Position& start, const Position& goal)
+{
+    if (!isInSnapshotRange(start, goal))
+        return nullptr;
+
+    // check the goal pos is walkable
+    if (g_map.isAwareOfPosition(goal)) {
+        const auto& goalTile = g_map.getTile(goal);
+        if (!goalTile || !goalTile->isWalkable())
+            return nullptr;
+    } else if (g_minimap.getTile(goal).hasFlag(MinimapTileNotWalkable))
+        return nullptr;
+
+    const auto snapshot = std::make_shared<PathSnapshot>();
+    snapshot->m_z = start.z;
+    snapshot->m_diagonalCost = g_gameConfig.getPlayerDiagonalWalkSpeed();
+
+    constexpr int lastBlock = UINT16_MAX / MMBLOCK_SIZE;
+    const int firstX = std::max<int>(0, std::min(start.x, goal.x) / MMBLOCK_SIZE - SNAPSHOT_MARGIN);
+    const int firstY = std::max<int>(0, std::min(start.y, goal.y) / MMBLOCK_SIZE - SNAPSHOT_MARGIN);
+    const int lastX = std::min<int>(lastBlock, std::max(start.x, goal.x) / MMBLOCK_SIZE + SNAPSHOT_MARGIN);
+    const int lastY = std::min<int>(lastBlock, std::max(start.y, goal.y) / MMBLOCK_SIZE + SNAPSHOT_MARGIN);
+
+    snapshot->m_area = Rect(Point(firstX * MMBLOCK_SIZE, firstY * MMBLOCK_SIZE), Point((lastX + 1) * MMBLOCK_SIZE - 1, (lastY + 1) * MMBLOCK_SIZE - 1));
+    snapshot->m_firstBlock = Point(firstX, firstY);
+    snapshot->m_blocksPerRow = lastX - firstX + 1;
+    snapshot->m_blocks.reserve(static_cast<size_t>(snapshot->m_blocksPerRow) * (lastY - firstY + 1));
+    for (int y = firstY; y <= lastY; ++y) {
+        for (int x = firstX; x <= lastX; ++x)
+            snapshot->m_blocks.emplace_back(getPackedBlock(start.z, Position(x * MMBLOCK_SIZE, y * MMBLOCK_SIZE, start.z)));
+    }
+
+    // the tiles on screen know better than the minimap, except the one the player stands on
+    const auto& tiles = g_map.getTiles(start.z);
+    if (tiles.empty())
+        return snapshot;
+
+    int left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+    for (const auto& tile : tiles) {
+        const auto& pos = tile->getPosition();
+        left = std::min<int>(left, pos.x);
+        top = std::min<int>(top, pos.y);
+        right = std::max<int>(right, pos.x);
+        bottom = std::max<int>(bottom, pos.y);
+    }
+
+    auto& liveArea = snapshot->m_liveArea;
+    liveArea = Rect(Point(left, top), Point(right, bottom));
+    const size_t liveSize = static_cast<size_t>(liveArea.width()) * liveArea.height();
+    snapshot->m_liveSpeed.resize(liveSize);
+    snapshot->m_liveKnown.resize(liveSize);
+    snapshot->m_liveBlocked.resize(liveSize);
+
+    for (const auto& tile : tiles) {
+        const auto& pos = tile->getPosition();
+        if (pos == start)
+            continue;
+
+        const size_t index = static_cast<size_t>(pos.y - top) * liveArea.width() + (pos.x - left);
+        snapshot->m_liveKnown[index] = true;
+        snapshot->m_liveBlocked[index] = !tile->isWalkable(false) || !tile->isPathable();
+        snapshot->m_liveSpeed[index] = tile->getGroundSpeed();
+    }
+
+    return snapshot;
+}
+
+PathFindResult_ptr PathFinder::findPath(const PathSnapshot& snapshot, const Position& start, const Position& goal, const std::atomic_bool* cancelled)
+{
+    auto ret = std::make_shared<PathFindResult>();
+    ret->start = start;
+    ret->destination = goal;
+
+    if (start == goal) {
+        ret->status = Otc::PathFindResultSamePosition;
+        return ret;
+    }
+
+    if (goal.z != start.z || start.z != snapshot.getZ())
+        return ret;
+
+    const auto& area = snapshot.getArea();
+    if (!area.contains(Point(start.x, start.y)) || !area.contains(Point(goal.x, goal.y)))
+        return ret;
+
+    thread_local SearchArena arena;
+    arena.reset(static_cast<size_t>(area.width()) * area.height());
+
+    auto& nodes = arena.nodes;
+    auto& open = arena.open;
+
+    const auto getSlot = [&](const Position& pos) { return static_cast<size_t>(pos.y - area.top()) * area.width() + (pos.x - area.left()); };
+
+    nodes.push_back({ .cost = 1, .totalCost = 0, .pos = start, .prev = -1, .distance = 0, .unseen = 0 });
+    arena.getSlot(getSlot(start)).first = 0;
+    open.push_back({ 0, 0 });
+
+    int limit = MAX_COMPLEXITY;
+    const float distance = start.distance(goal);
+
+    int32_t dstNode = -1;
+    while (!open.empty() && --limit) {
+        if (cancelled && limit % CANCEL_CHECK_INTERVAL == 0 && cancelled->load(std::memory_order_relaxed)) {
+            arena.trim();
+            return nullptr;
+        }
+
+        std::pop_heap(open.begin(), open.end());
+        const auto [entryCost, current] = open.back();
+        open.pop_back();
+
+        // already expanded through a cheaper way
+        if (entryCost > nodes[current].totalCost)
+            continue;
+
+        const Position pos = nodes[current].pos;
+        if (pos == goal) {
+            dstNode = current;
+            break;
+        }
+
+        if (pos.distance(goal) > distance + 10000)
+            continue;
+
+        for (int i = -1; i <= 1; ++i) {
+            for (int j = -1; j <= 1; ++j) {
+                if (i == 0 && j == 0)
+                    continue;
+
+                const Position neighbor = pos.translated(i, j);
+                if (!area.contains(Point(neighbor.x, neighbor.y)))
+                    continue;
+
+                auto [slot, reached] = arena.getSlot(getSlot(neighbor));
+                if (reached) {
+                    const auto cell = snapshot.getCell(neighbor.x, neighbor.y);
+                    if (!cell.blocked || neighbor == goal) {
+                        slot = static_cast<int32_t>(nodes.size());
+                        nodes.push_back({ .cost = cell.seen ? cell.speed : UNSEEN_SPEED, .totalCost = 10000000.0f, .pos = neighbor, .prev = current,
+                                          .distance = nodes[current].distance + 1, .unseen = cell.seen ? 0 : 1 });
+                    }
+                }
+
+                const int32_t next = slot;
+                if (next < 0) // no way
+                    continue;
+
+                auto& node = nodes[next];
+                if (node.unseen > MAX_UNSEEN_STEPS)
+                    continue;
+
+                const float diagonal = (i == 0 || j == 0) ? 1.0f : snapshot.getDiagonalCost();
+                float cost = node.cost * diagonal;
+                cost += diagonal * (50.0f * std::max<float>(5.0f, node.pos.distance(goal))); // heuristic
+
+                const auto& from = nodes[current];
+                if (from.totalCost + cost + 50 < node.totalCost) {
+                    node.totalCost = from.totalCost + cost;
+                    node.prev = current;
+                    if (node.unseen)
+                        node.unseen = from.unseen + 1;
+                    node.distance = from.distance + 1;
+                    open.push_back({ node.totalCost, next });
+                    std::push_heap(open.begin(), open.end());
+                }
+            }
+        }
+    }
+
+    if (dstNode >= 0) {
+        for (int32_t node = dstNode; node >= 0 && nodes[node].prev >= 0; node = nodes[node].prev) {
+            const auto& step = nodes[node];
+            if (step.unseen)
+                ret->path.clear();
+            else
+                ret->path.push_back(nodes[step.prev].pos.getDirectionFromPosition(step.pos));
+        }
+        std::ranges::reverse(ret->path);
+        ret->status = Otc::PathFindResultOk;
+    }
+    ret->complexity = MAX_COMPLEXITY - limit;
+
+    arena.trim();
+    return ret;
+}
+
+PathFinder::Cluster& PathFinder::getCluster(const uint8_t z, const int blockX, const int blockY)
+{
+    // nothing is walkable past the edges of the map
+    static Cluster outside;
+
+    constexpr int lastBlock = UINT16_MAX / MMBLOCK_SIZE;
+    if (blockX < 0 || blockY < 0 || blockX > lastBlock || blockY > lastBlock)
+        return outside;
+
+    if (m_clusters.size() <= z)
+        m_clusters.resize(z + 1);
+
+    auto& cluster = m_clusters[z][getPositionKey(Position(blockX, blockY, z))];
+    if (!cluster)
+        cluster = std::make_unique<Cluster>();
+
+    // the snapshot block cache belongs to the main thread, clusters pack their own blocks
+    const auto source = g_minimap.findBlock(Position(blockX * MMBLOCK_SIZE, blockY * MMBLOCK_SIZE, z));
+    if (source ? cluster->block && cluster->block->revision == source->getRevision() : !cluster->block)
+        return *cluster;
+
+    // the main thread keeps writing the minimap while this runs on the pool
+    const auto block = source ? g_minimap.threadReadBlock(*source, packBlock) : nullptr;
+    cluster->block = block;
+
+    ClusterCells walkable;
+    if (block)
+        walkable = block->seen & ~block->blocked;
+
+    if (walkable != cluster->walkable) {
+        if (((walkable ^ cluster->walkable) & getBorderCells()).any())
+            cluster->borderRevision = ++m_lastWalkRevision;
+
+        cluster->walkable = walkable;
+        cluster->walkRevision = ++m_lastWalkRevision;
+    }
+
+    return *cluster;
+}
+
+PathFinder::Cluster& PathFinder::getClusterGraph(const uint8_t z, const int blockX, const int blockY)
+{
+    auto& cluster = getCluster(z, blockX, blockY);
+
+    // the entrances depend on the borders of the blocks around as well
+    const std::array revisions{
+        cluster.walkRevision,
+        getCluster(z, blockX - 1, blockY).borderRevision,
+        getCluster(z, blockX + 1, blockY).borderRevision,
+        getCluster(z, blockX, blockY - 1).borderRevision,
+        getCluster(z, blockX, blockY + 1).borderRevision,
+    };
+
+    if (!cluster.built || revisions != cluster.builtFrom) {
+        buildCluster(cluster, z, blockX, blockY);
+        cluster.builtFrom = revisions;
+        cluster.built = true;
+    }
+
+    return cluster;
+}
+
+void PathFinder::buildCluster(Cluster& cluster, const uint8_t z, const int blockX, const int blockY)
+{
+    constexpr int lastCell = MMBLOCK_SIZE - 1;
+    const Point block(blockX, blockY);
+
+    cluster.entrances.clear();
+
+    for (const auto& side : { Point(-1, 0), Point(1, 0), Point(0, -1), Point(0, 1) }) {
+        const Point other = block + side;
+        const auto& otherWalkable = getCluster(z, other.x, other.y).walkable;
+
+        // i-th cell along the border, on this side of it and on the other
+        const auto getCell = [&](const int i) {
+            const int x = side.x < 0 ? 0 : side.x > 0 ? lastCell : i;
+            const int y = side.y < 0 ? 0 : side.y > 0 ? lastCell : i;
+            return static_cast<uint16_t>(y * MMBLOCK_SIZE + x);
+        };
+        const auto getOtherCell = [&](const int i) {
+            const int x = side.x < 0 ? lastCell : side.x > 0 ? 0 : i;
+            const int y = side.y < 0 ? lastCell : side.y > 0 ? 0 : i;
+            return static_cast<uint16_t>(y * MMBLOCK_SIZE + x);
+        };
+        const auto addEntrance = [&](const int i) {
+            cluster.entrances.push_back({ .cell = getCell(i), .exit = getCellPosition(other, getOtherCell(i), z) });
+        };
+
+        // both blocks find the same entrances on their shared border
+        int runStart = -1;
+        for (int i = 0; i <= MMBLOCK_SIZE; ++i) {
+            if (i < MMBLOCK_SIZE && cluster.walkable.test(getCell(i)) && otherWalkable.test(getOtherCell(i))) {
+                if (runStart < 0)
+                    runStart = i;
+                continue;
+            }
+
+            if (runStart < 0)
+                continue;
+
+            const int runEnd = i - 1;
+            if (runEnd - runStart + 1 > MAX_ENTRANCE_WIDTH) {
+                for (int j = runStart; j < runEnd; j += ENTRANCE_SPACING)
+                    addEntrance(j);
+                addEntrance(runEnd);
+            } else
+                addEntrance((runStart + runEnd) / 2);
+
+            runStart = -1;
+        }
+    }
+
+    const size_t count = cluster.entrances.size();
+    cluster.costs.assign(count * count, UNREACHABLE);
+    cluster.explored.assign(count, false);
+}
+
+const float* PathFinder::getEntranceCosts(Cluster& cluster, const size_t entrance) const
+{
+    const size_t count = cluster.entrances.size();
+    float* costs = cluster.costs.data() + entrance * count;
+    if (cluster.explored[entrance])
+        return costs;
+
+    // walks are symmetric, the rows searched before already hold their cost to this entrance
+    ClusterCells targets;
+    for (size_t j = 0; j < count; ++j) {
+        if (j != entrance && !cluster.explored[j])
+            targets.set(cluster.entrances[j].cell);
+    }
+
+    costs[entrance] = 0;
+    if (targets.any()) {
+        const auto& search = exploreCluster(cluster.walkable, cluster.entrances[entrance].cell, m_clusterDiagonalCost, targets);
+        for (size_t j = 0; j < count; ++j) {
+            if (j != entrance && !cluster.explored[j])
+                costs[j] = cluster.costs[j * count + entrance] = search.distance[cluster.entrances[j].cell];
+        }
+    }
+
+    cluster.explored[entrance] = true;
+    return costs;
+}
+
+std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> PathFinder::findLongPath(const Position& start, const Position& goal, const int maxComplexity)
+{
+    std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> ret;
+    auto& [dirs, result] = ret;
+
+    result = Otc::PathFindResultNoWay;
+
+    if (start == goal) {
+        result = Otc::PathFindResultSamePosition;
+        return ret;
+    }
+
+    if (start.z != goal.z) {
+        result = Otc::PathFindResultImpossible;
+        return ret;
+    }
+
+    std::scoped_lock lock(m_longPathMutex);
+
+    const auto diagonalCost = static_cast<float>(g_gameConfig.getPlayerDiagonalWalkSpeed());
+    if (diagonalCost != m_clusterDiagonalCost) {
+        m_clusters.clear();
+        m_clusterDiagonalCost = diagonalCost;
+    }
+
+    AutoStat s(TRACE_ZONE(STATS_MAIN, "PathFinder::findLongPath"));
+
+    const uint8_t z = start.z;
+    const Point startBlock = getBlockPoint(start);
+    const Point goalBlock = getBlockPoint(goal);
+
+    const auto& startCluster = getClusterGraph(z, startBlock.x, startBlock.y);
+    const auto& goalCluster = getClusterGraph(z, goalBlock.x, goalBlock.y);
+    if (!goalCluster.walkable.test(getClusterCell(goal)))
+        return ret;
+
+    // the start and the goal join the graph through the entrances of their own blocks
+    ClusterCells targets;
+    for (const auto& entrance : startCluster.entrances)
+        targets.set(entrance.cell);
+    if (startBlock == goalBlock)
+        targets.set(getClusterCell(goal));
+
+    const auto& fromStart = exploreCluster(startCluster.walkable, getClusterCell(start), diagonalCost, targets);
+    const float directCost = startBlock == goalBlock ? fromStart.distance[getClusterCell(goal)] : UNREACHABLE;
+    std::vector<float> startCosts;
+    startCosts.reserve(startCluster.entrances.size());
+    for (const auto& entrance : startCluster.entrances)
+        startCosts.emplace_back(fromStart.distance[entrance.cell]);
+
+    targets.reset();
+    for (const auto& entrance : goalCluster.entrances)
+        targets.set(entrance.cell);
+
+    const auto& fromGoal = exploreCluster(goalCluster.walkable, getClusterCell(goal), diagonalCost, targets);
+    std::vector<float> goalCosts;
+    goalCosts.reserve(goalCluster.entrances.size());
+    for (const auto& entrance : goalCluster.entrances)
+        goalCosts.emplace_back(fromGoal.distance[entrance.cell]);
+
+    struct GraphNode
+    {
+        float cost;
+        uint32_t prev;
+    };
+
+    struct GraphEntry
+    {
+        float estimate;
+        uint32_t key;
+
+        bool operator<(const GraphEntry& other) const { return estimate > other.estimate; }
+    };
+
+    stdext::map<uint32_t, GraphNode> nodes;
+    std::vector<GraphEntry> open;
+
+    const uint32_t startKey = getPositionKey(start);
+    const uint32_t goalKey = getPositionKey(goal);
+
+    const auto relax = [&](const uint32_t from, const float cost, const float edge, const Position& to) {
+        if (edge >= UNREACHABLE)
+            return;
+
+        const uint32_t key = getPositionKey(to);
+        const auto [it, inserted] = nodes.try_emplace(key, GraphNode{ cost + edge, from });
+        if (!inserted) {
+            if (cost + edge >= it->second.cost)
+                return;
+            it->second = { cost + edge, from };
+        }
+
+        open.push_back({ cost + edge + getWalkEstimate(to, goal, diagonalCost), key });
+        std::push_heap(open.begin(), open.end());
+    };
+
+    nodes.emplace(startKey, GraphNode{ 0, startKey });
+    open.push_back({ getWalkEstimate(start, goal, diagonalCost), startKey });
+
+    int expanded = 0;
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end());
+        const auto [estimate, key] = open.back();
+        open.pop_back();
+
+        const Position pos(key & 0xFFFF, key >> 16, z);
+        const float cost = nodes[key].cost;
+        if (estimate > cost + getWalkEstimate(pos, goal, diagonalCost))
+            continue; // reached through a cheaper way since
+
+        if (key == goalKey) {
+            found = true;
+            break;
+        }
+
+        if (++expanded > maxComplexity) {
+            result = Otc::PathFindResultTooFar;
+            break;
+        }
+
+        const Point block = getBlockPoint(pos);
+        auto& cluster = getClusterGraph(z, block.x, block.y);
+
+        if (key == startKey) {
+            for (size_t i = 0; i < startCosts.size(); ++i)
+                relax(key, cost, startCosts[i], getCellPosition(block, cluster.entrances[i].cell, z));
+            relax(key, cost, directCost, goal);
+        }
+
+        const uint16_t cell = getClusterCell(pos);
+        const size_t count = cluster.entrances.size();
+        for (size_t i = 0; i < count; ++i) {
+            if (cluster.entrances[i].cell != cell)
+                continue;
+
+            relax(key, cost, 1.f, cluster.entrances[i].exit);
+            if (key == startKey)
+                continue;
+
+            const float* costs = getEntranceCosts(cluster, i);
+            for (size_t j = 0; j < count; ++j) {
+                if (j != i)
+                    relax(key, cost, costs[j], getCellPosition(block, cluster.entrances[j].cell, z));
+            }
+
+            if (block == goalBlock)
+                relax(key, cost, goalCosts[i], goal);
+        }
+    }
+
+    if (!found)
+        return ret;
+
+    std::vector<Position> waypoints;
+    for (uint32_t key = goalKey; key != startKey; key = nodes[key].prev)
+        waypoints.emplace_back(key & 0xFFFF, key >> 16, z);
+    waypoints.emplace_back(start);
+    std::ranges::reverse(waypoints);
+
+    // every hop is a step across a border or a walk inside one block
+    for (size_t i = 1; i < waypoints.size(); ++i) {
+        const auto& from = waypoints[i - 1];
+        const auto& to = waypoints[i];
+
+        const Point block = getBlockPoint(from);
+        if (block != getBlockPoint(to)) {
+            dirs.push_back(from.getDirectionFromPosition(to));
+            continue;
+        }
+
+        ClusterCells target;
+        target.set(getClusterCell(to));
+
+        const auto& search = exploreCluster(getClusterGraph(z, block.x, block.y).walkable, getClusterCell(from), diagonalCost, target);
+
+        const size_t first = dirs.size();
+        for (int cell = getClusterCell(to); search.prev[cell] >= 0; cell = search.prev[cell]) {
+            const auto prev = static_cast<uint16_t>(search.prev[cell]);
+            dirs.push_back(getCellPosition(block, prev, z).getDirectionFromPosition(getCellPosition(block, cell, z)));
+        }
+        std::reverse(dirs.begin() + first, dirs.end());
+    }
+
+    result = Otc::PathFindResultOk;
+    return ret;
+}
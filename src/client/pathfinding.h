@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+#include "minimap.h"
+
+struct PathFindResult
+{
+    Otc::PathFindResult status = Otc::PathFindResultNoWay;
+    std::vector<Otc::Direction> path;
+    int complexity = 0;
+    Position start;
+    Position destination;
+};
+using PathFindResult_ptr = std::shared_ptr<PathFindResult>;
+
+// Walkability and cost of one floor around a search, copied from the map and the minimap on the main
+// thread so a pool thread can search it while both keep changing. Minimap blocks are packed once and
+// shared between snapshots until the minimap block changes, the tiles known to the map lay on top.
+class PathSnapshot
+{
+public:
+    // packed copy of a minimap block, speed in minimap units
+    struct Block
+    {
+        std::array<uint8_t, MMBLOCK_SIZE* MMBLOCK_SIZE> speed;
+        std::bitset<MMBLOCK_SIZE* MMBLOCK_SIZE> blocked;
+        std::bitset<MMBLOCK_SIZE* MMBLOCK_SIZE> seen;
+        uint32_t revision{ 0 };
+    };
+    using BlockPtr = std::shared_ptr<const Block>;
+
+    struct Cell
+    {
+        bool blocked;
+        bool seen;
+        float speed;
+    };
+
+    Cell getCell(int x, int y) const;
+
+    uint8_t getZ() const { return m_z; }
+    const Rect& getArea() const { return m_area; }
+    float getDiagonalCost() const { return m_diagonalCost; }
+
+private:
+    friend class PathFinder;
+
+    uint8_t m_z{ 0 };
+    // cells outside of it are not walkable, the search never leaves it
+    Rect m_area;
+    float m_diagonalCost{ 3.f };
+
+    Point m_firstBlock;
+    int m_blocksPerRow{ 0 };
+    // row major over the blocks of m_area, nullptr where the minimap has nothing
+    std::vector<BlockPtr> m_blocks;
+
+    // tiles the map knows about, they take precedence over the minimap
+    Rect m_liveArea;
+    std::vector<uint16_t> m_liveSpeed;
+    std::vector<bool> m_liveKnown;
+    std::vector<bool> m_liveBlocked;
+};
+using PathSnapshotPtr = std::shared_ptr<const PathSnapshot>;
+
+class PathFinder
+{
+public:
+    // blocks of minimap around the start and goal copied into a snapshot
+    static constexpr int SNAPSHOT_MARGIN = 4;
+    // blocks between the start and the goal a snapshot can span, farther goals are left to findLongPath
+    static constexpr int MAX_SNAPSHOT_SPAN = 32;
+    static constexpr int MAX_COMPLEXITY = 50000;
+    // packed minimap blocks kept per floor, the least recently used ones are dropped past it
+    static constexpr size_t MAX_CACHED_BLOCKS = 2048;
+    // walkable runs along a block border wider than this get an entrance at each end instead of one,
+    // and another one every ENTRANCE_SPACING cells so long paths do not detour through the corners
+    static constexpr int MAX_ENTRANCE_WIDTH = 6;
+    static constexpr int ENTRANCE_SPACING = 16;
+
+    void clear();
+
+    // false when the goal is too far from the start for a snapshot
+    static bool isInSnapshotRange(const Position& start, const Position& goal);
+    // must run on the main thread, returns nullptr when the goal is known not to be walkable or out of range
+    PathSnapshotPtr createSnapshot(const Position& start, const Position& goal);
+
+    // A* over the snapshot, safe to run on any thread; returns nullptr once cancelled is set
+    static PathFindResult_ptr findPath(const PathSnapshot& snapshot, const Position& start, const Position& goal,
+                                       const std::atomic_bool* cancelled = nullptr);
+
+    // routes across the explored minimap, too long for findPath; safe to run on any thread, one search
+    // at a time. Searches the graph of block entrances, maxComplexity bounds the entrances expanded, then walks
+    // every hop inside its block. Only seen cells are walked, creatures are not taken into account.
+    std::tuple<std::vector<Otc::Direction>, Otc::PathFindResult> findLongPath(const Position& start, const Position& goal, int maxComplexity);
+
+private:
+    // a minimap block as a node cluster of the long path graph
+    struct Cluster
+    {
+        // walkable cell on the border of the block and the one straight across it, in the next block
+        struct Entrance
+        {
+            uint16_t cell;
+            Position exit;
+        };
+
+        PathSnapshot::BlockPtr block;
+        std::bitset<MMBLOCK_SIZE* MMBLOCK_SIZE> walkable;
+        // changes only when walkable does, colours and speeds of the minimap do not matter here
+        uint32_t walkRevision{ 0 };
+        // changes only when the walkable cells along the borders do, the neighbours depend on those
+        uint32_t borderRevision{ 0 };
+
+        // walk revision of the block and border revisions of its four neighbours when it was built
+        std::array<uint32_t, 5> builtFrom{};
+        bool built{ false };
+        std::vector<Entrance> entrances;
+        // cheapest walk inside the block between every pair of entrances, row major; a row is only
+        // searched the first time the long path search leaves through its entrance
+        std::vector<float> costs;
+        std::vector<bool> explored;
+    };
+    using ClusterPtr = std::unique_ptr<Cluster>;
+
+    struct CachedBlock
+    {
+        PathSnapshot::BlockPtr block;
+        uint32_t lastUse{ 0 };
+    };
+
+    PathSnapshot::BlockPtr getPackedBlock(uint8_t z, const Position& blockPos);
+    static PathSnapshot::BlockPtr packBlock(MinimapBlock& source);
+
+    Cluster& getCluster(uint8_t z, int blockX, int blockY);
+    // the cluster with its entrances up to date with the minimap
+    Cluster& getClusterGraph(uint8_t z, int blockX, int blockY);
+    void buildCluster(Cluster& cluster, uint8_t z, int blockX, int blockY);
+    const float* getEntranceCosts(Cluster& cluster, size_t entrance) const;
+
+    // packed minimap blocks per floor, replaced when the minimap block revision moves on
+    std::vector<stdext::map<uint32_t, CachedBlock>> m_blockCache;
+    uint32_t m_blockUse{ 0 };
+
+    // guards the cluster graph below, the long path search runs on the thread pool
+    std::mutex m_longPathMutex;
+    std::vector<stdext::map<uint32_t, ClusterPtr>> m_clusters;
+    uint32_t m_lastWalkRevision{ 0 };
+    float m_clusterDiagonalCost{ 0 };
+};
@@ -26,6 +26,8 @@
 #include "framework/net/protocol.h"
 #include "staticdata.h"
 
+#include <bitset>
+
 class ProtocolGame final : public Protocol
 {
 public:
@@ -207,6 +209,16 @@ public:
     int getRecivedPacketsCount() { return m_recivedPackeds; }
     int getRecivedPacketsSize() { return m_recivedPackedsSize; }
 
+    // called before (finished = false) and after (finished = true) each parsed opcode
+    using OpcodeProfiler = std::function<void(uint8_t opcode, bool finished)>;
+    void setOpcodeProfiler(OpcodeProfiler profiler) { m_opcodeProfiler = std::move(profiler); }
+
+    // opcodes with a handler registered through ProtocolGame.registerOpcode, only those are offered to onOpcode
+    static void setLuaOpcodeHook(uint8_t opcode, bool enabled) { s_luaOpcodeHooks.set(opcode, enabled); }
+    static bool hasLuaOpcodeHook(const uint8_t opcode) { return s_luaOpcodeHooks.test(opcode); }
+    static std::map<int, std::map<std::string, uint64_t>> getLuaOpcodeHookStats();
+    static void resetLuaOpcodeHookStats() { s_luaOpcodeHookStats = {}; }
+
 private:
     void parseStoreButtonIndicators(const InputMessagePtr& msg);
     void parseSetStoreDeepLink(const InputMessagePtr& msg);
@@ -487,4 +499,15 @@ private:
     std::string m_sessionKey;
     std::string m_characterName;
     LocalPlayerPtr m_localPlayer;
+    OpcodeProfiler m_opcodeProfiler;
+
+    struct LuaOpcodeHookStats
+    {
+        uint64_t calls{ 0 };
+        uint64_t handled{ 0 };
+        uint64_t micros{ 0 };
+    };
+
+    static std::bitset<256> s_luaOpcodeHooks;
+    static std::array<LuaOpcodeHookStats, 256> s_luaOpcodeHookStats;
 };
@@ -44,6 +44,55 @@
 #include <fmt/format.h>
 #include <framework/util/stats.h>
 
+namespace {
+    class OpcodeProfilerScope
+    {
+    public:
+        OpcodeProfilerScope(const ProtocolGame::OpcodeProfiler& profiler, const uint8_t opcode) : m_profiler(profiler), m_opcode(opcode)
+        {
+            if (m_profiler)
+                m_profiler(m_opcode, false);
+        }
+
+        ~OpcodeProfilerScope()
+        {
+            if (m_profiler)
+                m_profiler(m_opcode, true);
+        }
+
+    private:
+        const ProtocolGame::OpcodeProfiler& m_profiler;
+        uint8_t m_opcode;
+    };
+
+    TraceZoneId opcodeZone(const uint8_t opcode)
+    {
+        static const auto zones = [] {
+            std::array<TraceZoneId, 256> zones{};
+            for (size_t i = 0; i < zones.size(); ++i)
+                zones[i] = g_tracer.intern(STATS_PACKETS, fmt::format("{} (0x{:02X})", i, i));
+            return zones;
+        }();
+        return zones[opcode];
+    }
+}
+
+std::bitset<256> ProtocolGame::s_luaOpcodeHooks;
+std::array<ProtocolGame::LuaOpcodeHookStats, 256> ProtocolGame::s_luaOpcodeHookStats{};
+
+std::map<int, std::map<std::string, uint64_t>> ProtocolGame::getLuaOpcodeHookStats()
+{
+    std::map<int, std::map<std::string, uint64_t>> stats;
+    for (size_t opcode = 0; opcode < s_luaOpcodeHookStats.size(); ++opcode) {
+        const auto& hook = s_luaOpcodeHookStats[opcode];
+        if (hook.calls == 0)
+            continue;
+
+        stats[static_cast<int>(opcode)] = { { "calls", hook.calls }, { "handled", hook.handled }, { "micros", hook.micros } };
+    }
+    return stats;
+}
+
 void ProtocolGame::parseMessage(const InputMessagePtr& msg)
 {
     int opcode = -1;
@@ -52,7 +101,8 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
     try {
         while (!msg->eof()) {
             opcode = msg->getU8();
-            AutoStat s(STATS_PACKETS, fmt::format("{} (0x{:02X})", opcode, opcode));
+            AutoStat s(opcodeZone(opcode));
+            const OpcodeProfilerScope profilerScope(m_opcodeProfiler, static_cast<uint8_t>(opcode));
 
             // must be > so extended will be enabled before GameStart.
             if (!g_game.getFeature(Otc::GameLoginPending)) {
@@ -62,13 +112,21 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
                 }
             }
 
-            // try to parse in lua first
-            const int readPos = msg->getReadPos();
-            if (callLuaField<bool>("onOpcode", opcode, msg)) {
-                continue;
+            // try to parse in lua first, only for the opcodes lua registered a handler for
+            if (hasLuaOpcodeHook(static_cast<uint8_t>(opcode))) {
+                auto& stats = s_luaOpcodeHookStats[opcode];
+                const stdext::timer timer;
+                const int readPos = msg->getReadPos();
+                const bool handled = callLuaField<bool>("onOpcode", opcode, msg);
+                ++stats.calls;
+                stats.micros += timer.elapsed_micros();
+                if (handled) {
+                    ++stats.handled;
+                    continue;
+                }
+                // restore read pos
+                msg->setReadPos(readPos);
             }
-            msg->setReadPos(readPos);
-            // restore read pos
 
             switch (opcode) {
                 case Proto::GameServerLoginOrPendingState:
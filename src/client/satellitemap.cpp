@@ -23,6 +23,7 @@
 #include "satellitemap.h"
 
 #include "gameconfig.h"
+#include <framework/core/asyncdispatcher.h>
 #include <framework/core/logger.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/graphics/drawpoolmanager.h>
@@ -50,12 +51,8 @@ int SatelliteMap::loadDirectory(const std::string& dir)
 int SatelliteMap::loadFloors(const std::string& dir, const int floorMin, const int floorMax)
 {
     // Clear stale chunk data whenever the source directory changes.
-    if (dir != m_fileCacheDir) {
-        m_chunks.clear();
-        m_index.clear();
-        m_mmChunks.clear();
-        m_mmIndex.clear();
-    }
+    if (dir != m_fileCacheDir)
+        resetChunks();
 
     // Build the file list exactly once per directory — reused on every subsequent call.
     buildFileCache(dir);
@@ -123,13 +120,33 @@ void SatelliteMap::buildFileCache(const std::string& dir)
 }
 
 void SatelliteMap::clear()
+{
+    resetChunks();
+    m_fileCache.clear();
+    m_fileCacheDir.clear();
+}
+
+void SatelliteMap::resetChunks()
 {
     m_chunks.clear();
     m_index.clear();
     m_mmChunks.clear();
     m_mmIndex.clear();
-    m_fileCache.clear();
-    m_fileCacheDir.clear();
+    m_lru.clear();
+    m_residentBytes = 0;
+    m_drawStates = {};
+
+    // loads in flight belong to the old chunks
+    ++m_generation;
+    m_pendingLoads = 0;
+    std::scoped_lock lock(m_loadedMutex);
+    m_loadedChunks.clear();
+}
+
+void SatelliteMap::setMemoryBudget(const size_t bytes)
+{
+    m_memoryBudget = bytes;
+    evictChunks();
 }
 
 void SatelliteMap::draw(const Rect& screenRect, const Position& cameraPos, float scale, const Color& color, float floorSeparatorOpacity)
@@ -137,6 +154,9 @@ void SatelliteMap::draw(const Rect& screenRect, const Position& cameraPos, float
     if (screenRect.isEmpty() || m_chunks.empty())
         return;
 
+    ++drawState(true).frame;
+    processLoadedChunks();
+
     const auto oldClipRect = g_drawPool.getClipRect();
     g_drawPool.setClipRect(screenRect);
     
@@ -180,43 +200,15 @@ void SatelliteMap::draw(const Rect& screenRect, const Position& cameraPos, float
             if (it == m_index.end())
                 continue;
 
-            // Tiles covered per chunk: 512 px × (lod/32) tiles/px
-            const float chunkTiles = 512.f * (static_cast<float>(lod) / 32.f);
-
             for (const ChunkKey& key : it->second) {
-                // Compute screen rect first — skip off-screen chunks before loading texture.
-                const float tileOx = static_cast<float>(key.posX) * 32.f;
-                const float tileOy = static_cast<float>(key.posY) * 32.f;
-
-                const float screenLeft = screenCenter.x + (tileOx - cameraPos.x) * scale;
-                const float screenTop  = screenCenter.y + (tileOy - cameraPos.y) * scale;
-                const float screenW    = chunkTiles * scale;
-                const float screenH    = chunkTiles * scale;
-
-                const Rect dest(
-                    static_cast<int>(std::floor(screenLeft)),
-                    static_cast<int>(std::floor(screenTop)),
-                    static_cast<int>(std::ceil(screenW)),
-                    static_cast<int>(std::ceil(screenH))
-                );
-
+                // Compute screen rect first — skip off-screen chunks before requesting them.
+                const Rect dest = getChunkRect(key, screenCenter, cameraPos, scale);
                 if (!dest.intersects(screenRect))
                     continue;
 
-                // Lazy-load texture only for visible chunks.
                 ChunkInfo& info = m_chunks.at(key);
-                if (!info.texture) {
-                    if (info.loadFailed)
-                        continue;
-                    info.texture = loadChunkTexture(info.path);
-                    if (!info.texture) {
-                        info.loadFailed = true;
-                        g_logger.warning("SatelliteMap: failed to load chunk '{}'", info.path);
-                        continue;
-                    }
-                }
-
-                g_drawPool.addTexturedRect(dest, info.texture, Rect(0, 0, 512, 512));
+                if (useChunk(info, key, true))
+                    g_drawPool.addTexturedRect(dest, info.texture, Rect(0, 0, 512, 512));
             }
         }
 
@@ -224,6 +216,9 @@ void SatelliteMap::draw(const Rect& screenRect, const Position& cameraPos, float
             g_drawPool.resetOpacity();
     }
     g_drawPool.setClipRect(oldClipRect);
+
+    evictChunks();
+    prefetchChunks(true, targetFloor, SURFACE_FLOOR, screenRect, cameraPos, scale);
 }
 
 void SatelliteMap::drawStaticMinimap(const Rect& screenRect, const Position& cameraPos, float scale, const Color& color)
@@ -231,6 +226,9 @@ void SatelliteMap::drawStaticMinimap(const Rect& screenRect, const Position& cam
     if (screenRect.isEmpty() || m_mmChunks.empty())
         return;
 
+    ++drawState(false).frame;
+    processLoadedChunks();
+
     const auto oldClipRect = g_drawPool.getClipRect();
     g_drawPool.setClipRect(screenRect);
 
@@ -255,44 +253,21 @@ void SatelliteMap::drawStaticMinimap(const Rect& screenRect, const Position& cam
         if (it == m_mmIndex.end())
             continue;
 
-        const float chunkTiles = 512.f * (static_cast<float>(lod) / 32.f);
-
         for (const ChunkKey& key : it->second) {
-            const float tileOx = static_cast<float>(key.posX) * 32.f;
-            const float tileOy = static_cast<float>(key.posY) * 32.f;
-
-            const float screenLeft = screenCenter.x + (tileOx - cameraPos.x) * scale;
-            const float screenTop  = screenCenter.y + (tileOy - cameraPos.y) * scale;
-            const float screenW    = chunkTiles * scale;
-            const float screenH    = chunkTiles * scale;
-
-            const Rect dest(
-                static_cast<int>(std::floor(screenLeft)),
-                static_cast<int>(std::floor(screenTop)),
-                static_cast<int>(std::ceil(screenW)),
-                static_cast<int>(std::ceil(screenH))
-            );
-
+            const Rect dest = getChunkRect(key, screenCenter, cameraPos, scale);
             if (!dest.intersects(screenRect))
                 continue;
 
             ChunkInfo& info = m_mmChunks.at(key);
-            if (!info.texture) {
-                if (info.loadFailed)
-                    continue;
-                info.texture = loadChunkTexture(info.path);
-                if (!info.texture) {
-                    info.loadFailed = true;
-                    g_logger.warning("SatelliteMap: failed to load minimap chunk '{}'", info.path);
-                    continue;
-                }
-            }
-
-            g_drawPool.addTexturedRect(dest, info.texture, Rect(0, 0, 512, 512));
+            if (useChunk(info, key, false))
+                g_drawPool.addTexturedRect(dest, info.texture, Rect(0, 0, 512, 512));
         }
     }
 
     g_drawPool.setClipRect(oldClipRect);
+
+    evictChunks();
+    prefetchChunks(false, floor, floor, screenRect, cameraPos, scale);
 }
 
 bool SatelliteMap::hasChunksForFloor(const int floor) const
@@ -345,7 +320,166 @@ int SatelliteMap::pickLod(const float scale)
     return 64;
 }
 
-TexturePtr SatelliteMap::loadChunkTexture(const std::string& path)
+Rect SatelliteMap::getChunkRect(const ChunkKey& key, const Point& screenCenter, const Position& cameraPos, const float scale)
+{
+    // Tiles covered per chunk: 512 px × (lod/32) tiles/px
+    const float chunkTiles = 512.f * (static_cast<float>(key.lod) / 32.f);
+
+    const float tileOx = static_cast<float>(key.posX) * 32.f;
+    const float tileOy = static_cast<float>(key.posY) * 32.f;
+
+    const float screenLeft = screenCenter.x + (tileOx - cameraPos.x) * scale;
+    const float screenTop  = screenCenter.y + (tileOy - cameraPos.y) * scale;
+    const float screenW    = chunkTiles * scale;
+    const float screenH    = chunkTiles * scale;
+
+    return {
+        static_cast<int>(std::floor(screenLeft)),
+        static_cast<int>(std::floor(screenTop)),
+        static_cast<int>(std::ceil(screenW)),
+        static_cast<int>(std::ceil(screenH))
+    };
+}
+
+bool SatelliteMap::useChunk(ChunkInfo& info, const ChunkKey& key, const bool isSatellite)
+{
+    if (info.state != ChunkState::RESIDENT) {
+        requestChunk(info, key, isSatellite);
+        return false;
+    }
+
+    info.lastDrawn = drawState(isSatellite).frame;
+    if (info.lruIt != m_lru.begin())
+        m_lru.splice(m_lru.begin(), m_lru, info.lruIt);
+    return true;
+}
+
+void SatelliteMap::requestChunk(ChunkInfo& info, const ChunkKey& key, const bool isSatellite)
+{
+    // asked again next frame while the loader is busy
+    if (info.state != ChunkState::UNLOADED || m_pendingLoads >= MAX_PENDING_LOADS)
+        return;
+
+    info.state = ChunkState::LOADING;
+    ++m_pendingLoads;
+
+    // a relative path resolves against the running Lua script, only known on this thread
+    g_asyncDispatcher->detach_task([this, key, isSatellite, path = g_resources.resolvePath(info.path), generation = m_generation] {
+        auto image = loadChunkImage(path);
+
+        std::scoped_lock lock(m_loadedMutex);
+        m_loadedChunks.push_back({ key, isSatellite, generation, std::move(image) });
+    });
+}
+
+void SatelliteMap::processLoadedChunks()
+{
+    std::vector<LoadedChunk> loaded;
+    {
+        std::scoped_lock lock(m_loadedMutex);
+        if (m_loadedChunks.empty())
+            return;
+
+        // uploads are spread over frames, the rest waits for the next ones
+        const auto count = std::min<size_t>(m_loadedChunks.size(), MAX_UPLOADS_PER_FRAME);
+        loaded.assign(std::make_move_iterator(m_loadedChunks.begin()), std::make_move_iterator(m_loadedChunks.begin() + count));
+        m_loadedChunks.erase(m_loadedChunks.begin(), m_loadedChunks.begin() + count);
+    }
+
+    for (auto& chunk : loaded) {
+        if (chunk.generation != m_generation)
+            continue;
+
+        --m_pendingLoads;
+
+        auto& chunks = chunk.isSatellite ? m_chunks : m_mmChunks;
+        const auto it = chunks.find(chunk.key);
+        if (it == chunks.end())
+            continue;
+
+        ChunkInfo& info = it->second;
+        if (!chunk.image) {
+            info.state = ChunkState::FAILED;
+            g_logger.warning("SatelliteMap: failed to load {} chunk '{}'", chunk.isSatellite ? "satellite" : "minimap", info.path);
+            continue;
+        }
+
+        info.texture = std::make_shared<Texture>(chunk.image);
+        info.state = ChunkState::RESIDENT;
+        info.isSatellite = chunk.isSatellite;
+        info.lastDrawn = drawState(chunk.isSatellite).frame;
+        m_lru.emplace_front(&info);
+        info.lruIt = m_lru.begin();
+        m_residentBytes += CHUNK_BYTES;
+    }
+}
+
+void SatelliteMap::evictChunks()
+{
+    if (m_memoryBudget == 0)
+        return;
+
+    // chunks drawn in the last frames of their view may still be in a pending draw pool frame
+    for (auto it = m_lru.end(); it != m_lru.begin() && m_residentBytes > m_memoryBudget;) {
+        ChunkInfo* info = *--it;
+        if (info->lastDrawn + 1 >= drawState(info->isSatellite).frame)
+            continue;
+
+        it = m_lru.erase(it);
+        info->texture = nullptr;
+        info->state = ChunkState::UNLOADED;
+        m_residentBytes -= CHUNK_BYTES;
+    }
+}
+
+void SatelliteMap::prefetchChunks(const bool isSatellite, const int floorMin, const int floorMax, const Rect& screenRect, const Position& cameraPos, const float scale)
+{
+    auto& chunks = isSatellite ? m_chunks : m_mmChunks;
+    const auto& index = isSatellite ? m_index : m_mmIndex;
+
+    const Point screenCenter = screenRect.center();
+    const int bestLod = pickLod(scale);
+    auto& state = drawState(isSatellite);
+
+    // one chunk past the screen edges the camera is moving towards
+    const int chunkPixels = static_cast<int>(std::ceil(512.f * (static_cast<float>(bestLod) / 32.f) * scale));
+    Rect ahead = screenRect;
+    if (state.lastCamera.isValid() && state.lastCamera.z == cameraPos.z) {
+        if (cameraPos.x > state.lastCamera.x) ahead.expandRight(chunkPixels);
+        else if (cameraPos.x < state.lastCamera.x) ahead.expandLeft(chunkPixels);
+        if (cameraPos.y > state.lastCamera.y) ahead.expandBottom(chunkPixels);
+        else if (cameraPos.y < state.lastCamera.y) ahead.expandTop(chunkPixels);
+    }
+
+    // zooming in, the finer LOD is drawn next
+    const int finerLod = scale > state.lastScale && state.lastScale > 0 && bestLod > 16 ? bestLod / 2 : 0;
+
+    state.lastCamera = cameraPos;
+    state.lastScale = scale;
+
+    for (int floor = floorMin; floor <= floorMax; ++floor) {
+        if (ahead != screenRect) {
+            if (const auto it = index.find(floor * 100 + bestLod); it != index.end()) {
+                for (const ChunkKey& key : it->second) {
+                    const Rect dest = getChunkRect(key, screenCenter, cameraPos, scale);
+                    if (dest.intersects(ahead) && !dest.intersects(screenRect))
+                        requestChunk(chunks.at(key), key, isSatellite);
+                }
+            }
+        }
+
+        if (finerLod > 0) {
+            if (const auto it = index.find(floor * 100 + finerLod); it != index.end()) {
+                for (const ChunkKey& key : it->second) {
+                    if (getChunkRect(key, screenCenter, cameraPos, scale).intersects(screenRect))
+                        requestChunk(chunks.at(key), key, isSatellite);
+                }
+            }
+        }
+    }
+}
+
+ImagePtr SatelliteMap::loadChunkImage(const std::string& path)
 {
     std::string fileData;
     try {
@@ -369,7 +503,7 @@ TexturePtr SatelliteMap::loadChunkTexture(const std::string& path)
         return nullptr;
     }
 
-    return std::make_shared<Texture>(image);
+    return image;
 }
 
 std::vector<uint8_t> SatelliteMap::decompressLzma(const std::string& fileData)
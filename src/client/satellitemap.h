@@ -24,6 +24,9 @@
 
 #include "declarations.h"
 #include <framework/graphics/declarations.h>
+#include <array>
+#include <list>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -40,6 +43,10 @@
 //   posX   : chunk X origin in map-block units (tile / 32)
 //   posY   : chunk Y origin in map-block units (tile / 32)
 //   floor  : Tibia floor index (0-15); surface = 7
+//
+// Chunks are decoded on g_asyncDispatcher and turned into textures on the drawing thread once ready,
+// a few per frame. Until then the coarser LOD, or nothing, shows in their place. Resident chunks are
+// freed least recently drawn first beyond the memory budget.
 class SatelliteMap
 {
 public:
@@ -53,12 +60,17 @@ public:
     // Returns the number of newly indexed chunks.
     int loadFloors(const std::string& dir, int floorMin, int floorMax);
 
-    // Releases all chunk metadata and textures.
+    // Releases all chunk metadata and textures; loads still in flight are dropped when they finish.
     void clear();
 
+    // Memory for resident chunk textures, 1 MB each (0 = unlimited).
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const { return m_memoryBudget; }
+
     // Draws the satellite layer for cameraPos.z onto screenRect.
     // Automatically selects the best LOD for the current scale.
-    // Chunks are loaded from disk on first use and cached.
+    // Missing chunks are requested from the background loader, with their neighbours along the
+    // pan direction and, when zooming in, the finer LOD.
     // floorSeparatorOpacity: 1.0 = all composite floors fully visible (default),
     //                        0.0 = only the target floor is rendered.
     void draw(const Rect& screenRect, const Position& cameraPos, float scale, const Color& color, float floorSeparatorOpacity = 1.0f);
@@ -100,19 +112,73 @@ private:
         }
     };
 
+    enum class ChunkState : uint8_t
+    {
+        UNLOADED,
+        LOADING,
+        RESIDENT,
+        FAILED, // skips retries
+    };
+
     struct ChunkInfo
     {
         std::string path;
-        TexturePtr  texture;    // nullptr until first successful load
-        bool        loadFailed{ false }; // set on first load failure; skips retries
+        TexturePtr  texture;    // set while resident
+        ChunkState  state{ ChunkState::UNLOADED };
+        uint32_t    lastDrawn{ 0 }; // frame of its own kind, see DrawState
+        std::list<ChunkInfo*>::iterator lruIt; // valid while resident
+        bool        isSatellite{ false };
+    };
+
+    // the surface view and the static minimap are drawn by different widgets, each counts its own frames
+    struct DrawState
+    {
+        uint32_t frame{ 0 };
+        Position lastCamera;
+        float    lastScale{ 0 };
+    };
+
+    using ChunkMap = std::unordered_map<ChunkKey, ChunkInfo, ChunkKeyHash>;
+    using ChunkIndex = std::unordered_map<int, std::vector<ChunkKey>>;
+
+    // a decoded chunk waiting for its texture, dropped if the chunks were cleared meanwhile
+    struct LoadedChunk
+    {
+        ChunkKey key;
+        bool     isSatellite;
+        uint32_t generation;
+        ImagePtr image;
     };
 
+    static constexpr size_t CHUNK_BYTES = 512 * 512 * 4;
+    static constexpr int MAX_PENDING_LOADS = 4;
+    static constexpr int MAX_UPLOADS_PER_FRAME = 2;
+
     // Selects the best LOD for a given scale (pixels per tile).
     static int pickLod(float scale);
 
-    // Loads and decompresses a single chunk file, returning its texture.
+    // Where a chunk lands on screen.
+    static Rect getChunkRect(const ChunkKey& key, const Point& screenCenter, const Position& cameraPos, float scale);
+
+    // Loads and decompresses a single chunk file, returning its image. Safe on any thread.
     // Returns nullptr on failure (file missing, corrupt, etc.).
-    static TexturePtr loadChunkTexture(const std::string& path);
+    static ImagePtr loadChunkImage(const std::string& path);
+
+    // Marks a chunk drawn this frame, requests it if it is not resident. Returns whether it can be drawn.
+    bool useChunk(ChunkInfo& info, const ChunkKey& key, bool isSatellite);
+    void requestChunk(ChunkInfo& info, const ChunkKey& key, bool isSatellite);
+
+    // Turns decoded chunks into textures.
+    void processLoadedChunks();
+    // Frees the least recently drawn chunks beyond the budget, once this frame's chunks are marked.
+    void evictChunks();
+
+    DrawState& drawState(const bool isSatellite) { return m_drawStates[isSatellite ? 0 : 1]; }
+
+    // Requests the chunks one step ahead of the pan, and the finer LOD while zooming in.
+    void prefetchChunks(bool isSatellite, int floorMin, int floorMax, const Rect& screenRect, const Position& cameraPos, float scale);
+
+    void resetChunks();
 
     // Decompresses a CIP LZMA file: skip 32-byte header, patch size field,
     // then run standard LZMA-alone decoder.
@@ -126,12 +192,26 @@ private:
     void buildFileCache(const std::string& dir);
 
     // Satellite chunks (satellite-* files): used for Surface View with composite rendering.
-    std::unordered_map<ChunkKey, ChunkInfo, ChunkKeyHash> m_chunks;
-    std::unordered_map<int, std::vector<ChunkKey>>        m_index;    // key = floor*100 + lod
+    ChunkMap   m_chunks;
+    ChunkIndex m_index;    // key = floor*100 + lod
 
     // Static-minimap chunks (minimap-* files): used for Map View single-floor rendering.
-    std::unordered_map<ChunkKey, ChunkInfo, ChunkKeyHash> m_mmChunks;
-    std::unordered_map<int, std::vector<ChunkKey>>        m_mmIndex;  // key = floor*100 + lod
+    ChunkMap   m_mmChunks;
+    ChunkIndex m_mmIndex;  // key = floor*100 + lod
+
+    // Resident chunks of both kinds, most recently drawn first.
+    std::list<ChunkInfo*> m_lru;
+    size_t m_residentBytes{ 0 };
+    size_t m_memoryBudget{ 256 * 1024 * 1024 };
+
+    // Filled by the loader threads, emptied by processLoadedChunks.
+    std::vector<LoadedChunk> m_loadedChunks;
+    std::mutex m_loadedMutex;
+
+    int m_pendingLoads{ 0 };
+    uint32_t m_generation{ 0 };
+
+    std::array<DrawState, 2> m_drawStates; // satellite, static minimap
 
     // File-scan cache: built once per directory, reused by every loadFloors() call.
     // isSatellite=true → satellite-* file; false → minimap-* file.
@@ -25,15 +25,71 @@
 #include <nlohmann/json_fwd.hpp>
 #include "lzma.h"
 #include "gameconfig.h"
-#include "framework/core/filestream.h"
+#include "framework/core/asyncdispatcher.h"
 #include "framework/core/resourcemanager.h"
 #include "framework/graphics/image.h"
+#include "framework/util/simd.h"
 
  // warnings related to protobuf
     // https://android.googlesource.com/platform/external/protobuf/+/brillo-m9-dev/vsprojects/readme.txt
 
 using json = nlohmann::json;
 
+namespace
+{
+    // pixels are handled as little endian 0xAARRGGBB words
+    constexpr uint32_t KEY_COLOR = 0x00FF00FF; // magenta, symmetric under the B <-> R swap
+    constexpr uint32_t RGB_MASK = 0x00FFFFFF;
+
+    inline uint32_t convertPixel(const uint32_t bgra)
+    {
+        if ((bgra & RGB_MASK) == KEY_COLOR)
+            return 0;
+        return (bgra & 0xFF00FF00) | ((bgra >> 16) & 0xFF) | ((bgra & 0xFF) << 16);
+    }
+
+    // a decode worker hands its pool thread back after this long, map and draw tasks share the pool
+    constexpr ticks_t DECODE_SLICE_MS = 8;
+}
+
+void SpriteAppearances::convertSheetRow(const uint8_t* src, uint8_t* dst, const size_t count)
+{
+    size_t i = 0;
+#if defined(OTC_SIMD_SSE2)
+    const __m128i keepMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+    const __m128i lowMask = _mm_set1_epi32(0xFF);
+    const __m128i rgbMask = _mm_set1_epi32(RGB_MASK);
+    const __m128i keyColor = _mm_set1_epi32(KEY_COLOR);
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        const __m128i swapped = _mm_or_si128(_mm_and_si128(px, keepMask),
+            _mm_or_si128(_mm_and_si128(_mm_srli_epi32(px, 16), lowMask), _mm_slli_epi32(_mm_and_si128(px, lowMask), 16)));
+        const __m128i isKey = _mm_cmpeq_epi32(_mm_and_si128(px, rgbMask), keyColor);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_andnot_si128(isKey, swapped));
+    }
+#elif defined(OTC_SIMD_NEON)
+    const uint32x4_t keepMask = vdupq_n_u32(0xFF00FF00);
+    const uint32x4_t lowMask = vdupq_n_u32(0xFF);
+    const uint32x4_t rgbMask = vdupq_n_u32(RGB_MASK);
+    const uint32x4_t keyColor = vdupq_n_u32(KEY_COLOR);
+
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4_t px = vreinterpretq_u32_u8(vld1q_u8(src + i * 4));
+        const uint32x4_t swapped = vorrq_u32(vandq_u32(px, keepMask),
+            vorrq_u32(vandq_u32(vshrq_n_u32(px, 16), lowMask), vshlq_n_u32(vandq_u32(px, lowMask), 16)));
+        const uint32x4_t isKey = vceqq_u32(vandq_u32(px, rgbMask), keyColor);
+        vst1q_u8(dst + i * 4, vreinterpretq_u8_u32(vbicq_u32(swapped, isKey)));
+    }
+#endif
+    for (; i < count; ++i) {
+        uint32_t px;
+        std::memcpy(&px, src + i * 4, 4);
+        px = convertPixel(px);
+        std::memcpy(dst + i * 4, &px, 4);
+    }
+}
+
 SpriteAppearances g_spriteAppearances;
 
 void SpriteAppearances::init()
@@ -108,134 +164,350 @@ int SpriteSheet::getSpritesPerSheet() const
     return getColumns() * spritesPerColumn;
 }
 
-bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet) const
+void SpriteAppearances::addSpriteSheet(const SpriteSheetPtr& sheet)
 {
-    if (sheet->m_loadingState.load(std::memory_order_acquire) == SpriteLoadState::LOADING)
-        return false;
+    // catalogs list sheets in order, so this is almost always an append
+    const auto it = std::ranges::upper_bound(m_sheets, sheet->firstId, {}, [](const SpriteSheetPtr& s) { return s->firstId; });
+    m_sheets.insert(it, sheet);
+}
 
-    if (sheet->data)
-        return true;
+bool SpriteAppearances::loadSpriteSheet(const SpriteSheetPtr& sheet)
+{
+    bool isLoading = false;
+    return getSheetData(sheet, isLoading) != nullptr;
+}
 
-    if (sheet->m_loadingState.exchange(SpriteLoadState::LOADING, std::memory_order_acq_rel) == SpriteLoadState::LOADING)
-        return false;
+std::shared_ptr<uint8_t[]> SpriteAppearances::getSheetData(const SpriteSheetPtr& sheet, bool& isLoading)
+{
+    return acquireSheet(sheet, isLoading, false);
+}
 
-    try {
-        const auto& path = fmt::format("{}{}", g_spriteAppearances.getPath(), sheet->file);
-        if (!g_resources.fileExists(path))
-            return false;
+void SpriteAppearances::prefetchSprite(const int spriteId, const int priority)
+{
+    if (const auto& sheet = getSheetBySpriteId(spriteId, false))
+        prefetchSheet(sheet, priority);
+}
 
-        const auto& fin = g_resources.openFile(path);
-        fin->cache(true);
+void SpriteAppearances::prefetchSheet(const SpriteSheetPtr& sheet, const int priority)
+{
+    // already resident or being decoded
+    if (sheet->m_loadingState.load(std::memory_order_acquire) != SpriteLoadState::NONE)
+        return;
+
+    static const int maxWorkers = std::max<int>(1, g_asyncDispatcher->get_thread_count() / 2);
 
-        thread_local static std::array<uint8_t, LZMA_UNCOMPRESSED_SIZE> decompressBuffer;
+    std::scoped_lock lock(m_queueMutex);
+    if (sheet->m_queued) {
+        if (sheet->m_queueIt->first >= priority)
+            return;
 
-        /*
-           CIP's header, always 32 (0x20) bytes.
-           Header format:
-           [0x00, X):          A variable number of NULL (0x00) bytes. The amount of pad-bytes can vary depending on how many
-                               bytes the "7-bit integer encoded LZMA file size" take.
-           [X, X + 0x05):      The constant byte sequence [0x70 0x0A 0xFA 0x80 0x24]
-           [X + 0x05, 0x20]:   LZMA file size (Note: excluding the 32 bytes of this header) encoded as a 7-bit integer
-       */
+        // moved up, not queued twice
+        m_decodeQueue.erase(sheet->m_queueIt);
+    }
 
-        while (fin->getU8() == 0x00);
-        fin->skip(4);
-        while ((fin->getU8() & 0x80) == 0x80);
+    sheet->m_queued = true;
+    sheet->m_queueIt = m_decodeQueue.emplace(priority, sheet);
 
-        const uint8_t lclppb = fin->getU8();
+    if (m_decodeWorkers < maxWorkers) {
+        ++m_decodeWorkers;
+        g_asyncDispatcher->detach_task([this] { runDecodeWorker(); });
+    }
+}
 
-        lzma_options_lzma options{};
-        options.lc = lclppb % 9;
+void SpriteAppearances::runDecodeWorker()
+{
+    const ticks_t deadline = stdext::millis() + DECODE_SLICE_MS;
+
+    while (true) {
+        SpriteSheetPtr sheet;
+        {
+            std::scoped_lock lock(m_queueMutex);
+            if (m_decodeQueue.empty()) {
+                --m_decodeWorkers;
+                return;
+            }
 
-        const int remainder = lclppb / 9;
-        options.lp = remainder % 5;
-        options.pb = remainder / 5;
+            // what is left goes behind the tasks queued meanwhile, the worker keeps its slot
+            if (stdext::millis() >= deadline) {
+                g_asyncDispatcher->detach_task([this] { runDecodeWorker(); });
+                return;
+            }
 
-        uint32_t dictionarySize = 0;
-        for (uint8_t i = 0; i < 4; ++i) {
-            dictionarySize += fin->getU8() << (i * 8);
+            const auto it = m_decodeQueue.begin();
+            sheet = std::move(it->second);
+            sheet->m_queued = false;
+            m_decodeQueue.erase(it);
         }
 
-        options.dict_size = dictionarySize;
-
-        fin->skip(8); // cip compressed size
+        bool isLoading = false;
+        acquireSheet(sheet, isLoading, true);
+    }
+}
 
-        lzma_stream stream = LZMA_STREAM_INIT;
+void SpriteAppearances::clearDecodeQueue()
+{
+    std::scoped_lock lock(m_queueMutex);
+    for (const auto& [priority, sheet] : m_decodeQueue)
+        sheet->m_queued = false;
+    m_decodeQueue.clear();
+}
 
-        const lzma_filter filters[2] = {
-            lzma_filter{LZMA_FILTER_LZMA1, &options},
-            lzma_filter{LZMA_VLI_UNKNOWN, nullptr}
-        };
+std::shared_ptr<uint8_t[]> SpriteAppearances::acquireSheet(const SpriteSheetPtr& sheet, bool& isLoading, const bool prefetch)
+{
+    uint32_t generation;
+    {
+        std::scoped_lock lock(m_cacheMutex);
+        if (sheet->data) {
+            if (!prefetch) {
+                ++m_cacheHits;
+                touchSheet(sheet.get());
+            }
+            return sheet->data;
+        }
 
-        lzma_ret ret = lzma_raw_decoder(&stream, filters);
-        if (ret != LZMA_OK) {
-            throw stdext::exception(fmt::format("failed to initialize lzma raw decoder result: {}", ret));
+        // another thread is decoding it, the caller retries on a later frame
+        if (sheet->m_loadingState.load(std::memory_order_acquire) == SpriteLoadState::LOADING) {
+            isLoading = true;
+            return nullptr;
         }
 
-        stream.next_in = &fin->m_data[fin->tell()];
-        stream.avail_in = fin->size() - fin->tell();
-        stream.next_out = decompressBuffer.data();
-        stream.avail_out = decompressBuffer.size();
-
-        const auto result = lzma_code(&stream, LZMA_RUN);
-        lzma_end(&stream);
-
-        if (result != LZMA_STREAM_END)
-            throw stdext::exception("LZMA decompression failed");
-
-        // pixel offset
-        const uint8_t* bmpOffsetPtr = decompressBuffer.data() + 10;
-        const uint32_t bmpDataOffset =
-            bmpOffsetPtr[0] |
-            (bmpOffsetPtr[1] << 8) |
-            (bmpOffsetPtr[2] << 16) |
-            (bmpOffsetPtr[3] << 24);
-
-        // validate offset
-        if (bmpDataOffset + BYTES_IN_SPRITE_SHEET > LZMA_UNCOMPRESSED_SIZE)
-            throw stdext::exception("sprite sheet image offset out of bounds");
-
-        uint8_t* bufferStart = decompressBuffer.data() + bmpDataOffset;
-
-        // swap BGR ? RGB and fix magenta
-        for (int i = 0; i < BYTES_IN_SPRITE_SHEET; i += 4) {
-            std::swap(bufferStart[i], bufferStart[i + 2]); // B <-> R
-
-            const uint32_t rgb = bufferStart[i] | (bufferStart[i + 1] << 8) | (bufferStart[i + 2] << 16);
-            if (rgb == 0xFF00FF) {
-                bufferStart[i + 0] = 0x00;
-                bufferStart[i + 1] = 0x00;
-                bufferStart[i + 2] = 0x00;
-                bufferStart[i + 3] = 0x00;
+        if (!prefetch)
+            ++m_cacheMisses;
+        sheet->m_loadingState.store(SpriteLoadState::LOADING, std::memory_order_release);
+        generation = m_cacheGeneration;
+    }
+
+    try {
+        // a sheet decoded in an earlier session is only paged in
+        std::shared_ptr<uint8_t[]> data = m_diskCache.load(sheet->file);
+        const bool fromDisk = data != nullptr;
+
+        if (!fromDisk) {
+            const auto& path = fmt::format("{}{}", m_path, sheet->file);
+            if (!g_resources.fileExists(path)) {
+                sheet->m_loadingState.store(SpriteLoadState::NONE, std::memory_order_release);
+                return nullptr;
             }
+
+            const auto& file = g_resources.readFileContents(path);
+
+            data = std::make_shared_for_overwrite<uint8_t[]>(BYTES_IN_SPRITE_SHEET);
+            decodeSpriteSheet({ reinterpret_cast<const uint8_t*>(file.data()), file.size() }, data.get());
+            m_diskCache.store(sheet->file, data.get());
         }
 
-        // vertical flip
-        constexpr int halfHeight = SpriteSheet::SIZE / 2;
-        uint8_t tempLine[SPRITE_SHEET_WIDTH_BYTES];
-        for (int y = 0; y < halfHeight; ++y) {
-            uint8_t* top = bufferStart + y * SPRITE_SHEET_WIDTH_BYTES;
-            uint8_t* bottom = bufferStart + (SpriteSheet::SIZE - 1 - y) * SPRITE_SHEET_WIDTH_BYTES;
+        std::scoped_lock lock(m_cacheMutex);
+        if (fromDisk)
+            ++m_diskCacheHits;
 
-            std::memcpy(tempLine, top, SPRITE_SHEET_WIDTH_BYTES);
-            std::memcpy(top, bottom, SPRITE_SHEET_WIDTH_BYTES);
-            std::memcpy(bottom, tempLine, SPRITE_SHEET_WIDTH_BYTES);
+        // the cache was cleared while decoding, the sheet may not be ours anymore
+        if (generation != m_cacheGeneration) {
+            sheet->m_loadingState.store(SpriteLoadState::NONE, std::memory_order_release);
+            return data;
         }
 
-        sheet->data = std::make_unique<uint8_t[]>(BYTES_IN_SPRITE_SHEET);
-        std::memcpy(sheet->data.get(), bufferStart, BYTES_IN_SPRITE_SHEET);
+        sheet->data = data;
+        m_lru.emplace_front(sheet.get());
+        sheet->m_lruIt = m_lru.begin();
+        m_residentBytes += BYTES_IN_SPRITE_SHEET;
+        evictSheets(sheet.get());
 
         sheet->m_loadingState.store(SpriteLoadState::LOADED, std::memory_order_release);
-        return true;
+        return data;
     } catch (const std::exception& e) {
         sheet->m_loadingState.store(SpriteLoadState::NONE, std::memory_order_release);
         g_logger.error("Failed to load single sprite sheet '{}': {}", sheet->file, e.what());
-        return false;
+        return nullptr;
     }
 }
 
+void SpriteAppearances::decodeSpriteSheet(const std::span<const uint8_t> file, uint8_t* pixels)
+{
+    size_t pos = 0;
+    const auto getU8 = [&] {
+        if (pos >= file.size())
+            throw stdext::exception("unexpected end of sprite sheet header");
+        return file[pos++];
+    };
+
+    /*
+       CIP's header, always 32 (0x20) bytes.
+       Header format:
+       [0x00, X):          A variable number of NULL (0x00) bytes. The amount of pad-bytes can vary depending on how many
+                           bytes the "7-bit integer encoded LZMA file size" take.
+       [X, X + 0x05):      The constant byte sequence [0x70 0x0A 0xFA 0x80 0x24]
+       [X + 0x05, 0x20]:   LZMA file size (Note: excluding the 32 bytes of this header) encoded as a 7-bit integer
+   */
+
+    while (getU8() == 0x00);
+    pos += 4;
+    while ((getU8() & 0x80) == 0x80);
+
+    const uint8_t lclppb = getU8();
+
+    lzma_options_lzma options{};
+    options.lc = lclppb % 9;
+
+    const int remainder = lclppb / 9;
+    options.lp = remainder % 5;
+    options.pb = remainder / 5;
+
+    uint32_t dictionarySize = 0;
+    for (uint8_t i = 0; i < 4; ++i) {
+        dictionarySize += getU8() << (i * 8);
+    }
+
+    options.dict_size = dictionarySize;
+
+    pos += 8; // cip compressed size
+    if (pos >= file.size())
+        throw stdext::exception("unexpected end of sprite sheet header");
+
+    thread_local static std::array<uint8_t, LZMA_UNCOMPRESSED_SIZE> decompressBuffer;
+
+    lzma_stream stream = LZMA_STREAM_INIT;
+
+    const lzma_filter filters[2] = {
+        lzma_filter{LZMA_FILTER_LZMA1, &options},
+        lzma_filter{LZMA_VLI_UNKNOWN, nullptr}
+    };
+
+    lzma_ret ret = lzma_raw_decoder(&stream, filters);
+    if (ret != LZMA_OK) {
+        throw stdext::exception(fmt::format("failed to initialize lzma raw decoder result: {}", static_cast<int>(ret)));
+    }
+
+    stream.next_in = file.data() + pos;
+    stream.avail_in = file.size() - pos;
+    stream.next_out = decompressBuffer.data();
+    stream.avail_out = decompressBuffer.size();
+
+    const auto result = lzma_code(&stream, LZMA_RUN);
+    lzma_end(&stream);
+
+    if (result != LZMA_STREAM_END)
+        throw stdext::exception("LZMA decompression failed");
+
+    // pixel offset
+    const uint8_t* bmpOffsetPtr = decompressBuffer.data() + 10;
+    const uint32_t bmpDataOffset =
+        bmpOffsetPtr[0] |
+        (bmpOffsetPtr[1] << 8) |
+        (bmpOffsetPtr[2] << 16) |
+        (bmpOffsetPtr[3] << 24);
+
+    // validate offset
+    if (bmpDataOffset + BYTES_IN_SPRITE_SHEET > LZMA_UNCOMPRESSED_SIZE)
+        throw stdext::exception("sprite sheet image offset out of bounds");
+
+    convertSheetPixels(decompressBuffer.data() + bmpDataOffset, pixels);
+}
+
+void SpriteAppearances::convertSheetPixels(const uint8_t* bmp, uint8_t* pixels)
+{
+    // bitmap rows are stored bottom-up, each one is converted straight into its flipped position
+    for (int y = 0; y < SpriteSheet::SIZE; ++y)
+        convertSheetRow(bmp + (SpriteSheet::SIZE - 1 - y) * SPRITE_SHEET_WIDTH_BYTES, pixels + y * SPRITE_SHEET_WIDTH_BYTES, SpriteSheet::SIZE);
+}
+
+void SpriteAppearances::touchSheet(SpriteSheet* sheet)
+{
+    if (sheet->m_lruIt != m_lru.begin())
+        m_lru.splice(m_lru.begin(), m_lru, sheet->m_lruIt);
+}
+
+void SpriteAppearances::evictSheets(const SpriteSheet* keep)
+{
+    if (m_cacheBudget == 0)
+        return;
+
+    // readers still holding a copy of the data keep it alive until they are done
+    while (m_residentBytes > m_cacheBudget && !m_lru.empty() && m_lru.back() != keep) {
+        auto* sheet = m_lru.back();
+        m_lru.pop_back();
+        sheet->data.reset();
+        sheet->m_loadingState.store(SpriteLoadState::NONE, std::memory_order_release);
+        m_residentBytes -= BYTES_IN_SPRITE_SHEET;
+        ++m_cacheEvictions;
+    }
+}
+
+void SpriteAppearances::setCacheBudget(const size_t bytes)
+{
+    std::scoped_lock lock(m_cacheMutex);
+    m_cacheBudget = bytes;
+    evictSheets(nullptr);
+}
+
+void SpriteAppearances::clearCache()
+{
+    std::scoped_lock lock(m_cacheMutex);
+    for (auto* sheet : m_lru) {
+        sheet->data.reset();
+        sheet->m_loadingState.store(SpriteLoadState::NONE, std::memory_order_release);
+    }
+    m_lru.clear();
+    m_residentBytes = 0;
+    ++m_cacheGeneration;
+}
+
+std::map<std::string, uint64_t> SpriteAppearances::getCacheStats() const
+{
+    std::scoped_lock lock(m_cacheMutex);
+    return {
+        { "hits", m_cacheHits },
+        { "misses", m_cacheMisses },
+        { "evictions", m_cacheEvictions },
+        { "residentBytes", m_residentBytes },
+        { "residentSheets", m_lru.size() },
+        { "budget", m_cacheBudget },
+        { "diskHits", m_diskCacheHits },
+        { "diskBytes", m_diskCache.getSize() }
+    };
+}
+
+void SpriteAppearances::setDiskCache(const std::string& dir, const uint64_t maxBytes)
+{
+    m_diskCacheDir = dir;
+    m_diskCacheLimit = maxBytes;
+    openDiskCache();
+}
+
+void SpriteAppearances::setCatalogFile(const std::string& file)
+{
+    if (m_catalogFile == file && m_diskCache.isOpen())
+        return;
+
+    m_catalogFile = file;
+    openDiskCache();
+}
+
+void SpriteAppearances::openDiskCache()
+{
+    if (m_diskCacheDir.empty() || m_catalogFile.empty()) {
+        m_diskCache.close();
+        return;
+    }
+
+    const auto& catalogHash = g_resources.fileSha256(m_catalogFile);
+    if (catalogHash.empty()) {
+        m_diskCache.close();
+        return;
+    }
+
+    std::filesystem::path dir(m_diskCacheDir);
+    if (dir.is_relative())
+        dir = std::filesystem::path(g_resources.getWriteDir()) / dir;
+
+    if (!m_diskCache.open(dir, catalogHash, m_diskCacheLimit))
+        m_diskCache.close();
+}
+
 void SpriteAppearances::unload()
 {
+    clearDecodeQueue();
+    clearCache();
+
     m_spritesCount = 0;
     m_sheets.clear();
 }
@@ -246,20 +518,17 @@ SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(const int id, bool& isLoadi
         return nullptr;
     }
 
-    // find sheet
-    const auto sheetIt = std::ranges::find_if(m_sheets, [=](const SpriteSheetPtr& sheet) {
-        return id >= sheet->firstId && id <= sheet->lastId;
-    });
-
-    if (sheetIt == m_sheets.end())
+    // find the last sheet starting at or before id
+    auto sheetIt = std::ranges::upper_bound(m_sheets, id, {}, [](const SpriteSheetPtr& sheet) { return sheet->firstId; });
+    if (sheetIt == m_sheets.begin())
         return nullptr;
 
-    const auto& sheet = *sheetIt;
+    const auto& sheet = *--sheetIt;
+    if (id > sheet->lastId)
+        return nullptr;
 
-    if (load && !loadSpriteSheet(sheet)) {
-        isLoading = sheet->m_loadingState == SpriteLoadState::LOADING;
+    if (load && !getSheetData(sheet, isLoading))
         return nullptr;
-    }
 
     return sheet;
 }
@@ -267,11 +536,17 @@ SpriteSheetPtr SpriteAppearances::getSheetBySpriteId(const int id, bool& isLoadi
 ImagePtr SpriteAppearances::getSpriteImage(const int id, bool& isLoading)
 {
     try {
-        const auto& sheet = getSheetBySpriteId(id, isLoading, true);
+        const auto& sheet = getSheetBySpriteId(id, isLoading, false);
         if (!sheet) {
             return nullptr;
         }
 
+        // hold the pixels, the sheet may be evicted by another thread meanwhile
+        const auto& data = getSheetData(sheet, isLoading);
+        if (!data) {
+            return nullptr;
+        }
+
         const Size& size = sheet->getSpriteSize();
 
         const auto& image = std::make_shared<Image>(size);
@@ -291,7 +566,7 @@ ImagePtr SpriteAppearances::getSpriteImage(const int id, bool& isLoading)
         const int spriteWidthBytes = size.width() * 4;
 
         for (int height = size.height() * spriteRow, offset = 0; height < size.height() + (spriteRow * size.height()); height++, offset++) {
-            std::memcpy(&pixelData[offset * spriteWidthBytes], &sheet->data[(height * SPRITE_SHEET_WIDTH_BYTES) + (spriteColumn * spriteWidthBytes)], spriteWidthBytes);
+            std::memcpy(&pixelData[offset * spriteWidthBytes], &data[(height * SPRITE_SHEET_WIDTH_BYTES) + (spriteColumn * spriteWidthBytes)], spriteWidthBytes);
         }
 
         if (!image->hasTransparentPixel()) {
@@ -322,14 +597,18 @@ void SpriteAppearances::saveSpriteToFile(const int id, const std::string& file)
 
 void SpriteAppearances::saveSheetToFileBySprite(const int id, const std::string& file)
 {
-    if (const auto& sheet = getSheetBySpriteId(id)) {
-        Image image({ SpriteSheet::SIZE }, 4, sheet->data.get());
-        image.savePNG(file);
+    if (const auto& sheet = getSheetBySpriteId(id, false)) {
+        saveSheetToFile(sheet, file);
     }
 }
 
 void SpriteAppearances::saveSheetToFile(const SpriteSheetPtr& sheet, const std::string& file)
 {
-    Image image({ SpriteSheet::SIZE }, 4, sheet->data.get());
+    bool isLoading = false;
+    const auto& data = getSheetData(sheet, isLoading);
+    if (!data)
+        return;
+
+    Image image({ SpriteSheet::SIZE }, 4, data.get());
     image.savePNG(file);
 }
\ No newline at end of file
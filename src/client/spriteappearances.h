@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include "spritesheetcache.h"
+
 #include <framework/graphics/declarations.h>
 #include <framework/luaengine/luaobject.h>
 
@@ -75,6 +77,9 @@ enum class SpriteLoadState
     LOADED
 };
 
+// pending decodes by priority, the highest first and in request order among equals
+using SpriteDecodeQueue = std::multimap<int, SpriteSheetPtr, std::greater<>>;
+
 class SpriteSheet
 {
 public:
@@ -97,8 +102,16 @@ public:
 
     SpriteLayout spriteLayout = SpriteLayout::SIZE_32_32;
     std::atomic<SpriteLoadState> m_loadingState = SpriteLoadState::NONE;
-    std::unique_ptr<uint8_t[]> data;
+    // decoded pixels, may be evicted at any time: take a copy through SpriteAppearances::getSheetData
+    std::shared_ptr<uint8_t[]> data;
     std::string file;
+
+    // position in the sheet cache LRU, valid while data is resident
+    std::list<SpriteSheet*>::iterator m_lruIt;
+
+    // pending prefetch request, guarded by the decode queue lock
+    bool m_queued = false;
+    SpriteDecodeQueue::iterator m_queueIt;
 };
 
 //@bindsingleton g_spriteAppearances
@@ -116,7 +129,19 @@ public:
     void setPath(const std::string& path) { m_path = path; }
     std::string getPath() const { return m_path; }
 
-    bool loadSpriteSheet(const SpriteSheetPtr& sheet) const;
+    bool loadSpriteSheet(const SpriteSheetPtr& sheet);
+    std::shared_ptr<uint8_t[]> getSheetData(const SpriteSheetPtr& sheet, bool& isLoading);
+
+    // queues the sheet for decoding on g_asyncDispatcher, higher priorities are decoded first
+    void prefetchSheet(const SpriteSheetPtr& sheet, int priority);
+    void prefetchSprite(int spriteId, int priority);
+
+    // decodes a .bmp.lzma sheet file into SpriteSheet::SIZE² RGBA pixels, throws on malformed input
+    static void decodeSpriteSheet(std::span<const uint8_t> file, uint8_t* pixels);
+    // bottom-up BGRA bitmap to top-down RGBA with the magenta key made transparent, in one sweep
+    static void convertSheetPixels(const uint8_t* bmp, uint8_t* pixels);
+    // one row of it, count pixels of any number; vectorized where the target allows
+    static void convertSheetRow(const uint8_t* src, uint8_t* dst, size_t count);
     void saveSheetToFileBySprite(int id, const std::string& file);
     void saveSheetToFile(const SpriteSheetPtr& sheet, const std::string& file);
     SpriteSheetPtr getSheetBySpriteId(int id, bool load = true) {
@@ -125,7 +150,19 @@ public:
     }
     SpriteSheetPtr getSheetBySpriteId(int id, bool& isLoading, bool load = true);
 
-    void addSpriteSheet(const SpriteSheetPtr& sheet) { m_sheets.emplace_back(sheet); }
+    void addSpriteSheet(const SpriteSheetPtr& sheet);
+
+    // memory budget for decoded sheets, least recently used ones are freed beyond it (0 = unlimited)
+    void setCacheBudget(size_t bytes);
+    size_t getCacheBudget() const { return m_cacheBudget; }
+    void clearCache();
+    std::map<std::string, uint64_t> getCacheStats() const;
+
+    // keeps decoded sheets on disk across sessions, relative paths are inside the write dir (empty = disabled)
+    void setDiskCache(const std::string& dir, uint64_t maxBytes);
+    std::string getDiskCacheDir() const { return m_diskCacheDir; }
+    // catalog the sheets belong to, its hash invalidates the disk cache when the assets change
+    void setCatalogFile(const std::string& file);
 
     ImagePtr getSpriteImage(int id) {
         bool isLoading = false;
@@ -135,9 +172,35 @@ public:
     void saveSpriteToFile(int id, const std::string& file);
 
 private:
+    std::shared_ptr<uint8_t[]> acquireSheet(const SpriteSheetPtr& sheet, bool& isLoading, bool prefetch);
+    void runDecodeWorker();
+    void openDiskCache();
+    void clearDecodeQueue();
+    void touchSheet(SpriteSheet* sheet);
+    void evictSheets(const SpriteSheet* keep);
+
     uint32_t m_spritesCount{ 0 };
-    std::vector<SpriteSheetPtr> m_sheets;
+    std::vector<SpriteSheetPtr> m_sheets; // sorted by firstId
     std::string m_path;
+
+    mutable std::mutex m_cacheMutex;
+    std::list<SpriteSheet*> m_lru; // most recently used first
+    size_t m_cacheBudget{ 512 * 1024 * 1024 };
+    size_t m_residentBytes{ 0 };
+    uint64_t m_cacheHits{ 0 };
+    uint64_t m_cacheMisses{ 0 };
+    uint64_t m_cacheEvictions{ 0 };
+    uint32_t m_cacheGeneration{ 0 };
+    uint64_t m_diskCacheHits{ 0 };
+
+    SpriteSheetCache m_diskCache;
+    std::string m_diskCacheDir;
+    uint64_t m_diskCacheLimit{ 0 };
+    std::string m_catalogFile;
+
+    std::mutex m_queueMutex;
+    SpriteDecodeQueue m_decodeQueue;
+    int m_decodeWorkers{ 0 };
 };
 
 extern SpriteAppearances g_spriteAppearances;
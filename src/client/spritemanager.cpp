@@ -25,9 +25,11 @@
 #include "game.h"
 #include "gameconfig.h"
 #include "spriteappearances.h"
+#include "thingtypemanager.h"
 #include "framework/core/asyncdispatcher.h"
 #include "framework/core/filestream.h"
 #include "framework/core/graphicalapplication.h"
+#include "framework/core/mappedfile.h"
 #include "framework/core/resourcemanager.h"
 #include "framework/graphics/image.h"
 
@@ -51,9 +53,27 @@ void SpriteManager::reload() {
         return;
 
     load();
+    indexSprites();
+    g_things.invalidateThingBounds();
 }
 
 void SpriteManager::load() {
+    m_spriteAddresses.clear();
+
+    // packed or encrypted files only open through PhysFS streams
+    m_spritesMapping = !m_spritesHd && !g_app.isEncrypted() ? MappedFile::open(g_resources.getRealPath(m_lastFileName)) : nullptr;
+    if (m_spritesMapping) {
+        // the stream only reads the header, and the sprites when saving
+        m_spritesFiles.resize(1);
+        m_spritesFiles[0] = std::make_unique<FileStream_m>(g_resources.openFile(m_lastFileName));
+        return;
+    }
+
+    openSpriteFiles();
+}
+
+void SpriteManager::openSpriteFiles() {
+    m_spritesFiles.clear();
     m_spritesFiles.resize(g_asyncDispatcher->get_thread_count());
     if (g_app.isLoadingAsyncTexture()) {
         for (auto& file : m_spritesFiles)
@@ -61,8 +81,36 @@ void SpriteManager::load() {
     } else (m_spritesFiles[0] = std::make_unique<FileStream_m>(g_resources.openFile(m_lastFileName)))->file->cache(true);
 }
 
+void SpriteManager::indexSprites()
+{
+    m_spriteAddresses.clear();
+    if (!m_spritesMapping || m_spritesHd)
+        return;
+
+    const uint8_t* data = m_spritesMapping->data();
+    const size_t size = m_spritesMapping->size();
+    if (m_spritesOffset + static_cast<size_t>(m_spritesCount) * 4 > size) {
+        g_logger.warning("Sprite table of '{}' is truncated, reading it through streams", m_lastFileName);
+        // the single uncached stream opened for the header is not enough to read sprites from
+        m_spritesMapping = nullptr;
+        openSpriteFiles();
+        return;
+    }
+
+    // ids start at 1, an address past the file reads as a blank sprite
+    m_spriteAddresses.resize(m_spritesCount + 1, 0);
+    for (uint32_t id = 1; id <= m_spritesCount; ++id) {
+        const uint32_t address = stdext::readULE32(data + m_spritesOffset + (id - 1) * 4);
+        if (address > 0 && static_cast<size_t>(address) + 5 <= size)
+            m_spriteAddresses[id] = address;
+    }
+}
+
 bool SpriteManager::loadSpr(std::string file)
 {
+    // the bounds are checked against the signature of the new sprites
+    g_things.invalidateThingBounds();
+
     m_spritesCount = 0;
     m_signature = 0;
     m_loaded = false;
@@ -91,6 +139,7 @@ bool SpriteManager::loadRegularSpr(std::string file)
         m_signature = getSpriteFile()->getU32();
         m_spritesCount = g_game.getFeature(Otc::GameSpritesU32) ? getSpriteFile()->getU32() : getSpriteFile()->getU16();
         m_spritesOffset = getSpriteFile()->tell();
+        indexSprites();
 
         m_loaded = true;
         g_lua.callGlobalField("g_sprites", "onLoadSpr", file);
@@ -211,6 +260,8 @@ void SpriteManager::unload()
     m_spritesCount = 0;
     m_signature = 0;
     m_spritesFiles.clear();
+    m_spriteAddresses.clear();
+    m_spritesMapping = nullptr;
 }
 
 ImagePtr SpriteManager::getSpriteImage(const int id, bool& isLoading)
@@ -219,6 +270,18 @@ ImagePtr SpriteManager::getSpriteImage(const int id, bool& isLoading)
         return g_spriteAppearances.getSpriteImage(id, isLoading);
     }
 
+    if (isMapped()) {
+        const int spriteSize = g_gameConfig.getSpriteSize();
+        auto image = std::make_shared<Image>(Size(spriteSize));
+
+        bool hasTransparentPixel = false;
+        if (!readSpritePixels(id, image->getPixelData(), hasTransparentPixel))
+            return nullptr;
+
+        image->setTransparentPixel(hasTransparentPixel);
+        return image;
+    }
+
     const auto threadId = g_app.isLoadingAsyncTexture() ? stdext::getThreadId() : 0;
     if (const auto& sf = m_spritesFiles[threadId % m_spritesFiles.size()]) {
         if (sf->m_loadingState.exchange(SpriteLoadState::LOADING, std::memory_order_acq_rel) == SpriteLoadState::LOADING) {
@@ -258,6 +321,92 @@ uint16_t readU16FromBuffer(const uint8_t* data, size_t& offset) {
     return val;
 }
 
+bool SpriteManager::readSpritePixels(const int id, uint8_t* pixels, bool& hasTransparentPixel) const
+{
+    if (id <= 0 || static_cast<size_t>(id) >= m_spriteAddresses.size())
+        return false;
+
+    const uint32_t address = m_spriteAddresses[id];
+    if (address == 0)
+        return false;
+
+    // RGB color key, then the size of the pixel data
+    size_t offset = address + 3;
+    const uint8_t* data = m_spritesMapping->data();
+    const uint16_t pixelDataSize = readU16FromBuffer(data, offset);
+    if (offset + pixelDataSize > m_spritesMapping->size())
+        return false;
+
+    hasTransparentPixel = decodeSprite(data + offset, pixelDataSize, pixels, g_gameConfig.getSpriteSize(), g_game.getFeature(Otc::GameSpritesAlphaChannel));
+    return true;
+}
+
+bool SpriteManager::decodeSprite(const uint8_t* data, const size_t size, uint8_t* pixels, const int spriteSize, const bool useAlpha)
+{
+    const int maxWriteSize = spriteSize * spriteSize * 4;
+    const uint8_t channels = useAlpha ? 4 : 3;
+
+    static constexpr int MAX_PIXEL_BLOCK = 4096;
+
+    size_t offset = 0;
+    int writePos = 0;
+    bool hasAlpha = false;
+    int transparentCount = 0;
+
+    while (offset + 4 <= size && writePos < maxWriteSize) {
+        const uint16_t transparentPixels = readU16FromBuffer(data, offset);
+        const uint16_t coloredPixels = readU16FromBuffer(data, offset);
+
+        transparentCount += transparentPixels;
+
+        const int transparentBytes = transparentPixels * 4;
+        if (writePos + transparentBytes > maxWriteSize)
+            break;
+
+        std::memset(pixels + writePos, 0, transparentBytes);
+        writePos += transparentBytes;
+
+        const int actualColoredPixels = (coloredPixels > MAX_PIXEL_BLOCK) ? MAX_PIXEL_BLOCK : coloredPixels;
+        const int bytesToRead = actualColoredPixels * channels;
+
+        if (offset + bytesToRead > size)
+            break;
+
+        const uint8_t* colored = data + offset;
+        offset += bytesToRead;
+
+        if (useAlpha) {
+            for (int i = 0, src = 0; i < actualColoredPixels && writePos + 4 <= maxWriteSize; ++i, src += 4) {
+                pixels[writePos + 0] = colored[src + 0];
+                pixels[writePos + 1] = colored[src + 1];
+                pixels[writePos + 2] = colored[src + 2];
+                const uint8_t alpha = colored[src + 3];
+                pixels[writePos + 3] = alpha;
+
+                if (alpha != 0xFF) hasAlpha = true;
+                else if (transparentCount <= 4 && alpha == 0x00) ++transparentCount;
+
+                writePos += 4;
+            }
+        } else {
+            for (int i = 0, src = 0; i < actualColoredPixels && writePos + 4 <= maxWriteSize; ++i, src += 3) {
+                pixels[writePos + 0] = colored[src + 0];
+                pixels[writePos + 1] = colored[src + 1];
+                pixels[writePos + 2] = colored[src + 2];
+                pixels[writePos + 3] = 0xFF;
+                writePos += 4;
+            }
+        }
+    }
+
+    if (writePos < maxWriteSize) {
+        std::memset(pixels + writePos, 0, maxWriteSize - writePos);
+        transparentCount += maxWriteSize - writePos;
+    }
+
+    return hasAlpha || transparentCount > 4;
+}
+
 ImagePtr SpriteManager::getSpriteImage(const int id, const FileStreamPtr& file)
 {
     if (id == 0 || !file)
@@ -274,78 +423,13 @@ ImagePtr SpriteManager::getSpriteImage(const int id, const FileStreamPtr& file)
 
         const uint16_t pixelDataSize = file->getU16();
         const int spriteSize = g_gameConfig.getSpriteSize();
-        const int totalPixels = spriteSize * spriteSize;
-        const int maxWriteSize = totalPixels * 4;
-
-        const bool useAlpha = g_game.getFeature(Otc::GameSpritesAlphaChannel);
-        const uint8_t channels = useAlpha ? 4 : 3;
 
         static thread_local std::vector<uint8_t> spriteBuffer;
         spriteBuffer.resize(pixelDataSize);
         file->read(spriteBuffer.data(), pixelDataSize);
 
-        size_t offset = 0;
         auto image = std::make_shared<Image>(Size(spriteSize));
-        uint8_t* pixels = image->getPixelData();
-        int writePos = 0;
-        bool hasAlpha = false;
-        int transparentCount = 0;
-
-        static constexpr int MAX_PIXEL_BLOCK = 4096;
-        static thread_local uint8_t tempBuffer[MAX_PIXEL_BLOCK * 4];
-
-        while (offset + 4 <= pixelDataSize && writePos < maxWriteSize) {
-            const uint16_t transparentPixels = readU16FromBuffer(spriteBuffer.data(), offset);
-            const uint16_t coloredPixels = readU16FromBuffer(spriteBuffer.data(), offset);
-
-            transparentCount += transparentPixels;
-
-            const int transparentBytes = transparentPixels * 4;
-            if (writePos + transparentBytes > maxWriteSize)
-                break;
-
-            std::memset(pixels + writePos, 0, transparentBytes);
-            writePos += transparentBytes;
-
-            const int actualColoredPixels = (coloredPixels > MAX_PIXEL_BLOCK) ? MAX_PIXEL_BLOCK : coloredPixels;
-            const int bytesToRead = actualColoredPixels * channels;
-
-            if (offset + bytesToRead > pixelDataSize)
-                break;
-
-            std::memcpy(tempBuffer, spriteBuffer.data() + offset, bytesToRead);
-            offset += bytesToRead;
-
-            if (useAlpha) {
-                for (int i = 0, src = 0; i < actualColoredPixels && writePos + 4 <= maxWriteSize; ++i, src += 4) {
-                    pixels[writePos + 0] = tempBuffer[src + 0];
-                    pixels[writePos + 1] = tempBuffer[src + 1];
-                    pixels[writePos + 2] = tempBuffer[src + 2];
-                    const uint8_t alpha = tempBuffer[src + 3];
-                    pixels[writePos + 3] = alpha;
-
-                    if (alpha != 0xFF) hasAlpha = true;
-                    else if (transparentCount <= 4 && alpha == 0x00) ++transparentCount;
-
-                    writePos += 4;
-                }
-            } else {
-                for (int i = 0, src = 0; i < actualColoredPixels && writePos + 4 <= maxWriteSize; ++i, src += 3) {
-                    pixels[writePos + 0] = tempBuffer[src + 0];
-                    pixels[writePos + 1] = tempBuffer[src + 1];
-                    pixels[writePos + 2] = tempBuffer[src + 2];
-                    pixels[writePos + 3] = 0xFF;
-                    writePos += 4;
-                }
-            }
-        }
-
-        if (writePos < maxWriteSize) {
-            std::memset(pixels + writePos, 0, maxWriteSize - writePos);
-            transparentCount += maxWriteSize - writePos;
-        }
-
-        if (hasAlpha || transparentCount > 4)
+        if (decodeSprite(spriteBuffer.data(), pixelDataSize, image->getPixelData(), spriteSize, g_game.getFeature(Otc::GameSpritesAlphaChannel)))
             image->setTransparentPixel(true);
 
         return image;
@@ -353,4 +437,4 @@ ImagePtr SpriteManager::getSpriteImage(const int id, const FileStreamPtr& file)
         g_logger.error("Failed to get sprite id {}: {}", id, e.what());
         return nullptr;
     }
-}
\ No newline at end of file
+}
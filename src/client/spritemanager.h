@@ -70,6 +70,12 @@ public:
     ImagePtr getSpriteImage(int id, bool& isLoading);
     bool isLoaded() { return m_loaded; }
 
+    // a plain .spr on the real filesystem is mapped once, any thread decodes from it without locks or handles
+    bool isMapped() const { return !m_spriteAddresses.empty(); }
+
+    // RLE-decodes a sprite of the mapped .spr into pixels, spriteSize * spriteSize RGBA; false if it is blank or missing
+    bool readSpritePixels(int id, uint8_t* pixels, bool& hasTransparentPixel) const;
+
 private:
     enum class SpriteLoadState
     {
@@ -87,6 +93,9 @@ private:
     };
 
     void load();
+    // one stream per loader thread, or a single cached one
+    void openSpriteFiles();
+    void indexSprites();
     FileStreamPtr getSpriteFile() const {
         return m_spritesFiles[0]->file;
     }
@@ -94,6 +103,9 @@ private:
     ImagePtr getSpriteImageHd(int id, const FileStreamPtr& file);
     ImagePtr getSpriteImage(int id, const FileStreamPtr& file);
 
+    // returns whether the sprite has transparent pixels
+    static bool decodeSprite(const uint8_t* data, size_t size, uint8_t* pixels, int spriteSize, bool useAlpha);
+
     std::string m_lastFileName;
 
     bool m_spritesHd{ false };
@@ -103,6 +115,9 @@ private:
     uint32_t m_spritesOffset{ 0 };
 
     std::vector<std::unique_ptr<FileStream_m>> m_spritesFiles;
+
+    MappedFilePtr m_spritesMapping;
+    std::vector<uint32_t> m_spriteAddresses; // by sprite id, 0 for blank sprites
     std::unordered_map<uint32_t, FileMetadata> m_cwmSpritesMetadata;
 };
 
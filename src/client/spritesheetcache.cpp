@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "spritesheetcache.h"
+
+#include "spriteappearances.h"
+#include <framework/core/mappedfile.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+namespace
+{
+    constexpr uint32_t ENTRY_MAGIC = 0x4353544F; // "OTSC"
+    constexpr uint32_t ENTRY_VERSION = 1;
+
+    struct EntryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t sheetSize;
+        uint32_t byteSize;
+    };
+
+    constexpr uint64_t ENTRY_SIZE = sizeof(EntryHeader) + BYTES_IN_SPRITE_SHEET;
+
+    // only directories named like a catalog hash are ours to remove
+    bool isCatalogHash(const std::string& name)
+    {
+        return name.size() == 64 && std::ranges::all_of(name, [](const char c) { return std::isxdigit(static_cast<uint8_t>(c)) != 0; });
+    }
+}
+
+bool SpriteSheetCache::open(const std::filesystem::path& dir, const std::string& catalogHash, const uint64_t maxBytes)
+{
+    std::unique_lock lock(m_mutex);
+    std::scoped_lock entriesLock(m_entriesMutex);
+    m_dir.clear();
+    m_size = 0;
+    m_lru.clear();
+    m_entries.clear();
+
+    std::error_code ec;
+    const auto root = dir / "spritesheets";
+    const auto path = root / catalogHash;
+    std::filesystem::create_directories(path, ec);
+    if (ec) {
+        g_logger.warning("Unable to create sprite sheet cache '{}': {}", path.string(), ec.message());
+        return false;
+    }
+
+    // sheets decoded for another catalog are never valid again
+    for (const auto& entry : std::filesystem::directory_iterator(root, ec)) {
+        const auto& name = entry.path().filename().string();
+        if (name != catalogHash && isCatalogHash(name) && entry.is_directory(ec))
+            std::filesystem::remove_all(entry.path(), ec);
+    }
+
+    // entries of earlier sessions, most recently used first
+    std::vector<std::pair<std::filesystem::file_time_type, std::string>> entries;
+    for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
+        if (entry.path().extension() == ".tmp")
+            std::filesystem::remove(entry.path(), ec);
+        else if (entry.path().extension() == ".rgba" && entry.is_regular_file(ec))
+            entries.emplace_back(entry.last_write_time(ec), entry.path().filename().string());
+    }
+    std::ranges::sort(entries, std::greater{});
+
+    for (auto& [time, name] : entries) {
+        m_lru.emplace_back(std::move(name));
+        m_entries.emplace(m_lru.back(), std::prev(m_lru.end()));
+    }
+
+    m_dir = path;
+    m_maxBytes = maxBytes;
+    m_size = entries.size() * ENTRY_SIZE;
+    return true;
+}
+
+void SpriteSheetCache::close()
+{
+    std::unique_lock lock(m_mutex);
+    std::scoped_lock entriesLock(m_entriesMutex);
+    m_dir.clear();
+    m_size = 0;
+    m_lru.clear();
+    m_entries.clear();
+}
+
+bool SpriteSheetCache::isOpen() const
+{
+    std::shared_lock lock(m_mutex);
+    return !m_dir.empty();
+}
+
+std::filesystem::path SpriteSheetCache::getEntryPath(const std::string& sheetFile) const
+{
+    auto name = std::filesystem::path(sheetFile).filename();
+    name += ".rgba";
+    return m_dir / name;
+}
+
+void SpriteSheetCache::touchEntry(const std::string& name)
+{
+    std::scoped_lock lock(m_entriesMutex);
+    const auto it = m_entries.find(name);
+    if (it != m_entries.end() && it->second != m_lru.begin())
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+}
+
+bool SpriteSheetCache::reserveEntry(const std::string& name)
+{
+    std::scoped_lock lock(m_entriesMutex);
+
+    // stored by another thread in the meantime
+    if (m_entries.contains(name))
+        return false;
+
+    while (m_maxBytes > 0 && m_size + ENTRY_SIZE > m_maxBytes && !m_lru.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(m_dir / m_lru.back(), ec);
+
+        // still mapped on a system that refuses to remove it, tried again once it was used less
+        if (ec) {
+            m_lru.splice(m_lru.begin(), m_lru, std::prev(m_lru.end()));
+            return false;
+        }
+
+        m_entries.erase(m_lru.back());
+        m_lru.pop_back();
+        m_size -= ENTRY_SIZE;
+    }
+
+    m_lru.emplace_front(name);
+    m_entries.emplace(name, m_lru.begin());
+    m_size += ENTRY_SIZE;
+    return true;
+}
+
+std::shared_ptr<uint8_t[]> SpriteSheetCache::load(const std::string& sheetFile)
+{
+    std::shared_lock lock(m_mutex);
+    if (m_dir.empty())
+        return nullptr;
+
+    const auto path = getEntryPath(sheetFile);
+    const auto& file = MappedFile::open(path);
+    if (!file)
+        return nullptr;
+
+    if (file->size() != ENTRY_SIZE)
+        return nullptr;
+
+    EntryHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (header.magic != ENTRY_MAGIC || header.version != ENTRY_VERSION || header.sheetSize != SpriteSheet::SIZE || header.byteSize != BYTES_IN_SPRITE_SHEET)
+        return nullptr;
+
+    // the write time orders the entries again in the next session
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    touchEntry(path.filename().string());
+
+    // the pixels share ownership of the mapping
+    return { file, file->data() + sizeof(EntryHeader) };
+}
+
+void SpriteSheetCache::store(const std::string& sheetFile, const uint8_t* pixels)
+{
+    std::shared_lock lock(m_mutex);
+    if (m_dir.empty() || (m_maxBytes > 0 && ENTRY_SIZE > m_maxBytes))
+        return;
+
+    const auto path = getEntryPath(sheetFile);
+    const auto& name = path.filename().string();
+    if (!reserveEntry(name))
+        return;
+
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+
+    // written aside and renamed, a crash never leaves a truncated entry behind
+    bool written = false;
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (out) {
+            const EntryHeader header{ ENTRY_MAGIC, ENTRY_VERSION, SpriteSheet::SIZE, BYTES_IN_SPRITE_SHEET };
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(pixels), BYTES_IN_SPRITE_SHEET);
+            written = out.good();
+        }
+    }
+
+    std::error_code ec;
+    if (written)
+        std::filesystem::rename(tmpPath, path, ec);
+
+    if (!written || ec) {
+        std::filesystem::remove(tmpPath, ec);
+
+        std::scoped_lock entriesLock(m_entriesMutex);
+        if (const auto it = m_entries.find(name); it != m_entries.end()) {
+            m_lru.erase(it->second);
+            m_entries.erase(it);
+            m_size -= ENTRY_SIZE;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <framework/core/declarations.h>
+
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+
+// Decoded sprite sheets kept across sessions, one file per sheet in <dir>/spritesheets/<catalog hash>.
+// Entries are memory mapped when loaded, so a cached sheet costs a page-in instead of an LZMA decode.
+class SpriteSheetCache
+{
+public:
+    // removes the entries left by other catalogs, false if the cache cannot be created
+    bool open(const std::filesystem::path& dir, const std::string& catalogHash, uint64_t maxBytes);
+    void close();
+    bool isOpen() const;
+
+    // RGBA pixels stored in an earlier session, nullptr when the sheet is not cached
+    std::shared_ptr<uint8_t[]> load(const std::string& sheetFile);
+    // evicts the least recently used entries to stay within the size limit (0 = unlimited)
+    void store(const std::string& sheetFile, const uint8_t* pixels);
+
+    uint64_t getSize() const { return m_size.load(std::memory_order_relaxed); }
+
+private:
+    std::filesystem::path getEntryPath(const std::string& sheetFile) const;
+
+    void touchEntry(const std::string& name);
+    bool reserveEntry(const std::string& name);
+
+    mutable std::shared_mutex m_mutex;
+    std::filesystem::path m_dir;
+    uint64_t m_maxBytes{ 0 };
+    std::atomic<uint64_t> m_size{ 0 };
+
+    std::mutex m_entriesMutex;
+    std::list<std::string> m_lru; // entry file names, most recently used first
+    stdext::map<std::string, std::list<std::string>::iterator> m_entries;
+};
@@ -478,6 +478,11 @@ bool Thing::isLoading() const {
         return t->isLoading();
     return false;
 }
+
+void Thing::prefetchSpriteSheets(const int priority) const {
+    if (const auto t = getThingType(); t)
+        t->prefetchSpriteSheets(priority);
+}
 bool Thing::isSingleDimension() const {
     if (const auto t = getThingType(); t)
         return t->isSingleDimension();
@@ -144,6 +144,7 @@ public:
     bool isPodium() const;
     bool isOpaque() const;
     bool isLoading() const;
+    void prefetchSpriteSheets(int priority) const;
     bool isSingleDimension() const;
     bool isTall(bool useRealSize = false) const;
 
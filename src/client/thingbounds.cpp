@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "thingbounds.h"
+
+#include <framework/core/filestream.h>
+#include <framework/core/resourcemanager.h>
+
+#include <fstream>
+
+namespace
+{
+    constexpr uint32_t BOUNDS_MAGIC = 0x4242544F; // "OTBB"
+    constexpr uint16_t BOUNDS_VERSION = 1;
+
+    void addU8(std::vector<uint8_t>& out, const uint8_t value) { out.emplace_back(value); }
+    void addU16(std::vector<uint8_t>& out, const uint16_t value)
+    {
+        out.resize(out.size() + 2);
+        stdext::writeULE16(out.data() + out.size() - 2, value);
+    }
+    void addU32(std::vector<uint8_t>& out, const uint32_t value)
+    {
+        out.resize(out.size() + 4);
+        stdext::writeULE32(out.data() + out.size() - 4, value);
+    }
+}
+
+bool ThingBoundsTable::load(const std::string& file)
+{
+    clear();
+
+    try {
+        const auto& fin = g_resources.openFile(file);
+        fin->cache();
+
+        if (fin->getU32() != BOUNDS_MAGIC)
+            throw Exception("invalid magic");
+
+        if (const uint16_t version = fin->getU16(); version != BOUNDS_VERSION)
+            throw Exception("unsupported version {}", version);
+
+        m_spriteSize = fin->getU16();
+        m_assetKey = fin->getString();
+
+        const uint32_t count = fin->getU32();
+        m_frames.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto category = static_cast<ThingCategory>(fin->getU8());
+            const uint16_t id = fin->getU16();
+            const uint16_t animationPhase = fin->getU16();
+
+            std::vector<Frame> frames(fin->getU16());
+            for (auto& frame : frames) {
+                frame.left = fin->get16();
+                frame.top = fin->get16();
+                frame.right = fin->get16();
+                frame.bottom = fin->get16();
+            }
+            m_frames.emplace(makeKey(category, id, animationPhase), std::move(frames));
+        }
+        return true;
+    } catch (const std::exception& e) {
+        g_logger.warning("Unable to load thing bounds '{}': {}", file, e.what());
+        clear();
+        return false;
+    }
+}
+
+bool ThingBoundsTable::save(const std::string& file) const
+{
+    std::vector<uint8_t> out;
+    addU32(out, BOUNDS_MAGIC);
+    addU16(out, BOUNDS_VERSION);
+    addU16(out, m_spriteSize);
+    addU16(out, static_cast<uint16_t>(m_assetKey.size()));
+    out.insert(out.end(), m_assetKey.begin(), m_assetKey.end());
+    addU32(out, static_cast<uint32_t>(m_frames.size()));
+
+    for (const auto& [key, frames] : m_frames) {
+        addU8(out, static_cast<uint8_t>(key >> 32));
+        addU16(out, static_cast<uint16_t>(key >> 16));
+        addU16(out, static_cast<uint16_t>(key));
+        addU16(out, static_cast<uint16_t>(frames.size()));
+        for (const auto& frame : frames) {
+            addU16(out, frame.left);
+            addU16(out, frame.top);
+            addU16(out, frame.right);
+            addU16(out, frame.bottom);
+        }
+    }
+
+    std::ofstream fout(file, std::ios::binary | std::ios::trunc);
+    fout.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    return fout.good();
+}
+
+void ThingBoundsTable::clear()
+{
+    m_assetKey.clear();
+    m_spriteSize = 0;
+    m_frames.clear();
+}
+
+void ThingBoundsTable::setAssetKey(const std::string& key, const uint16_t spriteSize)
+{
+    m_assetKey = key;
+    m_spriteSize = spriteSize;
+}
+
+void ThingBoundsTable::set(const ThingCategory category, const uint16_t id, const uint16_t animationPhase, std::vector<Frame> frames)
+{
+    m_frames[makeKey(category, id, animationPhase)] = std::move(frames);
+}
+
+std::span<const ThingBoundsTable::Frame> ThingBoundsTable::find(const ThingCategory category, const uint16_t id, const uint16_t animationPhase) const
+{
+    const auto it = m_frames.find(makeKey(category, id, animationPhase));
+    if (it == m_frames.end())
+        return {};
+    return it->second;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+
+#include <span>
+
+// Bounding boxes of the opaque pixels of every composed ThingType frame, computed offline
+// (datdump --dump-dat-bounds) and shipped next to the assets, so loading a texture only
+// has to blit its sprites. The table is keyed by the assets it was generated from.
+class ThingBoundsTable
+{
+public:
+    // relative to the frame origin, right < left and bottom < top for an empty frame
+    struct Frame
+    {
+        int16_t left;
+        int16_t top;
+        int16_t right;
+        int16_t bottom;
+    };
+
+    bool load(const std::string& file);
+    bool save(const std::string& file) const;
+    void clear();
+
+    void setAssetKey(const std::string& key, uint16_t spriteSize);
+    const std::string& getAssetKey() const { return m_assetKey; }
+    uint16_t getSpriteSize() const { return m_spriteSize; }
+    bool empty() const { return m_frames.empty(); }
+
+    void set(ThingCategory category, uint16_t id, uint16_t animationPhase, std::vector<Frame> frames);
+    std::span<const Frame> find(ThingCategory category, uint16_t id, uint16_t animationPhase) const;
+
+private:
+    static uint64_t makeKey(const ThingCategory category, const uint16_t id, const uint16_t animationPhase)
+    {
+        return static_cast<uint64_t>(category) << 32 | static_cast<uint64_t>(id) << 16 | animationPhase;
+    }
+
+    std::string m_assetKey;
+    uint16_t m_spriteSize{ 0 };
+    stdext::map<uint64_t, std::vector<Frame>> m_frames;
+};
@@ -28,6 +28,7 @@
 #include "lightview.h"
 #include "spriteappearances.h"
 #include "spritemanager.h"
+#include "thingtypemanager.h"
 #include "framework/core/asyncdispatcher.h"
 #include "framework/core/filestream.h"
 #include "framework/graphics/drawpoolmanager.h"
@@ -48,6 +49,16 @@ namespace {
             default: return "unknown";
         }
     }
+
+#ifdef FRAMEWORK_PROTOBUF
+    // FileStream::getString refuses longer strings, so a snapshot holding one could never be read back
+    void addSnapshotString(const FileStreamPtr& fout, const std::string_view str)
+    {
+        if (str.size() >= 8192)
+            throw Exception("string of {} bytes does not fit a snapshot", str.size());
+        fout->addString(str);
+    }
+#endif
 }
 
 #ifdef FRAMEWORK_PROTOBUF
@@ -488,6 +499,152 @@ void ThingType::applyAppearanceFlags(const appearances::AppearanceFlags& flags)
             m_weaponType = 0;
     }
 }
+
+void ThingType::serializeSnapshot(const FileStreamPtr& fout) const
+{
+    addSnapshotString(fout, m_name);
+    addSnapshotString(fout, m_description);
+    fout->addU64(m_flags);
+
+    fout->add16(m_size.width());
+    fout->add16(m_size.height());
+    fout->add16(m_displacement.x);
+    fout->add16(m_displacement.y);
+    fout->add8(m_opaque);
+    fout->addU8(m_animationPhases);
+    fout->addU8(m_numPatternX);
+    fout->addU8(m_numPatternY);
+    fout->addU8(m_numPatternZ);
+    fout->addU8(m_layers);
+    fout->addU8(m_minimapColor);
+    fout->addU8(m_clothSlot);
+    fout->addU8(m_lensHelp);
+    fout->addU8(m_elevation);
+    fout->addU8(m_light.intensity);
+    fout->addU8(m_light.color);
+    fout->addU8(m_defaultAction);
+    fout->addU16(m_groundSpeed);
+    fout->addU16(m_maxTextLength);
+    fout->addU16(m_upgradeClassification);
+    fout->addU32(m_cyclopediaType);
+    fout->addU32(m_proficiencyId);
+    fout->addU32(m_weaponType);
+    fout->addU32(m_minimumLevel);
+    fout->addU32(m_imbueSlots);
+    fout->addU32(m_skillWheelGem.gem_quality_id);
+    fout->addU32(m_skillWheelGem.vocation_id);
+
+    fout->addU8(static_cast<uint8_t>(m_restrictVocation.size()));
+    for (const uint32_t vocation : m_restrictVocation)
+        fout->addU32(vocation);
+
+    addSnapshotString(fout, m_market.name);
+    fout->addU8(m_market.category);
+    fout->addU16(m_market.requiredLevel);
+    fout->addU16(m_market.restrictVocation);
+    fout->addU16(m_market.showAs);
+    fout->addU16(m_market.tradeAs);
+
+    fout->addU16(static_cast<uint16_t>(m_npcData.size()));
+    for (const auto& data : m_npcData) {
+        addSnapshotString(fout, data.name);
+        addSnapshotString(fout, data.location);
+        fout->addU32(data.salePrice);
+        fout->addU32(data.buyPrice);
+        fout->addU32(data.currencyObjectTypeId);
+        addSnapshotString(fout, data.currencyQuestFlagDisplayName);
+    }
+
+    fout->addU8((m_animator ? 1 : 0) | (m_idleAnimator ? 2 : 0));
+    if (m_animator)
+        m_animator->serializeSnapshot(fout);
+    if (m_idleAnimator)
+        m_idleAnimator->serializeSnapshot(fout);
+
+    fout->addU32(static_cast<uint32_t>(m_spritesIndex.size()));
+    for (const uint32_t spriteId : m_spritesIndex)
+        fout->addU32(spriteId);
+}
+
+void ThingType::unserializeSnapshot(const uint16_t clientId, const ThingCategory category, const FileStreamPtr& fin)
+{
+    m_null = false;
+    m_id = clientId;
+    m_category = category;
+
+    m_name = fin->getString();
+    m_description = fin->getString();
+    m_flags = fin->getU64();
+
+    const int width = fin->get16();
+    m_size = Size(width, fin->get16());
+    const int x = fin->get16();
+    m_displacement = Point(x, fin->get16());
+    m_opaque = fin->get8();
+    m_animationPhases = fin->getU8();
+    m_numPatternX = fin->getU8();
+    m_numPatternY = fin->getU8();
+    m_numPatternZ = fin->getU8();
+    m_layers = fin->getU8();
+    m_minimapColor = fin->getU8();
+    m_clothSlot = fin->getU8();
+    m_lensHelp = fin->getU8();
+    m_elevation = fin->getU8();
+    m_light.intensity = fin->getU8();
+    m_light.color = fin->getU8();
+    m_defaultAction = static_cast<PLAYER_ACTION>(fin->getU8());
+    m_groundSpeed = fin->getU16();
+    m_maxTextLength = fin->getU16();
+    m_upgradeClassification = fin->getU16();
+    m_cyclopediaType = fin->getU32();
+    m_proficiencyId = fin->getU32();
+    m_weaponType = fin->getU32();
+    m_minimumLevel = fin->getU32();
+    m_imbueSlots = fin->getU32();
+    m_skillWheelGem.gem_quality_id = fin->getU32();
+    m_skillWheelGem.vocation_id = fin->getU32();
+
+    m_restrictVocation.resize(fin->getU8());
+    for (auto& vocation : m_restrictVocation)
+        vocation = fin->getU32();
+
+    m_market.name = fin->getString();
+    m_market.category = static_cast<ITEM_CATEGORY>(fin->getU8());
+    m_market.requiredLevel = fin->getU16();
+    m_market.restrictVocation = fin->getU16();
+    m_market.showAs = fin->getU16();
+    m_market.tradeAs = fin->getU16();
+
+    m_npcData.resize(fin->getU16());
+    for (auto& data : m_npcData) {
+        data.name = fin->getString();
+        data.location = fin->getString();
+        data.salePrice = fin->getU32();
+        data.buyPrice = fin->getU32();
+        data.currencyObjectTypeId = fin->getU32();
+        data.currencyQuestFlagDisplayName = fin->getString();
+    }
+
+    const uint8_t animators = fin->getU8();
+    if (animators & 1) {
+        m_animator = new Animator;
+        m_animator->unserializeSnapshot(fin);
+    }
+    if (animators & 2) {
+        m_idleAnimator = new Animator;
+        m_idleAnimator->unserializeSnapshot(fin);
+    }
+
+    const uint32_t spriteCount = fin->getU32();
+    if (spriteCount > 4096)
+        throw Exception("a thing type has more than 4096 sprites");
+
+    m_spritesIndex.resize(spriteCount);
+    for (auto& spriteId : m_spritesIndex)
+        spriteId = fin->getU32();
+
+    m_textureData.resize(m_animationPhases);
+}
 #endif
 
 void ThingType::unserialize(const uint16_t clientId, const ThingCategory category, const FileStreamPtr& fin)
@@ -853,12 +1010,97 @@ const TexturePtr& ThingType::getTexture(const int animationPhase)
     return m_textureNull;
 }
 
+void ThingType::prefetchSpriteSheets(const int priority)
+{
+    if (m_null || hasTexture() || m_loading.load(std::memory_order_acquire) || !g_game.isUsingProtobuf())
+        return;
+
+    // consecutive sprites nearly always share a sheet
+    SpriteSheetPtr sheet;
+    for (const uint32_t spriteId : m_spritesIndex) {
+        if (spriteId == 0 || (sheet && static_cast<int>(spriteId) >= sheet->firstId && static_cast<int>(spriteId) <= sheet->lastId))
+            continue;
+
+        sheet = g_spriteAppearances.getSheetBySpriteId(spriteId, false);
+        if (sheet)
+            g_spriteAppearances.prefetchSheet(sheet, priority);
+    }
+}
+
 void ThingType::loadTexture(const int animationPhase)
 {
     auto& textureData = m_textureData[animationPhase];
     if (textureData.source)
         return;
 
+    const uint32_t boundsRevision = g_things.getThingBoundsRevision();
+    bool knownBounds = textureData.boundsRevision == boundsRevision;
+    const bool useCustomImage = animationPhase == 0 && !m_customImage.empty();
+    if (!knownBounds && !useCustomImage) {
+        // precomputed for the loaded assets, see ThingBoundsTable
+        const auto& frames = g_things.findThingBounds(m_category, m_id, animationPhase);
+        if (!frames.empty() && frames.size() == static_cast<size_t>(getTextureIndexSize())) {
+            const auto& textureSize = getBestTextureDimension(m_size.width(), m_size.height(), frames.size());
+            const auto& frameSize = Size(m_size.width(), m_size.height()) * g_gameConfig.getSpriteSize();
+
+            textureData.pos.resize(frames.size());
+            for (size_t frameIndex = 0; frameIndex < frames.size(); ++frameIndex) {
+                const auto& frame = frames[frameIndex];
+                const auto& framePos = Point(frameIndex % (textureSize.width() / m_size.width()) * m_size.width(),
+                    frameIndex / (textureSize.width() / m_size.width()) * m_size.height()) * g_gameConfig.getSpriteSize();
+
+                auto& posData = textureData.pos[frameIndex];
+                posData.rects = { framePos + Point(frame.left, frame.top), framePos + Point(frame.right, frame.bottom) };
+                posData.originRects = Rect(framePos, frameSize);
+                posData.offsets = posData.rects.topLeft() - framePos;
+            }
+            knownBounds = true;
+        }
+    }
+
+    const auto& fullImage = composeImage(animationPhase, textureData.pos, knownBounds);
+    if (!fullImage)
+        return;
+
+    textureData.boundsRevision = boundsRevision;
+
+    if (m_opacity < 1.0f)
+        fullImage->setTransparentPixel(true);
+
+    if (m_opaque == -1)
+        m_opaque = !fullImage->hasTransparentPixel();
+
+    textureData.source = std::make_shared<Texture>(fullImage, true, false);
+    textureData.source->allowAtlasCache();
+}
+
+std::vector<ThingBoundsTable::Frame> ThingType::computeBounds(const int animationPhase)
+{
+    std::vector<TextureData::Pos> pos;
+    if (!composeImage(animationPhase, pos, false))
+        return {};
+
+    std::vector<ThingBoundsTable::Frame> frames;
+    frames.reserve(pos.size());
+    for (const auto& posData : pos) {
+        const auto& origin = posData.originRects.topLeft();
+        frames.push_back({
+            static_cast<int16_t>(posData.rects.left() - origin.x), static_cast<int16_t>(posData.rects.top() - origin.y),
+            static_cast<int16_t>(posData.rects.right() - origin.x), static_cast<int16_t>(posData.rects.bottom() - origin.y)
+        });
+    }
+    return frames;
+}
+
+int ThingType::getTextureIndexSize() const
+{
+    // creatures keep the outfit base and its 4 color masks as separate layers
+    const int textureLayers = m_category == ThingCategoryCreature && m_layers >= 2 ? 5 : 1;
+    return textureLayers * m_numPatternX * m_numPatternY * m_numPatternZ;
+}
+
+ImagePtr ThingType::composeImage(const int animationPhase, std::vector<TextureData::Pos>& pos, const bool knownBounds)
+{
     // we don't need layers in common items, they will be pre-drawn
     int textureLayers = 1;
     int numLayers = m_layers;
@@ -869,14 +1111,16 @@ void ThingType::loadTexture(const int animationPhase)
     }
 
     const bool useCustomImage = animationPhase == 0 && !m_customImage.empty();
-    const int indexSize = textureLayers * m_numPatternX * m_numPatternY * m_numPatternZ;
+    const int indexSize = getTextureIndexSize();
     const auto& textureSize = getBestTextureDimension(m_size.width(), m_size.height(), indexSize);
     const auto& fullImage = useCustomImage ? Image::load(m_customImage) : std::make_shared<Image>(textureSize * g_gameConfig.getSpriteSize());
     const bool protobufSupported = g_game.isUsingProtobuf();
 
     static Color maskColors[] = { Color::red, Color::green, Color::blue, Color::yellow };
 
-    textureData.pos.resize(indexSize);
+    if (!knownBounds)
+        pos.resize(indexSize);
+
     for (int z = 0; z < m_numPatternZ; ++z) {
         for (int y = 0; y < m_numPatternY; ++y) {
             for (int x = 0; x < m_numPatternX; ++x) {
@@ -895,11 +1139,11 @@ void ThingType::loadTexture(const int animationPhase)
                             const auto& spriteImage = g_sprites.getSpriteImage(spriteId, isLoading);
 
                             if (isLoading)
-                                return;
+                                return nullptr;
 
                             if (!spriteImage) {
                                 g_logger.error("Failed to fetch sprite id {} for thing {} ({}, {}), layer {}, pattern {}x{}x{}, frame {}", spriteId, m_name, m_id, categoryName(m_category), l, x, y, z, animationPhase);
-                                return;
+                                return nullptr;
                             }
 
                             // verifies that the first block in the lower right corner is transparent.
@@ -920,11 +1164,27 @@ void ThingType::loadTexture(const int animationPhase)
                                 for (int w = 0; w < m_size.width(); ++w) {
                                     const uint32_t spriteIndex = getSpriteIndex(w, h, spriteMask ? 1 : l, x, y, z, animationPhase);
                                     auto spriteId = m_spritesIndex[spriteIndex];
-                                    bool isLoading = false;
-                                    const auto& spriteImage = g_sprites.getSpriteImage(spriteId, isLoading);
 
-                                    if (isLoading)
-                                        return;
+                                    ImagePtr spriteImage;
+                                    if (g_sprites.isMapped()) {
+                                        // decoded into one image per thread, it is only blitted before the next sprite
+                                        static thread_local ImagePtr decodedImage;
+                                        const auto& decodedSize = Size(g_gameConfig.getSpriteSize());
+                                        if (!decodedImage || decodedImage->getSize() != decodedSize)
+                                            decodedImage = std::make_shared<Image>(decodedSize);
+
+                                        bool hasTransparentPixel = false;
+                                        if (g_sprites.readSpritePixels(spriteId, decodedImage->getPixelData(), hasTransparentPixel)) {
+                                            decodedImage->setTransparentPixel(hasTransparentPixel);
+                                            spriteImage = decodedImage;
+                                        }
+                                    } else {
+                                        bool isLoading = false;
+                                        spriteImage = g_sprites.getSpriteImage(spriteId, isLoading);
+
+                                        if (isLoading)
+                                            return nullptr;
+                                    }
 
                                     if (!spriteImage) {
                                         // Skip blank sprites silently (clients converted with Assets Editor have blank sprites with non-zero IDs)
@@ -947,36 +1207,25 @@ void ThingType::loadTexture(const int animationPhase)
                         }
                     }
 
-                    auto& posData = textureData.pos[frameIndex];
-                    posData.rects = { framePos + Point(m_size.width(), m_size.height()) * g_gameConfig.getSpriteSize() - Point(1), framePos };
-                    for (int fx = framePos.x; fx < framePos.x + m_size.width() * g_gameConfig.getSpriteSize(); ++fx) {
-                        for (int fy = framePos.y; fy < framePos.y + m_size.height() * g_gameConfig.getSpriteSize(); ++fy) {
-                            const uint8_t* p = fullImage->getPixel(fx, fy);
-                            if (p[3] == 0x00)
-                                continue;
-
-                            posData.rects.setTop(std::min<int>(fy, posData.rects.top()));
-                            posData.rects.setLeft(std::min<int>(fx, posData.rects.left()));
-                            posData.rects.setBottom(std::max<int>(fy, posData.rects.bottom()));
-                            posData.rects.setRight(std::max<int>(fx, posData.rects.right()));
-                        }
-                    }
+                    // layers sharing a frame are all blitted before its bounds are taken
+                    if (knownBounds || l + textureLayers < numLayers)
+                        continue;
+
+                    const auto& frameSize = Size(m_size.width(), m_size.height()) * g_gameConfig.getSpriteSize();
 
-                    posData.originRects = Rect(framePos, Size(m_size.width(), m_size.height()) * g_gameConfig.getSpriteSize());
+                    auto& posData = pos[frameIndex];
+                    posData.rects = fullImage->getOpaqueRect(Rect(framePos, frameSize));
+                    if (!posData.rects.isValid())
+                        posData.rects = { framePos + Point(frameSize.width(), frameSize.height()) - Point(1), framePos };
+
+                    posData.originRects = Rect(framePos, frameSize);
                     posData.offsets = posData.rects.topLeft() - framePos;
                 }
             }
         }
     }
 
-    if (m_opacity < 1.0f)
-        fullImage->setTransparentPixel(true);
-
-    if (m_opaque == -1)
-        m_opaque = !fullImage->hasTransparentPixel();
-
-    textureData.source = std::make_shared<Texture>(fullImage, true, false);
-    textureData.source->allowAtlasCache();
+    return fullImage;
 }
 
 Size ThingType::getBestTextureDimension(int w, int h, const int count)
@@ -1062,6 +1311,8 @@ void ThingType::setPathable(const bool var)
         m_flags &= ~ThingFlagAttrNotPathable;
     else
         m_flags |= ThingFlagAttrNotPathable;
+
+    g_things.updateThingTypeIndex(this);
 }
 
 int ThingType::getExactHeight()
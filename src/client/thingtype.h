@@ -28,6 +28,7 @@
 #endif
 
 #include "staticdata.h"
+#include "thingbounds.h"
 #include "const.h"
 #include "framework/core/declarations.h"
 #include "framework/core/timer.h"
@@ -52,6 +53,10 @@ public:
 #ifdef FRAMEWORK_PROTOBUF
     void applyAppearanceFlags(const appearances::AppearanceFlags& flags);
     void unserializeAppearance(uint16_t clientId, ThingCategory category, const appearances::Appearance& appearance);
+
+    // flat copy of what unserializeAppearance produced, read back by the appearance snapshot of ThingTypeManager
+    void serializeSnapshot(const FileStreamPtr& fout) const;
+    void unserializeSnapshot(uint16_t clientId, ThingCategory category, const FileStreamPtr& fin);
 #endif
     void unserialize(uint16_t clientId, ThingCategory category, const FileStreamPtr& fin);
     void unserializeOtml(const OTMLNodePtr& node);
@@ -196,6 +201,10 @@ public:
     void setPathable(bool var);
     int getExactHeight();
     const TexturePtr& getTexture(int animationPhase);
+    // queues the sprite sheets of a texture not loaded yet for background decoding
+    void prefetchSpriteSheets(int priority);
+    // opaque bounds of every frame of a phase, relative to the frame origin, empty if the sprites are unavailable
+    std::vector<ThingBoundsTable::Frame> computeBounds(int animationPhase);
 
     std::string getName() { return m_name; }
     std::string getDescription() { return m_description; }
@@ -217,10 +226,17 @@ private:
 
         TexturePtr source;
         std::vector<Pos> pos;
+        // pos stays valid when the texture is unloaded, reloading it only blits the sprites;
+        // until the sprites or the assets are loaded again, see ThingTypeManager::invalidateThingBounds
+        uint32_t boundsRevision{ 0 };
     };
 
+    // blits the sprites of a phase into one image, the frame bounds are computed unless already known
+    ImagePtr composeImage(int animationPhase, std::vector<TextureData::Pos>& pos, bool knownBounds);
+
     uint32_t getSpriteIndex(int w, int h, int l, int x, int y, int z, int a) const;
     uint32_t getTextureIndex(int l, int x, int y, int z) const;
+    int getTextureIndexSize() const;
 
     ThingCategory m_category{ ThingInvalidCategory };
 
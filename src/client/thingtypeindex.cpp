@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "thingtypeindex.h"
+
+#include <bit>
+
+void NameIndex::clear()
+{
+    m_entries.clear();
+    m_ids.clear();
+    m_trigrams.clear();
+}
+
+void NameIndex::add(const uint32_t id, const std::string_view name)
+{
+    assert(m_entries.empty() || m_entries.back().id <= id);
+
+    std::string lowered(name);
+    stdext::tolower(lowered);
+
+    auto& ids = m_ids[lowered];
+    if (ids.empty() || ids.back() != id)
+        ids.emplace_back(id);
+
+    const auto entry = static_cast<uint32_t>(m_entries.size());
+    for (size_t i = 0; i + 3 <= lowered.size(); ++i) {
+        // a trigram repeated within the name is listed once
+        auto& entries = m_trigrams[trigram(lowered.data() + i)];
+        if (entries.empty() || entries.back() != entry)
+            entries.emplace_back(entry);
+    }
+
+    m_entries.push_back({ id, std::move(lowered) });
+}
+
+std::span<const uint32_t> NameIndex::find(const std::string& name) const
+{
+    std::string lowered(name);
+    stdext::tolower(lowered);
+
+    const auto it = m_ids.find(lowered);
+    if (it == m_ids.end())
+        return {};
+    return it->second;
+}
+
+template<typename Visit>
+void NameIndex::forEachMatch(const std::string& text, Visit&& visit) const
+{
+    std::string lowered(text);
+    stdext::tolower(lowered);
+
+    // several names of the same id are consecutive, one match of them is enough
+    uint32_t lastId = 0;
+    bool any = false;
+    const auto check = [&](const Entry& entry) {
+        if (any && entry.id == lastId)
+            return true;
+        if (entry.name.find(lowered) == std::string::npos)
+            return true;
+
+        lastId = entry.id;
+        any = true;
+        return visit(entry.id);
+    };
+
+    if (lowered.size() < 3) {
+        for (const auto& entry : m_entries) {
+            if (!check(entry))
+                return;
+        }
+        return;
+    }
+
+    const std::vector<uint32_t>* rarest = nullptr;
+    for (size_t i = 0; i + 3 <= lowered.size(); ++i) {
+        const auto it = m_trigrams.find(trigram(lowered.data() + i));
+        if (it == m_trigrams.end())
+            return;
+
+        if (!rarest || it->second.size() < rarest->size())
+            rarest = &it->second;
+    }
+
+    for (const uint32_t entry : *rarest) {
+        if (!check(m_entries[entry]))
+            return;
+    }
+}
+
+std::vector<uint32_t> NameIndex::search(const std::string& text, size_t offset, const size_t limit) const
+{
+    std::vector<uint32_t> ids;
+    forEachMatch(text, [&](const uint32_t id) {
+        if (offset > 0) {
+            --offset;
+            return true;
+        }
+
+        ids.emplace_back(id);
+        return limit == 0 || ids.size() < limit;
+    });
+    return ids;
+}
+
+size_t NameIndex::count(const std::string& text) const
+{
+    size_t count = 0;
+    forEachMatch(text, [&count](uint32_t) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+void IdBitset::set(const size_t id, const bool value)
+{
+    if (id / 64 >= m_words.size())
+        m_words.resize(id / 64 + 1, 0);
+
+    if (value)
+        m_words[id / 64] |= uint64_t{ 1 } << (id % 64);
+    else
+        m_words[id / 64] &= ~(uint64_t{ 1 } << (id % 64));
+}
+
+size_t IdBitset::count() const
+{
+    size_t count = 0;
+    for (const uint64_t word : m_words)
+        count += std::popcount(word);
+    return count;
+}
+
+std::vector<uint32_t> IdBitset::ids(size_t offset, const size_t limit) const
+{
+    std::vector<uint32_t> ids;
+    for (size_t i = 0; i < m_words.size(); ++i) {
+        uint64_t word = m_words[i];
+
+        // whole words are skipped while the offset allows
+        if (const auto bits = static_cast<size_t>(std::popcount(word)); offset >= bits) {
+            offset -= bits;
+            continue;
+        }
+
+        while (word) {
+            const int bit = std::countr_zero(word);
+            word &= word - 1;
+
+            if (offset > 0) {
+                --offset;
+                continue;
+            }
+
+            ids.emplace_back(static_cast<uint32_t>(i * 64 + bit));
+            if (limit > 0 && ids.size() == limit)
+                return ids;
+        }
+    }
+    return ids;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+
+#include <span>
+
+// Case insensitive lookup of names, whole or by any part of them. Substring queries of three
+// characters or more only check the names holding the rarest trigram of the query.
+class NameIndex
+{
+public:
+    void clear();
+    // ids are added in ascending order, an id may come with several names
+    void add(uint32_t id, std::string_view name);
+    bool empty() const { return m_entries.empty(); }
+
+    // ids of the names equal to name, ascending
+    std::span<const uint32_t> find(const std::string& name) const;
+    // ids of the names containing text, ascending and unique, from the offset-th match on (limit 0 = all of them)
+    std::vector<uint32_t> search(const std::string& text, size_t offset = 0, size_t limit = 0) const;
+    size_t count(const std::string& text) const;
+
+private:
+    struct Entry
+    {
+        uint32_t id;
+        std::string name;
+    };
+
+    static uint32_t trigram(const char* str) { return static_cast<uint8_t>(str[0]) << 16 | static_cast<uint8_t>(str[1]) << 8 | static_cast<uint8_t>(str[2]); }
+
+    // calls visit with every matching id in ascending order until it returns false
+    template<typename Visit>
+    void forEachMatch(const std::string& text, Visit&& visit) const;
+
+    std::vector<Entry> m_entries;
+    stdext::map<std::string, std::vector<uint32_t>> m_ids;
+    stdext::map<uint32_t, std::vector<uint32_t>> m_trigrams;
+};
+
+// One bit per id, set for the ids holding some property.
+class IdBitset
+{
+public:
+    void resize(const size_t size) { m_words.assign((size + 63) / 64, 0); }
+    void set(size_t id, bool value);
+    bool test(const size_t id) const { return id / 64 < m_words.size() && (m_words[id / 64] >> (id % 64) & 1); }
+
+    size_t count() const;
+    // set ids in ascending order, from the offset-th on (limit 0 = all of them)
+    std::vector<uint32_t> ids(size_t offset = 0, size_t limit = 0) const;
+
+private:
+    std::vector<uint64_t> m_words;
+};
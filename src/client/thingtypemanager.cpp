@@ -25,15 +25,24 @@
 #include <nlohmann/json.hpp>
 
 #include "game.h"
+#include "gameconfig.h"
+#include "spritemanager.h"
 #include "spriteappearances.h"
 #include "thingtype.h"
+#include "framework/core/asyncdispatcher.h"
 #include "framework/core/filestream.h"
+#include "framework/core/graphicalapplication.h"
+#include "framework/core/mappedfile.h"
 #include "framework/core/resourcemanager.h"
 #include "framework/otml/otmldocument.h"
+#include "framework/util/crypt.h"
 #ifdef FRAMEWORK_PROTOBUF
+#include <google/protobuf/arena.h>
 #include <staticdata.pb.h>
 #endif
 
+#include <fstream>
+
 #ifdef FRAMEWORK_EDITOR
 #include "itemtype.h"
 #include "creatures.h"
@@ -80,12 +89,19 @@ void ThingTypeManager::terminate()
     m_proficienciesFile.clear();
     m_proficiencyThingsCache.clear();
     m_proficiencyThingsCacheDirty = true;
+    m_thingBounds.clear();
+    invalidateThingBounds();
     clearCatalogContent();
+    invalidateThingTypeIndexes();
+    m_monsterRaces.clear();
+    buildRaceIndex();
 
 #ifdef FRAMEWORK_EDITOR
     m_itemTypes.clear();
     m_reverseItemTypes.clear();
     m_nullItemType = nullptr;
+    m_itemTypeNames.clear();
+    m_itemTypeNamesDirty = true;
 #endif
 }
 
@@ -94,6 +110,7 @@ bool ThingTypeManager::loadDat(std::string file)
     m_datLoaded = false;
     m_datSignature = 0;
     m_contentRevision = 0;
+    invalidateThingTypeIndexes();
     try {
         file = g_resources.guessFilePath(file, "dat");
 
@@ -119,6 +136,12 @@ bool ThingTypeManager::loadDat(std::string file)
             }
         }
 
+        // optional table of precomputed frame bounds next to the dat, validated on first use
+        m_thingBounds.clear();
+        invalidateThingBounds();
+        if (const auto& boundsFile = file.substr(0, file.rfind('.')) + ".otbb"; g_resources.fileExists(boundsFile))
+            m_thingBounds.load(boundsFile);
+
         m_datLoaded = true;
         g_lua.callGlobalField("g_things", "onLoadDat", file);
         return true;
@@ -128,8 +151,37 @@ bool ThingTypeManager::loadDat(std::string file)
     }
 }
 
+std::string ThingTypeManager::getThingBoundsKey()
+{
+    if (g_game.isUsingProtobuf())
+        return fmt::format("assets:{}", m_assetIdentifier);
+
+    return fmt::format("dat:{:08x}:spr:{:08x}", m_datSignature, g_sprites.getSignature());
+}
+
+std::span<const ThingBoundsTable::Frame> ThingTypeManager::findThingBounds(const ThingCategory category, const uint16_t id, const uint16_t animationPhase)
+{
+    if (m_thingBounds.empty())
+        return {};
+
+    // the sprites are loaded after the dat, so the table can only be checked once they are in use
+    int8_t valid = m_thingBoundsValid.load(std::memory_order_acquire);
+    if (valid < 0) {
+        valid = m_thingBounds.getAssetKey() == getThingBoundsKey() && m_thingBounds.getSpriteSize() == g_gameConfig.getSpriteSize();
+        if (!valid)
+            g_logger.debug("Ignoring thing bounds generated for other assets ({})", m_thingBounds.getAssetKey());
+        m_thingBoundsValid.store(valid, std::memory_order_release);
+    }
+
+    if (!valid)
+        return {};
+
+    return m_thingBounds.find(category, id, animationPhase);
+}
+
 bool ThingTypeManager::loadOtml(std::string file)
 {
+    invalidateThingTypeIndexes();
     try {
         file = g_resources.guessFilePath(file, "otml");
 
@@ -163,9 +215,91 @@ bool ThingTypeManager::loadOtml(std::string file)
     }
 }
 
+#ifdef FRAMEWORK_PROTOBUF
+namespace {
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x5341544F; // "OTAS"
+    constexpr uint16_t SNAPSHOT_VERSION = 1;
+    constexpr size_t SNAPSHOT_BLOCK_SIZE = 2048;
+    constexpr int APPEARANCES_PER_TASK = 2048;
+
+    // an asset file mapped straight from the disk, or read into memory when it is packed or encrypted
+    struct AssetBuffer
+    {
+        MappedFilePtr mapping;
+        std::string contents;
+
+        const void* data() const { return mapping ? static_cast<const void*>(mapping->data()) : contents.data(); }
+        int size() const { return static_cast<int>(mapping ? mapping->size() : contents.size()); }
+    };
+
+    AssetBuffer readAsset(const std::string& file)
+    {
+        AssetBuffer buffer;
+        if (!g_app.isEncrypted())
+            buffer.mapping = MappedFile::open(g_resources.getRealPath(file));
+        if (!buffer.mapping)
+            buffer.contents = g_resources.readFileContents(file);
+        return buffer;
+    }
+
+    using AppearanceList = google::protobuf::RepeatedPtrField<appearances::Appearance>;
+
+    // the appearances are unserialized in blocks on the async dispatcher and stored by id afterwards in file order,
+    // so a repeated id still ends up with its last appearance
+    void unserializeAppearances(const appearances::Appearances& appearancesLib, ThingTypeList (&thingTypes)[ThingLastCategory], const ThingTypePtr& nullThingType)
+    {
+        const AppearanceList* lists[ThingLastCategory] = { &appearancesLib.object(), &appearancesLib.outfit(), &appearancesLib.effect(), &appearancesLib.missile() };
+        std::vector<ThingTypePtr> types[ThingLastCategory];
+
+        BS::multi_future<void> tasks;
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+            const auto* appearances = lists[category];
+            auto* categoryTypes = &types[category];
+            categoryTypes->resize(appearances->size());
+
+            for (int begin = 0; begin < appearances->size(); begin += APPEARANCES_PER_TASK) {
+                const int end = std::min<int>(begin + APPEARANCES_PER_TASK, appearances->size());
+                tasks.emplace_back(g_asyncDispatcher->submit_task([appearances, categoryTypes, category, begin, end] {
+                    for (int i = begin; i < end; ++i) {
+                        const auto& appearance = appearances->Get(i);
+                        const auto& type = std::make_shared<ThingType>();
+                        type->unserializeAppearance(static_cast<uint16_t>(appearance.id()), static_cast<ThingCategory>(category), appearance);
+                        (*categoryTypes)[i] = type;
+                    }
+                }));
+            }
+        }
+
+        tasks.wait();
+        tasks.get();
+
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+            const auto& appearances = *lists[category];
+
+            // fix for custom asserts, where ids are not sorted.
+            uint32_t lastAppearanceId = 0;
+            for (const auto& appearance : appearances) {
+                if (appearance.id() > lastAppearanceId)
+                    lastAppearanceId = appearance.id();
+            }
+
+            auto& things = thingTypes[category];
+            things.clear();
+            things.resize(lastAppearanceId + 1, nullThingType);
+            for (int i = 0; i < appearances.size(); ++i) {
+                const uint16_t id = appearances.Get(i).id();
+                things[id] = std::move(types[category][i]);
+            }
+        }
+    }
+}
+#endif
+
 bool ThingTypeManager::loadAppearances(const std::string& file)
 {
 #ifdef FRAMEWORK_PROTOBUF
+    invalidateThingTypeIndexes();
+    invalidateThingBounds();
     try {
         try {
             m_assetIdentifier = g_resources.readFileContents(g_resources.resolvePath(g_resources.guessFilePath(file + "assets", "json.sha256")));
@@ -199,48 +333,41 @@ bool ThingTypeManager::loadAppearances(const std::string& file)
             }
             g_spriteAppearances.setSpritesCount(spritesCount + 1);
             g_spriteAppearances.setPath(file);
-            // load appearances.dat
-            std::stringstream fin;
-            g_resources.readFileStream(g_resources.resolvePath(fmt::format("{}{}", file, appearancesFile)), fin);
-            auto appearancesLib = appearances::Appearances();
-            if (!appearancesLib.ParseFromIstream(&fin)) {
-                throw stdext::exception("Couldn't parse appearances lib.");
-            }
-            for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
-                const google::protobuf::RepeatedPtrField<appearances::Appearance>* appearances = nullptr;
-                switch (category) {
-                    case ThingCategoryItem: appearances = &appearancesLib.object(); break;
-                    case ThingCategoryCreature: appearances = &appearancesLib.outfit(); break;
-                    case ThingCategoryEffect: appearances = &appearancesLib.effect(); break;
-                    case ThingCategoryMissile: appearances = &appearancesLib.missile(); break;
-                    default: return false;
-                }
-                // fix for custom asserts, where ids are not sorted.
-                uint32_t lastAppearanceId = 0;
-                for (const auto& appearance : *appearances) {
-                    if (appearance.id() > lastAppearanceId)
-                        lastAppearanceId = appearance.id();
+            const auto& catalogFile = g_resources.resolvePath(g_resources.guessFilePath(file + "catalog-content", "json"));
+            g_spriteAppearances.setCatalogFile(catalogFile);
+            // load appearances.dat, unless the snapshot of the same catalog is around
+            std::filesystem::path snapshotPath;
+            std::string snapshotKey;
+            if (!m_snapshotDir.empty()) {
+                if (const auto& catalogHash = g_resources.fileSha256(catalogFile); !catalogHash.empty()) {
+                    snapshotKey = fmt::format("{}:{}:{}:{}", catalogHash, appearancesFile, g_gameConfig.getSpriteSize(), g_game.getFeature(Otc::GameProficiency));
+                    snapshotPath = getSnapshotPath(snapshotKey);
                 }
-                auto& things = m_thingTypes[category];
-                things.clear();
-                things.resize(lastAppearanceId + 1, m_nullThingType);
-                for (const auto& appearance : *appearances) {
-                    const auto& type = std::make_shared<ThingType>();
-                    const uint16_t id = appearance.id();
-                    type->unserializeAppearance(id, static_cast<ThingCategory>(category), appearance);
-                    m_thingTypes[category][id] = type;
+            }
+
+            if (snapshotKey.empty() || !loadSnapshot(snapshotPath, snapshotKey)) {
+                const auto& buffer = readAsset(g_resources.resolvePath(fmt::format("{}{}", file, appearancesFile)));
+                google::protobuf::Arena arena;
+                auto* appearancesLib = google::protobuf::Arena::Create<appearances::Appearances>(&arena);
+                if (!appearancesLib->ParseFromArray(buffer.data(), buffer.size())) {
+                    throw stdext::exception("Couldn't parse appearances lib.");
                 }
+
+                unserializeAppearances(*appearancesLib, m_thingTypes, m_nullThingType);
+
+                if (!snapshotKey.empty())
+                    saveSnapshot(snapshotPath, snapshotKey);
             }
             m_datLoaded = true;
             m_proficiencyThingsCacheDirty = true;
         } else {
-            std::stringstream datFileStream;
-            auto appearancesLib = appearances::Appearances();
-            g_resources.readFileStream(g_resources.resolvePath(g_resources.guessFilePath(file, "dat")), datFileStream);
-            if (!appearancesLib.ParseFromIstream(&datFileStream)) {
+            const auto& buffer = readAsset(g_resources.resolvePath(g_resources.guessFilePath(file, "dat")));
+            google::protobuf::Arena arena;
+            auto* appearancesLib = google::protobuf::Arena::Create<appearances::Appearances>(&arena);
+            if (!appearancesLib->ParseFromArray(buffer.data(), buffer.size())) {
                 throw stdext::exception("Couldn't parse appearances.dat.");
             }
-            for (const auto& appearance : appearancesLib.object()) {
+            for (const auto& appearance : appearancesLib->object()) {
                 const uint16_t id = appearance.id();
                 if (auto* type = getRawThingType(id, ThingCategoryItem)) {
                     type->applyAppearanceFlags(appearance.flags());
@@ -259,6 +386,197 @@ bool ThingTypeManager::loadAppearances(const std::string& file)
 }
 
 #ifdef FRAMEWORK_PROTOBUF
+std::filesystem::path ThingTypeManager::getSnapshotPath(const std::string& key)
+{
+    std::filesystem::path dir(m_snapshotDir);
+    if (dir.is_relative())
+        dir = std::filesystem::path(g_resources.getWriteDir()) / dir;
+
+    return dir / fmt::format("appearances-{}.otas", g_crypt.sha256(key).substr(0, 16));
+}
+
+bool ThingTypeManager::loadSnapshot(const std::filesystem::path& path, const std::string& key)
+{
+    const auto& file = MappedFile::open(path);
+    if (!file)
+        return false;
+
+    try {
+        const std::string name = path.string();
+        const std::string_view data(reinterpret_cast<const char*>(file->data()), file->size());
+
+        // magic, version, key, the table size of every category and the block count
+        const size_t headerSize = 4 + 2 + 2 + key.size() + 4 * ThingLastCategory + 4;
+        if (data.size() < headerSize)
+            throw Exception("truncated header");
+
+        const auto& header = std::make_shared<FileStream>(name, data.substr(0, headerSize));
+        if (header->getU32() != SNAPSHOT_MAGIC)
+            throw Exception("invalid magic");
+
+        if (const uint16_t version = header->getU16(); version != SNAPSHOT_VERSION)
+            throw Exception("unsupported version {}", version);
+
+        if (header->getString() != key)
+            throw Exception("written for other assets");
+
+        ThingTypeList thingTypes[ThingLastCategory];
+        for (auto& things : thingTypes) {
+            const uint32_t size = header->getU32();
+            if (size == 0 || size > std::numeric_limits<uint16_t>::max() + 1u)
+                throw Exception("invalid table size {}", size);
+            things.resize(size, m_nullThingType);
+        }
+
+        struct Block
+        {
+            uint8_t category;
+            uint32_t count;
+            std::string_view data;
+        };
+
+        const uint32_t blockCount = header->getU32();
+        if (blockCount == 0)
+            throw Exception("no appearances");
+
+        const size_t tableSize = static_cast<size_t>(blockCount) * 9;
+        if (data.size() < headerSize + tableSize)
+            throw Exception("truncated block table");
+
+        const auto& table = std::make_shared<FileStream>(name, data.substr(headerSize, tableSize));
+        size_t offset = headerSize + tableSize;
+
+        std::vector<Block> blocks(blockCount);
+        for (auto& block : blocks) {
+            block.category = table->getU8();
+            block.count = table->getU32();
+            const uint32_t size = table->getU32();
+            if (block.category >= ThingLastCategory || size == 0 || offset + size > data.size())
+                throw Exception("invalid block");
+
+            block.data = data.substr(offset, size);
+            offset += size;
+        }
+
+        if (offset != data.size())
+            throw Exception("trailing data");
+
+        // every block holds its own ids, so they are restored side by side
+        BS::multi_future<void> tasks;
+        for (const auto& block : blocks) {
+            tasks.emplace_back(g_asyncDispatcher->submit_task([&name, &block, things = &thingTypes[block.category]] {
+                const auto& fin = std::make_shared<FileStream>(name, block.data);
+                for (uint32_t i = 0; i < block.count; ++i) {
+                    const uint16_t id = fin->getU16();
+                    if (id >= things->size())
+                        throw Exception("id {} out of range", id);
+
+                    const auto& type = std::make_shared<ThingType>();
+                    type->unserializeSnapshot(id, static_cast<ThingCategory>(block.category), fin);
+                    (*things)[id] = type;
+                }
+            }));
+        }
+
+        tasks.wait();
+        tasks.get();
+
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category)
+            m_thingTypes[category] = std::move(thingTypes[category]);
+
+        return true;
+    } catch (const std::exception& e) {
+        g_logger.warning("Unable to load appearance snapshot '{}': {}", path.string(), e.what());
+        return false;
+    }
+}
+
+void ThingTypeManager::saveSnapshot(const std::filesystem::path& path, const std::string& key)
+{
+    try {
+        struct Block
+        {
+            uint8_t category;
+            size_t begin;
+            size_t end;
+            uint32_t count{ 0 };
+            FileStreamPtr out;
+        };
+
+        std::vector<Block> blocks;
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+            const size_t size = m_thingTypes[category].size();
+            if (size > std::numeric_limits<uint16_t>::max() + 1u)
+                throw Exception("too many {} ids", size);
+
+            for (size_t begin = 0; begin < size; begin += SNAPSHOT_BLOCK_SIZE)
+                blocks.push_back({ .category = static_cast<uint8_t>(category), .begin = begin, .end = std::min(begin + SNAPSHOT_BLOCK_SIZE, size) });
+        }
+
+        BS::multi_future<void> tasks;
+        for (auto& block : blocks) {
+            tasks.emplace_back(g_asyncDispatcher->submit_task([&block, &things = m_thingTypes[block.category]] {
+                block.out = std::make_shared<FileStream>("appearance snapshot", nullptr, true);
+                block.out->cache();
+                for (size_t id = block.begin; id < block.end; ++id) {
+                    const auto& type = things[id];
+                    if (type->isNull())
+                        continue;
+
+                    block.out->addU16(static_cast<uint16_t>(id));
+                    type->serializeSnapshot(block.out);
+                    ++block.count;
+                }
+            }));
+        }
+
+        tasks.wait();
+        tasks.get();
+
+        std::erase_if(blocks, [](const Block& block) { return block.count == 0; });
+
+        const auto& out = std::make_shared<FileStream>("appearance snapshot", nullptr, true);
+        out->cache();
+        out->addU32(SNAPSHOT_MAGIC);
+        out->addU16(SNAPSHOT_VERSION);
+        out->addString(key);
+        for (const auto& things : m_thingTypes)
+            out->addU32(static_cast<uint32_t>(things.size()));
+
+        out->addU32(static_cast<uint32_t>(blocks.size()));
+        for (const auto& block : blocks) {
+            out->addU8(block.category);
+            out->addU32(block.count);
+            out->addU32(static_cast<uint32_t>(block.out->m_data.size()));
+        }
+        for (const auto& block : blocks)
+            out->write(block.out->m_data.data(), static_cast<uint32_t>(block.out->m_data.size()));
+
+        const auto& dir = path.parent_path();
+        std::filesystem::create_directories(dir);
+
+        // snapshots of other assets are not read again
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            std::error_code ec;
+            if (entry.path().extension() == ".otas" && entry.path() != path)
+                std::filesystem::remove(entry.path(), ec);
+        }
+
+        // written aside first, a client killed halfway must not leave a truncated snapshot behind
+        auto tmpPath = path;
+        tmpPath += ".tmp";
+        {
+            std::ofstream fout(tmpPath, std::ios::binary | std::ios::trunc);
+            fout.write(reinterpret_cast<const char*>(out->m_data.data()), static_cast<std::streamsize>(out->m_data.size()));
+            if (!fout.good())
+                throw Exception("write failed");
+        }
+        std::filesystem::rename(tmpPath, path);
+    } catch (const std::exception& e) {
+        g_logger.warning("Unable to save appearance snapshot '{}': {}", path.string(), e.what());
+    }
+}
+
 namespace {
     using RaceBank = google::protobuf::RepeatedPtrField<staticdata::Creature>;
 
@@ -308,18 +626,19 @@ bool ThingTypeManager::loadStaticData(const std::string& file)
         }
 
         // load staticdata.dat
-        std::stringstream datFileStream;
-        g_resources.readFileStream(g_resources.resolvePath(fmt::format("{}{}", file, staticDataFile)), datFileStream);
-        auto staticDataLib = staticdata::Staticdata();
-        if (!staticDataLib.ParseFromIstream(&datFileStream)) {
+        const auto& buffer = readAsset(g_resources.resolvePath(fmt::format("{}{}", file, staticDataFile)));
+        google::protobuf::Arena arena;
+        auto* staticDataLib = google::protobuf::Arena::Create<staticdata::Staticdata>(&arena);
+        if (!staticDataLib->ParseFromArray(buffer.data(), buffer.size())) {
             throw stdext::exception("Couldn't parse staticdata lib.");
         }
 
         // if reload, start again
         m_monsterRaces.clear();
+        buildRaceIndex();
 
-        const auto& raceBank = staticDataLib.monsters();
-        const auto& bossBank = staticDataLib.bosses();
+        const auto& raceBank = staticDataLib->monsters();
+        const auto& bossBank = staticDataLib->bosses();
         m_monsterRaces.reserve(static_cast<size_t>(raceBank.size()) + bossBank.size());
 
         // load monsters and bosses
@@ -328,6 +647,7 @@ bool ThingTypeManager::loadStaticData(const std::string& file)
         // in separate data banks
         loadCreatureBank(m_monsterRaces, raceBank, false);
         loadCreatureBank(m_monsterRaces, bossBank, true);
+        buildRaceIndex();
         return true;
     } catch (const std::exception& e) {
         g_logger.error("Failed to load '{}' (StaticData): {}", file, e.what());
@@ -405,15 +725,125 @@ ThingType* ThingTypeManager::getRawThingType(uint16_t id, ThingCategory category
     return m_thingTypes[category][id].get();
 }
 
-ThingTypeList ThingTypeManager::findThingTypeByAttr(const ThingAttr attr, const ThingCategory category)
+ThingTypeManager::ThingTypeIndex& ThingTypeManager::getThingTypeIndex(const ThingCategory category)
+{
+    auto& index = m_thingTypeIndexes[category];
+    if (index.built)
+        return index;
+
+    // the cyclopedia and the market show the market name, the name is kept searchable when it differs
+    const auto& things = m_thingTypes[category];
+    for (uint32_t id = 0; id < things.size(); ++id) {
+        const auto& type = things[id];
+        if (type->isNull())
+            continue;
+
+        const auto& name = type->getName();
+        if (!name.empty())
+            index.names.add(id, name);
+
+        if (const auto& marketName = type->getMarketData().name; !marketName.empty() && marketName != name)
+            index.names.add(id, marketName);
+    }
+
+    index.built = true;
+    return index;
+}
+
+const IdBitset& ThingTypeManager::getAttrIndex(const ThingAttr attr, const ThingCategory category)
+{
+    static const IdBitset emptyIds;
+    if (category >= ThingLastCategory)
+        return emptyIds;
+
+    // one pass over the category the first time an attribute is asked for
+    auto& index = getThingTypeIndex(category);
+    auto [it, inserted] = index.attrs.try_emplace(static_cast<uint8_t>(attr));
+    if (inserted) {
+        const auto& things = m_thingTypes[category];
+        it->second.resize(things.size());
+        for (size_t id = 0; id < things.size(); ++id) {
+            if (things[id]->hasAttr(attr))
+                it->second.set(id, true);
+        }
+    }
+    return it->second;
+}
+
+void ThingTypeManager::invalidateThingTypeIndexes()
+{
+    for (auto& index : m_thingTypeIndexes) {
+        index.built = false;
+        index.names.clear();
+        index.attrs.clear();
+    }
+}
+
+void ThingTypeManager::updateThingTypeIndex(ThingType* type)
+{
+    const auto category = type->getCategory();
+    if (category >= ThingLastCategory)
+        return;
+
+    const uint16_t id = type->getId();
+    if (id >= m_thingTypes[category].size() || m_thingTypes[category][id].get() != type)
+        return;
+
+    for (auto& [attr, ids] : m_thingTypeIndexes[category].attrs)
+        ids.set(id, type->hasAttr(static_cast<ThingAttr>(attr)));
+}
+
+ThingTypeList ThingTypeManager::toThingTypes(const ThingCategory category, const std::vector<uint32_t>& ids)
 {
     ThingTypeList ret;
-    for (const auto& type : m_thingTypes[category])
-        if (type->hasAttr(attr))
-            ret.emplace_back(type);
+    ret.reserve(ids.size());
+    for (const uint32_t id : ids)
+        ret.emplace_back(m_thingTypes[category][id]);
     return ret;
 }
 
+ThingTypeList ThingTypeManager::findThingTypeByAttr(const ThingAttr attr, const ThingCategory category)
+{
+    return findThingTypeByAttrPage(attr, category, 0, 0);
+}
+
+ThingTypeList ThingTypeManager::findThingTypeByAttrPage(const ThingAttr attr, const ThingCategory category, const uint32_t offset, const uint32_t limit)
+{
+    return toThingTypes(category, getAttrIndex(attr, category).ids(offset, limit));
+}
+
+uint32_t ThingTypeManager::countThingTypesByAttr(const ThingAttr attr, const ThingCategory category)
+{
+    return static_cast<uint32_t>(getAttrIndex(attr, category).count());
+}
+
+const ThingTypePtr& ThingTypeManager::findThingTypeByName(const std::string& name, const ThingCategory category)
+{
+    if (category >= ThingLastCategory)
+        return m_nullThingType;
+
+    const auto ids = getThingTypeIndex(category).names.find(name);
+    if (ids.empty())
+        return m_nullThingType;
+    return m_thingTypes[category][ids.front()];
+}
+
+ThingTypeList ThingTypeManager::findThingTypesByString(const std::string& text, const ThingCategory category, const uint32_t offset, const uint32_t limit)
+{
+    if (category >= ThingLastCategory)
+        return {};
+
+    return toThingTypes(category, getThingTypeIndex(category).names.search(text, offset, limit));
+}
+
+uint32_t ThingTypeManager::countThingTypesByString(const std::string& text, const ThingCategory category)
+{
+    if (category >= ThingLastCategory)
+        return 0;
+
+    return static_cast<uint32_t>(getThingTypeIndex(category).names.count(text));
+}
+
 void ThingTypeManager::buildProficiencyCache()
 {
     m_proficiencyThingsCache.clear();
@@ -454,28 +884,54 @@ std::string ThingTypeManager::getProficienciesFile()
     return "";
 }
 
-const RaceType& ThingTypeManager::getRaceData(uint32_t raceId)
+void ThingTypeManager::buildRaceIndex()
 {
-    for (const auto& raceData : m_monsterRaces) {
-        if (raceData.raceId == raceId) {
-            return raceData;
-        }
+    m_raceNames.clear();
+    m_racePositions.clear();
+    m_racePositions.reserve(m_monsterRaces.size());
+
+    for (uint32_t i = 0; i < m_monsterRaces.size(); ++i) {
+        const auto& race = m_monsterRaces[i];
+        // a race listed twice resolves to its first entry
+        m_racePositions.try_emplace(race.raceId, i);
+        m_raceNames.add(i, race.name);
     }
+}
+
+const RaceType& ThingTypeManager::getRaceData(uint32_t raceId)
+{
+    const auto it = m_racePositions.find(raceId);
+    if (it == m_racePositions.end())
+        return emptyRaceType;
 
-    return emptyRaceType;
+    return m_monsterRaces[it->second];
 }
 
 RaceList ThingTypeManager::getRacesByName(const std::string& searchString)
 {
+    // the index matches regardless of case, this lookup never did
     RaceList result;
-    for (const auto& race : m_monsterRaces) {
-        if (race.name.find(searchString) != std::string::npos) {
-            result.push_back(race);
+    for (const uint32_t i : m_raceNames.search(searchString)) {
+        if (m_monsterRaces[i].name.find(searchString) != std::string::npos) {
+            result.push_back(m_monsterRaces[i]);
         }
     }
     return result;
 }
 
+RaceList ThingTypeManager::getRacesByNamePage(const std::string& searchString, const uint32_t offset, const uint32_t limit)
+{
+    RaceList result;
+    for (const uint32_t i : m_raceNames.search(searchString, offset, limit))
+        result.push_back(m_monsterRaces[i]);
+    return result;
+}
+
+uint32_t ThingTypeManager::countRacesByName(const std::string& searchString)
+{
+    return static_cast<uint32_t>(m_raceNames.count(searchString));
+}
+
 #ifdef FRAMEWORK_EDITOR
 void ThingTypeManager::parseItemType(uint16_t serverId, pugi::xml_node node)
 {
@@ -538,6 +994,20 @@ void ThingTypeManager::addItemType(const ItemTypePtr& itemType)
     if (unlikely(id >= m_itemTypes.size()))
         m_itemTypes.resize(id + 1, m_nullItemType);
     m_itemTypes[id] = itemType;
+    m_itemTypeNamesDirty = true;
+}
+
+const NameIndex& ThingTypeManager::getItemTypeNames()
+{
+    if (m_itemTypeNamesDirty) {
+        m_itemTypeNames.clear();
+        for (uint32_t id = 0; id < m_itemTypes.size(); ++id) {
+            if (m_itemTypes[id] != m_nullItemType)
+                m_itemTypeNames.add(id, m_itemTypes[id]->getName());
+        }
+        m_itemTypeNamesDirty = false;
+    }
+    return m_itemTypeNames;
 }
 
 const ItemTypePtr& ThingTypeManager::findItemTypeByClientId(uint16_t id)
@@ -550,29 +1020,30 @@ const ItemTypePtr& ThingTypeManager::findItemTypeByClientId(uint16_t id)
     return m_nullItemType;
 }
 
+// the name index ignores case, these lookups keep comparing it
 const ItemTypePtr& ThingTypeManager::findItemTypeByName(const std::string& name)
 {
-    for (const ItemTypePtr& it : m_itemTypes)
-        if (it->getName() == name)
-            return it;
+    for (const uint32_t id : getItemTypeNames().find(name))
+        if (m_itemTypes[id]->getName() == name)
+            return m_itemTypes[id];
     return m_nullItemType;
 }
 
 ItemTypeList ThingTypeManager::findItemTypesByName(const std::string& name)
 {
     ItemTypeList ret;
-    for (const ItemTypePtr& it : m_itemTypes)
-        if (it->getName() == name)
-            ret.emplace_back(it);
+    for (const uint32_t id : getItemTypeNames().find(name))
+        if (m_itemTypes[id]->getName() == name)
+            ret.emplace_back(m_itemTypes[id]);
     return ret;
 }
 
 ItemTypeList ThingTypeManager::findItemTypesByString(const std::string& name)
 {
     ItemTypeList ret;
-    for (const ItemTypePtr& it : m_itemTypes)
-        if (it->getName().find(name) != std::string::npos)
-            ret.emplace_back(it);
+    for (const uint32_t id : getItemTypeNames().search(name))
+        if (m_itemTypes[id]->getName().find(name) != std::string::npos)
+            ret.emplace_back(m_itemTypes[id]);
     return ret;
 }
 
@@ -721,6 +1192,7 @@ void ThingTypeManager::loadXml(const std::string& file)
         }
 
         m_xmlLoaded = true;
+        m_itemTypeNamesDirty = true;
         g_logger.debug("Items.xml read successfully.");
     } catch (const std::exception& e) {
         g_logger.error("Failed to load '{}' (XML file): {}", file, e.what());
@@ -22,9 +22,13 @@
 
 #pragma once
 
+#include <filesystem>
+
 #include <nlohmann/json_fwd.hpp>
 
 #include "staticdata.h"
+#include "thingbounds.h"
+#include "thingtypeindex.h"
 
 using RaceList = std::vector<RaceType>;
 static const RaceType emptyRaceType{};
@@ -41,6 +45,11 @@ public:
     bool loadStaticData(const std::string& file);
     bool resolveProficienciesFile(const std::string& file);
 
+    // directory of the appearance snapshot, a flat copy of the tables loadAppearances rebuilt from protobuf that the next
+    // start with the same catalog reads back instead, relative to the write dir unless absolute, empty disables it
+    void setSnapshotDir(const std::string& dir) { m_snapshotDir = dir; }
+    const std::string& getSnapshotDir() { return m_snapshotDir; }
+
 #ifdef FRAMEWORK_EDITOR
     void parseItemType(uint16_t id, pugi::xml_node node);
     void loadOtb(const std::string& file);
@@ -64,6 +73,15 @@ public:
 #endif
 
     ThingTypeList findThingTypeByAttr(ThingAttr attr, ThingCategory category);
+    // paged lookups answer in ascending id order, from the offset-th match on and at most limit of them (0 = all)
+    ThingTypeList findThingTypeByAttrPage(ThingAttr attr, ThingCategory category, uint32_t offset, uint32_t limit);
+    uint32_t countThingTypesByAttr(ThingAttr attr, ThingCategory category);
+    // case insensitive, against the name and the market name of the types
+    const ThingTypePtr& findThingTypeByName(const std::string& name, ThingCategory category);
+    ThingTypeList findThingTypesByString(const std::string& text, ThingCategory category, uint32_t offset, uint32_t limit);
+    uint32_t countThingTypesByString(const std::string& text, ThingCategory category);
+    // keeps the indexes in step with a type changed after loading
+    void updateThingTypeIndex(ThingType* type);
     const ThingTypeList& getProficiencyThings();
     std::string getCyclopediaItemName(uint16_t id);
     std::string getProficienciesFile();
@@ -71,6 +89,9 @@ public:
     const RaceType& getRaceData(uint32_t raceId);
     const RaceList& getAllRaces() const { return m_monsterRaces; }
     RaceList getRacesByName(const std::string& searchString);
+    // case insensitive, paged like the thing type lookups
+    RaceList getRacesByNamePage(const std::string& searchString, uint32_t offset, uint32_t limit);
+    uint32_t countRacesByName(const std::string& searchString);
 
     const ThingTypePtr& getNullThingType() { return m_nullThingType; }
 
@@ -83,6 +104,13 @@ public:
     uint16_t getContentRevision() { return m_contentRevision; }
     const std::string& getAssetIdentifier() { return m_assetIdentifier; }
 
+    // frame bounds precomputed for the loaded assets, empty when there are none or they belong to other assets
+    std::span<const ThingBoundsTable::Frame> findThingBounds(ThingCategory category, uint16_t id, uint16_t animationPhase);
+    std::string getThingBoundsKey();
+    // the table is checked again and the bounds kept by the thing types are dropped, on every asset or sprite load
+    void invalidateThingBounds() { m_thingBoundsValid = -1; ++m_thingBoundsRevision; }
+    uint32_t getThingBoundsRevision() const { return m_thingBoundsRevision.load(std::memory_order_acquire); }
+
     bool isDatLoaded() { return m_datLoaded; }
     bool isValidDatId(const uint16_t id, const ThingCategory category) const { return category < ThingLastCategory && id >= 1 && id < m_thingTypes[category].size(); }
 
@@ -91,8 +119,29 @@ private:
     void clearCatalogContent();
     void buildProficiencyCache();
 
+    // built on the first lookup after a load, dropped by the next one
+    struct ThingTypeIndex
+    {
+        bool built{ false };
+        NameIndex names;
+        stdext::map<uint8_t, IdBitset> attrs;
+    };
+
+    ThingTypeIndex& getThingTypeIndex(ThingCategory category);
+    const IdBitset& getAttrIndex(ThingAttr attr, ThingCategory category);
+    void invalidateThingTypeIndexes();
+    void buildRaceIndex();
+    ThingTypeList toThingTypes(ThingCategory category, const std::vector<uint32_t>& ids);
+
+    std::filesystem::path getSnapshotPath(const std::string& key);
+    bool loadSnapshot(const std::filesystem::path& path, const std::string& key);
+    void saveSnapshot(const std::filesystem::path& path, const std::string& key);
+
     ThingTypeList m_thingTypes[ThingLastCategory];
     RaceList m_monsterRaces;
+    NameIndex m_raceNames;
+    stdext::map<uint32_t, uint32_t> m_racePositions;
+    ThingTypeIndex m_thingTypeIndexes[ThingLastCategory];
 
     ThingTypePtr m_nullThingType;
 
@@ -103,14 +152,22 @@ private:
     std::string m_assetIdentifier;
     std::string m_proficienciesFile;
     std::string m_catalogContentPath;
+    std::string m_snapshotDir;
     std::unique_ptr<nlohmann::json> m_catalogContent;
+    ThingBoundsTable m_thingBounds;
+    std::atomic<int8_t> m_thingBoundsValid{ -1 };
+    std::atomic_uint32_t m_thingBoundsRevision{ 1 };
     ThingTypeList m_proficiencyThingsCache;
     bool m_proficiencyThingsCacheDirty{ true };
 
 #ifdef FRAMEWORK_EDITOR
+    const NameIndex& getItemTypeNames();
+
     ItemTypePtr m_nullItemType;
     ItemTypeList m_reverseItemTypes;
     ItemTypeList m_itemTypes;
+    NameIndex m_itemTypeNames;
+    bool m_itemTypeNamesDirty{ true };
     uint32_t m_otbMinorVersion{ 0 };
     uint32_t m_otbMajorVersion{ 0 };
     bool m_xmlLoaded{ false };
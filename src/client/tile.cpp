@@ -254,6 +254,8 @@ void Tile::clean()
     m_firstCreatureIndex = -1;
     m_lastCreatureIndex = -1;
 
+    g_map.updateTileSight(*this);
+
 #ifdef FRAMEWORK_EDITOR
     m_flags = 0;
 #endif
@@ -371,6 +373,7 @@ void Tile::addThing(const ThingPtr& thing, int stackPos)
 
     updateElevation(thing, m_drawElevation);
     checkForDetachableThing();
+    g_map.updateTileSight(*this);
 
     if (g_game.isTileThingLuaCallbackEnabled())
         callLuaField("onAddThing", thing);
@@ -416,6 +419,7 @@ bool Tile::removeThing(const ThingPtr thing)
             updateElevation(t, m_drawElevation);
     }
 
+    g_map.updateTileSight(*this);
     thing->onDisappear();
 
     if (g_game.isTileThingLuaCallbackEnabled())
@@ -72,10 +72,10 @@ public:
     std::string getBuildCommit();
     std::string getOs();
     std::string getStartupOptions() { return m_startupOptions; }
-
-protected:
+    // also used by tools that set up the Lua state without a full init()
     void registerLuaFunctions();
 
+protected:
     std::string m_charset{ "cp1252" };
     std::string m_organizationName{ "otbr" };
     std::string m_appName{ "OTClient - Redemption" };
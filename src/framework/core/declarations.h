@@ -36,6 +36,7 @@ class Config;
 class Event;
 class ScheduledEvent;
 class FileStream;
+class MappedFile;
 class BinaryTree;
 class OutputBinaryTree;
 class ApplicationDrawEvents;
@@ -46,6 +47,7 @@ using EventPtr = std::shared_ptr<Event>;
 using ScheduledEventPtr = std::shared_ptr<ScheduledEvent>;
 
 using FileStreamPtr = std::shared_ptr<FileStream>;
+using MappedFilePtr = std::shared_ptr<MappedFile>;
 using BinaryTreePtr = std::shared_ptr<BinaryTree>;
 using OutputBinaryTreePtr = std::shared_ptr<OutputBinaryTree>;
 
@@ -32,7 +32,7 @@ public:
     ~Event() override;
 
     virtual void execute();
-    void cancel();
+    virtual void cancel();
 
     bool isCanceled() { return m_canceled; }
     bool isExecuted() { return m_executed; }
@@ -21,6 +21,7 @@
  */
 
 #include "asyncdispatcher.h"
+#include "clock.h"
 #include "eventdispatcher.h"
 #include <framework/util/stats.h>
 
@@ -43,7 +44,7 @@ void EventDispatcher::shutdown()
         mergeEvents();
     } while (!m_eventList.empty());
 
-    m_scheduledEventList.clear();
+    m_scheduledEvents.clear();
     m_deferEventList.clear();
     m_threads.clear();
 
@@ -52,7 +53,7 @@ void EventDispatcher::shutdown()
 
 void EventDispatcher::poll()
 {
-    AutoStat s(this == &g_dispatcher ? STATS_MAIN : STATS_RENDER, "PollDispatcher");
+    AutoStat s(this == &g_dispatcher ? TRACE_ZONE(STATS_MAIN, "PollDispatcher") : TRACE_ZONE(STATS_RENDER, "PollDispatcher"));
     mergeEvents();
     executeEvents();
     executeScheduledEvents();
@@ -67,12 +68,12 @@ ScheduledEventPtr EventDispatcher::scheduleEvent(const std::function<void()>& ca
 ScheduledEventPtr EventDispatcher::scheduleEventEx(const std::string& function, const std::function<void()>& callback, int delay)
 {
     if (m_disabled)
-        return std::make_shared<ScheduledEvent>(function, nullptr, delay, 1);
+        return ScheduledEvent::create(function, nullptr, delay, 1);
 
     assert(delay >= 0);
 
     return pushThreadTask<ScheduledEventPtr>([&](const std::unique_ptr<ThreadTask>& thread) {
-        return thread->scheduledEventList.emplace_back(std::make_shared<ScheduledEvent>(function, callback, delay, 1));
+        return thread->scheduledEventList.emplace_back(ScheduledEvent::create(function, callback, delay, 1));
     });
 }
 
@@ -84,12 +85,12 @@ ScheduledEventPtr EventDispatcher::cycleEvent(const std::function<void()>& callb
 ScheduledEventPtr EventDispatcher::cycleEventEx(const std::string& function, const std::function<void()>& callback, int delay)
 {
     if (m_disabled)
-        return std::make_shared<ScheduledEvent>(function, nullptr, delay, 0);
+        return ScheduledEvent::create(function, nullptr, delay, 0);
 
     assert(delay > 0);
 
     return pushThreadTask<ScheduledEventPtr>([&](const std::unique_ptr<ThreadTask>& thread) {
-        return thread->scheduledEventList.emplace_back(std::make_shared<ScheduledEvent>(function, callback, delay, 0));
+        return thread->scheduledEventList.emplace_back(ScheduledEvent::create(function, callback, delay, 0));
     });
 }
 
@@ -169,30 +170,23 @@ void EventDispatcher::executeDeferEvents() {
 }
 
 void EventDispatcher::executeScheduledEvents() {
-    auto& threadScheduledTasks = getThreadTask()->scheduledEventList;
-
-    auto it = m_scheduledEventList.begin();
-    while (it != m_scheduledEventList.end()) {
-        const auto& scheduledEvent = *it;
-        if (scheduledEvent->remainingTicks() > 0)
-            break;
+    m_scheduledEvents.advance(g_clock.millis(), m_expiredEvents);
+    if (m_expiredEvents.empty())
+        return;
 
+    for (const auto& scheduledEvent : m_expiredEvents) {
         dispacherContext.type = scheduledEvent->maxCycles() > 0 ? DispatcherType::CycleEvent : DispatcherType::ScheduledEvent;
         dispacherContext.group = TaskGroup::Serial;
 
         AutoStat s(STATS_DISPATCHER, scheduledEvent->getFunction());
         scheduledEvent->execute();
 
+        // next cycles are never due before the next advance, so they cannot run twice in this poll
         if (scheduledEvent->nextCycle())
-            threadScheduledTasks.emplace_back(scheduledEvent);
-
-        ++it;
-    }
-
-    if (it != m_scheduledEventList.begin()) {
-        m_scheduledEventList.erase(m_scheduledEventList.begin(), it);
+            m_scheduledEvents.insert(scheduledEvent);
     }
 
+    m_expiredEvents.clear();
     dispacherContext.reset();
 }
 
@@ -210,7 +204,11 @@ void EventDispatcher::mergeEvents() {
         }
 
         if (!thread->scheduledEventList.empty()) {
-            m_scheduledEventList.insert(make_move_iterator(thread->scheduledEventList.begin()), make_move_iterator(thread->scheduledEventList.end()));
+            for (const auto& scheduledEvent : thread->scheduledEventList) {
+                // canceled before ever reaching the wheel
+                if (!scheduledEvent->isCanceled())
+                    m_scheduledEvents.insert(scheduledEvent);
+            }
             thread->scheduledEventList.clear();
         }
     }
@@ -150,7 +150,8 @@ private:
     // Main Events
     std::vector<EventPtr> m_eventList;
     std::vector<Event> m_deferEventList;
-    phmap::btree_multiset<ScheduledEventPtr, ScheduledEvent::Compare> m_scheduledEventList;
+    TimingWheel m_scheduledEvents;
+    std::vector<ScheduledEventPtr> m_expiredEvents;
 };
 
 extern EventDispatcher g_dispatcher, g_textDispatcher, g_mainDispatcher;
@@ -151,7 +151,7 @@ void GraphicalApplication::mainLoop() {
     };
 
     {
-        AutoStat s(STATS_RENDER, "DrawPool");
+        AutoStat s(TRACE_ZONE(STATS_RENDER, "DrawPool"));
         g_drawPool.draw();
     }
 
@@ -205,6 +205,7 @@ void GraphicalApplication::run()
         BS::multi_future<void> tasks;
 
         g_luaThreadId = g_eventThreadId = stdext::getThreadId();
+        g_tracer.setThreadName("Map");
         while (!m_stopping) {
             poll();
 
@@ -214,19 +215,19 @@ void GraphicalApplication::run()
             }
 
             if (g_game.isOnline()) {
-                AutoStat s(STATS_RENDER, "DrawPreload");
+                AutoStat s(TRACE_ZONE(STATS_RENDER, "DrawPreload"));
                 m_drawEvents->preLoad();
             }
 
             bool canDrawForeground = !g_drawPool.isDrawing(DrawPoolType::FOREGROUND) && m_drawEvents->canDraw(DrawPoolType::FOREGROUND);
 
             if (!g_game.isOnline() && canDrawForeground) {
-                AutoStat s(STATS_RENDER, "DrawForegroundUI");
+                AutoStat s(TRACE_ZONE(STATS_RENDER, "DrawForegroundUI"));
                 g_ui.render(DrawPoolType::FOREGROUND);
             } else if (canDrawMap()) {
                 if (canDrawForeground) {
                     tasks.emplace_back(g_asyncDispatcher->submit_task([] {
-                        AutoStat s(STATS_RENDER, "DrawForegroundUI");
+                        AutoStat s(TRACE_ZONE(STATS_RENDER, "DrawForegroundUI"));
                         g_ui.render(DrawPoolType::FOREGROUND);
                     }));
                 }
@@ -235,14 +236,14 @@ void GraphicalApplication::run()
                 for (const auto type : types) {
                     if (m_drawEvents->canDraw(type)) {
                         tasks.emplace_back(g_asyncDispatcher->submit_task([this, type] {
-                            AutoStat s(STATS_RENDER, type == DrawPoolType::LIGHT ? "DrawLight" : "DrawForegroundMap");
+                            AutoStat s(type == DrawPoolType::LIGHT ? TRACE_ZONE(STATS_RENDER, "DrawLight") : TRACE_ZONE(STATS_RENDER, "DrawForegroundMap"));
                             m_drawEvents->draw(type);
                         }));
                     }
                 }
 
                 {
-                    AutoStat s(STATS_RENDER, "DrawMap");
+                    AutoStat s(TRACE_ZONE(STATS_RENDER, "DrawMap"));
                     m_drawEvents->draw(DrawPoolType::MAP);
                 }
 
@@ -268,13 +269,13 @@ void GraphicalApplication::run()
         }
 
         {
-            AutoStat s(STATS_RENDER, "DrawPool");
+            AutoStat s(TRACE_ZONE(STATS_RENDER, "DrawPool"));
             g_drawPool.draw();
         }
 
         // update screen pixels
         {
-            AutoStat s(STATS_RENDER, "SwapBuffers");
+            AutoStat s(TRACE_ZONE(STATS_RENDER, "SwapBuffers"));
             g_window.swapBuffers();
         }
 
@@ -311,21 +312,21 @@ void GraphicalApplication::poll()
 }
 void GraphicalApplication::mainPoll()
 {
-    AutoStat s(STATS_MAIN, "MainPoll");
+    AutoStat s(TRACE_ZONE(STATS_MAIN, "MainPoll"));
     {
-        AutoStat s2(STATS_MAIN, "ClockUpdate");
+        AutoStat s2(TRACE_ZONE(STATS_MAIN, "ClockUpdate"));
         g_clock.update();
     }
     {
-        AutoStat s2(STATS_MAIN, "DispatcherPoll");
+        AutoStat s2(TRACE_ZONE(STATS_MAIN, "DispatcherPoll"));
         g_mainDispatcher.poll();
     }
     {
-        AutoStat s2(STATS_MAIN, "WindowPoll");
+        AutoStat s2(TRACE_ZONE(STATS_MAIN, "WindowPoll"));
         g_window.poll();
     }
     {
-        AutoStat s2(STATS_MAIN, "TexturePoll");
+        AutoStat s2(TRACE_ZONE(STATS_MAIN, "TexturePoll"));
         g_textures.poll();
     }
 }
@@ -24,10 +24,99 @@
 
 #include "clock.h"
 
+#include <framework/util/spinlock.h>
+
+namespace
+{
+    // free list of same sized blocks, never destroyed so events released during static destruction stay valid
+    template<size_t Size, size_t Align>
+    class BlockPool
+    {
+    public:
+        static BlockPool& instance()
+        {
+            static auto* pool = new BlockPool;
+            return *pool;
+        }
+
+        void* acquire()
+        {
+            {
+                SpinLock::Guard guard(m_lock);
+                if (!m_free.empty()) {
+                    void* block = m_free.back();
+                    m_free.pop_back();
+                    return block;
+                }
+            }
+            return ::operator new(Size, std::align_val_t{ Align });
+        }
+
+        void release(void* block)
+        {
+            {
+                SpinLock::Guard guard(m_lock);
+                if (m_free.size() < MAX_FREE_BLOCKS) {
+                    m_free.emplace_back(block);
+                    return;
+                }
+            }
+            ::operator delete(block, std::align_val_t{ Align });
+        }
+
+    private:
+        static constexpr size_t MAX_FREE_BLOCKS = 8192;
+
+        SpinLock m_lock;
+        std::vector<void*> m_free;
+    };
+
+    template<typename T>
+    struct PoolAllocator
+    {
+        using value_type = T;
+
+        PoolAllocator() = default;
+        template<typename U>
+        PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+        T* allocate(const size_t n)
+        {
+            if (n != 1)
+                return std::allocator<T>{}.allocate(n);
+            return static_cast<T*>(BlockPool<sizeof(T), alignof(T)>::instance().acquire());
+        }
+
+        void deallocate(T* ptr, const size_t n) noexcept
+        {
+            if (n != 1)
+                return std::allocator<T>{}.deallocate(ptr, n);
+            BlockPool<sizeof(T), alignof(T)>::instance().release(ptr);
+        }
+
+        template<typename U>
+        bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    };
+}
+
 ScheduledEvent::ScheduledEvent(const std::string& function, const std::function<void()>& callback, const int delay, const int maxCycles) :
     Event(callback, function),
     m_ticks(g_clock.millis() + delay), m_delay(delay), m_maxCycles(maxCycles) {}
 
+ScheduledEventPtr ScheduledEvent::create(const std::string& function, const std::function<void()>& callback, const int delay, const int maxCycles)
+{
+    return std::allocate_shared<ScheduledEvent>(PoolAllocator<ScheduledEvent>(), function, callback, delay, maxCycles);
+}
+
+void ScheduledEvent::cancel()
+{
+    Event::cancel();
+
+    // drop out of the wheel right away instead of waiting for the due time
+    if (auto* wheel = m_wheel.load(std::memory_order_acquire))
+        wheel->remove(this);
+}
+
 void ScheduledEvent::execute()
 {
     if (!m_canceled && m_callback && (m_maxCycles == 0 || m_cyclesExecuted < m_maxCycles)) {
@@ -42,7 +131,17 @@ void ScheduledEvent::execute()
     ++m_cyclesExecuted;
 }
 
-void ScheduledEvent::postpone() { m_ticks = g_clock.millis() + m_delay; }
+void ScheduledEvent::postpone()
+{
+    m_ticks = g_clock.millis() + m_delay;
+
+    // relink under the new due time if it is waiting in the wheel
+    if (auto* wheel = m_wheel.load(std::memory_order_acquire)) {
+        const auto self = static_self_cast<ScheduledEvent>();
+        if (wheel->remove(this))
+            wheel->insert(self);
+    }
+}
 int ScheduledEvent::remainingTicks() { return m_ticks - g_clock.millis(); }
 bool ScheduledEvent::nextCycle()
 {
@@ -24,13 +24,19 @@
 
 #include "declarations.h"
 #include "event.h"
+#include "timingwheel.h"
 
  // @bindclass
 class ScheduledEvent final : public Event
 {
 public:
     ScheduledEvent(const std::string& function, const std::function<void()>& callback, int delay, int maxCycles = 0);
+
+    // allocates from a pool shared by all scheduled events, they are created and dropped at a high rate
+    static ScheduledEventPtr create(const std::string& function, const std::function<void()>& callback, int delay, int maxCycles = 0);
+
     void execute() override;
+    void cancel() override;
     void postpone();
     bool nextCycle();
 
@@ -53,4 +59,13 @@ private:
     int m_delay;
     int m_maxCycles;
     int m_cyclesExecuted{ 0 };
+
+    // links of the dispatcher timing wheel, guarded by its lock
+    std::atomic<TimingWheel*> m_wheel{ nullptr };
+    TimingWheel::Slot* m_wheelSlot{ nullptr };
+    ScheduledEvent* m_wheelPrev{ nullptr };
+    ScheduledEvent* m_wheelNext{ nullptr };
+    ScheduledEventPtr m_wheelRef;
+
+    friend class TimingWheel;
 };
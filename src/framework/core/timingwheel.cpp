@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "timingwheel.h"
+
+#include "clock.h"
+#include "scheduledevent.h"
+
+void TimingWheel::insert(const ScheduledEventPtr& event)
+{
+    SpinLock::Guard guard(m_lock);
+    if (event->m_wheelSlot)
+        return;
+
+    if (m_current < 0)
+        m_current = g_clock.millis();
+
+    event->m_wheel.store(this, std::memory_order_release);
+    event->m_wheelRef = event;
+    link(event.get());
+}
+
+bool TimingWheel::remove(ScheduledEvent* event)
+{
+    ScheduledEventPtr ref;
+    {
+        SpinLock::Guard guard(m_lock);
+        if (!event->m_wheelSlot)
+            return false;
+
+        unlink(event);
+        event->m_wheel.store(nullptr, std::memory_order_release);
+        ref = std::move(event->m_wheelRef);
+    }
+    // the last reference may be released here, never while holding the lock
+    return true;
+}
+
+void TimingWheel::advance(const ticks_t now, std::vector<ScheduledEventPtr>& expired)
+{
+    SpinLock::Guard guard(m_lock);
+    take(m_due, expired);
+
+    if (m_current < 0) {
+        m_current = now;
+        return;
+    }
+
+    while (m_current < now) {
+        if (m_size == 0) {
+            m_current = now;
+            break;
+        }
+
+        ++m_current;
+
+        // every time a level wraps, the next slot of the level above is spread over the levels below,
+        // top-down so events cascaded from above still reach level 0 in this same tick
+        int top = 0;
+        while (top < LEVELS - 1 && (m_current & ((ticks_t{ 1 } << (SLOT_BITS * (top + 1))) - 1)) == 0)
+            ++top;
+        for (int level = top; level > 0; --level)
+            cascade(level);
+
+        // cascaded events due right at this tick land in m_due
+        take(m_due, expired);
+        take(m_slots[0][m_current & (SLOTS - 1)], expired);
+    }
+}
+
+void TimingWheel::clear()
+{
+    std::vector<ScheduledEventPtr> events;
+    {
+        SpinLock::Guard guard(m_lock);
+        events.reserve(m_size);
+        take(m_due, events);
+        for (auto& level : m_slots) {
+            for (auto& slot : level)
+                take(slot, events);
+        }
+
+        // a dispatcher initialized again starts from its own clock, not from where this one stopped
+        m_current = -1;
+    }
+}
+
+void TimingWheel::link(ScheduledEvent* event)
+{
+    const ticks_t expire = event->m_ticks;
+
+    Slot* slot = &m_due;
+    if (expire > m_current) {
+        constexpr ticks_t range = ticks_t{ 1 } << (SLOT_BITS * LEVELS);
+        const ticks_t delta = std::min<ticks_t>(expire - m_current, range - 1);
+        const ticks_t at = m_current + delta;
+
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (ticks_t{ 1 } << (SLOT_BITS * (level + 1))))
+            ++level;
+        slot = &m_slots[level][(at >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    }
+
+    event->m_wheelSlot = slot;
+    event->m_wheelPrev = slot->tail;
+    event->m_wheelNext = nullptr;
+    if (slot->tail)
+        slot->tail->m_wheelNext = event;
+    else
+        slot->head = event;
+    slot->tail = event;
+    ++m_size;
+}
+
+void TimingWheel::unlink(ScheduledEvent* event)
+{
+    auto* slot = event->m_wheelSlot;
+    if (event->m_wheelPrev)
+        event->m_wheelPrev->m_wheelNext = event->m_wheelNext;
+    else
+        slot->head = event->m_wheelNext;
+
+    if (event->m_wheelNext)
+        event->m_wheelNext->m_wheelPrev = event->m_wheelPrev;
+    else
+        slot->tail = event->m_wheelPrev;
+
+    event->m_wheelSlot = nullptr;
+    event->m_wheelPrev = event->m_wheelNext = nullptr;
+    --m_size;
+}
+
+void TimingWheel::cascade(const int level)
+{
+    auto& slot = m_slots[level][(m_current >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    auto* event = slot.head;
+    slot.head = slot.tail = nullptr;
+
+    while (event) {
+        auto* next = event->m_wheelNext;
+        event->m_wheelSlot = nullptr;
+        --m_size;
+        link(event);
+        event = next;
+    }
+}
+
+void TimingWheel::take(Slot& slot, std::vector<ScheduledEventPtr>& expired)
+{
+    auto* event = slot.head;
+    slot.head = slot.tail = nullptr;
+
+    while (event) {
+        auto* next = event->m_wheelNext;
+        event->m_wheelSlot = nullptr;
+        event->m_wheelPrev = event->m_wheelNext = nullptr;
+        // events outlive the wheel once taken out, a later cancel or postpone must not reach it
+        event->m_wheel.store(nullptr, std::memory_order_release);
+        expired.emplace_back(std::move(event->m_wheelRef));
+        --m_size;
+        event = next;
+    }
+}
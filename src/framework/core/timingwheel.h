@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "declarations.h"
+
+#include <framework/util/spinlock.h>
+
+// Hierarchical timing wheel holding the scheduled events of a dispatcher.
+// Four levels of 256 slots at millisecond resolution: inserting, cancelling and
+// expiring an event are O(1), events further than the first level are cascaded
+// down once per wheel turn. Events are linked intrusively through ScheduledEvent,
+// and the wheel keeps them alive until they expire or are removed.
+class TimingWheel
+{
+public:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+
+    TimingWheel() = default;
+    ~TimingWheel() { clear(); }
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    void insert(const ScheduledEventPtr& event);
+    // unlinks a canceled or rescheduled event, false if it was not waiting in this wheel
+    bool remove(ScheduledEvent* event);
+    // moves every event due at or before now into expired, in due order
+    void advance(ticks_t now, std::vector<ScheduledEventPtr>& expired);
+    void clear();
+
+    size_t size() const { return m_size; }
+
+    struct Slot
+    {
+        ScheduledEvent* head = nullptr;
+        ScheduledEvent* tail = nullptr;
+    };
+
+private:
+    void link(ScheduledEvent* event);
+    void unlink(ScheduledEvent* event);
+    void cascade(int level);
+    void take(Slot& slot, std::vector<ScheduledEventPtr>& expired);
+
+    std::array<std::array<Slot, SLOTS>, LEVELS> m_slots{};
+    Slot m_due; // inserted already late, expired on the next advance
+    ticks_t m_current{ -1 };
+    size_t m_size{ 0 };
+    SpinLock m_lock;
+};
@@ -64,4 +64,29 @@ void CoordsBuffer::addRepeatedRects(const Rect& dest, const Rect& src)
             m_textureCoordArray.addRect(partialSrc);
         }
     }
-}
\ No newline at end of file
+}
+
+void CoordsBuffer::writeQuads(std::vector<QuadVertex>& quads) const
+{
+    // the corners 0, 1, 2 and 5 of each six, the shared index buffer rebuilds both triangles from them
+    static constexpr int corners[] = { 0, 1, 2, 5 };
+
+    const float* vertices = getVertexArray();
+    const float* texCoords = getTextureCoordCount() > 0 ? getTextureCoordArray() : nullptr;
+
+    const int vertexCount = getVertexCount();
+    quads.resize(getQuadCount() * 4);
+
+    auto* out = quads.data();
+    for (int first = 0; first < vertexCount; first += 6) {
+        for (const int corner : corners) {
+            const int i = first + corner;
+            out->x = vertices[i * 2];
+            out->y = vertices[i * 2 + 1];
+            out->u = texCoords ? texCoords[i * 2] : 0.f;
+            out->v = texCoords ? texCoords[i * 2 + 1] : 0.f;
+            out->color = i < static_cast<int>(m_colorArray.size()) ? m_colorArray[i] : Color::white.rgba();
+            ++out;
+        }
+    }
+}
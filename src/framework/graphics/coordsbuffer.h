@@ -24,6 +24,14 @@
 
 #include "vertexarray.h"
 
+// one corner of a quad, interleaved for the indexed quad path of the painter
+struct QuadVertex
+{
+    float x, y;
+    float u, v;
+    uint32_t color;
+};
+
 class CoordsBuffer
 {
 public:
@@ -34,11 +42,15 @@ public:
     {
         m_textureCoordArray.clear();
         m_vertexArray.clear();
+        m_colorArray.clear();
+        m_colorRuns = 0;
+        m_quads = true;
     }
 
     void addTriangle(const Point& a, const Point& b, const Point& c)
     {
         m_vertexArray.addTriangle(a, b, c);
+        m_quads = false;
     }
     void addRect(const Rect& dest)
     {
@@ -66,6 +78,7 @@ public:
     {
         m_vertexArray.addUpsideDownQuad(dest);
         m_textureCoordArray.addQuad(src);
+        m_quads = false;
     }
 
     void addHorizontallyFlippedQuad(const Rect& dest, const Rect& src)
@@ -84,15 +97,40 @@ public:
     {
         m_vertexArray.addUpsideDownRect(dest);
         m_textureCoordArray.addRect(src);
+        m_quads = false;
     }
 
     void addBoudingRect(const Rect& dest, int innerLineWidth);
     void addRepeatedRects(const Rect& dest, const Rect& src);
 
+    // colors the vertices added since the last call, vertices that never got a color are drawn white
+    void addColor(const Color& color)
+    {
+        const size_t vertexCount = getVertexCount();
+        if (m_colorArray.size() >= vertexCount)
+            return;
+
+        const uint32_t rgba = color.rgba();
+        if (m_colorArray.empty() || m_colorArray.back() != rgba)
+            ++m_colorRuns;
+
+        m_colorArray.resize(vertexCount, rgba);
+    }
+
     void append(const CoordsBuffer* buffer)
     {
+        if (buffer->hasColors())
+            addColor(Color::white);
+
         m_vertexArray.append(&buffer->m_vertexArray);
         m_textureCoordArray.append(&buffer->m_textureCoordArray);
+        m_quads = m_quads && buffer->m_quads;
+
+        if (buffer->hasColors()) {
+            const bool sameColor = !m_colorArray.empty() && m_colorArray.back() == buffer->m_colorArray.front();
+            m_colorRuns += buffer->m_colorRuns - (sameColor ? 1 : 0);
+            m_colorArray.insert(m_colorArray.end(), buffer->m_colorArray.begin(), buffer->m_colorArray.end());
+        }
     }
 
     const float* getVertexArray() const { return m_vertexArray.vertices(); }
@@ -100,11 +138,39 @@ public:
     int getVertexCount() const { return m_vertexArray.vertexCount(); }
     int getTextureCoordCount() const { return m_textureCoordArray.vertexCount(); }
 
+    // one RGBA8 color per vertex, empty when the buffer was never colored
+    const uint32_t* getColorArray() const { return m_colorArray.data(); }
+    bool hasColors() const { return !m_colorArray.empty(); }
+
+    // every six vertices cover one quad in the order VertexArray::addRect lays them out,
+    // the fourth and fifth repeating the third and second
+    bool isQuadList() const
+    {
+        const int vertexCount = getVertexCount();
+        const int texCoordCount = getTextureCoordCount();
+        return m_quads && vertexCount % 6 == 0 && (texCoordCount == 0 || texCoordCount == vertexCount);
+    }
+    int getQuadCount() const { return getVertexCount() / 6; }
+
+    // four corners per quad, uncolored vertices come out white
+    void writeQuads(std::vector<QuadVertex>& quads) const;
+
+    // draw calls this buffer would take if every color change had to break the batch
+    int getColorRuns() const { return std::max<int>(m_colorRuns, 1); }
+
     size_t size() const {
         return  std::max<size_t>(m_vertexArray.size(), m_textureCoordArray.size());
     }
 
+    // grows only when one of the arrays had to reallocate
+    size_t capacity() const {
+        return m_vertexArray.capacity() + m_textureCoordArray.capacity() + m_colorArray.capacity();
+    }
+
 private:
     VertexArray m_vertexArray;
     VertexArray m_textureCoordArray;
+    std::vector<uint32_t> m_colorArray;
+    uint32_t m_colorRuns{ 0 };
+    bool m_quads{ true };
 };
@@ -25,6 +25,19 @@
 #include "painter.h"
 #include "textureatlas.h"
 #include "coordsbuffer.h"
+#include <framework/util/stats.h>
+
+namespace
+{
+    // the buffers of a frame are reused, a push only allocates while they are still growing
+    template<typename T, typename... Args>
+    T& emplaceCounted(std::vector<T>& list, Args&&... args)
+    {
+        if (list.size() == list.capacity())
+            g_stats.addDrawAllocation();
+        return list.emplace_back(std::forward<Args>(args)...);
+    }
+}
 
 DrawPool* DrawPool::create(const DrawPoolType type)
 {
@@ -81,18 +94,31 @@ void DrawPool::add(const Color& color, const TexturePtr& texture, DrawMethod&& m
     auto& list = m_objects[m_currentDrawOrder];
     auto& state = getCurrentState();
 
-    if (!list.empty() && list.back().coords && list.back().state == state) {
-        auto& last = list.back();
-        coordsBuffer ? last.coords->append(coordsBuffer.get()) : addCoords(*last.coords, method);
+    const auto& addTo = [&](CoordsBuffer& coords) {
+        const size_t capacity = coords.capacity();
+        coordsBuffer ? coords.append(coordsBuffer.get()) : addCoords(coords, method);
+        if (hasVertexColor(state))
+            coords.addColor(color);
+        if (coords.capacity() != capacity)
+            g_stats.addDrawAllocation();
+    };
+
+    const auto& addObject = [&] {
+        return emplaceCounted(list, DrawObject{ .state = getState(texture, textureAtlas, color), .coords = getCoordsBuffer() }).coords;
+    };
+
+    if (!list.empty() && list.back().command == DrawCommand::COORDS && m_frame.states[list.back().state].hash == state.hash) {
+        addTo(*list.back().coords);
     } else if (m_alwaysGroupDrawings) {
+        const size_t buckets = m_coords.bucket_count();
         auto& coords = m_coords.try_emplace(state.hash, nullptr).first->second;
-        if (!coords) {
-            coords = list.emplace_back(getState(texture, textureAtlas, color), getCoordsBuffer()).coords.get();
-        }
-        coordsBuffer ? coords->append(coordsBuffer.get()) : addCoords(*coords, method);
+        if (m_coords.bucket_count() != buckets)
+            g_stats.addDrawAllocation();
+        if (!coords)
+            coords = addObject();
+        addTo(*coords);
     } else {
-        auto& draw = list.emplace_back(getState(texture, textureAtlas, color), getCoordsBuffer());
-        coordsBuffer ? draw.coords->append(coordsBuffer.get()) : addCoords(*draw.coords, method);
+        addTo(*addObject());
     }
 
     resetOnlyOnceParameters();
@@ -139,7 +165,8 @@ bool DrawPool::updateHash(const DrawMethod& method, const Texture* texture, cons
         if (state.transformMatrix != DEFAULT_MATRIX3)
             stdext::hash_union(state.hash, state.transformMatrix.hash());
 
-        if (color != Color::white)
+        // with the painter's own programs the color goes into the vertices instead of breaking the batch
+        if (color != Color::white && !hasVertexColor(state))
             stdext::hash_union(state.hash, color.hash());
 
         if (texture)
@@ -149,6 +176,9 @@ bool DrawPool::updateHash(const DrawMethod& method, const Texture* texture, cons
     if (hasFrameBuffer()) { // Pool Hash
         size_t hash = state.hash;
 
+        if (color != Color::white && hasVertexColor(state))
+            stdext::hash_union(hash, color.hash());
+
         if (method.type == DrawMethodType::TRIANGLE) {
             if (!method.a.isNull()) stdext::hash_union(hash, method.a.hash());
             if (!method.b.isNull()) stdext::hash_union(hash, method.b.hash());
@@ -170,33 +200,66 @@ bool DrawPool::updateHash(const DrawMethod& method, const Texture* texture, cons
     return true;
 }
 
-DrawPool::PoolState DrawPool::getState(const TexturePtr& texture, Texture* textureAtlas, const Color& color)
+uint32_t DrawPool::getState(const TexturePtr& texture, Texture* textureAtlas, const Color& color)
 {
-    PoolState copy = getCurrentState();
+    const size_t hash = getCurrentState().hash;
+
+    const size_t buckets = m_stateIndex.bucket_count();
+    auto& interned = m_stateIndex[hash];
+    if (m_stateIndex.bucket_count() != buckets)
+        g_stats.addDrawAllocation();
+
+    if (interned.frame != m_frameSerial || interned.index == NO_INDEX) {
+        // vertex colored draws share a state whatever their color
+        interned = { .index = addState(texture, textureAtlas, hasVertexColor(getCurrentState()) ? Color::white : color), .frame = m_frameSerial };
+    }
+
+    return interned.index;
+}
 
-    if (copy.color != color)
-        copy.color = color;
+uint32_t DrawPool::addState(const TexturePtr& texture, Texture* textureAtlas, const Color& color)
+{
+    const auto& current = getCurrentState();
+
+    DrawState state{
+        .transformMatrix = current.transformMatrix,
+        .clipRect = current.clipRect,
+        .color = color,
+        .shaderProgram = current.shaderProgram,
+        .opacity = current.opacity,
+        .compositionMode = current.compositionMode,
+        .blendEquation = current.blendEquation,
+        .hash = current.hash
+    };
 
     if (textureAtlas) {
         // Texture is batched inside an atlas
-        copy.textureId = textureAtlas->getId();
-        copy.textureMatrixId = textureAtlas->getTransformMatrixId();
+        state.textureId = textureAtlas->getId();
+        state.textureMatrixId = textureAtlas->getTransformMatrixId();
     } else if (texture) {
         if (texture->isEmpty() || // Texture not initialized in the current OpenGL context
             !texture->canCacheInAtlas() || // Texture is marked as non-atlas-cacheable (short-lived/temporary, e.g. minimap)
             (m_atlas && m_atlas->canAdd(texture)) // Force this texture to be packed into the current pool atlas,
                                                   // even if it might already belong to another DrawPool's atlas
         ) {
-            copy.texture = texture;
+            state.texture = m_frame.textures.size();
+            emplaceCounted(m_frame.textures, texture);
         } else {
             // Standalone GL texture cached in memory (non-atlased)
-            copy.textureId = texture->getId();
-            copy.textureMatrixId = texture->getTransformMatrixId();
+            state.textureId = texture->getId();
+            state.textureMatrixId = texture->getTransformMatrixId();
         }
     }
 
-    return copy;
+    if (current.action) {
+        state.action = m_frame.actions.size();
+        emplaceCounted(m_frame.actions, current.action);
+    }
+
+    emplaceCounted(m_frame.states, state);
+    return m_frame.states.size() - 1;
 }
+
 void DrawPool::setCompositionMode(const CompositionMode mode, const bool onlyOnce)
 {
     if (onlyOnce && !(m_onlyOnceStateFlag & STATE_COMPOSITE_MODE)) {
@@ -281,78 +344,62 @@ void DrawPool::release() {
     if (hasFrameBuffer() && !m_hashCtrl.wasModified() && !canRefresh()) {
         for (auto& objs : m_objects)
             objs.clear();
-        m_objectsFlushed.clear();
+        m_frame.clear();
+        ++m_frameSerial;
         return;
     }
 
     m_refreshTimer.restart();
 
-    SpinLock::Guard guard(m_threadLock);
-
-    m_objectsDraw[0].clear();
+    mergeObjects();
 
-    if (!m_objectsFlushed.empty()) {
-        if (m_objectsDraw[0].size() < m_objectsFlushed.size())
-            m_objectsDraw[0].swap(m_objectsFlushed);
-
-        if (!m_objectsFlushed.empty()) {
-            m_objectsDraw[0].insert(
-                m_objectsDraw[0].end(),
-                std::make_move_iterator(m_objectsFlushed.begin()),
-                std::make_move_iterator(m_objectsFlushed.end()));
-        }
-        m_objectsFlushed.clear();
+    {
+        SpinLock::Guard guard(m_threadLock);
+        std::swap(m_framesDraw[0], m_frame);
+        m_shouldRepaint.store(true, std::memory_order_relaxed);
     }
 
-    for (auto& objs : m_objects) {
-        if (m_objectsDraw[0].size() < objs.size())
-            m_objectsDraw[0].swap(objs);
-
-        bool addFirst = true;
-
-        if (!m_objectsDraw[0].empty() && !objs.empty()) {
-            auto& last = m_objectsDraw[0].back();
-            auto& first = objs.front();
-
-            if (last.state == first.state && last.coords && first.coords) {
-                last.coords->append(first.coords.get());
-                addFirst = false;
-            }
-        }
-
-        if (!objs.empty()) {
-            m_objectsDraw[0].insert(
-                m_objectsDraw[0].end(),
-                std::make_move_iterator(objs.begin() + (addFirst ? 0 : 1)),
-                std::make_move_iterator(objs.end()));
-            objs.clear();
-        }
-    }
+    // the frame released before this one was never drawn
+    m_frame.clear();
+    ++m_frameSerial;
 
-    m_shouldRepaint.store(true, std::memory_order_relaxed);
+    // states interned by frames long gone only take room
+    if (m_stateIndex.size() > 1024 && m_stateIndex.size() > m_framesDraw[0].states.size() * 8)
+        m_stateIndex.clear();
 }
 
 void DrawPool::flush()
 {
     m_coords.clear();
+    mergeObjects();
+}
+
+void DrawPool::mergeObjects()
+{
+    auto& merged = m_frame.objects;
 
     for (auto& objs : m_objects) {
-        bool addFirst = true;
-        if (!objs.empty() && !m_objectsFlushed.empty()) {
-            auto& last = m_objectsFlushed.back();
-            auto& first = objs.front();
+        if (objs.empty())
+            continue;
 
-            if (last.state == first.state && last.coords && first.coords) {
-                last.coords->append(first.coords.get());
+        bool addFirst = true;
+        if (!merged.empty()) {
+            auto& last = merged.back();
+            const auto& first = objs.front();
+
+            if (last.command == DrawCommand::COORDS && first.command == DrawCommand::COORDS && last.state == first.state) {
+                const size_t capacity = last.coords->capacity();
+                last.coords->append(first.coords);
+                if (last.coords->capacity() != capacity)
+                    g_stats.addDrawAllocation();
                 addFirst = false;
             }
         }
 
-        m_objectsFlushed.insert(
-            m_objectsFlushed.end(),
-            std::make_move_iterator(objs.begin() + (addFirst ? 0 : 1)),
-            std::make_move_iterator(objs.end())
-        );
+        if (merged.capacity() < merged.size() + objs.size())
+            g_stats.addDrawAllocation();
+
+        merged.insert(merged.end(), objs.begin() + (addFirst ? 0 : 1), objs.end());
         objs.clear();
     }
 }
@@ -412,7 +459,7 @@ void DrawPool::popTransformMatrix()
     m_transformMatrixStack.pop_back();
 }
 
-void DrawPool::PoolState::execute(DrawPool* pool) const {
+void DrawPool::DrawState::execute(DrawPool* pool, const DrawFrame& frame) const {
     g_painter->setColor(color);
     g_painter->setOpacity(opacity);
     g_painter->setCompositionMode(compositionMode);
@@ -420,17 +467,32 @@ void DrawPool::PoolState::execute(DrawPool* pool) const {
     g_painter->setClipRect(clipRect);
     g_painter->setShaderProgram(shaderProgram);
     g_painter->setTransformMatrix(transformMatrix);
-    if (action) action();
-    if (texture) {
-        texture->create();
-        g_painter->setTexture(texture);
-        if (texture->canCacheInAtlas() && pool->m_atlas && !texture->getAtlasRegion(pool->m_atlas->getType())) {
-            pool->m_atlas->addTexture(texture);
+    if (action != NO_INDEX) frame.actions[action]();
+    if (texture != NO_INDEX) {
+        const auto& tex = frame.textures[texture];
+        g_painter->uploadTexture(tex);
+        g_painter->setTexture(tex);
+        if (tex->canCacheInAtlas() && pool->m_atlas && !tex->getAtlasRegion(pool->m_atlas->getType())) {
+            pool->m_atlas->addTexture(tex);
         }
     } else
         g_painter->setTexture(textureId, textureMatrixId);
 }
 
+void DrawPool::DrawFrame::clear()
+{
+    objects.clear();
+    states.clear();
+    actions.clear();
+    textures.clear();
+
+    for (uint32_t i = 0; i < usedCoords; ++i)
+        coords[i]->clear();
+    usedCoords = 0;
+
+    prepareFramebuffer = false;
+}
+
 void DrawPool::setFramebuffer(const Size& size) {
     if (!m_framebuffer) {
         m_framebuffer = std::make_shared<FrameBuffer>();
@@ -451,12 +513,21 @@ void DrawPool::removeFramebuffer() {
 void DrawPool::addAction(const std::function<void()>& action, size_t hash)
 {
     const uint8_t order = m_type == DrawPoolType::MAP ? THIRD : FIRST;
-    m_objects[order].emplace_back(action);
+    emplaceCounted(m_objects[order], DrawObject{ .command = DrawCommand::ACTION, .action = static_cast<uint32_t>(m_frame.actions.size()) });
+    emplaceCounted(m_frame.actions, action);
     if (hasFrameBuffer() && hash > 0 && !m_hashCtrl.isLast(hash)) {
         m_hashCtrl.put(hash);
     }
 }
 
+void DrawPool::setPrepareFramebuffer(const Rect& dest, const Rect& src, const Color& colorClear)
+{
+    m_frame.prepareFramebuffer = true;
+    m_frame.prepareDest = dest;
+    m_frame.prepareSrc = src;
+    m_frame.colorClear = colorClear;
+}
+
 void DrawPool::bindFrameBuffer(const Size& size, const Color& color)
 {
     ++m_bindedFramebuffers;
@@ -467,14 +538,11 @@ void DrawPool::bindFrameBuffer(const Size& size, const Color& color)
 
     nextStateAndReset();
 
-    addAction([this, size, frameIndex = m_bindedFramebuffers] {
-        static const PoolState state;
-
-        state.execute(this);
-
-        const auto& frame = getTemporaryFrameBuffer(frameIndex);
-        frame->resize(size);
-        frame->bind();
+    const uint8_t order = m_type == DrawPoolType::MAP ? THIRD : FIRST;
+    emplaceCounted(m_objects[order], DrawObject{
+        .command = DrawCommand::BIND_FRAMEBUFFER,
+        .frameIndex = static_cast<uint8_t>(m_bindedFramebuffers),
+        .rect = Rect(Point(), size)
     });
 }
 void DrawPool::releaseFrameBuffer(const Rect& dest)
@@ -486,11 +554,13 @@ void DrawPool::releaseFrameBuffer(const Rect& dest, uint8_t flipDirection)
 {
     backState();
 
-    addAction([this, dest, flipDirection, frameIndex = m_bindedFramebuffers, drawState = getCurrentState()] {
-        const auto& frame = getTemporaryFrameBuffer(frameIndex);
-        frame->release();
-        drawState.execute(this);
-        frame->draw(dest, flipDirection);
+    const uint8_t order = m_type == DrawPoolType::MAP ? THIRD : FIRST;
+    emplaceCounted(m_objects[order], DrawObject{
+        .command = DrawCommand::RELEASE_FRAMEBUFFER,
+        .frameIndex = static_cast<uint8_t>(m_bindedFramebuffers),
+        .flipDirection = flipDirection,
+        .state = addState(nullptr, nullptr, getCurrentState().color),
+        .rect = dest
     });
 
     if (hasFrameBuffer() && !dest.isNull()) m_hashCtrl.put(dest.hash());
@@ -507,21 +577,12 @@ const FrameBufferPtr& DrawPool::getTemporaryFrameBuffer(const uint8_t index) {
     return tempfb;
 }
 
-std::shared_ptr<CoordsBuffer> DrawPool::getCoordsBuffer() {
-    CoordsBuffer* coordsBuffer = nullptr;
-
-    if (!m_coordsCache.empty()) {
-        coordsBuffer = m_coordsCache.back();
-        m_coordsCache.pop_back();
-    } else
-        coordsBuffer = new CoordsBuffer();
+CoordsBuffer* DrawPool::getCoordsBuffer() {
+    auto& arena = m_frame.coords;
+    if (m_frame.usedCoords == arena.size()) {
+        g_stats.addDrawAllocation();
+        emplaceCounted(arena, std::make_unique<CoordsBuffer>());
+    }
 
-    return std::shared_ptr<CoordsBuffer>(coordsBuffer, [this](CoordsBuffer* ptr) {
-        if (m_enabled) {
-            ptr->clear();
-            m_coordsCache.emplace_back(ptr);
-        } else {
-            delete ptr;
-        }
-    });
+    return arena[m_frame.usedCoords++].get();
 }
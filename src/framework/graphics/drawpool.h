@@ -147,6 +147,7 @@ protected:
         uint16_t intValue{ 0 };
     };
 
+    // the state being built, getState turns it into a DrawState of the frame
     struct PoolState
     {
         Matrix3 transformMatrix = DEFAULT_MATRIX3;
@@ -157,22 +158,67 @@ protected:
         PainterShaderProgram* shaderProgram{ nullptr };
         std::function<void()> action{ nullptr };
         Color color{ Color::white };
-        TexturePtr texture;
-        uint32_t textureId{ 0 };
+        size_t hash{ 0 };
+    };
+
+    static constexpr uint32_t NO_INDEX = UINT32_MAX;
+
+    struct DrawFrame;
+
+    // plain data, interned once per frame by hash and referenced by index from the draw objects
+    struct DrawState
+    {
+        Matrix3 transformMatrix = DEFAULT_MATRIX3;
+        Rect clipRect;
+        Color color{ Color::white };
+        PainterShaderProgram* shaderProgram{ nullptr };
+        float opacity{ 1.f };
+        CompositionMode compositionMode{ CompositionMode::NORMAL };
+        BlendEquation blendEquation{ BlendEquation::ADD };
         uint16_t textureMatrixId{ 0 };
+        uint32_t textureId{ 0 };
+        uint32_t texture{ NO_INDEX }; // DrawFrame::textures, a texture still to upload or to pack into the atlas
+        uint32_t action{ NO_INDEX }; // DrawFrame::actions, what the shader program sets before drawing
         size_t hash{ 0 };
 
-        bool operator==(const PoolState& s2) const { return hash == s2.hash; }
-        void execute(DrawPool* pool) const;
+        void execute(DrawPool* pool, const DrawFrame& frame) const;
+    };
+
+    enum class DrawCommand : uint8_t
+    {
+        COORDS,
+        ACTION,
+        BIND_FRAMEBUFFER,
+        RELEASE_FRAMEBUFFER,
     };
 
     struct DrawObject
     {
-        DrawObject(std::function<void()> action) : action(std::move(action)) {}
-        DrawObject(PoolState&& state, std::shared_ptr<CoordsBuffer>&& coords) : coords(std::move(coords)), state(std::move(state)) {}
-        std::function<void()> action{ nullptr };
-        std::shared_ptr<CoordsBuffer> coords;
-        PoolState state;
+        DrawCommand command{ DrawCommand::COORDS };
+        uint8_t frameIndex{ 0 }; // temporary framebuffer to bind or release
+        uint8_t flipDirection{ 0 };
+        uint32_t state{ NO_INDEX }; // DrawFrame::states, for COORDS and RELEASE_FRAMEBUFFER
+        uint32_t action{ NO_INDEX }; // DrawFrame::actions, for ACTION
+        CoordsBuffer* coords{ nullptr };
+        Rect rect; // the size to bind or where the released framebuffer is drawn
+    };
+
+    // what the draw objects of a frame point into, cleared without freeing so a warm frame builds without allocating
+    struct DrawFrame
+    {
+        std::vector<DrawObject> objects;
+        std::vector<DrawState> states;
+        std::vector<std::function<void()>> actions;
+        std::vector<TexturePtr> textures;
+        std::vector<std::unique_ptr<CoordsBuffer>> coords;
+        uint32_t usedCoords{ 0 };
+
+        // the scene framebuffer prepare of DrawPoolManager::preDraw
+        bool prepareFramebuffer{ false };
+        Rect prepareDest, prepareSrc;
+        Color colorClear;
+
+        void clear();
     };
 
     struct DrawObjectState
@@ -217,8 +263,13 @@ private:
         return refreshDelay > 0 && m_refreshTimer.ticksElapsed() >= refreshDelay;
     }
 
+    // custom shaders only read u_Color, the painter's programs also read a per vertex color
+    static bool hasVertexColor(const PoolState& state) { return state.shaderProgram == nullptr; }
+
     bool updateHash(const DrawMethod& method, const Texture* texture, const Color& color, bool hasCoord);
-    PoolState getState(const TexturePtr& texture, Texture* textureAtlas, const Color& color);
+    uint32_t getState(const TexturePtr& texture, Texture* textureAtlas, const Color& color);
+    uint32_t addState(const TexturePtr& texture, Texture* textureAtlas, const Color& color);
+    void setPrepareFramebuffer(const Rect& dest, const Rect& src, const Color& colorClear);
 
     PoolState& getCurrentState() { return m_states[m_lastStateIndex]; }
     const PoolState& getCurrentState() const { return m_states[m_lastStateIndex]; }
@@ -250,7 +301,7 @@ private:
     void rotate(float x, float y, float angle);
     void rotate(const Point& p, const float angle) { rotate(p.x, p.y, angle); }
 
-    std::shared_ptr<CoordsBuffer> getCoordsBuffer();
+    CoordsBuffer* getCoordsBuffer();
 
     template<typename T>
     void setParameter(std::string_view name, T&& value) {
@@ -275,6 +326,7 @@ private:
     }
 
     void flush();
+    void mergeObjects();
 
     void resetOnlyOnceParameters() {
         if (m_onlyOnceStateFlag > 0) { // Only Once State
@@ -341,9 +393,20 @@ private:
     std::vector<FrameBufferPtr> m_temporaryFramebuffers;
 
     std::vector<DrawObject> m_objects[static_cast<uint8_t>(LAST)];
-    std::vector<DrawObject> m_objectsFlushed;
-    std::array<std::vector<DrawObject>, 2> m_objectsDraw;
-    std::vector<CoordsBuffer*> m_coordsCache;
+
+    // the frame being built, the last one released and the one being drawn
+    DrawFrame m_frame;
+    std::array<DrawFrame, 2> m_framesDraw;
+
+    struct InternedState
+    {
+        uint32_t index{ NO_INDEX };
+        uint32_t frame{ 0 };
+    };
+
+    // kept across frames so that its table is not freed, entries of an older frame are stale
+    stdext::map<size_t, InternedState> m_stateIndex;
+    uint32_t m_frameSerial{ 0 };
 
     stdext::map<size_t, CoordsBuffer*> m_coords;
     stdext::map<std::string_view, std::any> m_parameters;
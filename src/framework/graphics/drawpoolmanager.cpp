@@ -26,6 +26,7 @@
 #include "painter.h"
 #include "textureatlas.h"
 #include <framework/core/configmanager.h>
+#include <framework/util/stats.h>
 
 thread_local static uint8_t CURRENT_POOL = static_cast<uint8_t>(DrawPoolType::LAST);
 
@@ -49,8 +50,10 @@ void DrawPoolManager::init(const uint16_t spriteSize)
     if (foregroundAtlasSize == 0)
         foregroundAtlasSize = g_graphics.getMaxTextureSize();
 
-    auto atlasMap = mapAtlasSize > 0 ? std::make_shared<TextureAtlas>(Fw::TextureAtlasType::MAP, mapAtlasSize) : nullptr;
-    auto atlasForeground = foregroundAtlasSize > 0 ? std::make_shared<TextureAtlas>(Fw::TextureAtlasType::FOREGROUND, foregroundAtlasSize, true) : nullptr;
+    // atlases are backed by framebuffers, so there is nothing to pack into without a GL context
+    const bool hasGraphics = g_graphics.ok();
+    auto atlasMap = hasGraphics && mapAtlasSize > 0 ? std::make_shared<TextureAtlas>(Fw::TextureAtlasType::MAP, mapAtlasSize) : nullptr;
+    auto atlasForeground = hasGraphics && foregroundAtlasSize > 0 ? std::make_shared<TextureAtlas>(Fw::TextureAtlasType::FOREGROUND, foregroundAtlasSize, true) : nullptr;
 
     // Create Pools
     for (int8_t i = -1; ++i < static_cast<uint8_t>(DrawPoolType::LAST);) {
@@ -95,18 +98,49 @@ void DrawPoolManager::draw()
         g_painter->setResolution(m_size, m_transformMatrix);
     }
 
+    g_painter->resetDrawCalls();
+
     for (int8_t i = -1; ++i < static_cast<uint8_t>(DrawPoolType::LAST);) {
         drawPool(static_cast<DrawPoolType>(i));
     }
+
+    m_drawCalls = g_painter->getDrawCalls();
+    m_unbatchedDrawCalls = g_painter->getUnbatchedDrawCalls();
+
+    const auto allocations = g_stats.getDrawAllocations();
+    m_drawAllocations = allocations - m_lastDrawAllocations;
+    m_lastDrawAllocations = allocations;
 }
 
-void DrawPoolManager::drawObject(DrawPool* pool, const DrawPool::DrawObject& obj)
+void DrawPoolManager::drawObject(DrawPool* pool, const DrawPool::DrawFrame& frame, const DrawPool::DrawObject& obj)
 {
-    if (obj.action) {
-        obj.action();
-    } else if (obj.coords) {
-        obj.state.execute(pool);
-        g_painter->drawCoords(*obj.coords, DrawMode::TRIANGLES);
+    switch (obj.command) {
+        case DrawPool::DrawCommand::COORDS:
+            frame.states[obj.state].execute(pool, frame);
+            g_painter->drawCoords(*obj.coords, DrawMode::TRIANGLES);
+            break;
+
+        case DrawPool::DrawCommand::ACTION:
+            frame.actions[obj.action]();
+            break;
+
+        case DrawPool::DrawCommand::BIND_FRAMEBUFFER: {
+            static const DrawPool::DrawState state;
+            state.execute(pool, frame);
+
+            const auto& framebuffer = pool->getTemporaryFrameBuffer(obj.frameIndex);
+            framebuffer->resize(obj.rect.size());
+            framebuffer->bind();
+            break;
+        }
+
+        case DrawPool::DrawCommand::RELEASE_FRAMEBUFFER: {
+            const auto& framebuffer = pool->getTemporaryFrameBuffer(obj.frameIndex);
+            framebuffer->release();
+            frame.states[obj.state].execute(pool, frame);
+            framebuffer->draw(obj.rect, obj.flipDirection);
+            break;
+        }
     }
 }
 
@@ -205,11 +239,8 @@ void DrawPoolManager::preDraw(const DrawPoolType type, const std::function<void(
     if (beforeRelease)
         beforeRelease();
 
-    if (pool->hasFrameBuffer()) {
-        addAction([pool, dest, src, colorClear] {
-            pool->m_framebuffer->prepare(dest, src, colorClear);
-        });
-    }
+    if (pool->hasFrameBuffer())
+        pool->setPrepareFramebuffer(dest, src, colorClear);
 
     pool->release();
 
@@ -228,15 +259,18 @@ void DrawPoolManager::drawObjects(DrawPool* pool) {
 
     if (shouldRepaint) {
         SpinLock::Guard guard(pool->m_threadLock);
-        pool->m_objectsDraw[0].swap(pool->m_objectsDraw[1]);
+        std::swap(pool->m_framesDraw[0], pool->m_framesDraw[1]);
         pool->m_shouldRepaint.store(false, std::memory_order_relaxed);
     }
 
-    for (auto& obj : pool->m_objectsDraw[1]) {
-        drawObject(pool, obj);
+    const auto& frame = pool->m_framesDraw[1];
+    for (const auto& obj : frame.objects) {
+        drawObject(pool, frame, obj);
     }
 
     if (hasFramebuffer) {
+        if (frame.prepareFramebuffer)
+            pool->m_framebuffer->prepare(frame.prepareDest, frame.prepareSrc, frame.colorClear);
         pool->m_framebuffer->release();
     }
 
@@ -277,4 +311,12 @@ std::string DrawPoolManager::getAtlasStats() const
     ss << "map=" << (mapAtlas ? mapAtlas->getStats() : "disabled");
     ss << " | fg=" << (fgAtlas ? fgAtlas->getStats() : "disabled");
     return ss.str();
-}
\ No newline at end of file
+}
+
+std::string DrawPoolManager::getDrawCallStats() const
+{
+    std::stringstream ss;
+    ss << m_drawCalls << " per frame (" << m_unbatchedDrawCalls << " without vertex colors), ";
+    ss << m_drawAllocations << " draw pool allocations";
+    return ss.str();
+}
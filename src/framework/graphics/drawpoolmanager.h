@@ -117,13 +117,17 @@ public:
     void removeTextureFromAtlas(uint32_t id, bool smooth);
     std::string getAtlasStats() const;
 
+    // draw calls of the last frame, next to the count colors breaking batches would have cost,
+    // and the allocations the pools made building frames since the one before
+    std::string getDrawCallStats() const;
+
 private:
     DrawPool* getCurrentPool() const;
 
     void draw();
     void init(uint16_t spriteSize);
     void terminate() const;
-    void drawObject(DrawPool* pool, const DrawPool::DrawObject& obj);
+    void drawObject(DrawPool* pool, const DrawPool::DrawFrame& frame, const DrawPool::DrawObject& obj);
     void drawPool(DrawPoolType type);
     void drawObjects(DrawPool* pool);
 
@@ -139,7 +143,13 @@ private:
 
     uint16_t m_spriteSize{ 32 };
 
+    uint32_t m_drawCalls{ 0 };
+    uint32_t m_unbatchedDrawCalls{ 0 };
+    uint64_t m_drawAllocations{ 0 };
+    uint64_t m_lastDrawAllocations{ 0 };
+
     friend class GraphicalApplication;
+    friend class ReplayBenchmark;
 };
 
 extern DrawPoolManager g_drawPool;
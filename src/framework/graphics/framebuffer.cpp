@@ -33,6 +33,10 @@ uint32_t FrameBuffer::boundFbo = 0;
 
 FrameBuffer::FrameBuffer()
 {
+    // headless tools build the draw pools without a GL context
+    if (!g_graphics.ok())
+        return;
+
     glGenFramebuffers(1, &m_fbo);
     if (!m_fbo)
         g_logger.warning("Unable to create framebuffer object");
@@ -65,6 +69,9 @@ bool FrameBuffer::resize(const Size& size)
     m_screenCoordsBuffer.clear();
     m_screenCoordsBuffer.addRect(Rect{ 0, 0, size });
 
+    if (!m_fbo)
+        return true; // headless, there is no framebuffer object to attach the texture to
+
     internalBind();
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture->getId(), 0);
 
@@ -114,16 +121,19 @@ void FrameBuffer::release() const
 
 void FrameBuffer::draw()
 {
-    if (m_disableBlend) glDisable(GL_BLEND);
+    if (m_disableBlend) g_painter->setBlending(false);
     g_painter->setCompositionMode(m_compositeMode);
     g_painter->setTexture(m_texture);
     g_painter->drawCoords(m_coordsBuffer, DrawMode::TRIANGLE_STRIP);
     g_painter->resetCompositionMode();
-    if (m_disableBlend) glEnable(GL_BLEND);
+    if (m_disableBlend) g_painter->setBlending(true);
 }
 
 void FrameBuffer::internalBind()
 {
+    if (!m_fbo)
+        return;
+
     assert(boundFbo != m_fbo);
     glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
     m_prevBoundFbo = boundFbo;
@@ -132,6 +142,9 @@ void FrameBuffer::internalBind()
 
 void FrameBuffer::internalRelease() const
 {
+    if (!m_fbo)
+        return;
+
     assert(boundFbo == m_fbo);
     glBindFramebuffer(GL_FRAMEBUFFER, m_prevBoundFbo);
     boundFbo = m_prevBoundFbo;
@@ -25,6 +25,7 @@
 #include "apngloader.h"
 #include "framework/core/filestream.h"
 #include "framework/core/resourcemanager.h"
+#include "framework/util/simd.h"
 
 using namespace qrcodegen;
 
@@ -149,6 +150,83 @@ void Image::overwrite(const Color& color)
     }
 }
 
+namespace
+{
+    constexpr uint32_t ALPHA_MASK = 0xFF000000;
+
+    bool hasOpaque4(const uint8_t* pixels)
+    {
+#if defined(OTC_SIMD_SSE2)
+        const __m128i alpha = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels)), _mm_set1_epi32(static_cast<int>(ALPHA_MASK)));
+        return _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_setzero_si128())) != 0xFFFF;
+#elif defined(OTC_SIMD_NEON)
+        const uint32x4_t alpha = vandq_u32(vreinterpretq_u32_u8(vld1q_u8(pixels)), vdupq_n_u32(ALPHA_MASK));
+        const uint32x2_t any = vorr_u32(vget_low_u32(alpha), vget_high_u32(alpha));
+        return (vget_lane_u32(any, 0) | vget_lane_u32(any, 1)) != 0;
+#else
+        return pixels[3] | pixels[7] | pixels[11] | pixels[15];
+#endif
+    }
+
+    // index of the first pixel of the row with a non zero alpha, -1 if there is none
+    int findFirstOpaque(const uint8_t* row, const int count)
+    {
+        int i = 0;
+        while (i + 4 <= count && !hasOpaque4(row + i * 4))
+            i += 4;
+        for (; i < count; ++i) {
+            if (row[i * 4 + 3])
+                return i;
+        }
+        return -1;
+    }
+
+    int findLastOpaque(const uint8_t* row, const int count)
+    {
+        int i = count;
+        while (i >= 4 && !hasOpaque4(row + (i - 4) * 4))
+            i -= 4;
+        while (--i >= 0) {
+            if (row[i * 4 + 3])
+                return i;
+        }
+        return -1;
+    }
+}
+
+Rect Image::getOpaqueRect(const Rect& area) const
+{
+    const Rect bounds = area.intersection(Rect(0, 0, m_size));
+    if (!bounds.isValid())
+        return {};
+
+    // without an alpha channel every pixel counts
+    if (m_bpp != 4)
+        return bounds;
+
+    // row-major, every row is a contiguous run scanned a few pixels at a time from both ends
+    int top = -1, bottom = -1;
+    int left = bounds.width(), right = -1;
+    for (int y = bounds.top(); y <= bounds.bottom(); ++y) {
+        const uint8_t* row = &m_pixels[(static_cast<size_t>(y) * m_size.width() + bounds.left()) * 4];
+        const int first = findFirstOpaque(row, bounds.width());
+        if (first < 0)
+            continue;
+
+        if (top < 0)
+            top = y;
+        bottom = y;
+        left = std::min<int>(left, first);
+        if (right < bounds.width() - 1)
+            right = std::max<int>(right, findLastOpaque(row, bounds.width()));
+    }
+
+    if (top < 0)
+        return {};
+
+    return { Point(bounds.left() + left, top), Point(bounds.left() + right, bottom) };
+}
+
 void Image::blit(const Point& dest, const ImagePtr& other)
 {
     assert(m_bpp == 4);
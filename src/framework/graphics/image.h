@@ -70,6 +70,9 @@ public:
     int getBpp() const { return m_bpp; }
     uint8_t* getPixel(const int x, const int y) { return &m_pixels[static_cast<size_t>(y * m_size.width() + x) * m_bpp]; }
 
+    // smallest rect of area holding every pixel with a non zero alpha, invalid if there is none
+    Rect getOpaqueRect(const Rect& area) const;
+
     bool hasTransparentPixel() const { return m_transparentPixel; }
     void setTransparentPixel(const bool value) { m_transparentPixel = value; }
 
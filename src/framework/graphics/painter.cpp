@@ -59,7 +59,7 @@ Painter::Painter()
         return program;
     };
 
-    m_drawTexturedProgram = getProgram(joinPainterShaderSources(glslMainWithTexCoordsVertexShader, glslPositionOnlyVertexShader), joinPainterShaderSources(glslMainFragmentShader, glslTextureSrcFragmentShader));
+    m_drawTexturedProgram = getProgram(joinPainterShaderSources(glslMainWithTexCoordsAndColorVertexShader, glslPositionOnlyVertexShader), joinPainterShaderSources(glslMainFragmentShader, glslTextureSrcFragmentShader));
     m_drawSolidColorProgram = getProgram(joinPainterShaderSources(glslMainVertexShader, glslPositionOnlyVertexShader), joinPainterShaderSources(glslMainFragmentShader, glslSolidColorFragmentShader));
     m_drawReplaceColorProgram = getProgram(joinPainterShaderSources(glslMainWithTexCoordsVertexShader, glslPositionOnlyVertexShader), joinPainterShaderSources(glslMainFragmentShader, glslReplaceColorFragmentShader));
     m_drawLineProgram = getProgram(lineVertexShader, lineFragmentShader);
@@ -72,6 +72,18 @@ Painter::Painter()
     // to avoid massive enable/disables, thus improving frame rate
     PainterShaderProgram::enableAttributeArray(PainterShaderProgram::VERTEX_ATTR);
     PainterShaderProgram::enableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
+
+    // the color attribute is only fed from an array by colored coords buffers
+    m_drawTexturedProgram->setAttributeValue(PainterShaderProgram::COLOR_ATTR, 1.f, 1.f, 1.f, 1.f);
+}
+
+Painter::~Painter()
+{
+    if (m_quadVertexBuffer != 0)
+        glDeleteBuffers(1, &m_quadVertexBuffer);
+
+    if (m_quadIndexBuffer != 0)
+        glDeleteBuffers(1, &m_quadIndexBuffer);
 }
 
 void Painter::drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode)
@@ -94,26 +106,105 @@ void Painter::drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode)
     m_drawProgram->setOpacity(m_opacity);
     m_drawProgram->setColor(m_color);
     m_drawProgram->setResolution(m_resolution);
-    m_drawProgram->updateTime();
 
-    // only set texture coords arrays when needed
+    // the painter's own programs have no u_Time, it changes on every call
+    if (m_shaderProgram)
+        m_drawProgram->updateTime();
+
     if (textured) {
         m_drawProgram->setTextureMatrix(m_textureMatrix);
         m_drawProgram->bindMultiTextures();
-        m_drawProgram->setAttributeArray(PainterShaderProgram::TEXCOORD_ATTR, coordsBuffer.getTextureCoordArray(), 2);
     } else
         PainterShaderProgram::disableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
 
-    // set vertex array
-    m_drawProgram->setAttributeArray(PainterShaderProgram::VERTEX_ATTR, coordsBuffer.getVertexArray(), 2);
+    m_unbatchedDrawCalls += coordsBuffer.getColorRuns();
 
-    // draw the element in coords buffers
-    glDrawArrays(static_cast<GLenum>(drawMode), 0, vertexCount);
+    if (drawMode == DrawMode::TRIANGLES && coordsBuffer.isQuadList()) {
+        drawQuads(coordsBuffer, textured);
+    } else {
+        // only set texture coords arrays when needed
+        if (textured)
+            m_drawProgram->setAttributeArray(PainterShaderProgram::TEXCOORD_ATTR, coordsBuffer.getTextureCoordArray(), 2);
+
+        // set vertex array
+        m_drawProgram->setAttributeArray(PainterShaderProgram::VERTEX_ATTR, coordsBuffer.getVertexArray(), 2);
+
+        // per vertex colors let draws that only differ by color share one call,
+        // the attribute stays disabled otherwise and reads as white
+        const bool colored = coordsBuffer.hasColors();
+        if (colored) {
+            PainterShaderProgram::enableAttributeArray(PainterShaderProgram::COLOR_ATTR);
+            m_drawProgram->setAttributeArray(PainterShaderProgram::COLOR_ATTR, coordsBuffer.getColorArray());
+        }
+
+        // draw the element in coords buffers
+        glDrawArrays(static_cast<GLenum>(drawMode), 0, vertexCount);
+        ++m_drawCalls;
+
+        if (colored) {
+            PainterShaderProgram::disableAttributeArray(PainterShaderProgram::COLOR_ATTR);
+            m_drawProgram->setAttributeValue(PainterShaderProgram::COLOR_ATTR, 1.f, 1.f, 1.f, 1.f);
+        }
+    }
 
     if (!textured)
         PainterShaderProgram::enableAttributeArray(PainterShaderProgram::TEXCOORD_ATTR);
 }
 
+void Painter::drawQuads(const CoordsBuffer& coordsBuffer, const bool textured)
+{
+    if (m_quadVertexBuffer == 0)
+        createQuadBuffers();
+
+    coordsBuffer.writeQuads(m_quadVertices);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_quadVertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quadIndexBuffer);
+
+    // respecifying the whole store orphans the one the previous draw may still be reading
+    glBufferData(GL_ARRAY_BUFFER, m_quadVertices.size() * sizeof(QuadVertex), m_quadVertices.data(), GL_STREAM_DRAW);
+
+    PainterShaderProgram::enableAttributeArray(PainterShaderProgram::COLOR_ATTR);
+
+    // indices only reach MAX_QUADS_PER_DRAW quads, longer buffers move the attribute base instead
+    const int quadCount = coordsBuffer.getQuadCount();
+    for (int first = 0; first < quadCount; first += MAX_QUADS_PER_DRAW) {
+        const auto* base = reinterpret_cast<const uint8_t*>(first * 4 * sizeof(QuadVertex));
+
+        m_drawProgram->setAttributeArray(PainterShaderProgram::VERTEX_ATTR, reinterpret_cast<const float*>(base + offsetof(QuadVertex, x)), 2, sizeof(QuadVertex));
+        if (textured)
+            m_drawProgram->setAttributeArray(PainterShaderProgram::TEXCOORD_ATTR, reinterpret_cast<const float*>(base + offsetof(QuadVertex, u)), 2, sizeof(QuadVertex));
+        m_drawProgram->setAttributeArray(PainterShaderProgram::COLOR_ATTR, reinterpret_cast<const uint32_t*>(base + offsetof(QuadVertex, color)), sizeof(QuadVertex));
+
+        glDrawElements(GL_TRIANGLES, std::min<int>(quadCount - first, MAX_QUADS_PER_DRAW) * 6, GL_UNSIGNED_SHORT, nullptr);
+        ++m_drawCalls;
+    }
+
+    PainterShaderProgram::disableAttributeArray(PainterShaderProgram::COLOR_ATTR);
+    m_drawProgram->setAttributeValue(PainterShaderProgram::COLOR_ATTR, 1.f, 1.f, 1.f, 1.f);
+
+    // the other paths feed client side arrays
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Painter::createQuadBuffers()
+{
+    std::vector<uint16_t> indices;
+    indices.reserve(MAX_QUADS_PER_DRAW * 6);
+    for (uint32_t corner = 0; corner < MAX_QUADS_PER_DRAW * 4; corner += 4) {
+        for (const uint32_t i : { 0, 1, 2, 2, 1, 3 })
+            indices.emplace_back(corner + i);
+    }
+
+    glGenBuffers(1, &m_quadVertexBuffer);
+    glGenBuffers(1, &m_quadIndexBuffer);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quadIndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
 void Painter::drawLine(const std::vector<float>& vertex, const int size, const int width) const
 {
     m_drawLineProgram->bind();
@@ -219,6 +310,17 @@ void Painter::setTexture(uint32_t textureId, uint16_t textureMatrixId)
     updateGlTexture();
 }
 
+void Painter::uploadTexture(const TexturePtr& texture) { texture->create(); }
+
+void Painter::setBlending(const bool enable)
+{
+    if (m_blending == enable)
+        return;
+
+    m_blending = enable;
+    updateGlBlending();
+}
+
 void Painter::setAlphaWriting(const bool enable)
 {
     if (m_alphaWriting == enable)
@@ -296,4 +398,5 @@ void Painter::updateGlClipRect() const
 void Painter::updateGlTexture() const { if (m_glTextureId != 0) glBindTexture(GL_TEXTURE_2D, m_glTextureId); }
 void Painter::updateGlBlendEquation() const { glBlendEquation(static_cast<GLenum>(m_blendEquation)); }
 void Painter::updateGlAlphaWriting() const { glColorMask(1, 1, 1, m_alphaWriting); }
+void Painter::updateGlBlending() const { m_blending ? glEnable(GL_BLEND) : glDisable(GL_BLEND); }
 void Painter::updateGlViewport() const { glViewport(0, 0, m_resolution.width(), m_resolution.height()); }
@@ -30,12 +30,16 @@ class Painter
 {
 public:
     Painter();
+    virtual ~Painter();
 
-    void clear(const Color& color);
-    void clearRect(const Color& color, const Rect& rect);
+    virtual void clear(const Color& color);
+    virtual void clearRect(const Color& color, const Rect& rect);
 
-    void drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode = DrawMode::TRIANGLES);
-    void drawLine(const std::vector<float>& vertex, int size, int width) const;
+    virtual void drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode = DrawMode::TRIANGLES);
+    virtual void drawLine(const std::vector<float>& vertex, int size, int width) const;
+
+    // uploads the pixels a texture still holds, before it gets bound
+    virtual void uploadTexture(const TexturePtr& texture);
 
     float getOpacity() const { return m_opacity; }
     bool getAlphaWriting() const { return m_alphaWriting; }
@@ -61,6 +65,7 @@ public:
     void setResolution(const Size& resolution, const Matrix3& projectionMatrix = DEFAULT_MATRIX3);
     void setDrawProgram(PainterShaderProgram* drawProgram) { m_drawProgram = drawProgram; }
     void setAlphaWriting(bool enable);
+    void setBlending(bool enable);
     void setBlendEquation(BlendEquation blendEquation);
     void setShaderProgram(PainterShaderProgram* shaderProgram) { m_shaderProgram = shaderProgram; }
     void setShaderProgram(const PainterShaderProgramPtr& shaderProgram) { setShaderProgram(shaderProgram.get()); }
@@ -82,14 +87,30 @@ public:
     void resetTransformMatrix() { setTransformMatrix(DEFAULT_MATRIX3); }
     bool isReplaceColorShader(const PainterShaderProgram* shader) const { return m_drawReplaceColorProgram.get() == shader; }
 
+    // draw calls issued since the last reset, and how many they would have been with colors breaking batches
+    uint32_t getDrawCalls() const { return m_drawCalls; }
+    uint32_t getUnbatchedDrawCalls() const { return m_unbatchedDrawCalls; }
+    void resetDrawCalls() { m_drawCalls = m_unbatchedDrawCalls = 0; }
+
 protected:
+    // for painters that never reach a GL context: no programs are built and nothing is sent to GL
+    struct NoContext {};
+    explicit Painter(NoContext) {}
+
+    // 16-bit indices address four corners per quad
+    static constexpr uint32_t MAX_QUADS_PER_DRAW = 65536 / 4;
+
+    void drawQuads(const CoordsBuffer& coordsBuffer, bool textured);
+    void createQuadBuffers();
+
     void refreshState() const;
-    void updateGlTexture() const;
-    void updateGlCompositionMode() const;
-    void updateGlBlendEquation() const;
-    void updateGlClipRect() const;
-    void updateGlAlphaWriting() const;
-    void updateGlViewport() const;
+    virtual void updateGlTexture() const;
+    virtual void updateGlCompositionMode() const;
+    virtual void updateGlBlendEquation() const;
+    virtual void updateGlClipRect() const;
+    virtual void updateGlAlphaWriting() const;
+    virtual void updateGlBlending() const;
+    virtual void updateGlViewport() const;
 
     Matrix3 m_transformMatrix;
     Matrix3 m_projectionMatrix;
@@ -97,10 +118,18 @@ protected:
 
     BlendEquation m_blendEquation{ BlendEquation::ADD };
     bool m_alphaWriting{ false };
+    bool m_blending{ true };
     uint32_t m_glTextureId{ 0 };
 
     float m_opacity{ 1.f };
 
+    uint32_t m_quadVertexBuffer{ 0 };
+    uint32_t m_quadIndexBuffer{ 0 };
+    std::vector<QuadVertex> m_quadVertices;
+
+    uint32_t m_drawCalls{ 0 };
+    uint32_t m_unbatchedDrawCalls{ 0 };
+
     PainterShaderProgram* m_shaderProgram{ nullptr };
     CompositionMode m_compositionMode{ CompositionMode::NORMAL };
     Color m_color{ Color::white };
@@ -62,6 +62,7 @@ bool PainterShaderProgram::link()
     m_startTime = g_clock.seconds();
     bindAttributeLocation(VERTEX_ATTR, "a_Vertex");
     bindAttributeLocation(TEXCOORD_ATTR, "a_TexCoord");
+    bindAttributeLocation(COLOR_ATTR, "a_Color");
     if (!ShaderProgram::link())
         return false;
 
@@ -31,6 +31,7 @@ protected:
     {
         VERTEX_ATTR = 0,
         TEXCOORD_ATTR = 1,
+        COLOR_ATTR = 2,
         PROJECTION_MATRIX_UNIFORM = 0,
         TEXTURE_MATRIX_UNIFORM = 1,
         COLOR_UNIFORM = 2,
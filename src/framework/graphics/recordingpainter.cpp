@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "recordingpainter.h"
+
+#include "image.h"
+#include "texture.h"
+
+void RecordingPainter::clear(const Color& color)
+{
+    record({ .type = CommandType::CLEAR, .color = color, .rect = Rect(0, 0, m_resolution) });
+}
+
+void RecordingPainter::clearRect(const Color& color, const Rect& rect)
+{
+    record({ .type = CommandType::CLEAR, .color = color, .rect = rect });
+}
+
+void RecordingPainter::drawCoords(const CoordsBuffer& coordsBuffer, const DrawMode drawMode)
+{
+    const int vertexCount = coordsBuffer.getVertexCount();
+    if (vertexCount == 0)
+        return;
+
+    // unlike GL, draws of framebuffer textures still show up, those have no id without a context
+    const bool textured = coordsBuffer.getTextureCoordCount() > 0;
+
+    record({
+        .type = CommandType::DRAW,
+        .textureId = textured ? m_glTextureId : 0,
+        .vertexCount = static_cast<uint32_t>(vertexCount),
+        .value = static_cast<uint32_t>(drawMode),
+        .color = m_color,
+        .rect = m_clipRect,
+        .shaderProgram = m_shaderProgram
+    });
+
+    ++m_drawCalls;
+    m_unbatchedDrawCalls += coordsBuffer.getColorRuns();
+}
+
+void RecordingPainter::drawLine(const std::vector<float>& /*vertex*/, const int size, const int width) const
+{
+    record({ .type = CommandType::DRAW_LINE, .vertexCount = static_cast<uint32_t>(size), .value = static_cast<uint32_t>(width), .color = m_color });
+}
+
+void RecordingPainter::uploadTexture(const TexturePtr& texture)
+{
+    if (!texture->m_image)
+        return;
+
+    const auto& image = texture->m_image;
+    if (texture->m_id == 0) {
+        texture->m_id = texture->m_uniqueId;
+        texture->generateHash();
+    }
+
+    record({
+        .type = CommandType::UPLOAD_TEXTURE,
+        .textureId = texture->m_id,
+        .value = static_cast<uint32_t>(image->getPixelCount() * image->getBpp()),
+        .rect = Rect(Point(), image->getSize())
+    });
+
+    texture->m_image = nullptr;
+}
+
+size_t RecordingPainter::count(const CommandType type) const
+{
+    return std::ranges::count_if(m_commands, [type](const Command& command) { return command.type == type; });
+}
+
+uint64_t RecordingPainter::getDrawnVertexCount() const
+{
+    uint64_t vertices = 0;
+    for (const auto& command : m_commands) {
+        if (command.type == CommandType::DRAW)
+            vertices += command.vertexCount;
+    }
+    return vertices;
+}
+
+void RecordingPainter::updateGlTexture() const
+{
+    if (m_glTextureId != 0)
+        record({ .type = CommandType::BIND_TEXTURE, .textureId = m_glTextureId });
+}
+
+void RecordingPainter::updateGlCompositionMode() const { record({ .type = CommandType::COMPOSITION_MODE, .value = static_cast<uint32_t>(m_compositionMode) }); }
+void RecordingPainter::updateGlBlendEquation() const { record({ .type = CommandType::BLEND_EQUATION, .value = static_cast<uint32_t>(m_blendEquation) }); }
+void RecordingPainter::updateGlClipRect() const { record({ .type = CommandType::CLIP_RECT, .rect = m_clipRect }); }
+void RecordingPainter::updateGlAlphaWriting() const { record({ .type = CommandType::ALPHA_WRITING, .value = m_alphaWriting }); }
+void RecordingPainter::updateGlBlending() const { record({ .type = CommandType::BLENDING, .value = m_blending }); }
+void RecordingPainter::updateGlViewport() const { record({ .type = CommandType::VIEWPORT, .rect = Rect(0, 0, m_resolution) }); }
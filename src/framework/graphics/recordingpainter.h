@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "painter.h"
+
+// Painter that never touches GL. Draw calls, state changes and texture uploads go into a command
+// stream instead, so the draw pools can be exercised by tests and benchmarks on machines without a GPU.
+class RecordingPainter final : public Painter
+{
+public:
+    enum class CommandType : uint8_t
+    {
+        DRAW,
+        DRAW_LINE,
+        CLEAR,
+        BIND_TEXTURE,
+        UPLOAD_TEXTURE,
+        COMPOSITION_MODE,
+        BLEND_EQUATION,
+        CLIP_RECT,
+        ALPHA_WRITING,
+        BLENDING,
+        VIEWPORT
+    };
+
+    struct Command
+    {
+        CommandType type{ CommandType::DRAW };
+        uint32_t textureId{ 0 };
+        uint32_t vertexCount{ 0 };
+        uint32_t value{ 0 }; // draw mode, composition mode, blend equation, flag or uploaded bytes
+        Color color{ Color::white };
+        Rect rect;
+        PainterShaderProgram* shaderProgram{ nullptr };
+    };
+
+    RecordingPainter() : Painter(NoContext{}) {}
+
+    void clear(const Color& color) override;
+    void clearRect(const Color& color, const Rect& rect) override;
+
+    void drawCoords(const CoordsBuffer& coordsBuffer, DrawMode drawMode = DrawMode::TRIANGLES) override;
+    void drawLine(const std::vector<float>& vertex, int size, int width) const override;
+
+    // textures get their unique id in place of a GL name
+    void uploadTexture(const TexturePtr& texture) override;
+
+    const std::vector<Command>& getCommands() const { return m_commands; }
+    size_t count(CommandType type) const;
+    uint64_t getDrawnVertexCount() const;
+    void clearCommands() { m_commands.clear(); }
+
+protected:
+    void updateGlTexture() const override;
+    void updateGlCompositionMode() const override;
+    void updateGlBlendEquation() const override;
+    void updateGlClipRect() const override;
+    void updateGlAlphaWriting() const override;
+    void updateGlBlending() const override;
+    void updateGlViewport() const override;
+
+private:
+    void record(const Command& command) const { m_commands.emplace_back(command); }
+
+    // the GL updaters are const
+    mutable std::vector<Command> m_commands;
+};
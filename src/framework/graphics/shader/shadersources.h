@@ -23,9 +23,12 @@
 #pragma once
 
 static constexpr std::string_view glslMainVertexShader = "\n\
+    attribute lowp vec4 a_Color;\n\
+    varying lowp vec4 v_Color;\n\
     highp vec4 calculatePosition();\n\
     void main() {\n\
         gl_Position = calculatePosition();\n\
+        v_Color = a_Color;\n\
     }\n",
 
     glslMainWithTexCoordsVertexShader = "\n\
@@ -39,6 +42,20 @@ static constexpr std::string_view glslMainVertexShader = "\n\
         v_TexCoord = (u_TextureMatrix * vec3(a_TexCoord,1.0)).xy;\n\
     }\n",
 
+    glslMainWithTexCoordsAndColorVertexShader = "\n\
+    attribute highp vec2 a_TexCoord;\n\
+    attribute lowp vec4 a_Color;\n\
+    uniform highp mat3 u_TextureMatrix;\n\
+    varying highp vec2 v_TexCoord;\n\
+    varying lowp vec4 v_Color;\n\
+    highp vec4 calculatePosition();\n\
+    void main()\n\
+    {\n\
+        gl_Position = calculatePosition();\n\
+        v_TexCoord = (u_TextureMatrix * vec3(a_TexCoord,1.0)).xy;\n\
+        v_Color = a_Color;\n\
+    }\n",
+
     glslPositionOnlyVertexShader = "\n\
     attribute highp vec2 a_Vertex;\n\
     uniform highp mat3 u_TransformMatrix;\n\
@@ -58,16 +75,18 @@ static constexpr std::string_view glslMainVertexShader = "\n\
 
     glslTextureSrcFragmentShader = "\n\
     varying mediump vec2 v_TexCoord;\n\
+    varying lowp vec4 v_Color;\n\
     uniform lowp vec4 u_Color;\n\
     uniform sampler2D u_Tex0;\n\
     lowp vec4 calculatePixel() {\n\
-        return texture2D(u_Tex0, v_TexCoord) * u_Color;\n\
+        return texture2D(u_Tex0, v_TexCoord) * u_Color * v_Color;\n\
     }\n",
 
     glslSolidColorFragmentShader = "\n\
+    varying lowp vec4 v_Color;\n\
     uniform lowp vec4 u_Color;\n\
     lowp vec4 calculatePixel() {\n\
-        return u_Color;\n\
+        return u_Color * v_Color;\n\
     }\n",
 
     glslReplaceColorFragmentShader = "\n\
@@ -59,9 +59,12 @@ public:
     void bindUniformLocation(int location, const char* name);
 
     void setAttributeArray(const int location, const float* values, const int size, const int stride = 0) { glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, stride, values); }
+    // packed RGBA8 values, normalized to vec4
+    void setAttributeArray(const int location, const uint32_t* values, const int stride = 0) { glVertexAttribPointer(location, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, values); }
     void setAttributeValue(const int location, const float value) { glVertexAttrib1f(location, value); }
     void setAttributeValue(const int location, const float x, const float y) { glVertexAttrib2f(location, x, y); }
     void setAttributeValue(const int location, const float x, const float y, const float z) { glVertexAttrib3f(location, x, y, z); }
+    void setAttributeValue(const int location, const float x, const float y, const float z, const float w) { glVertexAttrib4f(location, x, y, z, w); }
     void setAttributeArray(const char* name, const float* values, const int size, const int stride = 0) const
     { glVertexAttribPointer(getAttributeLocation(name), size, GL_FLOAT, GL_FALSE, stride, values); }
     void setAttributeValue(const char* name, const float value) const
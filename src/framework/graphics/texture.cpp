@@ -42,7 +42,8 @@ Texture::Texture(const Size& size) : m_uniqueId(UID.fetch_add(1))
 {
     generateHash();
     g_stats.addTexture();
-    if (!setupSize(size))
+    // headless tools have no GL context to allocate the storage in
+    if (!setupSize(size) || !g_graphics.ok())
         return;
 
     createTexture();
@@ -189,13 +190,14 @@ bool Texture::setupSize(const Size& size)
     if (m_size == size)
         return true;
 
-    // checks texture max size
-    if (std::max<int>(size.width(), size.height()) > g_graphics.getMaxTextureSize()) {
+    // checks texture max size, unknown without a GL context
+    const int maxTextureSize = g_graphics.getMaxTextureSize();
+    if (maxTextureSize > 0 && std::max<int>(size.width(), size.height()) > maxTextureSize) {
         g_logger.error(
             "Loading texture with size {}x{} failed, "
             "the maximum size allowed by the graphics card is {}x{}, "
             "to prevent crashes the texture will be displayed as a blank texture",
-            size.width(), size.height(), g_graphics.getMaxTextureSize(), g_graphics.getMaxTextureSize()
+            size.width(), size.height(), maxTextureSize, maxTextureSize
         );
         return false;
     }
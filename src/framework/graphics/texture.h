@@ -111,4 +111,5 @@ protected:
     friend class GarbageCollection;
     friend class TextureManager;
     friend class TextureAtlas;
+    friend class RecordingPainter;
 };
@@ -164,7 +164,7 @@ void TextureAtlas::flush() {
         for (auto& layer : group.layers) {
             if (!layer.textures.empty()) {
                 layer.framebuffer->bind();
-                glDisable(GL_BLEND);
+                g_painter->setBlending(false);
                 for (const auto& texture : layer.textures) {
                     const int x = texture->x;
                     const int y = texture->y;
@@ -189,7 +189,7 @@ void TextureAtlas::flush() {
 
                     texture->enabled.store(true, std::memory_order_relaxed);
                 }
-                glEnable(GL_BLEND);
+                g_painter->setBlending(true);
                 layer.textures.clear();
                 layer.framebuffer->release();
             }
@@ -194,6 +194,7 @@ public:
     const float* vertices() const { return m_buffer.data(); }
     int vertexCount() const { return m_buffer.size() / 2; }
     int size() const { return m_buffer.size(); }
+    size_t capacity() const { return m_buffer.capacity(); }
 
 private:
     std::vector<float> m_buffer;
@@ -528,7 +528,7 @@ T LuaInterface::castValue(int index)
 template<typename... T>
 int LuaInterface::luaCallGlobalField(const std::string_view global, const std::string_view field, const T&... args)
 {
-    AutoStat s(STATS_LUA, std::string(global) + ":" + std::string(field));
+    AutoStat s(STATS_LUA, global, field, {});
 
     g_lua.getGlobalField(global, field);
     if (!g_lua.isNil()) {
@@ -24,6 +24,8 @@
 
 #include "framework/core/graphicalapplication.h"
 
+#include <typeindex>
+
 int16_t g_luaThreadId = -1;
 
 LuaObject::LuaObject() :
@@ -117,12 +119,23 @@ void LuaObject::luaGetFieldsTable() const
 
 std::string LuaObject::getClassName()
 {
-    // TODO: this could be cached for more performance
+    return std::string(getClassNameView());
+}
+
+std::string_view LuaObject::getClassNameView()
+{
+    thread_local phmap::flat_hash_map<std::type_index, std::string> names;
+
+    const std::type_index type(typeid(*this));
+    auto it = names.find(type);
+    if (it == names.end()) {
 #ifdef _MSC_VER
-    return stdext::demangle_name(typeid(*this).name()) + 6;
+        it = names.emplace(type, stdext::demangle_name(typeid(*this).name()) + 6).first;
 #else
-    return stdext::demangle_name(typeid(*this).name());
+        it = names.emplace(type, stdext::demangle_name(typeid(*this).name())).first;
 #endif
+    }
+    return it->second;
 }
 
 int LuaObject::getUseCount()
@@ -79,6 +79,8 @@ public:
 
     /// Returns the derived class name, its the same name used in Lua
     std::string getClassName();
+    /// Same as getClassName, demangled once per class and thread
+    std::string_view getClassNameView();
 
     LuaObjectPtr asLuaObject() { return shared_from_this(); }
 
@@ -184,7 +186,7 @@ int LuaObject::luaCallLuaField(const std::string_view field, const T&... args)
         return -1;
     }
 
-    AutoStat s(STATS_LUA, getClassName() + ":" + std::string{ field });
+    AutoStat s(STATS_LUA, getClassNameView(), field, {});
 
     // note that the field must be retrieved from this object lua value
     // to force using the __index metamethod of it's metatable
@@ -302,6 +302,10 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_stats", "getSleepTime", &Stats::getSleepTime, &g_stats);
     g_lua.bindSingletonFunction("g_stats", "resetSleepTime", &Stats::resetSleepTime, &g_stats);
     g_lua.bindSingletonFunction("g_stats", "getWidgetsInfo", &Stats::getWidgetsInfo, &g_stats);
+    g_lua.bindSingletonFunction("g_stats", "startTrace", &Stats::startTrace, &g_stats);
+    g_lua.bindSingletonFunction("g_stats", "stopTrace", &Stats::stopTrace, &g_stats);
+    g_lua.bindSingletonFunction("g_stats", "isTracing", &Stats::isTracing, &g_stats);
+    g_lua.bindSingletonFunction("g_stats", "saveTrace", &Stats::saveTrace, &g_stats);
 
     // OTCv8 proxy system
     g_lua.registerSingletonClass("g_proxy");
@@ -456,6 +460,7 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_graphics", "getVendor", &Graphics::getVendor, &g_graphics);
     g_lua.bindSingletonFunction("g_graphics", "getRenderer", &Graphics::getRenderer, &g_graphics);
     g_lua.bindSingletonFunction("g_graphics", "getVersion", &Graphics::getVersion, &g_graphics);
+    g_lua.bindSingletonFunction("g_graphics", "getDrawCallStats", &DrawPoolManager::getDrawCallStats, &g_drawPool);
 
     g_lua.registerSingletonClass("g_atlas");
     g_lua.bindSingletonFunction("g_atlas", "getStats", &DrawPoolManager::getAtlasStats, &g_drawPool);
@@ -1106,6 +1111,12 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_sounds", "isEaxEnabled", &SoundManager::isEaxEnabled, &g_sounds);
     g_lua.bindSingletonFunction("g_sounds", "loadClientFiles", &SoundManager::loadClientFiles, &g_sounds);
     g_lua.bindSingletonFunction("g_sounds", "getAudioFileNameById", &SoundManager::getAudioFileNameById, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "setCacheBudget", &SoundManager::setCacheBudget, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getCacheBudget", &SoundManager::getCacheBudget, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "clearCache", &SoundManager::clearCache, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getCacheStats", &SoundManager::getCacheStats, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "setChannelVoiceLimit", &SoundManager::setChannelVoiceLimit, &g_sounds);
+    g_lua.bindSingletonFunction("g_sounds", "getChannelVoiceLimit", &SoundManager::getChannelVoiceLimit, &g_sounds);
 
     g_lua.registerClass<SoundSource>();
     g_lua.bindClassStaticFunction<SoundSource>("create", [] { return std::make_shared<SoundSource>(); });
@@ -1122,6 +1133,8 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<SoundSource>("setReferenceDistance", &SoundSource::setReferenceDistance);
     g_lua.bindClassMemberFunction<SoundSource>("setEffect", &SoundSource::setEffect);
     g_lua.bindClassMemberFunction<SoundSource>("removeEffect", &SoundSource::removeEffect);
+    g_lua.bindClassMemberFunction<SoundSource>("setPriority", &SoundSource::setPriority);
+    g_lua.bindClassMemberFunction<SoundSource>("getPriority", &SoundSource::getPriority);
     g_lua.registerClass<CombinedSoundSource, SoundSource>();
     g_lua.registerClass<StreamSoundSource, SoundSource>();
 
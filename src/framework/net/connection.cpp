@@ -49,7 +49,7 @@ Connection::~Connection()
 void Connection::poll()
 {
 	// reset must always be called prior to poll
-	AutoStat s(STATS_MAIN, "PollConnection");
+	AutoStat s(TRACE_ZONE(STATS_MAIN, "PollConnection"));
     g_ioService.reset();
     g_ioService.poll();
 }
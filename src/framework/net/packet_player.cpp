@@ -31,32 +31,27 @@ PacketPlayer::~PacketPlayer()
         m_event->cancel();
 }
 
-PacketPlayer::PacketPlayer(const std::string_view& file)
-{
 #ifdef ANDROID
-    std::ifstream f(std::string("records/") + std::string(file));
+PacketPlayer::PacketPlayer(const std::string_view& file) : m_reader(std::string("records/") + std::string(file))
 #else
-    std::ifstream f(std::filesystem::path("records") / file);
+PacketPlayer::PacketPlayer(const std::string_view& file) : m_reader((std::filesystem::path("records") / file).string())
 #endif
-    if (!f.is_open())
-        return;
-    std::string type, packetHex;
-    ticks_t time;
-    while (f >> type >> time >> packetHex) {
-        // Convert hex string to binary data manually
-        std::string packetStr;
-        for (size_t i = 0; i < packetHex.length(); i += 2) {
-            std::string byteString = packetHex.substr(i, 2);
-            char byte = (char)strtol(byteString.c_str(), nullptr, 16);
-            packetStr.push_back(byte);
-        }
-        auto packet = std::make_shared<std::vector<uint8_t>>(packetStr.begin(), packetStr.end());
-        if (type == "<") {
-            m_input.push_back(std::make_pair(time, packet));
-        } else if (type == ">") {
-            m_output.push_back(std::make_pair(time, packet));
-        }
+{
+}
+
+bool PacketPlayer::readInputPacket()
+{
+    if (m_pending.data)
+        return true;
+
+    // client packets are kept in the record for reference only, the player never replays them
+    while (m_reader.next(m_pending)) {
+        if (m_pending.input)
+            return true;
     }
+
+    m_pending.data = nullptr;
+    return false;
 }
 
 void PacketPlayer::start(std::function<void(std::shared_ptr<std::vector<uint8_t>>)> recvCallback,
@@ -83,19 +78,25 @@ void PacketPlayer::onOutputPacket(const OutputMessagePtr& packet)
     }
 }
 
+std::shared_ptr<std::vector<uint8_t>> PacketPlayer::nextInputPacket()
+{
+    if (!readInputPacket())
+        return nullptr;
+
+    return std::move(m_pending.data);
+}
+
 void PacketPlayer::process()
 {
     ticks_t nextPacket = 1;
-    while (!m_input.empty()) {
-        auto& packet = m_input.front();
-        nextPacket = (packet.first + m_start) - g_clock.millis();
+    while (readInputPacket()) {
+        nextPacket = (m_pending.time + m_start) - g_clock.millis();
         if (nextPacket > 1)
             break;
-        m_recvCallback(packet.second);
-        m_input.pop_front();
+        m_recvCallback(std::move(m_pending.data));
     }
 
-    if (!m_input.empty() && nextPacket > 1) {
+    if (m_pending.data && nextPacket > 1) {
         m_event = g_dispatcher.scheduleEvent(std::bind(&PacketPlayer::process, this), nextPacket);
     } else {
         m_disconnectCallback(asio::error::eof);
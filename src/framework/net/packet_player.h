@@ -23,12 +23,14 @@
 #pragma once
 
 #include <framework/net/outputmessage.h>
+#include <framework/net/packet_record.h>
 
 #include "framework/core/declarations.h"
 
 class PacketPlayer : public LuaObject
 {
 public:
+    // hex and binary records are both accepted, packets are read from disk as they are played
     PacketPlayer(const std::string_view& file);
     virtual ~PacketPlayer();
 
@@ -37,13 +39,20 @@ public:
 
     void onOutputPacket(const OutputMessagePtr& packet);
 
+    // pops the next server packet without waiting for its timestamp, nullptr once exhausted
+    std::shared_ptr<std::vector<uint8_t>> nextInputPacket();
+
+    bool isOpen() const { return m_reader.isOpen(); }
+    ticks_t getDuration() const { return m_reader.getDuration(); }
+
 private:
     void process();
+    bool readInputPacket();
 
     ticks_t m_start;
     ScheduledEventPtr m_event;
-    std::deque<std::pair<ticks_t, std::shared_ptr<std::vector<uint8_t>>>> m_input;
-    std::deque<std::pair<ticks_t, std::shared_ptr<std::vector<uint8_t>>>> m_output;
+    PacketRecordReader m_reader;
+    RecordedPacket m_pending;
     std::function<void(std::shared_ptr<std::vector<uint8_t>>)> m_recvCallback;
     std::function<void(std::error_code)> m_disconnectCallback;
 };
@@ -0,0 +1,347 @@
+/*
+* Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#include "packet_record.h"
+
+#include "framework/core/logger.h"
+
+#include <zlib.h>
+
+namespace
+{
+    constexpr std::array<char, 4> RECORD_MAGIC{ 'O', 'T', 'R', 'C' };
+    constexpr std::array<char, 4> INDEX_MAGIC{ 'O', 'T', 'R', 'I' };
+    constexpr uint8_t RECORD_VERSION = 1;
+
+    constexpr size_t HEADER_SIZE = 8;   // magic, version, flags, reserved
+    constexpr size_t FRAME_SIZE = 9;    // kind, time, stored size
+    constexpr size_t FOOTER_SIZE = 16;  // index entries, index offset, magic
+    constexpr size_t INDEX_ENTRY_SIZE = 12;
+
+    constexpr uint8_t FRAME_INPUT = 0x01;
+    constexpr uint8_t FRAME_COMPRESSED = 0x80;
+    // largest packet the protocol can carry, anything bigger is a corrupt frame
+    constexpr uint32_t MAX_PACKET_SIZE = 65535;
+
+    // packets smaller than this rarely shrink enough to pay for the extra raw size field
+    constexpr size_t MIN_COMPRESS_SIZE = 128;
+    constexpr ticks_t INDEX_INTERVAL = 1000;
+    constexpr size_t READ_BUFFER_SIZE = 64 * 1024;
+
+    int hexValue(const char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+}
+
+PacketRecordWriter::PacketRecordWriter(const std::string& path, const PacketRecordFormat format, const bool compress) :
+    m_stream(path, std::ios::binary), m_format(format), m_compress(compress)
+{
+    if (!m_stream.is_open() || m_format != PacketRecordFormat::Binary)
+        return;
+
+    std::array<uint8_t, HEADER_SIZE> header{};
+    std::memcpy(header.data(), RECORD_MAGIC.data(), RECORD_MAGIC.size());
+    header[4] = RECORD_VERSION;
+    header[5] = m_compress ? 1 : 0;
+    m_stream.write(reinterpret_cast<const char*>(header.data()), header.size());
+    m_offset = header.size();
+}
+
+PacketRecordWriter::~PacketRecordWriter()
+{
+    finish();
+}
+
+void PacketRecordWriter::write(const bool input, const ticks_t time, const uint8_t* data, const size_t size)
+{
+    if (!m_stream.is_open() || m_finished)
+        return;
+
+    if (m_format == PacketRecordFormat::Binary)
+        writeBinary(input, time, data, size);
+    else
+        writeHex(input, time, data, size);
+}
+
+void PacketRecordWriter::writeHex(const bool input, const ticks_t time, const uint8_t* data, const size_t size)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+
+    m_buffer.resize(size * 2);
+    for (size_t i = 0; i < size; ++i) {
+        m_buffer[i * 2] = digits[data[i] >> 4];
+        m_buffer[i * 2 + 1] = digits[data[i] & 0x0F];
+    }
+
+    m_stream << (input ? "< " : "> ") << time << ' ';
+    m_stream.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+    m_stream << '\n';
+}
+
+void PacketRecordWriter::writeBinary(const bool input, const ticks_t time, const uint8_t* data, const size_t size)
+{
+    if (time >= m_nextIndexTime) {
+        m_index.push_back({ static_cast<uint32_t>(time), m_offset });
+        m_nextIndexTime = time + INDEX_INTERVAL;
+    }
+
+    uint8_t kind = input ? FRAME_INPUT : 0;
+    const uint8_t* payload = data;
+    size_t payloadSize = size;
+
+    if (m_compress && size >= MIN_COMPRESS_SIZE) {
+        uLongf compressedSize = compressBound(size);
+        m_buffer.resize(compressedSize);
+        if (compress2(m_buffer.data(), &compressedSize, data, size, Z_BEST_SPEED) == Z_OK && compressedSize + 4 < size) {
+            kind |= FRAME_COMPRESSED;
+            payload = m_buffer.data();
+            payloadSize = compressedSize;
+        }
+    }
+
+    std::array<uint8_t, FRAME_SIZE + 4> frame{};
+    size_t frameSize = FRAME_SIZE;
+    frame[0] = kind;
+    stdext::writeULE32(frame.data() + 1, static_cast<uint32_t>(time));
+    stdext::writeULE32(frame.data() + 5, static_cast<uint32_t>(payloadSize));
+    if (kind & FRAME_COMPRESSED) {
+        stdext::writeULE32(frame.data() + 9, static_cast<uint32_t>(size));
+        frameSize += 4;
+    }
+
+    m_stream.write(reinterpret_cast<const char*>(frame.data()), frameSize);
+    m_stream.write(reinterpret_cast<const char*>(payload), payloadSize);
+    m_offset += frameSize + payloadSize;
+}
+
+void PacketRecordWriter::finish()
+{
+    if (m_finished || !m_stream.is_open())
+        return;
+
+    m_finished = true;
+    if (m_format == PacketRecordFormat::Binary) {
+        std::vector<uint8_t> index(m_index.size() * INDEX_ENTRY_SIZE + FOOTER_SIZE);
+        uint8_t* it = index.data();
+        for (const auto& entry : m_index) {
+            stdext::writeULE32(it, entry.time);
+            stdext::writeULE64(it + 4, entry.offset);
+            it += INDEX_ENTRY_SIZE;
+        }
+        stdext::writeULE32(it, static_cast<uint32_t>(m_index.size()));
+        stdext::writeULE64(it + 4, m_offset);
+        std::memcpy(it + 12, INDEX_MAGIC.data(), INDEX_MAGIC.size());
+        m_stream.write(reinterpret_cast<const char*>(index.data()), index.size());
+    }
+    m_stream.close();
+}
+
+PacketRecordReader::PacketRecordReader(const std::string& path) : m_streamBuffer(READ_BUFFER_SIZE)
+{
+    m_stream.rdbuf()->pubsetbuf(m_streamBuffer.data(), m_streamBuffer.size());
+    m_stream.open(path, std::ios::binary);
+    if (!m_stream.is_open())
+        return;
+
+    m_open = true;
+
+    std::array<char, HEADER_SIZE> header{};
+    if (!m_stream.read(header.data(), header.size()) || !std::equal(RECORD_MAGIC.begin(), RECORD_MAGIC.end(), header.begin())) {
+        // not a binary record, read it back as hex lines from the start
+        m_stream.clear();
+        m_stream.seekg(0);
+        return;
+    }
+
+    if (header[4] != RECORD_VERSION) {
+        g_logger.error("Unsupported packet record version {} in {}", static_cast<int>(header[4]), path);
+        m_open = false;
+        return;
+    }
+
+    m_format = PacketRecordFormat::Binary;
+
+    m_stream.seekg(0, std::ios::end);
+    const uint64_t fileSize = m_stream.tellg();
+    m_dataEnd = fileSize;
+    readIndex(fileSize);
+    m_stream.seekg(HEADER_SIZE);
+}
+
+void PacketRecordReader::readIndex(const uint64_t fileSize)
+{
+    // records that were not closed properly (crash, killed client) have no footer and are read until the last full frame
+    if (fileSize < HEADER_SIZE + FOOTER_SIZE)
+        return;
+
+    std::array<uint8_t, FOOTER_SIZE> footer{};
+    m_stream.seekg(fileSize - FOOTER_SIZE);
+    if (!m_stream.read(reinterpret_cast<char*>(footer.data()), footer.size()) || std::memcmp(footer.data() + 12, INDEX_MAGIC.data(), INDEX_MAGIC.size()) != 0) {
+        m_stream.clear();
+        return;
+    }
+
+    const uint32_t count = stdext::readULE32(footer.data());
+    const uint64_t indexOffset = stdext::readULE64(footer.data() + 4);
+    if (indexOffset < HEADER_SIZE || indexOffset + count * INDEX_ENTRY_SIZE + FOOTER_SIZE != fileSize)
+        return;
+
+    std::vector<uint8_t> entries(count * INDEX_ENTRY_SIZE);
+    m_stream.seekg(indexOffset);
+    if (!m_stream.read(reinterpret_cast<char*>(entries.data()), entries.size())) {
+        m_stream.clear();
+        return;
+    }
+
+    m_dataEnd = indexOffset;
+    m_index.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        m_index[i].time = stdext::readULE32(entries.data() + i * INDEX_ENTRY_SIZE);
+        m_index[i].offset = stdext::readULE64(entries.data() + i * INDEX_ENTRY_SIZE + 4);
+    }
+
+    if (!m_index.empty()) {
+        // the index only marks the first packet of each interval, so the exact end lies past the last entry
+        m_duration = m_index.back().time + INDEX_INTERVAL;
+    }
+}
+
+bool PacketRecordReader::next(RecordedPacket& packet)
+{
+    if (!m_open)
+        return false;
+
+    return m_format == PacketRecordFormat::Binary ? nextBinary(packet) : nextHex(packet);
+}
+
+bool PacketRecordReader::nextHex(RecordedPacket& packet)
+{
+    while (std::getline(m_stream, m_line)) {
+        const auto typeEnd = m_line.find(' ');
+        const auto timeEnd = typeEnd == std::string::npos ? std::string::npos : m_line.find(' ', typeEnd + 1);
+        if (timeEnd == std::string::npos)
+            continue;
+
+        const auto type = std::string_view(m_line).substr(0, typeEnd);
+        if (type != "<" && type != ">")
+            continue;
+
+        ticks_t time = 0;
+        std::from_chars(m_line.data() + typeEnd + 1, m_line.data() + timeEnd, time);
+
+        size_t hexEnd = m_line.size();
+        while (hexEnd > timeEnd + 1 && std::isspace(static_cast<unsigned char>(m_line[hexEnd - 1])))
+            --hexEnd;
+
+        auto data = std::make_shared<std::vector<uint8_t>>();
+        data->reserve((hexEnd - timeEnd - 1) / 2);
+        for (size_t i = timeEnd + 1; i + 1 < hexEnd; i += 2) {
+            const int high = hexValue(m_line[i]);
+            const int low = hexValue(m_line[i + 1]);
+            if (high < 0 || low < 0)
+                break;
+            data->push_back(static_cast<uint8_t>(high << 4 | low));
+        }
+
+        packet.time = time;
+        packet.input = type == "<";
+        packet.data = std::move(data);
+        return true;
+    }
+    return false;
+}
+
+bool PacketRecordReader::nextBinary(RecordedPacket& packet)
+{
+    const uint64_t position = m_stream.tellg();
+    if (!m_stream || position + FRAME_SIZE > m_dataEnd)
+        return false;
+
+    std::array<uint8_t, FRAME_SIZE + 4> frame{};
+    if (!m_stream.read(reinterpret_cast<char*>(frame.data()), FRAME_SIZE))
+        return false;
+
+    const uint8_t kind = frame[0];
+    const uint32_t storedSize = stdext::readULE32(frame.data() + 5);
+    uint32_t size = storedSize;
+    uint64_t frameEnd = position + FRAME_SIZE + storedSize;
+    if (kind & FRAME_COMPRESSED) {
+        if (!m_stream.read(reinterpret_cast<char*>(frame.data() + FRAME_SIZE), 4))
+            return false;
+        size = stdext::readULE32(frame.data() + FRAME_SIZE);
+        frameEnd += 4;
+    }
+
+    if (frameEnd > m_dataEnd)
+        return false; // truncated last frame
+
+    // a frame is only stored compressed when that makes it smaller
+    if (size > MAX_PACKET_SIZE || storedSize > size) {
+        g_logger.error("Corrupted packet size {} in record at offset {}", size, position);
+        return false;
+    }
+
+    auto data = std::make_shared<std::vector<uint8_t>>(size);
+    if (kind & FRAME_COMPRESSED) {
+        m_buffer.resize(storedSize);
+        if (!m_stream.read(reinterpret_cast<char*>(m_buffer.data()), storedSize))
+            return false;
+
+        uLongf rawSize = size;
+        if (uncompress(data->data(), &rawSize, m_buffer.data(), storedSize) != Z_OK || rawSize != size) {
+            g_logger.error("Corrupted compressed packet in record at offset {}", position);
+            return false;
+        }
+    } else if (!m_stream.read(reinterpret_cast<char*>(data->data()), size))
+        return false;
+
+    packet.time = stdext::readULE32(frame.data() + 1);
+    packet.input = kind & FRAME_INPUT;
+    packet.data = std::move(data);
+    return true;
+}
+
+bool convertPacketRecord(const std::string& from, const std::string& to, const PacketRecordFormat format)
+{
+    PacketRecordReader reader(from);
+    if (!reader.isOpen()) {
+        g_logger.error("Unable to open packet record {}", from);
+        return false;
+    }
+
+    PacketRecordWriter writer(to, format);
+    if (!writer.isOpen()) {
+        g_logger.error("Unable to create packet record {}", to);
+        return false;
+    }
+
+    RecordedPacket packet;
+    while (reader.next(packet))
+        writer.write(packet.input, packet.time, packet.data->data(), packet.data->size());
+
+    writer.finish();
+    return true;
+}
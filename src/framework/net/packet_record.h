@@ -0,0 +1,120 @@
+/*
+* Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "declarations.h"
+
+#include "framework/stdext/types.h"
+
+#include <fstream>
+#include <vector>
+
+// Recorded sessions (records/*) come in two formats:
+//  - Hex: one "<|> time hexpayload" text line per packet, the original human readable format.
+//  - Binary: an 8 byte header followed by length-prefixed frames, optionally zlib compressed,
+//    and a footer with a timestamp index written when the recording is closed.
+// Both are read as a stream, so playback memory does not grow with the record length.
+enum class PacketRecordFormat : uint8_t
+{
+    Hex,
+    Binary
+};
+
+struct RecordedPacket
+{
+    ticks_t time{ 0 };
+    bool input{ false }; // server -> client
+    std::shared_ptr<std::vector<uint8_t>> data;
+};
+
+class PacketRecordWriter
+{
+public:
+    PacketRecordWriter(const std::string& path, PacketRecordFormat format, bool compress = true);
+    ~PacketRecordWriter();
+
+    bool isOpen() const { return m_stream.is_open(); }
+
+    void write(bool input, ticks_t time, const uint8_t* data, size_t size);
+
+    // flushes the binary index footer, called by the destructor
+    void finish();
+
+private:
+    struct IndexEntry
+    {
+        uint32_t time;
+        uint64_t offset;
+    };
+
+    void writeHex(bool input, ticks_t time, const uint8_t* data, size_t size);
+    void writeBinary(bool input, ticks_t time, const uint8_t* data, size_t size);
+
+    std::ofstream m_stream;
+    PacketRecordFormat m_format;
+    bool m_compress;
+    bool m_finished{ false };
+    uint64_t m_offset{ 0 };
+    int64_t m_nextIndexTime{ 0 };
+    std::vector<IndexEntry> m_index;
+    std::vector<uint8_t> m_buffer;
+};
+
+class PacketRecordReader
+{
+public:
+    explicit PacketRecordReader(const std::string& path);
+
+    bool isOpen() const { return m_open; }
+    PacketRecordFormat getFormat() const { return m_format; }
+
+    // total length of a binary record with an index, 0 when unknown
+    ticks_t getDuration() const { return m_index.empty() ? 0 : m_duration; }
+
+    // reads the next packet in the record, false at the end (or at a truncated frame)
+    bool next(RecordedPacket& packet);
+
+private:
+    struct IndexEntry
+    {
+        uint32_t time;
+        uint64_t offset;
+    };
+
+    bool nextHex(RecordedPacket& packet);
+    bool nextBinary(RecordedPacket& packet);
+    void readIndex(uint64_t fileSize);
+
+    std::ifstream m_stream;
+    std::vector<char> m_streamBuffer;
+    PacketRecordFormat m_format{ PacketRecordFormat::Hex };
+    bool m_open{ false };
+    uint64_t m_dataEnd{ 0 };
+    ticks_t m_duration{ 0 };
+    std::vector<IndexEntry> m_index;
+    std::vector<uint8_t> m_buffer;
+    std::string m_line;
+};
+
+// rewrites a record in another format, returns false if either file cannot be opened
+bool convertPacketRecord(const std::string& from, const std::string& to, PacketRecordFormat format);
@@ -28,13 +28,14 @@
 PacketRecorder::PacketRecorder(const std::string_view& file)
 {
     m_start = g_clock.millis();
+    const auto format = file.ends_with(".otrec") ? PacketRecordFormat::Binary : PacketRecordFormat::Hex;
 #ifdef ANDROID
     g_resources.makeDir("records");
-    m_stream = std::ofstream(std::string("records/") + std::string(file));
+    m_writer = std::make_unique<PacketRecordWriter>(std::string("records/") + std::string(file), format);
 #else
     std::error_code ec;
     std::filesystem::create_directory("records", ec);
-    m_stream = std::ofstream(std::filesystem::path("records") / file);
+    m_writer = std::make_unique<PacketRecordWriter>((std::filesystem::path("records") / file).string(), format);
 #endif
 }
 
@@ -44,11 +45,8 @@ PacketRecorder::~PacketRecorder()
 
 void PacketRecorder::addInputPacket(const InputMessagePtr& packet)
 {
-    m_stream << "< " << (g_clock.millis() - m_start) << " ";
-    for (auto& buffer : packet->getBodyBuffer()) {
-        m_stream << std::setfill('0') << std::setw(2) << std::hex << (uint16_t)(uint8_t)buffer;
-    }
-    m_stream << std::dec << "\n";
+    const auto& body = packet->getBodyBuffer();
+    m_writer->write(true, g_clock.millis() - m_start, reinterpret_cast<const uint8_t*>(body.data()), body.size());
 }
 
 void PacketRecorder::addOutputPacket(const OutputMessagePtr& packet)
@@ -59,9 +57,6 @@ void PacketRecorder::addOutputPacket(const OutputMessagePtr& packet)
         return;
     }
 
-    m_stream << "> " << (g_clock.millis() - m_start) << " ";
-    for (auto& buffer : packet->getBuffer()) {
-        m_stream << std::setfill('0') << std::setw(2) << std::hex << (uint16_t)(uint8_t)buffer;
-    }
-    m_stream << std::dec << "\n";
-}
\ No newline at end of file
+    const auto& buffer = packet->getBuffer();
+    m_writer->write(false, g_clock.millis() - m_start, reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size());
+}
@@ -22,11 +22,13 @@
 
 #pragma once
 #include "declarations.h"
+#include "packet_record.h"
 #include "framework/luaengine/luaobject.h"
 
 class PacketRecorder : public LuaObject
 {
 public:
+    // files ending in ".otrec" are written in the binary format, anything else as hex text
     PacketRecorder(const std::string_view& file);
     virtual ~PacketRecorder();
 
@@ -35,6 +37,6 @@ public:
 
 private:
     ticks_t m_start;
-    std::ofstream m_stream;
+    std::unique_ptr<PacketRecordWriter> m_writer;
     bool m_firstOutput = true;
 };
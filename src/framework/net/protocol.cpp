@@ -479,16 +479,21 @@ void Protocol::onPlayerPacket(const std::shared_ptr<std::vector<uint8_t>>& packe
     post(g_ioService, [&, packet] {
         if (m_disconnected)
             return;
-        m_inputMessage->reset();
-
-        m_inputMessage->setHeaderSize(0);
-        m_inputMessage->fillBuffer(packet->data(), packet->size());
-        m_inputMessage->setMessageSize(packet->size());
-        onRecv(m_inputMessage);
+        processPlayerPacket(packet);
     });
 #endif
 }
 
+void Protocol::processPlayerPacket(const std::shared_ptr<std::vector<uint8_t>>& packet)
+{
+    m_inputMessage->reset();
+
+    m_inputMessage->setHeaderSize(0);
+    m_inputMessage->fillBuffer(packet->data(), packet->size());
+    m_inputMessage->setMessageSize(packet->size());
+    onRecv(m_inputMessage);
+}
+
 void Protocol::playRecord(PacketPlayerPtr player)
 {
     m_disconnected = false;
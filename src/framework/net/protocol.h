@@ -48,6 +48,8 @@ public:
 
     void setRecorder(PacketRecorderPtr recorder);
     void playRecord(PacketPlayerPtr player);
+    // parses a recorded packet synchronously, bypassing the io service (headless replays)
+    void processPlayerPacket(const std::shared_ptr<std::vector<uint8_t>>& packet);
 
     bool isConnected();
     bool isConnecting();
@@ -519,7 +519,7 @@ void WIN32Window::maximize()
 
 void WIN32Window::poll()
 {
-    AutoStat s(STATS_RENDER, "PollWindow");
+    AutoStat s(TRACE_ZONE(STATS_RENDER, "PollWindow"));
     fireKeysPress();
     MSG msg;
     while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
@@ -819,7 +819,7 @@ void X11Window::maximize()
 
 void X11Window::poll()
 {
-    AutoStat s(STATS_RENDER, "PollWindow");
+    AutoStat s(TRACE_ZONE(STATS_RENDER, "PollWindow"));
     bool needsResizeUpdate = false;
 
     XEvent event, peekEvent;
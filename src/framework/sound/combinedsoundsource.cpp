@@ -22,8 +22,6 @@
 
 #include "combinedsoundsource.h"
 
-CombinedSoundSource::CombinedSoundSource() : SoundSource(0) {}
-
 void CombinedSoundSource::addSource(const SoundSourcePtr& source)
 {
     m_sources.emplace_back(source);
@@ -31,8 +29,12 @@ void CombinedSoundSource::addSource(const SoundSourcePtr& source)
 
 void CombinedSoundSource::play()
 {
-    for (const auto& source : m_sources)
+    // every part takes its own voice, under the channel and priority of the whole
+    for (const auto& source : m_sources) {
+        source->m_channel = m_channel;
+        source->m_priority = m_priority;
         source->play();
+    }
 }
 
 void CombinedSoundSource::stop()
@@ -27,8 +27,6 @@
 class CombinedSoundSource final : public SoundSource
 {
 public:
-    CombinedSoundSource();
-
     void addSource(const SoundSourcePtr& source);
     std::vector<SoundSourcePtr> getSources() { return m_sources; }
 
@@ -42,6 +42,7 @@ class StreamSoundSource;
 class CombinedSoundSource;
 class OggSoundFile;
 class SoundEffect;
+class SoundStream;
 
 using SoundSourcePtr = std::shared_ptr<SoundSource>;
 using SoundFilePtr = std::shared_ptr<SoundFile>;
@@ -51,3 +52,4 @@ using StreamSoundSourcePtr = std::shared_ptr<StreamSoundSource>;
 using CombinedSoundSourcePtr = std::shared_ptr<CombinedSoundSource>;
 using OggSoundFilePtr = std::shared_ptr<OggSoundFile>;
 using SoundEffectPtr = std::shared_ptr<SoundEffect>;
+using SoundStreamPtr = std::shared_ptr<SoundStream>;
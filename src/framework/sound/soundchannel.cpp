@@ -32,7 +32,7 @@ SoundSourcePtr SoundChannel::play(const std::string& filename, const float fadet
     if (m_currentSource)
         m_currentSource->stop();
 
-    m_currentSource = g_sounds.play(filename, fadetime, m_gain * gain, pitch);
+    m_currentSource = g_sounds.play(filename, fadetime, m_gain * gain, pitch, m_id);
     return m_currentSource;
 }
 
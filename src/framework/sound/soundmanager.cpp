@@ -31,10 +31,10 @@
 #include "soundeffect.h"
 #include "soundfile.h"
 #include "soundsource.h"
+#include "soundstream.h"
 #include "streamsoundsource.h"
 #include "combinedsoundsource.h"
 #include "client/game.h"
-#include "framework/core/asyncdispatcher.h"
 #include "framework/core/clock.h"
 #include "framework/core/garbagecollection.h"
 #include "framework/core/resourcemanager.h"
@@ -50,6 +50,9 @@ SoundManager g_sounds;
 
 void SoundManager::init()
 {
+    m_stopStreaming = false;
+    m_streamThread = std::thread([this] { streamLoop(); });
+
 #ifdef ANDROID
     // The alcOpenDevice call needs to be executed on Android main thread
     g_androidManager.attachToAppMainThread();
@@ -70,22 +73,46 @@ void SoundManager::init()
     if (alcMakeContextCurrent(m_context) != ALC_TRUE) {
         g_logger.error(fmt::format("unable to make context current: {}", alcGetString(m_device, alcGetError(m_device))));
     }
+
+    // the device may support fewer sources than we ask for, the pool is whatever it gives
+    for (int i = 0; i < MAX_VOICES; ++i) {
+        ALuint id = 0;
+        alGenSources(1, &id);
+        if (alGetError() != AL_NO_ERROR)
+            break;
+        m_voices.push_back({ id });
+    }
 }
 
 void SoundManager::terminate()
 {
     ensureContext();
 
-    for (auto& streamFile : m_streamFiles) {
-        auto& future = streamFile.second;
-        future.wait();
+    {
+        std::scoped_lock lock(m_streamMutex);
+        m_stopStreaming = true;
     }
-    m_streamFiles.clear();
+    m_streamCondition.notify_one();
+    if (m_streamThread.joinable())
+        m_streamThread.join();
+    m_streams.clear();
 
     m_sources.clear();
-    m_buffers.clear();
     m_channels.clear();
 
+    // sources still held by lua outlive the pool, they just lose their voices
+    for (auto& voice : m_voices) {
+        if (voice.owner) {
+            auto* owner = voice.owner;
+            resetVoice(voice);
+            owner->voiceLost();
+        }
+        alDeleteSources(1, &voice.id);
+    }
+    m_voices.clear();
+
+    clearCache();
+
     m_audioEnabled = false;
 
     alcMakeContextCurrent(nullptr);
@@ -103,7 +130,7 @@ void SoundManager::terminate()
 
 void SoundManager::poll()
 {
-    AutoStat s(STATS_MAIN, "PollSounds");
+    AutoStat s(TRACE_ZONE(STATS_MAIN, "PollSounds"));
     static ticks_t lastUpdate = 0;
     static uint_fast8_t soundsErased = 0;
 
@@ -116,22 +143,7 @@ void SoundManager::poll()
 
     ensureContext();
 
-    for (auto it = m_streamFiles.begin(); it != m_streamFiles.end();) {
-        const auto& source = it->first;
-        const auto& future = it->second;
-
-        if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            const auto& sound = future.get();
-            if (sound)
-                source->setSoundFile(sound);
-            else
-                source->stop();
-
-            it = m_streamFiles.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    updateStreams();
 
     for (auto it = m_sources.begin(); it != m_sources.end();) {
         const auto& source = *it;
@@ -139,6 +151,8 @@ void SoundManager::poll()
         source->update();
 
         if (!source->isPlaying()) {
+            // hand the voice back to the pool
+            source->stop();
             ++soundsErased;
             it = m_sources.erase(it);
         } else
@@ -149,6 +163,13 @@ void SoundManager::poll()
         it.second->update();
     }
 
+    // sources drained their fragment queues, let the decoder refill them
+    {
+        std::scoped_lock lock(m_streamMutex);
+        m_streamWake = true;
+    }
+    m_streamCondition.notify_one();
+
     if (m_context) {
         alcProcessContext(m_context);
     }
@@ -160,6 +181,254 @@ void SoundManager::poll()
     }
 }
 
+void SoundManager::updateStreams()
+{
+    struct Decoded
+    {
+        std::string filename;
+        std::vector<char> samples;
+        ALenum format{ AL_NONE };
+        int rate{ 0 };
+    };
+    std::vector<Decoded> decoded;
+
+    {
+        std::scoped_lock lock(m_streamMutex);
+        std::erase_if(m_streams, [&](const SoundStreamPtr& stream) {
+            Decoded file{ stream->getFilename() };
+            if (stream->takeDecoded(file.samples, file.format, file.rate))
+                decoded.emplace_back(std::move(file));
+
+            // no source left to play it and nothing more to decode for the cache
+            return stream.use_count() == 1 && !stream->isDecoding();
+        });
+    }
+
+    for (const auto& file : decoded)
+        cacheSound(file.filename, file.samples, file.format, file.rate);
+}
+
+void SoundManager::streamLoop()
+{
+    std::vector<SoundStreamPtr> streams;
+    bool busy = false;
+
+    while (true) {
+        {
+            std::unique_lock lock(m_streamMutex);
+            if (!busy)
+                m_streamCondition.wait_for(lock, std::chrono::milliseconds(STREAM_IDLE_DELAY), [this] { return m_streamWake || m_stopStreaming; });
+            if (m_stopStreaming)
+                break;
+            m_streamWake = false;
+            streams = m_streams;
+        }
+
+        busy = false;
+        for (const auto& stream : streams)
+            busy |= stream->decode();
+        streams.clear();
+    }
+}
+
+SoundStreamPtr SoundManager::createStream(const std::string& filename, std::vector<StreamSoundSource::DownMix> consumers)
+{
+    const auto& stream = std::make_shared<SoundStream>(filename, std::move(consumers), m_cache.contains(filename) ? 0 : MAX_CACHE_SIZE);
+    {
+        std::scoped_lock lock(m_streamMutex);
+        m_streams.emplace_back(stream);
+        m_streamWake = true;
+    }
+    m_streamCondition.notify_one();
+    return stream;
+}
+
+void SoundManager::cacheSound(const std::string& filename, const std::vector<char>& samples, const ALenum format, const int rate)
+{
+    if (samples.empty() || m_cache.contains(filename))
+        return;
+
+    if (m_cacheBudget > 0 && samples.size() > m_cacheBudget)
+        return;
+
+    ensureContext();
+
+    CachedSound sound;
+    sound.bytes = samples.size();
+
+#if defined __linux && !defined OPENGL_ES
+    // stereo is played as two mono sources on linux, see createSoundSource
+    if (format == AL_FORMAT_STEREO16) {
+        const auto& left = SoundStream::extractChannel(samples.data(), samples.size(), 0);
+        const auto& right = SoundStream::extractChannel(samples.data(), samples.size(), 1);
+        sound.left = std::make_shared<SoundBuffer>();
+        sound.right = std::make_shared<SoundBuffer>();
+        if (!sound.left->fillBuffer(AL_FORMAT_MONO16, left, left.size(), rate) || !sound.right->fillBuffer(AL_FORMAT_MONO16, right, right.size(), rate))
+            return;
+    } else
+#endif
+    {
+        sound.buffer = std::make_shared<SoundBuffer>();
+        if (!sound.buffer->fillBuffer(format, samples, samples.size(), rate))
+            return;
+    }
+
+    m_cacheLru.emplace_front(filename);
+    sound.lruIt = m_cacheLru.begin();
+    m_cachedBytes += sound.bytes;
+    m_cache.emplace(filename, std::move(sound));
+
+    evictSounds();
+}
+
+void SoundManager::evictSounds()
+{
+    if (m_cacheBudget == 0)
+        return;
+
+    // sources still playing an evicted sound keep its buffers alive until they stop
+    while (m_cachedBytes > m_cacheBudget && !m_cacheLru.empty()) {
+        const auto it = m_cache.find(m_cacheLru.back());
+        m_cachedBytes -= it->second.bytes;
+        m_cache.erase(it);
+        m_cacheLru.pop_back();
+        ++m_cacheEvictions;
+    }
+}
+
+void SoundManager::setCacheBudget(const size_t bytes)
+{
+    m_cacheBudget = bytes;
+    evictSounds();
+}
+
+void SoundManager::clearCache()
+{
+    ensureContext();
+    m_cache.clear();
+    m_cacheLru.clear();
+    m_cachedBytes = 0;
+}
+
+std::map<std::string, uint64_t> SoundManager::getCacheStats() const
+{
+    const auto voicesInUse = static_cast<uint64_t>(std::ranges::count_if(m_voices, [](const Voice& voice) { return voice.owner != nullptr; }));
+
+    return {
+        { "hits", m_cacheHits },
+        { "misses", m_cacheMisses },
+        { "evictions", m_cacheEvictions },
+        { "residentBytes", m_cachedBytes },
+        { "residentSounds", m_cache.size() },
+        { "budget", m_cacheBudget },
+        { "voices", m_voices.size() },
+        { "voicesInUse", voicesInUse },
+        { "voicesStolen", m_voicesStolen },
+        { "voicesDenied", m_voicesDenied }
+    };
+}
+
+void SoundManager::setChannelVoiceLimit(const int channel, const int limit)
+{
+    if (limit > 0)
+        m_channelVoiceLimits[channel] = limit;
+    else
+        m_channelVoiceLimits.erase(channel);
+}
+
+int SoundManager::getChannelVoiceLimit(const int channel) const
+{
+    const auto it = m_channelVoiceLimits.find(channel);
+    return it != m_channelVoiceLimits.end() ? it->second : 0;
+}
+
+ALuint SoundManager::acquireVoice(SoundSource* source)
+{
+    Voice* chosen = nullptr;
+
+    // a channel at its limit can only recycle one of its own voices
+    if (const auto it = m_channelVoiceLimits.find(source->m_channel); source->m_channel != 0 && it != m_channelVoiceLimits.end()) {
+        int used = 0;
+        Voice* oldest = nullptr;
+        for (auto& voice : m_voices) {
+            if (!voice.owner || voice.owner->m_channel != source->m_channel)
+                continue;
+
+            ++used;
+            if (voice.owner->m_priority <= source->m_priority && (!oldest || voice.startedAt < oldest->startedAt))
+                oldest = &voice;
+        }
+
+        if (used >= it->second) {
+            if (!oldest) {
+                ++m_voicesDenied;
+                return 0;
+            }
+            chosen = oldest;
+        }
+    }
+
+    if (!chosen) {
+        for (auto& voice : m_voices) {
+            if (!voice.owner) {
+                chosen = &voice;
+                break;
+            }
+        }
+    }
+
+    // steal the lowest priority voice, the oldest among equals
+    if (!chosen) {
+        for (auto& voice : m_voices) {
+            if (voice.owner->m_priority > source->m_priority)
+                continue;
+
+            if (!chosen || voice.owner->m_priority < chosen->owner->m_priority
+                || (voice.owner->m_priority == chosen->owner->m_priority && voice.startedAt < chosen->startedAt))
+                chosen = &voice;
+        }
+    }
+
+    if (!chosen) {
+        ++m_voicesDenied;
+        return 0;
+    }
+
+    if (chosen->owner) {
+        auto* owner = chosen->owner;
+        resetVoice(*chosen);
+        owner->voiceLost();
+        ++m_voicesStolen;
+    }
+
+    chosen->owner = source;
+    chosen->startedAt = g_clock.millis();
+    return chosen->id;
+}
+
+void SoundManager::releaseVoice(SoundSource* source)
+{
+    for (auto& voice : m_voices) {
+        if (voice.owner == source) {
+            resetVoice(voice);
+            break;
+        }
+    }
+    source->m_sourceId = 0;
+}
+
+void SoundManager::resetVoice(Voice& voice)
+{
+    // rewinding leaves the voice in its initial state for the next owner
+    alSourceRewind(voice.id);
+    alSourcei(voice.id, AL_BUFFER, AL_NONE);
+    if (voice.owner->m_effectSlot != 0)
+        alSource3i(voice.id, AL_AUXILIARY_SEND_FILTER, AL_EFFECTSLOT_NULL, 0, AL_FILTER_NULL);
+    alGetError();
+
+    voice.owner = nullptr;
+}
+
 void SoundManager::setAudioEnabled(const bool enable)
 {
     if (m_audioEnabled == enable)
@@ -178,23 +447,22 @@ void SoundManager::preload(std::string filename)
 {
     filename = resolveSoundFile(filename);
 
-    const auto it = m_buffers.find(filename);
-    if (it != m_buffers.end())
+    if (m_cache.contains(filename))
         return;
 
-    ensureContext();
-    const auto& soundFile = SoundFile::loadSoundFile(filename);
-
-    // only keep small files
-    if (!soundFile || soundFile->getSize() > MAX_CACHE_SIZE)
-        return;
+    {
+        std::scoped_lock lock(m_streamMutex);
+        for (const auto& stream : m_streams) {
+            if (stream->getFilename() == filename)
+                return;
+        }
+    }
 
-    const auto& buffer = std::make_shared<SoundBuffer>();
-    if (buffer->fillBuffer(soundFile))
-        m_buffers[filename] = buffer;
+    // decoded in the background, the sound lands in the cache on a later poll
+    createStream(filename, {});
 }
 
-SoundSourcePtr SoundManager::play(const std::string& fn, const float fadetime, float gain, float pitch)
+SoundSourcePtr SoundManager::play(const std::string& fn, const float fadetime, float gain, float pitch, const int channel)
 {
     if (!m_audioEnabled)
         return nullptr;
@@ -215,6 +483,7 @@ SoundSourcePtr SoundManager::play(const std::string& fn, const float fadetime, f
     }
 
     soundSource->setName(filename);
+    soundSource->setChannel(channel);
     soundSource->setRelative(true);
     soundSource->setGain(gain);
     soundSource->setPitch(pitch);
@@ -255,58 +524,56 @@ SoundSourcePtr SoundManager::createSoundSource(const std::string& name)
 
     try {
         const std::string& filename = resolveSoundFile(name);
-        const auto it = m_buffers.find(filename);
-        if (it != m_buffers.end()) {
-            source = std::make_shared<SoundSource>();
-            source->setBuffer(it->second);
+        const auto it = m_cache.find(filename);
+        if (it != m_cache.end()) {
+            ++m_cacheHits;
+            auto& sound = it->second;
+            m_cacheLru.splice(m_cacheLru.begin(), m_cacheLru, sound.lruIt);
+
+            if (sound.buffer) {
+                source = std::make_shared<SoundSource>();
+                source->setBuffer(sound.buffer);
+            } else {
+                const auto& combinedSource = std::make_shared<CombinedSoundSource>();
+                const auto& leftSource = std::make_shared<SoundSource>();
+                leftSource->setBuffer(sound.left);
+                leftSource->setRelative(true);
+                leftSource->setPosition(Point(-128, 0));
+                combinedSource->addSource(leftSource);
+
+                const auto& rightSource = std::make_shared<SoundSource>();
+                rightSource->setBuffer(sound.right);
+                rightSource->setRelative(true);
+                rightSource->setPosition(Point(128, 0));
+                combinedSource->addSource(rightSource);
+
+                source = combinedSource;
+            }
         } else {
+            ++m_cacheMisses;
 #if defined __linux && !defined OPENGL_ES
             // due to OpenAL implementation bug, stereo buffers are always downmixed to mono on linux systems
-            // this is hack to work around the issue
+            // this is hack to work around the issue, both halves come from the same decode
             // solution taken from http://opensource.creative.com/pipermail/openal/2007-April/010355.html
+            const auto& stream = createStream(filename, { StreamSoundSource::DownMixLeft, StreamSoundSource::DownMixRight });
             const auto& combinedSource = std::make_shared<CombinedSoundSource>();
-            StreamSoundSourcePtr streamSource;
 
-            streamSource = std::make_shared<StreamSoundSource>();
-            streamSource->downMix(StreamSoundSource::DownMixLeft);
+            auto streamSource = std::make_shared<StreamSoundSource>();
+            streamSource->setStream(stream, 0);
             streamSource->setRelative(true);
             streamSource->setPosition(Point(-128, 0));
             combinedSource->addSource(streamSource);
-            m_streamFiles[streamSource] = g_asyncDispatcher->submit_task([=]() -> SoundFilePtr {
-                stdext::timer a;
-                try {
-                    return SoundFile::loadSoundFile(filename);
-                } catch (std::exception& e) {
-                    g_logger.error(e.what());
-                    return nullptr;
-                }
-            });
 
             streamSource = std::make_shared<StreamSoundSource>();
-            streamSource->downMix(StreamSoundSource::DownMixRight);
+            streamSource->setStream(stream, 1);
             streamSource->setRelative(true);
             streamSource->setPosition(Point(128, 0));
             combinedSource->addSource(streamSource);
-            m_streamFiles[streamSource] = g_asyncDispatcher->submit_task([=]() -> SoundFilePtr {
-                try {
-                    return SoundFile::loadSoundFile(filename);
-                } catch (std::exception& e) {
-                    g_logger.error(e.what());
-                    return nullptr;
-                }
-            });
 
             source = combinedSource;
 #else
             const auto& streamSource = std::make_shared<StreamSoundSource>();
-            m_streamFiles[streamSource] = g_asyncDispatcher->submit_task([=]() -> SoundFilePtr {
-                try {
-                    return SoundFile::loadSoundFile(filename);
-                } catch (std::exception& e) {
-                    g_logger.error(e.what());
-                    return nullptr;
-                }
-            });
+            streamSource->setStream(createStream(filename, { StreamSoundSource::NoDownMix }), 0);
             source = streamSource;
 #endif
         }
@@ -23,6 +23,9 @@
 #pragma once
 
 #include "declarations.h"
+#include "streamsoundsource.h"
+
+#include <condition_variable>
 
 using DelayedSoundEffect = std::pair<uint32_t, uint32_t>;
 using DelayedSoundEffects = std::vector<DelayedSoundEffect>;
@@ -119,8 +122,10 @@ class SoundManager
 {
     enum
     {
-        MAX_CACHE_SIZE = 100000,
-        POLL_DELAY = 100
+        MAX_CACHE_SIZE = 2 * 1024 * 1024,
+        MAX_VOICES = 64,
+        POLL_DELAY = 100,
+        STREAM_IDLE_DELAY = 20
     };
 public:
     void init();
@@ -138,15 +143,54 @@ public:
     std::string getAudioFileNameById(int32_t audioFileId);
 
     void preload(std::string filename);
-    SoundSourcePtr play(const std::string& filename, float fadetime = 0, float gain = 0, float pitch = 0);
+    SoundSourcePtr play(const std::string& filename, float fadetime = 0, float gain = 0, float pitch = 0, int channel = 0);
     SoundChannelPtr getChannel(int channel);
     SoundEffectPtr createSoundEffect();
 
+    // memory budget for decoded sounds, least recently played ones are freed beyond it (0 = unlimited)
+    void setCacheBudget(size_t bytes);
+    size_t getCacheBudget() const { return m_cacheBudget; }
+    void clearCache();
+    std::map<std::string, uint64_t> getCacheStats() const;
+
+    // most voices the sources of one channel may hold at once (0 = no limit)
+    void setChannelVoiceLimit(int channel, int limit);
+    int getChannelVoiceLimit(int channel) const;
+
     std::string resolveSoundFile(const std::string& file);
     void ensureContext() const;
 
+    // a stream decoded on the sound streaming thread, one queue per consumer
+    SoundStreamPtr createStream(const std::string& filename, std::vector<StreamSoundSource::DownMix> consumers);
+
 private:
+    struct Voice
+    {
+        ALuint id{ 0 };
+        SoundSource* owner{ nullptr };
+        ticks_t startedAt{ 0 };
+    };
+
+    struct CachedSound
+    {
+        SoundBufferPtr buffer;
+        // mono halves of a stereo sound, for the linux downmix workaround
+        SoundBufferPtr left;
+        SoundBufferPtr right;
+        size_t bytes{ 0 };
+        std::list<std::string>::iterator lruIt;
+    };
+
+    ALuint acquireVoice(SoundSource* source);
+    void releaseVoice(SoundSource* source);
+    void resetVoice(Voice& voice);
+    friend class SoundSource;
+
     SoundSourcePtr createSoundSource(const std::string& name);
+    void cacheSound(const std::string& filename, const std::vector<char>& samples, ALenum format, int rate);
+    void evictSounds();
+    void updateStreams();
+    void streamLoop();
     bool loadFromProtobuf(const std::string& directory, const std::string& fileName);
 
     ALCdevice* m_device{};
@@ -154,8 +198,27 @@ private:
     ALuint m_effect;
     ALuint m_effectSlot;
 
-    std::unordered_map<StreamSoundSourcePtr, std::shared_future<SoundFilePtr>> m_streamFiles;
-    std::unordered_map<std::string, SoundBufferPtr> m_buffers;
+    std::vector<Voice> m_voices;
+    std::unordered_map<int, int> m_channelVoiceLimits;
+    uint64_t m_voicesStolen{ 0 };
+    uint64_t m_voicesDenied{ 0 };
+
+    std::unordered_map<std::string, CachedSound> m_cache;
+    std::list<std::string> m_cacheLru; // most recently played first
+    size_t m_cacheBudget{ 64 * 1024 * 1024 };
+    size_t m_cachedBytes{ 0 };
+    uint64_t m_cacheHits{ 0 };
+    uint64_t m_cacheMisses{ 0 };
+    uint64_t m_cacheEvictions{ 0 };
+
+    // streams being decoded, shared with the streaming thread
+    std::vector<SoundStreamPtr> m_streams;
+    std::thread m_streamThread;
+    std::mutex m_streamMutex;
+    std::condition_variable m_streamCondition;
+    bool m_streamWake{ false };
+    bool m_stopStreaming{ false };
+
     std::unordered_map<int, SoundChannelPtr> m_channels;
     std::unordered_map<std::string, SoundEffectPtr> m_effects;
 
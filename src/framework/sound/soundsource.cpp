@@ -24,45 +24,60 @@
 
 #include "soundbuffer.h"
 #include "soundeffect.h"
+#include "soundmanager.h"
 
-SoundSource::SoundSource()
+SoundSource::~SoundSource()
 {
-    alGenSources(1, &m_sourceId);
-    assert(alGetError() == AL_NO_ERROR);
-    SoundSource::setReferenceDistance(128);
+    if (m_sourceId != 0)
+        g_sounds.releaseVoice(this);
 }
 
-SoundSource::~SoundSource()
+bool SoundSource::bindVoice()
 {
-    if (m_effectSlot != 0) {
-        removeEffect();
-    }
-    if (m_sourceId != 0) {
-        stop();
-        alDeleteSources(1, &m_sourceId);
-        assert(alGetError() == AL_NO_ERROR);
-    }
+    m_sourceId = g_sounds.acquireVoice(this);
+    if (m_sourceId == 0)
+        return false;
+
+    alSourcei(m_sourceId, AL_LOOPING, m_looping ? AL_TRUE : AL_FALSE);
+    alSourcei(m_sourceId, AL_SOURCE_RELATIVE, m_relative ? AL_TRUE : AL_FALSE);
+    alSourcef(m_sourceId, AL_REFERENCE_DISTANCE, m_referenceDistance);
+    alSourcef(m_sourceId, AL_ROLLOFF_FACTOR, m_rolloff);
+    alSourcef(m_sourceId, AL_GAIN, m_gain);
+    alSourcef(m_sourceId, AL_PITCH, m_pitch);
+    alSource3f(m_sourceId, AL_POSITION, m_position.x, m_position.y, 0);
+    alSource3f(m_sourceId, AL_VELOCITY, m_velocity.x, m_velocity.y, 0);
+    if (m_effectSlot != 0)
+        alSource3i(m_sourceId, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(m_effectSlot), 0, AL_FILTER_NULL);
+    if (m_buffer)
+        alSourcei(m_sourceId, AL_BUFFER, m_buffer->getBufferId());
+
+    const ALenum err = alGetError();
+    if (err != AL_NO_ERROR)
+        g_logger.error("Unable to set up voice for '{}': {}", m_name, alGetString(err));
+
+    return true;
 }
 
 void SoundSource::play()
 {
+    if (m_sourceId == 0 && !bindVoice())
+        return;
+
     alSourcePlay(m_sourceId);
     assert(alGetError() == AL_NO_ERROR);
 }
 
 void SoundSource::stop()
 {
-    alSourceStop(m_sourceId);
-    assert(alGetError() == AL_NO_ERROR);
-    if (m_buffer) {
-        alSourcei(m_sourceId, AL_BUFFER, AL_NONE);
-        assert(alGetError() == AL_NO_ERROR);
-        m_buffer = nullptr;
-    }
+    if (m_sourceId != 0)
+        g_sounds.releaseVoice(this);
 }
 
 bool SoundSource::isBuffering()
 {
+    if (m_sourceId == 0)
+        return false;
+
     int state = AL_PLAYING;
     alGetSourcei(m_sourceId, AL_SOURCE_STATE, &state);
     return state != AL_STOPPED;
@@ -70,57 +85,67 @@ bool SoundSource::isBuffering()
 
 void SoundSource::setBuffer(const SoundBufferPtr& buffer)
 {
-    alSourcei(m_sourceId, AL_BUFFER, buffer->getBufferId());
-    assert(alGetError() == AL_NO_ERROR);
     m_buffer = buffer;
+    if (m_sourceId != 0) {
+        alSourcei(m_sourceId, AL_BUFFER, buffer->getBufferId());
+        assert(alGetError() == AL_NO_ERROR);
+    }
 }
 
 void SoundSource::setLooping(const bool looping)
 {
-    alSourcei(m_sourceId, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
+    m_looping = looping;
+    if (m_sourceId != 0)
+        alSourcei(m_sourceId, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
 }
 
 void SoundSource::setRelative(const bool relative)
 {
-    alSourcei(m_sourceId, AL_SOURCE_RELATIVE, relative ? AL_TRUE : AL_FALSE);
+    m_relative = relative;
+    if (m_sourceId != 0)
+        alSourcei(m_sourceId, AL_SOURCE_RELATIVE, relative ? AL_TRUE : AL_FALSE);
 }
 
 void SoundSource::setReferenceDistance(const float distance)
 {
-    alSourcef(m_sourceId, AL_REFERENCE_DISTANCE, distance);
-}
-
-float SoundSource::getReferenceDistance()
-{
-    float distance;
-    alGetSourcef(m_sourceId, AL_REFERENCE_DISTANCE, &distance);
-    return distance;
+    m_referenceDistance = distance;
+    if (m_sourceId != 0)
+        alSourcef(m_sourceId, AL_REFERENCE_DISTANCE, distance);
 }
 
 void SoundSource::setGain(const float gain)
 {
-    alSourcef(m_sourceId, AL_GAIN, gain);
     m_gain = gain;
+    if (m_sourceId != 0)
+        alSourcef(m_sourceId, AL_GAIN, gain);
 }
 
 void SoundSource::setPitch(const float pitch)
 {
-    alSourcef(m_sourceId, AL_PITCH, pitch);
+    m_pitch = pitch;
+    if (m_sourceId != 0)
+        alSourcef(m_sourceId, AL_PITCH, pitch);
 }
 
 void SoundSource::setPosition(const Point& pos)
 {
-    alSource3f(m_sourceId, AL_POSITION, pos.x, pos.y, 0);
+    m_position = pos;
+    if (m_sourceId != 0)
+        alSource3f(m_sourceId, AL_POSITION, pos.x, pos.y, 0);
 }
 
 void SoundSource::setRolloff(const float rolloff)
 {
-    alSourcef(m_sourceId, AL_ROLLOFF_FACTOR, rolloff);
+    m_rolloff = rolloff;
+    if (m_sourceId != 0)
+        alSourcef(m_sourceId, AL_ROLLOFF_FACTOR, rolloff);
 }
 
 void SoundSource::setVelocity(const Point& velocity)
 {
-    alSource3f(m_sourceId, AL_VELOCITY, velocity.x, velocity.y, 0);
+    m_velocity = velocity;
+    if (m_sourceId != 0)
+        alSource3f(m_sourceId, AL_VELOCITY, velocity.x, velocity.y, 0);
 }
 
 void SoundSource::setFading(const FadeState state, const float fadeTime)
@@ -169,10 +194,13 @@ void SoundSource::update()
 
 void SoundSource::setEffect(const SoundEffectPtr soundEffect)
 {
-    if (!soundEffect || m_sourceId == 0)
+    if (!soundEffect)
         return;
 
     m_effectSlot = soundEffect->m_effectSlot;
+    if (m_sourceId == 0)
+        return;
+
     alSource3i(m_sourceId, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(soundEffect->m_effectSlot), 0, AL_FILTER_NULL);
     const ALenum err = alGetError();
     if (err != AL_NO_ERROR) {
@@ -192,4 +220,4 @@ void SoundSource::removeEffect()
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -27,13 +27,10 @@
 
 class SoundSource : public LuaObject
 {
-protected:
-    SoundSource(const uint32_t sourceId) : m_sourceId(sourceId) {}
-
 public:
     enum FadeState { NoFading, FadingOn, FadingOff };
 
-    SoundSource();
+    SoundSource() = default;
     ~SoundSource() override;
 
     virtual void play();
@@ -55,15 +52,25 @@ public:
     virtual void setEffect(SoundEffectPtr soundEffect);
     virtual void removeEffect();
 
+    // when the voice pool is full, sources of higher priority steal voices from lower ones
+    void setPriority(const int priority) { m_priority = priority; }
+
     std::string getName() const { return m_name; }
     uint8_t getChannel() const { return m_channel; }
+    int getPriority() const { return m_priority; }
     float getGain() const { return m_gain; }
-    float getReferenceDistance();
+    float getReferenceDistance() const { return m_referenceDistance; }
+    bool hasVoice() const { return m_sourceId != 0; }
 
 protected:
     void setBuffer(const SoundBufferPtr& buffer);
     void setChannel(const uint8_t channel) { m_channel = channel; }
 
+    // takes an AL source from the SoundManager voice pool and applies the stored properties to it
+    bool bindVoice();
+    // the voice was handed to another source, the manager already stopped it
+    virtual void voiceLost() { m_sourceId = 0; }
+
     virtual void update();
     friend class SoundManager;
     friend class CombinedSoundSource;
@@ -72,12 +79,21 @@ protected:
     float m_fadeTime{ 0 };
     float m_fadeGain{ 0 };
     float m_gain{ 1.f };
+    float m_pitch{ 1.f };
+    float m_referenceDistance{ 128.f };
+    float m_rolloff{ 1.f };
     uint m_effectSlot{ 0 };
 
+    Point m_position;
+    Point m_velocity;
+
     FadeState m_fadeState{ NoFading };
 
     uint32_t m_sourceId{ 0 };
+    int m_priority{ 0 };
     uint8_t m_channel{ 0 };
+    bool m_looping{ false };
+    bool m_relative{ false };
 
     std::string m_name;
 
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "soundstream.h"
+#include "soundfile.h"
+
+SoundStream::SoundStream(std::string filename, std::vector<StreamSoundSource::DownMix> consumers, const size_t cacheLimit) :
+    m_filename(std::move(filename)),
+    m_downMix(std::move(consumers)),
+    m_cacheLimit(cacheLimit),
+    m_queues(m_downMix.size()),
+    m_active(m_downMix.size(), false),
+    // a stream nobody listens to only decodes for the cache, so it starts right away
+    m_state(m_downMix.empty() ? Running : Stopped),
+    m_capture(cacheLimit > 0)
+{}
+
+void SoundStream::start(const size_t consumer)
+{
+    std::scoped_lock lock(m_mutex);
+    if (m_state == Failed)
+        return;
+
+    if (m_state != Running) {
+        ++m_generation;
+        for (auto& queue : m_queues)
+            queue.clear();
+        std::fill(m_active.begin(), m_active.end(), false);
+
+        m_rewind = true;
+        m_state = Running;
+    }
+
+    m_active[consumer] = true;
+}
+
+void SoundStream::stop(const size_t consumer)
+{
+    std::scoped_lock lock(m_mutex);
+    if (m_state == Failed)
+        return;
+
+    m_active[consumer] = false;
+    m_queues[consumer].clear();
+
+    // the other half of a split sound keeps playing
+    if (std::find(m_active.begin(), m_active.end(), true) != m_active.end())
+        return;
+
+    ++m_generation;
+    for (auto& queue : m_queues)
+        queue.clear();
+
+    m_state = Stopped;
+}
+
+void SoundStream::setLooping(const bool looping)
+{
+    std::scoped_lock lock(m_mutex);
+    m_looping = looping;
+}
+
+SoundFragmentPtr SoundStream::pop(const size_t consumer)
+{
+    std::scoped_lock lock(m_mutex);
+    auto& queue = m_queues[consumer];
+    if (queue.empty())
+        return nullptr;
+
+    auto fragment = std::move(queue.front());
+    queue.pop_front();
+    return fragment;
+}
+
+bool SoundStream::isFinished(const size_t consumer) const
+{
+    std::scoped_lock lock(m_mutex);
+    return (m_state != Running || !m_active[consumer]) && m_queues[consumer].empty();
+}
+
+bool SoundStream::isDecoding() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_decodedReady || (m_downMix.empty() && m_state == Running);
+}
+
+bool SoundStream::takeDecoded(std::vector<char>& samples, ALenum& format, int& rate)
+{
+    std::scoped_lock lock(m_mutex);
+    if (!m_decodedReady)
+        return false;
+
+    samples = std::move(m_decoded);
+    format = m_format;
+    rate = m_rate;
+    m_decoded = {};
+    m_decodedReady = false;
+    m_capture = false;
+    return true;
+}
+
+bool SoundStream::wantsFragments() const
+{
+    for (size_t i = 0; i < m_queues.size(); ++i) {
+        if (m_active[i] && m_queues[i].size() >= FRAGMENTS_AHEAD)
+            return false;
+    }
+    return true;
+}
+
+bool SoundStream::decode()
+{
+    uint32_t generation;
+    bool rewind;
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_state != Running || !wantsFragments())
+            return false;
+
+        generation = m_generation;
+        rewind = std::exchange(m_rewind, false);
+        if (rewind && !m_decodedReady)
+            m_decoded.clear();
+    }
+
+    if (!m_file) {
+        try {
+            m_file = SoundFile::loadSoundFile(m_filename);
+        } catch (const std::exception& e) {
+            g_logger.error("Unable to stream '{}': {}", m_filename, e.what());
+        }
+
+        std::scoped_lock lock(m_mutex);
+        if (!m_file || m_file->getSampleFormat() == AL_UNDETERMINED) {
+            m_file = nullptr;
+            m_state = Failed;
+            for (auto& queue : m_queues)
+                queue.clear();
+            return true;
+        }
+
+        m_format = m_file->getSampleFormat();
+        m_rate = m_file->getRate();
+        if (static_cast<size_t>(m_file->getSize()) > m_cacheLimit) {
+            m_capture = false;
+
+            // a preload of a file too large to cache
+            if (m_downMix.empty()) {
+                m_state = Ended;
+                return true;
+            }
+        }
+
+        m_readBuffer.resize(FRAGMENT_SIZE);
+        rewind = false;
+    }
+
+    if (rewind)
+        m_file->reset();
+
+    const int bytesRead = std::max<int>(m_file->read(m_readBuffer.data(), FRAGMENT_SIZE), 0);
+    const bool eof = bytesRead < FRAGMENT_SIZE;
+
+    std::scoped_lock lock(m_mutex);
+
+    // stopped or restarted while reading, this data belongs to the old run
+    if (generation != m_generation)
+        return true;
+
+    if (eof && m_looping)
+        m_file->reset();
+
+    if (m_capture && !m_decodedReady) {
+        m_decoded.insert(m_decoded.end(), m_readBuffer.begin(), m_readBuffer.begin() + bytesRead);
+        m_decodedReady = eof;
+    }
+
+    if (bytesRead > 0) {
+        SoundFragmentPtr whole;
+        for (size_t i = 0; i < m_downMix.size(); ++i) {
+            if (!m_active[i])
+                continue;
+
+            const auto downMix = m_downMix[i];
+            if (downMix == StreamSoundSource::NoDownMix || m_format != AL_FORMAT_STEREO16) {
+                if (!whole)
+                    whole = std::make_shared<SoundFragment>(SoundFragment{ m_format, m_rate, { m_readBuffer.begin(), m_readBuffer.begin() + bytesRead } });
+                m_queues[i].emplace_back(whole);
+            } else {
+                const int channel = downMix == StreamSoundSource::DownMixLeft ? 0 : 1;
+                m_queues[i].emplace_back(std::make_shared<SoundFragment>(SoundFragment{ AL_FORMAT_MONO16, m_rate, extractChannel(m_readBuffer.data(), bytesRead, channel) }));
+            }
+        }
+    }
+
+    if (eof && !m_looping)
+        m_state = Ended;
+
+    return true;
+}
+
+std::vector<char> SoundStream::extractChannel(const char* samples, const size_t size, const int channel)
+{
+    const size_t frames = size / 4;
+    std::vector<char> mono(frames * 2);
+
+    const auto* in = reinterpret_cast<const int16_t*>(samples);
+    auto* out = reinterpret_cast<int16_t*>(mono.data());
+    for (size_t i = 0; i < frames; ++i)
+        out[i] = in[2 * i + channel];
+
+    return mono;
+}
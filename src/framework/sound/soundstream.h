@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "streamsoundsource.h"
+
+// PCM decoded ahead of playback, ready for alBufferData
+struct SoundFragment
+{
+    ALenum format{ AL_NONE };
+    int rate{ 0 };
+    std::vector<char> samples;
+};
+
+using SoundFragmentPtr = std::shared_ptr<SoundFragment>;
+
+// A sound file decoded on the sound streaming thread. Every consumer (a
+// StreamSoundSource) has its own fragment queue and down mix, so the left and
+// right halves of a split stereo sound come out of a single decode.
+class SoundStream
+{
+public:
+    enum
+    {
+        FRAGMENT_SIZE = 1024 * 100,
+        FRAGMENTS_AHEAD = 4
+    };
+
+    // a file no larger than cacheLimit decoded bytes is also kept whole for the PCM cache
+    SoundStream(std::string filename, std::vector<StreamSoundSource::DownMix> consumers, size_t cacheLimit);
+
+    const std::string& getFilename() const { return m_filename; }
+    size_t getConsumers() const { return m_downMix.size(); }
+
+    // main thread; a consumer joins a running stream where it is, the stream starts over from the top
+    // when the first one starts and stops once the last one does
+    void start(size_t consumer);
+    void stop(size_t consumer);
+    void setLooping(bool looping);
+    SoundFragmentPtr pop(size_t consumer);
+    bool isFinished(size_t consumer) const;
+    bool isDecoding() const;
+    bool takeDecoded(std::vector<char>& samples, ALenum& format, int& rate);
+
+    // sound streaming thread, returns false when there was nothing to do
+    bool decode();
+
+    // copies one channel out of interleaved 16 bit stereo samples
+    static std::vector<char> extractChannel(const char* samples, size_t size, int channel);
+
+private:
+    enum State : uint8_t { Stopped, Running, Ended, Failed };
+
+    bool wantsFragments() const;
+
+    const std::string m_filename;
+    const std::vector<StreamSoundSource::DownMix> m_downMix;
+    const size_t m_cacheLimit;
+
+    // only touched by the streaming thread
+    SoundFilePtr m_file;
+    std::vector<char> m_readBuffer;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::deque<SoundFragmentPtr>> m_queues;
+    std::vector<bool> m_active;
+    std::vector<char> m_decoded;
+    ALenum m_format{ AL_NONE };
+    int m_rate{ 0 };
+    uint32_t m_generation{ 0 };
+    State m_state;
+    bool m_looping{ false };
+    bool m_rewind{ false };
+    bool m_capture;
+    bool m_decodedReady{ false };
+};
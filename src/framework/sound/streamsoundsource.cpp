@@ -23,14 +23,14 @@
 #include "streamsoundsource.h"
 
 #include "soundbuffer.h"
-#include "soundfile.h"
-#include "framework/core/resourcemanager.h"
+#include "soundmanager.h"
+#include "soundstream.h"
 
 StreamSoundSource::StreamSoundSource()
 {
     for (auto& buffer : m_buffers)
         buffer = std::make_shared<SoundBuffer>();
-    m_downMix = NoDownMix;
+    resetBuffers();
 }
 
 StreamSoundSource::~StreamSoundSource()
@@ -40,163 +40,131 @@ StreamSoundSource::~StreamSoundSource()
 
 void StreamSoundSource::setFile(std::string filename)
 {
-    filename = g_resources.guessFilePath(filename, "ogg");
-    filename = g_resources.resolvePath(filename);
-
-    const SoundFilePtr soundFile = SoundFile::loadSoundFile(filename);
+    filename = g_sounds.resolveSoundFile(filename);
+    setStream(g_sounds.createStream(filename, { NoDownMix }), 0);
+}
 
-    if (!soundFile) {
-        g_logger.error("Unable to load sound file '{}'", filename);
-        return;
-    }
+void StreamSoundSource::setStream(const SoundStreamPtr& stream, const size_t consumer)
+{
+    if (m_stream)
+        stop();
 
-    setSoundFile(soundFile);
+    m_stream = stream;
+    m_consumer = consumer;
+    if (m_stream)
+        m_stream->setLooping(m_looping);
 }
 
-void StreamSoundSource::setSoundFile(const SoundFilePtr& soundFile)
+void StreamSoundSource::setLooping(const bool looping)
 {
-    m_soundFile = soundFile;
-    if (m_waitingFile) {
-        m_waitingFile = false;
-        play();
-    }
+    // the stream rewinds itself, the AL source only ever sees a queue of fragments
+    m_looping = looping;
+    if (m_stream)
+        m_stream->setLooping(looping);
 }
 
 void StreamSoundSource::play()
 {
-    m_playing = true;
-
-    if (!m_soundFile) {
-        m_waitingFile = true;
+    if (!m_stream)
         return;
-    }
 
-    if (m_eof) {
-        m_soundFile->reset();
-        m_eof = false;
+    m_stream->start(m_consumer);
+    if (m_sourceId == 0 && !bindVoice()) {
+        m_stream->stop(m_consumer);
+        return;
     }
 
-    queueBuffers();
+    // streaming voices never loop on their own
+    alSourcei(m_sourceId, AL_LOOPING, AL_FALSE);
 
-    SoundSource::play();
+    m_playing = true;
+    queueFragments();
 }
 
 void StreamSoundSource::stop()
 {
     m_playing = false;
 
-    if (m_waitingFile)
-        return;
+    if (m_stream)
+        m_stream->stop(m_consumer);
 
+    // releasing the voice also unqueues every buffer
     SoundSource::stop();
-    unqueueBuffers();
+    resetBuffers();
 }
 
-void StreamSoundSource::queueBuffers()
+void StreamSoundSource::voiceLost()
 {
-    int queued;
-    alGetSourcei(m_sourceId, AL_BUFFERS_QUEUED, &queued);
-    for (int i = 0; i < STREAM_FRAGMENTS - queued; ++i) {
-        if (!fillBufferAndQueue(m_buffers[i]->getBufferId()))
-            break;
-    }
+    SoundSource::voiceLost();
+
+    m_playing = false;
+    if (m_stream)
+        m_stream->stop(m_consumer);
+    resetBuffers();
 }
 
-void StreamSoundSource::unqueueBuffers() const
+void StreamSoundSource::resetBuffers()
 {
-    int queued;
-    alGetSourcei(m_sourceId, AL_BUFFERS_QUEUED, &queued);
-    for (int i = 0; i < queued; ++i) {
-        uint32_t buffer;
-        alSourceUnqueueBuffers(m_sourceId, 1, &buffer);
-    }
+    m_freeBuffers.clear();
+    for (const auto& buffer : m_buffers)
+        m_freeBuffers.emplace_back(buffer->getBufferId());
 }
 
-void StreamSoundSource::update()
+void StreamSoundSource::queueFragments()
 {
-    if (m_waitingFile)
-        return;
+    while (!m_freeBuffers.empty()) {
+        const auto& fragment = m_stream->pop(m_consumer);
+        if (!fragment)
+            break;
 
-    SoundSource::update();
+        const uint32_t buffer = m_freeBuffers.back();
+        alBufferData(buffer, fragment->format, fragment->samples.data(), fragment->samples.size(), fragment->rate);
+        ALenum err = alGetError();
+        if (err != AL_NO_ERROR) {
+            g_logger.error("Unable to refill audio buffer for '{}': {}", m_name, alGetString(err));
+            continue;
+        }
 
-    int processed = 0;
-    alGetSourcei(m_sourceId, AL_BUFFERS_PROCESSED, &processed);
-    for (int i = 0; i < processed; ++i) {
-        uint32_t buffer;
-        alSourceUnqueueBuffers(m_sourceId, 1, &buffer);
+        alSourceQueueBuffers(m_sourceId, 1, &buffer);
+        err = alGetError();
+        if (err != AL_NO_ERROR) {
+            g_logger.error("Unable to queue audio buffer for '{}': {}", m_name, alGetString(err));
+            continue;
+        }
 
-        if (!fillBufferAndQueue(buffer))
-            break;
+        m_freeBuffers.pop_back();
     }
 
-    if (!isBuffering() && m_playing) {
-        if (!m_looping && m_eof) {
-            stop();
-        } else if (processed == 0) {
+    int state = AL_STOPPED;
+    alGetSourcei(m_sourceId, AL_SOURCE_STATE, &state);
+    if (state == AL_PLAYING)
+        return;
+
+    int queued = 0;
+    alGetSourcei(m_sourceId, AL_BUFFERS_QUEUED, &queued);
+    if (queued > 0) {
+        // first fragments arrived, or the decoder fell behind and the voice ran dry
+        if (state == AL_STOPPED)
             g_logger.traceError("audio buffer underrun");
-            play();
-        } else if (m_looping) {
-            play();
-        }
-    }
+        alSourcePlay(m_sourceId);
+    } else if (m_stream->isFinished(m_consumer))
+        stop();
 }
 
-bool StreamSoundSource::fillBufferAndQueue(const uint32_t buffer)
+void StreamSoundSource::update()
 {
-    if (m_waitingFile)
-        return false;
-
-    // fill buffer
-    static std::vector<char> bufferData(2 * STREAM_FRAGMENT_SIZE);
-    ALenum format = m_soundFile->getSampleFormat();
-
-    int maxRead = STREAM_FRAGMENT_SIZE;
-    if (m_downMix != NoDownMix)
-        maxRead *= 2;
-
-    int bytesRead = 0;
-    do {
-        bytesRead += m_soundFile->read(bufferData.data() + bytesRead, maxRead - bytesRead);
-
-        // end of sound file
-        if (bytesRead < maxRead) {
-            if (m_looping)
-                m_soundFile->reset();
-            else {
-                m_eof = true;
-                break;
-            }
-        }
-    } while (bytesRead < maxRead);
-
-    if (bytesRead > 0) {
-        if (m_downMix != NoDownMix) {
-            if (format == AL_FORMAT_STEREO16) {
-                assert(bytesRead % 2 == 0);
-                bytesRead /= 2;
-                auto* const data = reinterpret_cast<uint16_t*>(bufferData.data());
-                for (int i = 0; i < bytesRead / 2; ++i)
-                    data[i] = data[2 * i + (m_downMix == DownMixLeft ? 0 : 1)];
-                format = AL_FORMAT_MONO16;
-            }
-        }
+    SoundSource::update();
 
-        alBufferData(buffer, format, bufferData.data(), bytesRead, m_soundFile->getRate());
-        ALenum err = alGetError();
-        if (err != AL_NO_ERROR)
-            g_logger.error("Unable to refill audio buffer for '{}': {}", m_soundFile->getName(), alGetString(err));
+    if (!m_playing || m_sourceId == 0)
+        return;
 
-        alSourceQueueBuffers(m_sourceId, 1, &buffer);
-        err = alGetError();
-        if (err != AL_NO_ERROR)
-            g_logger.error("Unable to queue audio buffer for '{}': {}", m_soundFile->getName(), alGetString(err));
+    int processed = 0;
+    alGetSourcei(m_sourceId, AL_BUFFERS_PROCESSED, &processed);
+    for (int i = 0; i < processed; ++i) {
+        uint32_t buffer;
+        alSourceUnqueueBuffers(m_sourceId, 1, &buffer);
+        m_freeBuffers.emplace_back(buffer);
     }
 
-    // return false if there aren't more buffers to fill
-    return (bytesRead >= STREAM_FRAGMENT_SIZE && !m_eof);
+    queueFragments();
 }
-
-void StreamSoundSource::downMix(const DownMix downMix)
-{
-    m_downMix = downMix;
-}
\ No newline at end of file
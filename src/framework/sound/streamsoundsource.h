@@ -24,13 +24,13 @@
 
 #include "soundsource.h"
 
+// Plays PCM that a SoundStream decodes on the sound streaming thread, the
+// main thread only hands the ready fragments to OpenAL.
 class StreamSoundSource final : public SoundSource
 {
     enum
     {
-        STREAM_BUFFER_SIZE = 1024 * 400,
-        STREAM_FRAGMENTS = 4,
-        STREAM_FRAGMENT_SIZE = STREAM_BUFFER_SIZE / STREAM_FRAGMENTS
+        STREAM_FRAGMENTS = 4
     };
 
 public:
@@ -44,24 +44,25 @@ public:
 
     bool isPlaying() override { return m_playing; }
 
-    void setSoundFile(const SoundFilePtr& soundFile);
+    void setLooping(bool looping) override;
 
-    void setFile(std::string filename);
+    // plays what the stream decodes for the given consumer
+    void setStream(const SoundStreamPtr& stream, size_t consumer);
 
-    void downMix(DownMix downMix);
+    void setFile(std::string filename);
 
     void update() override;
 
+protected:
+    void voiceLost() override;
+
 private:
-    void queueBuffers();
-    void unqueueBuffers() const;
-    bool fillBufferAndQueue(uint32_t buffer);
+    void queueFragments();
+    void resetBuffers();
 
-    SoundFilePtr m_soundFile;
+    SoundStreamPtr m_stream;
+    size_t m_consumer{ 0 };
     std::array<SoundBufferPtr, STREAM_FRAGMENTS> m_buffers;
-    DownMix m_downMix;
-    bool m_looping{ false };
+    std::vector<uint32_t> m_freeBuffers;
     bool m_playing{ false };
-    bool m_eof{ false };
-    bool m_waitingFile{ false };
 };
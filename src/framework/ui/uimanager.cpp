@@ -362,7 +362,7 @@ void UIManager::onWidgetDestroy(const UIWidgetPtr& widget)
     std::string extra = widget->getId();
     if (widget->getParent())
         extra += " (" + widget->getParent()->getId() + ")";
-    AutoStat s(STATS_MAIN, "UIManager::onWidgetDestroy", extra);
+    AutoStat s(TRACE_ZONE(STATS_MAIN, "UIManager::onWidgetDestroy"), extra);
 
     // release input grabs
     if (m_keyboardReceiver == widget)
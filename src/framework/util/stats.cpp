@@ -35,40 +35,61 @@
 
 Stats g_stats;
 
-void Stats::add(int type, Stat* stat) {
-    if (type < 0 || type > STATS_LAST || paused) {
-        delete stat;
+namespace
+{
+    constexpr std::array<std::string_view, STATS_LAST + 1> STATS_NAMES{ "general", "main", "render", "dispatcher", "lua", "luacallback", "packets" };
+
+    // AutoStat durations are nanoseconds, everything reported here keeps the old microsecond unit
+    constexpr int64_t SLOW_STAT_NANOS = 1000 * 1000;
+}
+
+void Stats::add(const TraceZoneId zone, const int64_t start, const int64_t duration, const std::string_view extraDescription) {
+    const bool count = !paused;
+    g_tracer.record(zone, start, duration, count);
+    if (!count || duration <= SLOW_STAT_NANOS)
         return;
-    }
-    std::lock_guard<std::mutex> lock(m_mutex);
 
-    auto it = stats[type].data.emplace(stat->description, StatsData(0, 0, stat->extraDescription)).first;
-    it->second.calls += 1;
-    it->second.executionTime += stat->executionTime;
+    const int type = g_tracer.getZoneCategory(zone);
+    if (type < 0 || type > STATS_LAST)
+        return;
 
-    if (stat->executionTime > 1000) {
-        if (stats[type].slow.size() > 10000) {
-            delete stats[type].slow.front();
-            stats[type].slow.pop_front();
-        }
-        stats[type].slow.push_back(stat);
-    } else
-        delete stat;
+    auto description = g_tracer.getZoneName(zone);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& slow = stats[type].slow;
+    if (slow.size() > 10000)
+        slow.pop_front();
+    slow.push_back({ static_cast<uint64_t>(duration / 1000), std::move(description), std::string(extraDescription) });
 }
 
 std::string Stats::get(int type, int limit, bool pretty) {
     if (type < 0 || type > STATS_LAST)
         return "";
 
+    const auto totals = g_tracer.collectTotals();
+
     std::lock_guard<std::mutex> lock(m_mutex);
-    std::multimap<uint64_t, StatsMap::const_iterator> sorted_stats;
+    const auto& baseline = stats[type].baseline;
+    std::multimap<uint64_t, std::pair<TraceZoneId, uint64_t>> sorted_stats;
 
     uint64_t total_time = 0;
     const uint64_t time_from_start = (stdext::micros() - stats[type].start);
 
-    for (auto it = stats[type].data.cbegin(); it != stats[type].data.cend(); ++it) {
-        sorted_stats.emplace(it->second.executionTime, it);
-        total_time += it->second.executionTime;
+    for (size_t zone = 0; zone < totals.size(); ++zone) {
+        if (g_tracer.getZoneCategory(static_cast<TraceZoneId>(zone)) != type)
+            continue;
+
+        uint64_t calls = totals[zone].calls;
+        uint64_t nanoseconds = totals[zone].nanoseconds;
+        if (zone < baseline.size()) {
+            calls -= baseline[zone].calls;
+            nanoseconds -= baseline[zone].nanoseconds;
+        }
+        if (calls == 0)
+            continue;
+
+        const uint64_t executionTime = nanoseconds / 1000;
+        sorted_stats.emplace(executionTime, std::make_pair(static_cast<TraceZoneId>(zone), calls));
+        total_time += executionTime;
     }
 
     if (total_time == 0 || time_from_start == 0)
@@ -85,12 +106,15 @@ std::string Stats::get(int type, int limit, bool pretty) {
     for (auto it = sorted_stats.rbegin(); it != sorted_stats.rend(); ++it) {
         if (i++ > limit)
             break;
+        const uint64_t executionTime = it->first;
+        const auto& [zone, calls] = it->second;
+        const auto description = g_tracer.getZoneName(zone);
         if (pretty) {
-            const std::string name = it->second->first.substr(0, 45);
-            ret << name << std::setw(50 - name.size()) << it->second->second.calls << std::setw(10) << (it->second->second.executionTime / 1000)
-                << std::setw(10) << ((it->second->second.executionTime * 100) / (total_time)) << std::setw(10) << ((it->second->second.executionTime * 100) / (time_from_start)) << "\n";
+            const std::string name = description.substr(0, 45);
+            ret << name << std::setw(50 - name.size()) << calls << std::setw(10) << (executionTime / 1000)
+                << std::setw(10) << ((executionTime * 100) / (total_time)) << std::setw(10) << ((executionTime * 100) / (time_from_start)) << "\n";
         } else {
-            ret << it->second->first << "|" << it->second->second.calls << "|" << it->second->second.executionTime << "\n";
+            ret << description << "|" << calls << "|" << executionTime << "\n";
         }
     }
 
@@ -100,15 +124,17 @@ std::string Stats::get(int type, int limit, bool pretty) {
 void Stats::clear(int type) {
     if (type < 0 || type > STATS_LAST)
         return;
+    auto totals = g_tracer.collectTotals();
     std::lock_guard<std::mutex> lock(m_mutex);
     stats[type].start = stdext::micros();
-    stats[type].data.clear();
+    stats[type].baseline = std::move(totals);
 }
 
 void Stats::clearAll() {
+    const auto totals = g_tracer.collectTotals();
     std::lock_guard<std::mutex> lock(m_mutex);
     for (int i = 0; i <= STATS_LAST; ++i) {
-        stats[i].data.clear();
+        stats[i].baseline = totals;
         stats[i].slow.clear();
     }
     resetSleepTime();
@@ -130,15 +156,15 @@ std::string Stats::getSlow(int type, int limit, unsigned int minTime, bool prett
     minTime *= 1000;
 
     for (auto it = stats[type].slow.rbegin(); it != stats[type].slow.rend(); ++it) {
-        if ((*it)->executionTime < (minTime))
+        if (it->executionTime < (minTime))
             continue;
         if (i++ > limit)
             break;
         if (pretty) {
-            const std::string name = (*it)->description.substr(0, 45);
-            ret << name << std::setw(50 - name.size()) << (*it)->executionTime / 1000 << std::setw(20) << (*it)->extraDescription << "\n";
+            const std::string name = it->description.substr(0, 45);
+            ret << name << std::setw(50 - name.size()) << it->executionTime / 1000 << std::setw(20) << it->extraDescription << "\n";
         } else {
-            ret << (*it)->description << "|" << (*it)->executionTime << "|" << (*it)->extraDescription << "\n";
+            ret << it->description << "|" << it->executionTime << "|" << it->extraDescription << "\n";
         }
     }
 
@@ -149,11 +175,14 @@ void Stats::clearSlow(int type) {
     if (type < 0 || type > STATS_LAST)
         return;
     std::lock_guard<std::mutex> lock(m_mutex);
-    for (auto& stat : stats[type].slow)
-        delete stat;
     stats[type].slow.clear();
 }
 
+bool Stats::saveTrace(const std::string& path)
+{
+    return g_tracer.saveCapture(path, STATS_NAMES);
+}
+
 void Stats::addWidget(UIWidget* widget)
 {
     createdWidgets += 1;
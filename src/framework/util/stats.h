@@ -24,15 +24,18 @@
 #pragma once
 
 #include <atomic>
-#include <chrono>
 #include <cstdint>
-#include <list>
+#include <deque>
 #include <mutex>
 #include <set>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
-// NOT THREAD SAFE
+#include "tracer.h"
+
+// Zone timings go through g_tracer and may be recorded from any thread.
+// Widget, texture, thing and creature counters are bookkeeping for the debug view only.
 
 enum StatsTypes
 {
@@ -49,31 +52,19 @@ enum StatsTypes
 
 struct Stat
 {
-    Stat(uint64_t _executionTime, const std::string& _description, const std::string& _extraDescription) :
-        executionTime(_executionTime), description(_description), extraDescription(_extraDescription) {}
     uint64_t executionTime = 0;
     std::string description;
     std::string extraDescription;
 };
 
-struct StatsData
-{
-    StatsData(uint32_t _calls, uint64_t _executionTime, const std::string& _extraInfo) :
-        calls(_calls), executionTime(_executionTime), extraInfo(_extraInfo) {}
-    uint32_t calls = 0;
-    uint64_t executionTime = 0;
-    std::string extraInfo;
-};
-
-using StatsMap = std::unordered_map<std::string, StatsData>;
-using StatsList = std::list<Stat*>;
-
 class UIWidget;
 
 class Stats
 {
 public:
-    void add(int type, Stat* stats);
+    void add(TraceZoneId zone, int64_t start, int64_t duration, std::string_view extraDescription);
+
+    bool isRecording() const { return !paused || g_tracer.isCapturing(); }
 
     std::string get(int type, int limit, bool pretty);
     void clear(int type);
@@ -85,6 +76,12 @@ public:
 
     int types() { return STATS_LAST + 1; }
 
+    // captures every zone with its thread and timestamps, saved as Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+    void startTrace() { g_tracer.startCapture(); }
+    void stopTrace() { g_tracer.stopCapture(); }
+    bool isTracing() const { return g_tracer.isCapturing(); }
+    bool saveTrace(const std::string& path);
+
     int64_t getSleepTime() {
         return m_sleepTime;
     }
@@ -107,52 +104,78 @@ public:
     inline void addCreature() { createdCreatures += 1; }
     inline void removeCreature() { destroyedCreatures += 1; }
 
+    // heap allocations of the draw pools while building frames, none once their buffers are warm
+    inline void addDrawAllocation() { drawAllocations += 1; }
+    uint64_t getDrawAllocations() const { return drawAllocations; }
+
     inline void pause() { paused = true; }
     inline void resume() { paused = false; }
 
 private:
     struct
     {
-        StatsMap data;
-        StatsList slow;
+        std::vector<Tracer::ZoneTotals> baseline;
+        std::deque<Stat> slow;
         int64_t start = 0;
     } stats[STATS_LAST + 1];
 
     std::set<UIWidget*> widgets;
     int createdWidgets = 0;
     int destroyedWidgets = 0;
-    int createdTextures = 0;
-    int destroyedTextures = 0;
-    int createdThings = 0;
-    int destroyedThings = 0;
-    int createdCreatures = 0;
-    int destroyedCreatures = 0;
+    std::atomic_int createdTextures = 0;
+    std::atomic_int destroyedTextures = 0;
+    std::atomic_int createdThings = 0;
+    std::atomic_int destroyedThings = 0;
+    std::atomic_int createdCreatures = 0;
+    std::atomic_int destroyedCreatures = 0;
+    std::atomic_uint64_t drawAllocations = 0;
     std::atomic_bool paused { false };
     std::mutex m_mutex;
 };
 
 extern Stats g_stats;
 
+// Times its scope into g_stats. Prefer AutoStat s(TRACE_ZONE(STATS_X, "Name")) for constant names,
+// dynamic names are interned per thread and only allocate the first time they are seen.
 class AutoStat
 {
 public:
-    AutoStat(int type, const std::string& description, const std::string& extraDescription = "") :
-        m_type(type), m_stat(new Stat(0, description, extraDescription)), m_timePoint(std::chrono::high_resolution_clock::now()) {}
+    explicit AutoStat(const TraceZoneId zone, const std::string_view extraDescription = {})
+    {
+        if (g_stats.isRecording())
+            start(zone, extraDescription);
+    }
+
+    AutoStat(const int type, const std::string_view description, const std::string_view extraDescription = {})
+    {
+        if (g_stats.isRecording())
+            start(g_tracer.intern(type, description), extraDescription);
+    }
+
+    AutoStat(const int type, const std::string_view prefix, const std::string_view description, const std::string_view extraDescription)
+    {
+        if (g_stats.isRecording())
+            start(g_tracer.intern(type, prefix, description), extraDescription);
+    }
 
     ~AutoStat() {
-        m_stat->executionTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - m_timePoint).count();
-        m_stat->executionTime -= m_minusTime;
-        g_stats.add(m_type, m_stat);
+        if (m_start != 0)
+            g_stats.add(m_zone, m_start, Tracer::now() - m_start, m_extraDescription);
     }
 
     AutoStat(const AutoStat&) = delete;
     AutoStat& operator=(const AutoStat&) = delete;
 
 private:
-    int m_type;
-    Stat* m_stat;
+    // the extra description is copied, callers often pass a temporary
+    void start(const TraceZoneId zone, const std::string_view extraDescription)
+    {
+        m_zone = zone;
+        m_extraDescription = extraDescription;
+        m_start = Tracer::now();
+    }
 
-protected:
-    uint64_t m_minusTime = 0;
-    std::chrono::high_resolution_clock::time_point m_timePoint;
+    TraceZoneId m_zone{ 0 };
+    std::string m_extraDescription;
+    int64_t m_start{ 0 };
 };
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "tracer.h"
+
+#include <fstream>
+
+Tracer g_tracer;
+
+namespace
+{
+    void writeJsonString(std::ofstream& out, const std::string_view str)
+    {
+        out << '"';
+        for (const char c : str) {
+            switch (c) {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                        out << ' ';
+                    else
+                        out << c;
+            }
+        }
+        out << '"';
+    }
+}
+
+Tracer::ThreadTrace::~ThreadTrace()
+{
+    for (auto& block : blocks)
+        delete[] block.load(std::memory_order_relaxed);
+    delete[] ring.load(std::memory_order_relaxed);
+}
+
+Tracer::ThreadTrace& Tracer::localThread()
+{
+    thread_local ThreadTrace* thread = nullptr;
+    if (thread)
+        return *thread;
+
+    std::scoped_lock lock(m_mutex);
+    auto& trace = m_threads.emplace_back(std::make_unique<ThreadTrace>());
+    trace->id = static_cast<uint32_t>(m_threads.size());
+    trace->name = "Thread " + std::to_string(trace->id);
+    thread = trace.get();
+    return *thread;
+}
+
+TraceZoneId Tracer::intern(const uint8_t category, const std::string_view name)
+{
+    auto& cache = localThread().cache[category % MAX_CATEGORIES];
+    if (const auto it = cache.find(name); it != cache.end())
+        return it->second;
+
+    const auto zone = registerZone(category, name);
+    cache.emplace(name, zone);
+    return zone;
+}
+
+TraceZoneId Tracer::intern(const uint8_t category, const std::string_view prefix, const std::string_view name)
+{
+    auto& key = localThread().key;
+    key.assign(prefix);
+    key += ':';
+    key += name;
+    return intern(category, key);
+}
+
+TraceZoneId Tracer::registerZone(const uint8_t category, const std::string_view name)
+{
+    std::scoped_lock lock(m_mutex);
+
+    auto& zones = m_zones[category % MAX_CATEGORIES];
+    if (const auto it = zones.find(name); it != zones.end())
+        return it->second;
+
+    if (m_zoneNames.size() >= MAX_ZONES - 1) {
+        // every further name shares the last id rather than growing without bound (e.g. unique event names)
+        if (m_zoneNames.size() == MAX_ZONES - 1) {
+            m_zoneNames.emplace_back("<zone limit reached>");
+            m_zoneCategories[MAX_ZONES - 1].store(category, std::memory_order_relaxed);
+            m_zoneCount.store(m_zoneNames.size(), std::memory_order_release);
+        }
+        return MAX_ZONES - 1;
+    }
+
+    const auto zone = static_cast<TraceZoneId>(m_zoneNames.size());
+    m_zoneNames.emplace_back(name);
+    m_zoneCategories[zone].store(category, std::memory_order_relaxed);
+    zones.emplace(name, zone);
+    m_zoneCount.store(m_zoneNames.size(), std::memory_order_release);
+    return zone;
+}
+
+std::string Tracer::getZoneName(const TraceZoneId zone)
+{
+    std::scoped_lock lock(m_mutex);
+    return zone < m_zoneNames.size() ? m_zoneNames[zone] : std::string();
+}
+
+void Tracer::record(const TraceZoneId zone, const int64_t start, const int64_t duration, const bool count)
+{
+    auto& thread = localThread();
+
+    if (count) {
+        auto& slot = thread.blocks[zone / ZONE_BLOCK_SIZE];
+        auto* block = slot.load(std::memory_order_relaxed);
+        if (!block) {
+            block = new ZoneCounters[ZONE_BLOCK_SIZE];
+            slot.store(block, std::memory_order_release);
+        }
+
+        // single writer: plain load/store keeps the hot path free of locked instructions
+        auto& counters = block[zone % ZONE_BLOCK_SIZE];
+        counters.calls.store(counters.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        counters.nanoseconds.store(counters.nanoseconds.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+    }
+
+    if (!m_capturing.load(std::memory_order_relaxed))
+        return;
+
+    auto* ring = thread.ring.load(std::memory_order_relaxed);
+    if (!ring) {
+        ring = new EventSlot[RING_CAPACITY];
+        thread.ring.store(ring, std::memory_order_release);
+    }
+
+    // a reader that sees any of the slot writes also sees the claim, and drops the slot
+    const auto head = thread.head.load(std::memory_order_relaxed);
+    thread.claimed.store(head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& slot = ring[head % RING_CAPACITY];
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(duration, std::memory_order_relaxed);
+    slot.zone.store(zone, std::memory_order_relaxed);
+    thread.head.store(head + 1, std::memory_order_release);
+}
+
+std::vector<Tracer::ZoneTotals> Tracer::collectTotals()
+{
+    std::vector<ZoneTotals> totals(getZoneCount());
+
+    std::scoped_lock lock(m_mutex);
+    for (const auto& thread : m_threads) {
+        for (size_t b = 0; b < thread->blocks.size(); ++b) {
+            const auto* block = thread->blocks[b].load(std::memory_order_acquire);
+            if (!block)
+                continue;
+
+            for (size_t i = 0; i < ZONE_BLOCK_SIZE; ++i) {
+                const size_t zone = b * ZONE_BLOCK_SIZE + i;
+                if (zone >= totals.size())
+                    break;
+                totals[zone].calls += block[i].calls.load(std::memory_order_relaxed);
+                totals[zone].nanoseconds += block[i].nanoseconds.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return totals;
+}
+
+void Tracer::startCapture()
+{
+    // the rings are left to their owners, events from before the start are filtered out when saving
+    m_captureStart.store(now(), std::memory_order_relaxed);
+    m_captureEnd.store(0, std::memory_order_relaxed);
+    m_capturing.store(true, std::memory_order_release);
+}
+
+void Tracer::stopCapture()
+{
+    m_captureEnd.store(now(), std::memory_order_relaxed);
+    m_capturing.store(false, std::memory_order_release);
+}
+
+bool Tracer::saveCapture(const std::string& path, const std::span<const std::string_view> categoryNames)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+        return false;
+
+    const int64_t captureStart = m_captureStart.load(std::memory_order_relaxed);
+    const int64_t savedEnd = m_captureEnd.load(std::memory_order_relaxed);
+    const int64_t captureEnd = isCapturing() || savedEnd == 0 ? now() : savedEnd;
+
+    std::scoped_lock lock(m_mutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    std::vector<Event> events;
+    for (const auto& thread : m_threads) {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id << ",\"args\":{\"name\":";
+        writeJsonString(out, thread->name);
+        out << "}}";
+        first = false;
+
+        const auto* ring = thread->ring.load(std::memory_order_acquire);
+        if (!ring)
+            continue;
+
+        const auto head = thread->head.load(std::memory_order_acquire);
+        const auto begin = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+        events.clear();
+        for (auto i = begin; i < head; ++i) {
+            const auto& slot = ring[i % RING_CAPACITY];
+            events.push_back({ slot.start.load(std::memory_order_relaxed), slot.duration.load(std::memory_order_relaxed), slot.zone.load(std::memory_order_relaxed) });
+        }
+
+        // the owner may have wrapped over the oldest slots while they were copied, those are dropped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto claimed = thread->claimed.load(std::memory_order_relaxed);
+        const size_t overwritten = claimed > RING_CAPACITY + begin ? std::min<size_t>(claimed - RING_CAPACITY - begin, events.size()) : 0;
+
+        for (size_t i = overwritten; i < events.size(); ++i) {
+            const auto& event = events[i];
+            if (event.start < captureStart || event.start > captureEnd || event.zone >= m_zoneNames.size())
+                continue;
+
+            const auto category = m_zoneCategories[event.zone].load(std::memory_order_relaxed);
+            out << ",\n{\"name\":";
+            writeJsonString(out, m_zoneNames[event.zone]);
+            out << ",\"cat\":";
+            writeJsonString(out, category < categoryNames.size() ? categoryNames[category] : std::string_view("other"));
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->id
+                << ",\"ts\":" << (event.start - captureStart) / 1000.0
+                << ",\"dur\":" << event.duration / 1000.0 << '}';
+        }
+    }
+
+    out << "\n]}\n";
+    return out.good();
+}
+
+void Tracer::setThreadName(const std::string_view name)
+{
+    auto& thread = localThread();
+    std::scoped_lock lock(m_mutex);
+    thread.name = name;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <parallel_hashmap/phmap.h>
+
+using TraceZoneId = uint16_t;
+
+// Zone recording behind g_stats and trace captures.
+//
+// A zone is a (category, name) pair interned once into a small id. Each thread
+// records into its own counters and ring buffer, written only by that thread and
+// read by others through atomics, so recording takes no lock and, once a thread
+// has seen a zone, does no allocation. Captures are exported as Chrome trace
+// JSON, which chrome://tracing and ui.perfetto.dev both open.
+class Tracer
+{
+public:
+    static constexpr size_t MAX_CATEGORIES = 16;
+    static constexpr size_t MAX_ZONES = 1 << 14;
+    static constexpr size_t ZONE_BLOCK_SIZE = 256;
+    static constexpr size_t RING_CAPACITY = 1 << 16;
+
+    struct ZoneTotals
+    {
+        uint64_t calls = 0;
+        uint64_t nanoseconds = 0;
+    };
+
+    static int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    TraceZoneId intern(uint8_t category, std::string_view name);
+    // interns "prefix:name", building the key in a per thread buffer instead of a temporary string
+    TraceZoneId intern(uint8_t category, std::string_view prefix, std::string_view name);
+
+    uint8_t getZoneCategory(const TraceZoneId zone) const { return m_zoneCategories[zone].load(std::memory_order_relaxed); }
+    std::string getZoneName(TraceZoneId zone);
+    size_t getZoneCount() const { return m_zoneCount.load(std::memory_order_acquire); }
+
+    void record(TraceZoneId zone, int64_t start, int64_t duration, bool count);
+
+    // sums every thread's counters, indexed by zone id
+    std::vector<ZoneTotals> collectTotals();
+
+    void startCapture();
+    void stopCapture();
+    bool isCapturing() const { return m_capturing.load(std::memory_order_relaxed); }
+    bool saveCapture(const std::string& path, std::span<const std::string_view> categoryNames);
+
+    void setThreadName(std::string_view name);
+
+private:
+    struct ZoneCounters
+    {
+        std::atomic<uint64_t> calls{ 0 };
+        std::atomic<uint64_t> nanoseconds{ 0 };
+    };
+
+    struct Event
+    {
+        int64_t start;
+        int64_t duration;
+        TraceZoneId zone;
+    };
+
+    // written by the owner thread while saveCapture may copy it
+    struct EventSlot
+    {
+        std::atomic<int64_t> start{ 0 };
+        std::atomic<int64_t> duration{ 0 };
+        std::atomic<TraceZoneId> zone{ 0 };
+    };
+
+    struct ThreadTrace
+    {
+        uint32_t id = 0;
+        std::string name;
+        std::array<std::atomic<ZoneCounters*>, MAX_ZONES / ZONE_BLOCK_SIZE> blocks{};
+        std::atomic<EventSlot*> ring{ nullptr };
+        // events written, and events the owner has started to write; only the owner moves them
+        std::atomic<uint64_t> head{ 0 };
+        std::atomic<uint64_t> claimed{ 0 };
+
+        // owner thread only
+        std::array<phmap::flat_hash_map<std::string, TraceZoneId>, MAX_CATEGORIES> cache;
+        std::string key;
+
+        ~ThreadTrace();
+    };
+
+    ThreadTrace& localThread();
+    TraceZoneId registerZone(uint8_t category, std::string_view name);
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadTrace>> m_threads;
+    std::array<phmap::flat_hash_map<std::string, TraceZoneId>, MAX_CATEGORIES> m_zones;
+    std::vector<std::string> m_zoneNames;
+    std::array<std::atomic<uint8_t>, MAX_ZONES> m_zoneCategories{};
+    std::atomic<size_t> m_zoneCount{ 0 };
+
+    std::atomic_bool m_capturing{ false };
+    std::atomic<int64_t> m_captureStart{ 0 };
+    std::atomic<int64_t> m_captureEnd{ 0 };
+};
+
+extern Tracer g_tracer;
+
+// interns a constant zone name once per call site
+#define TRACE_ZONE(category, name) ([] { static const TraceZoneId zone = g_tracer.intern(category, name); return zone; }())
@@ -47,6 +47,7 @@
 #endif
 
 #ifdef FRAMEWORK_NET
+#include <framework/net/packet_record.h>
 #include <framework/net/protocolhttp.h>
 #endif
 
@@ -85,7 +86,10 @@ void printHelp(const std::string& executableName)
                  "DAT debugging:\n"
                  "  --dump-dat-to-json=<path|ver> Dump the specified Tibia DAT file or version as JSON (requires FRAMEWORK_EDITOR build)\n"
                  "    --dump-dat-output=<path>    Write JSON to file instead of stdout\n"
-                 "    --dump-dat-compact          Emit compact (single-line) JSON\n";
+                 "    --dump-dat-compact          Emit compact (single-line) JSON\n"
+                 "    --dump-dat-bounds=<path>    Also write the frame bounds table (.otbb) of the DAT/SPR pair\n\n"
+                 "Records:\n"
+                 "  --convert-record <from> <to> Convert a packet record, <to> ending in .otrec is written as binary, anything else as hex\n";
 }
 
 std::string buildStartupTimestamp()
@@ -163,6 +167,18 @@ int main(const int argc, const char* argv[])
         return 0;
     }
 
+#ifdef FRAMEWORK_NET
+    if (const auto it = std::find(args.begin(), args.end(), "--convert-record"); it != args.end()) {
+        if (std::distance(it, args.end()) < 3) {
+            printHelp(args[0]);
+            return 1;
+        }
+        const auto& to = *(it + 2);
+        const auto format = to.ends_with(".otrec") ? PacketRecordFormat::Binary : PacketRecordFormat::Hex;
+        return convertPacketRecord(*(it + 1), to, format) ? 0 : 1;
+    }
+#endif
+
 #ifdef FRAMEWORK_EDITOR
     if (const auto dumpRequest = datdump::parseRequest(args); dumpRequest) {
         return datdump::run(*dumpRequest) ? 0 : 1;
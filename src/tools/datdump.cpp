@@ -23,6 +23,9 @@
 #include "tools/datdump.h"
 
 #include "client/game.h"
+#include "client/gameconfig.h"
+#include "client/spritemanager.h"
+#include "client/thingbounds.h"
 #include "client/thingtype.h"
 #include "client/thingtypemanager.h"
 #include "framework/luaengine/luainterface.h"
@@ -154,6 +157,37 @@ namespace datdump {
 
             return entry;
         }
+
+        void dumpBounds(const Request& request)
+        {
+            const auto& sprPath = request.datPath.substr(0, request.datPath.rfind('.')) + ".spr";
+
+            g_sprites.init();
+            if (!g_sprites.loadSpr(sprPath))
+                throw std::runtime_error("unable to load SPR file: " + sprPath);
+
+            ThingBoundsTable table;
+            table.setAssetKey(g_things.getThingBoundsKey(), static_cast<uint16_t>(g_gameConfig.getSpriteSize()));
+
+            for (const auto category : { ThingCategoryItem, ThingCategoryCreature, ThingCategoryEffect, ThingCategoryMissile }) {
+                const auto& list = g_things.getThingTypes(category);
+                for (size_t idx = 1; idx < list.size() && idx <= std::numeric_limits<uint16_t>::max(); ++idx) {
+                    const auto& type = list[idx];
+                    if (!type || type->isNull())
+                        continue;
+
+                    for (int phase = 0; phase < std::max<int>(1, type->getAnimationPhases()); ++phase) {
+                        if (auto frames = type->computeBounds(phase); !frames.empty())
+                            table.set(category, static_cast<uint16_t>(idx), static_cast<uint16_t>(phase), std::move(frames));
+                    }
+                }
+            }
+
+            if (!table.save(request.boundsPath))
+                throw std::runtime_error("unable to write bounds file: " + request.boundsPath);
+
+            g_sprites.terminate();
+        }
     } // namespace
 
     std::optional<Request> parseRequest(std::vector<std::string>& args)
@@ -178,6 +212,11 @@ namespace datdump {
                     args.erase(args.begin() + static_cast<long>(j));
                     continue;
                 }
+                if (auto value = readFlagValue(args, j, "--dump-dat-bounds"); value) {
+                    request.boundsPath = *value;
+                    args.erase(args.begin() + static_cast<long>(j));
+                    continue;
+                }
                 if (args[j] == "--dump-dat-compact") {
                     request.compactOutput = true;
                     args.erase(args.begin() + static_cast<long>(j));
@@ -216,6 +255,9 @@ namespace datdump {
             throw std::runtime_error("unable to load DAT file: " + request.datPath);
         }
 
+        if (!request.boundsPath.empty())
+            dumpBounds(request);
+
         json root;
         root["datSignature"] = g_things.getDatSignature();
         root["contentRevision"] = g_things.getContentRevision();
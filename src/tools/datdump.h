@@ -32,6 +32,7 @@ struct Request
 {
     std::string datPath;
     std::string outputPath;
+    std::string boundsPath;
     int clientVersion{ 0 };
     bool compactOutput{ false };
 };
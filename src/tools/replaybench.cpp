@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2010-2026 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Headless replay benchmark: feeds a recorded session (records/*.cam) through
+// ProtocolGame and MapView as fast as possible, without a window or GL context,
+// and reports parse throughput, allocations and per-opcode cost.
+//
+// usage: otclient_replay_bench [--record=test1098.cam] [--version=1098] [--repeat=1]
+//                              [--top=15] [--modules=a,b,c] [--output=report.json]
+
+#include "client/client.h"
+#include "client/game.h"
+#include "client/gameconfig.h"
+#include "client/localplayer.h"
+#include "client/map.h"
+#include "client/mapview.h"
+#include "client/minimap.h"
+#include "client/protocolgame.h"
+#include "client/spriteappearances.h"
+#include "client/spritemanager.h"
+#include "client/thingtypemanager.h"
+#include "framework/core/application.h"
+#include "framework/core/configmanager.h"
+#include "framework/core/eventdispatcher.h"
+#include "framework/core/module.h"
+#include "framework/core/modulemanager.h"
+#include "framework/core/resourcemanager.h"
+#include "framework/graphics/drawpoolmanager.h"
+#include "framework/luaengine/luainterface.h"
+#include "framework/net/packet_player.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+namespace
+{
+    std::atomic<uint64_t> s_allocations{ 0 };
+    std::atomic<uint64_t> s_allocatedBytes{ 0 };
+
+    void* countedAlloc(const std::size_t size)
+    {
+        s_allocations.fetch_add(1, std::memory_order_relaxed);
+        s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+}
+
+void* operator new(const std::size_t size)
+{
+    if (void* ptr = countedAlloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size)
+{
+    if (void* ptr = countedAlloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+class ReplayBenchmark
+{
+public:
+    struct Options
+    {
+        std::string record{ "test1098.cam" };
+        std::vector<std::string> modules{ "corelib", "gamelib", "modulelib", "game_features", "game_things" };
+        std::string outputPath;
+        uint16_t clientVersion{ 1098 };
+        uint32_t repeat{ 1 };
+        uint32_t top{ 15 };
+    };
+
+    static std::optional<Options> parseOptions(const std::vector<std::string>& args)
+    {
+        Options options;
+        for (size_t i = 1; i < args.size(); ++i) {
+            const auto& arg = args[i];
+            const auto separator = arg.find('=');
+            const auto name = arg.substr(0, separator);
+            const auto value = separator == std::string::npos ? std::string() : arg.substr(separator + 1);
+
+            try {
+                if (name == "--record") options.record = value;
+                else if (name == "--version") options.clientVersion = static_cast<uint16_t>(std::stoul(value));
+                else if (name == "--repeat") options.repeat = std::max<uint32_t>(1, std::stoul(value));
+                else if (name == "--top") options.top = std::stoul(value);
+                else if (name == "--output") options.outputPath = value;
+                else if (name == "--modules") options.modules = stdext::split(value, ",");
+                else {
+                    std::cerr << "Unknown option: " << arg << '\n';
+                    return std::nullopt;
+                }
+            } catch (const std::exception&) {
+                std::cerr << "Invalid value for " << name << ": " << value << '\n';
+                return std::nullopt;
+            }
+        }
+        return options;
+    }
+
+    explicit ReplayBenchmark(Options options) : m_options(std::move(options)) {}
+
+    bool init(const char* argv0)
+    {
+        g_logger.setLevel(Fw::LogWarning);
+
+        g_resources.init(argv0);
+        if (!g_resources.discoverWorkDir("init.lua")) {
+            std::cerr << "Unable to find work directory (init.lua)\n";
+            return false;
+        }
+
+        const auto& workDir = g_resources.getWorkDir();
+        g_resources.addSearchPath(workDir + "data", true);
+        g_resources.addSearchPath(workDir + "modules", true);
+        g_resources.addSearchPath(workDir + "mods", true);
+
+        g_dispatcher.init();
+        g_textDispatcher.init();
+        g_mainDispatcher.init();
+
+        g_configs.init();
+        g_lua.init();
+        g_app.registerLuaFunctions();
+        Client::registerLuaFunctions();
+
+        g_gameConfig.init();
+        g_map.init();
+        g_minimap.init();
+        g_game.init();
+        g_sprites.init();
+        g_spriteAppearances.init();
+        g_things.init();
+
+        // no GL context: the pools only collect draw calls, nothing is ever flushed
+        g_drawPool.init(g_gameConfig.getSpriteSize());
+
+        g_modules.discoverModules();
+        for (const auto& name : m_options.modules) {
+            const auto& module = g_modules.getModule(name);
+            if (!module || !module->load())
+                g_logger.warning("replay bench: unable to load module '{}'", name);
+        }
+
+        g_game.setClientVersion(m_options.clientVersion);
+
+        uint16_t protocolVersion = m_options.clientVersion;
+        if (const auto version = g_lua.callGlobalField<int>("g_game", "getClientProtocolVersion", m_options.clientVersion); version > 0)
+            protocolVersion = static_cast<uint16_t>(version);
+        g_game.setProtocolVersion(protocolVersion);
+
+        m_mapView = std::make_shared<MapView>();
+        g_map.addMapView(m_mapView);
+        return true;
+    }
+
+    void terminate()
+    {
+        g_map.removeMapView(m_mapView);
+        m_mapView = nullptr;
+
+        g_game.terminate();
+        g_map.terminate();
+        g_minimap.terminate();
+        g_things.terminate();
+        g_spriteAppearances.terminate();
+        g_sprites.terminate();
+        g_gameConfig.terminate();
+
+        g_textDispatcher.shutdown();
+        g_dispatcher.shutdown();
+        g_mainDispatcher.shutdown();
+
+        g_modules.unloadModules();
+        g_modules.clear();
+        g_lua.collectGarbage();
+
+        g_configs.terminate();
+        g_resources.terminate();
+        g_lua.terminate();
+    }
+
+    bool run()
+    {
+        for (uint32_t i = 0; i < m_options.repeat; ++i) {
+            if (!replay())
+                return false;
+        }
+
+        report();
+        return true;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct OpcodeStats
+    {
+        uint64_t calls{ 0 };
+        uint64_t nanoseconds{ 0 };
+        uint64_t allocations{ 0 };
+    };
+
+    static uint64_t elapsed(const Clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    bool replay()
+    {
+        const auto player = std::make_shared<PacketPlayer>(m_options.record);
+        try {
+            g_game.playRecordPlayer(player);
+        } catch (const std::exception& e) {
+            std::cerr << "Unable to play record: " << e.what() << '\n';
+            return false;
+        }
+
+        // packets are pulled below as fast as they parse, not on their recorded timestamps
+        player->stop();
+
+        const auto& protocol = g_game.getProtocolGame();
+        protocol->setOpcodeProfiler([this](const uint8_t opcode, const bool finished) {
+            if (!finished) {
+                m_opcodeStart = Clock::now();
+                m_opcodeAllocations = s_allocations.load(std::memory_order_relaxed);
+                return;
+            }
+
+            auto& stats = m_opcodes[opcode];
+            ++stats.calls;
+            stats.nanoseconds += elapsed(m_opcodeStart);
+            stats.allocations += s_allocations.load(std::memory_order_relaxed) - m_opcodeAllocations;
+        });
+
+        auto packet = player->nextInputPacket();
+        if (!packet) {
+            std::cerr << "Record '" << m_options.record << "' has no server packets\n";
+            g_game.cancelLogin();
+            return false;
+        }
+
+        const auto replayStart = Clock::now();
+        for (; packet; packet = player->nextInputPacket()) {
+            const auto allocations = s_allocations.load(std::memory_order_relaxed);
+            const auto bytes = s_allocatedBytes.load(std::memory_order_relaxed);
+
+            const auto parseStart = Clock::now();
+            protocol->processPlayerPacket(packet);
+            m_parseNanoseconds += elapsed(parseStart);
+
+            const auto dispatchStart = Clock::now();
+            g_dispatcher.poll();
+            m_dispatchNanoseconds += elapsed(dispatchStart);
+
+            updateMapView();
+
+            ++m_packets;
+            m_packetBytes += packet->size();
+            m_allocations += s_allocations.load(std::memory_order_relaxed) - allocations;
+            m_allocatedBytes += s_allocatedBytes.load(std::memory_order_relaxed) - bytes;
+
+            if (!g_game.getProtocolGame())
+                break; // the record logged out
+        }
+        m_replayNanoseconds += elapsed(replayStart);
+
+        if (const auto& current = g_game.getProtocolGame())
+            current->setOpcodeProfiler(nullptr);
+
+        g_game.cancelLogin();
+        g_dispatcher.poll();
+        return true;
+    }
+
+    // mirrors what MapView::updateRect/preLoad do every frame, minus the drawing
+    void updateMapView()
+    {
+        const auto& localPlayer = g_game.getLocalPlayer();
+        if (!localPlayer || !localPlayer->getPosition().isValid())
+            return;
+
+        if (m_mapView->getFollowingCreature() != localPlayer)
+            m_mapView->followCreature(localPlayer);
+
+        m_mapView->updateCamera();
+        if (!m_mapView->m_updateVisibleTiles)
+            return;
+
+        const auto start = Clock::now();
+        m_mapView->updateVisibleTiles();
+        m_mapUpdateNanoseconds += elapsed(start);
+        ++m_mapUpdates;
+    }
+
+    void report() const
+    {
+        using json = nlohmann::ordered_json;
+
+        const auto ms = [](const uint64_t ns) { return ns / 1e6; };
+        const auto us = [](const uint64_t ns, const uint64_t count) { return count ? ns / 1e3 / count : 0.0; };
+        const auto perPacket = [this](const uint64_t value) { return m_packets ? static_cast<double>(value) / m_packets : 0.0; };
+        const double seconds = m_replayNanoseconds / 1e9;
+
+        std::vector<std::pair<uint8_t, OpcodeStats>> opcodes;
+        for (size_t i = 0; i < m_opcodes.size(); ++i) {
+            if (m_opcodes[i].calls > 0)
+                opcodes.emplace_back(static_cast<uint8_t>(i), m_opcodes[i]);
+        }
+        std::ranges::sort(opcodes, [](const auto& a, const auto& b) { return a.second.nanoseconds > b.second.nanoseconds; });
+        if (opcodes.size() > m_options.top)
+            opcodes.resize(m_options.top);
+
+        std::cout << fmt::format("record: {} (client {}, protocol {}), {} pass(es)\n", m_options.record, m_options.clientVersion, g_game.getProtocolVersion(), m_options.repeat);
+        std::cout << fmt::format("packets: {} ({} bytes) in {:.2f} ms, {:.0f} packets/s\n", m_packets, m_packetBytes, ms(m_replayNanoseconds), seconds > 0 ? m_packets / seconds : 0.0);
+        std::cout << fmt::format("parse: {:.2f} ms, {:.2f} us/packet\n", ms(m_parseNanoseconds), us(m_parseNanoseconds, m_packets));
+        std::cout << fmt::format("dispatcher: {:.2f} ms\n", ms(m_dispatchNanoseconds));
+        std::cout << fmt::format("map view: {} updates, {:.2f} ms, {:.2f} us/update\n", m_mapUpdates, ms(m_mapUpdateNanoseconds), us(m_mapUpdateNanoseconds, m_mapUpdates));
+        std::cout << fmt::format("allocations: {} ({:.1f}/packet), {} bytes ({:.0f}/packet)\n", m_allocations, perPacket(m_allocations), m_allocatedBytes, perPacket(m_allocatedBytes));
+
+        std::cout << fmt::format("\n{:>6} {:>10} {:>12} {:>10} {:>12}\n", "opcode", "calls", "total ms", "us/call", "allocs/call");
+        for (const auto& [opcode, stats] : opcodes) {
+            std::cout << fmt::format("{:>#6x} {:>10} {:>12.3f} {:>10.2f} {:>12.1f}\n", opcode, stats.calls, ms(stats.nanoseconds),
+                                     us(stats.nanoseconds, stats.calls), static_cast<double>(stats.allocations) / stats.calls);
+        }
+
+        if (m_options.outputPath.empty())
+            return;
+
+        json output;
+        output["record"] = m_options.record;
+        output["clientVersion"] = m_options.clientVersion;
+        output["repeat"] = m_options.repeat;
+        output["packets"] = m_packets;
+        output["packetBytes"] = m_packetBytes;
+        output["packetsPerSecond"] = seconds > 0 ? m_packets / seconds : 0.0;
+        output["replayMs"] = ms(m_replayNanoseconds);
+        output["parseMs"] = ms(m_parseNanoseconds);
+        output["dispatcherMs"] = ms(m_dispatchNanoseconds);
+        output["mapUpdates"] = m_mapUpdates;
+        output["mapUpdateMs"] = ms(m_mapUpdateNanoseconds);
+        output["allocations"] = m_allocations;
+        output["allocatedBytes"] = m_allocatedBytes;
+
+        auto& opcodeList = output["opcodes"] = json::array();
+        for (const auto& [opcode, stats] : opcodes) {
+            opcodeList.push_back({ { "opcode", opcode }, { "calls", stats.calls }, { "totalMs", ms(stats.nanoseconds) }, { "allocations", stats.allocations } });
+        }
+
+        std::ofstream file(m_options.outputPath);
+        if (!file)
+            std::cerr << "Unable to write " << m_options.outputPath << '\n';
+        else
+            file << output.dump(2) << '\n';
+    }
+
+    Options m_options;
+    MapViewPtr m_mapView;
+
+    std::array<OpcodeStats, 256> m_opcodes{};
+    Clock::time_point m_opcodeStart;
+    uint64_t m_opcodeAllocations{ 0 };
+
+    uint64_t m_packets{ 0 };
+    uint64_t m_packetBytes{ 0 };
+    uint64_t m_allocations{ 0 };
+    uint64_t m_allocatedBytes{ 0 };
+    uint64_t m_replayNanoseconds{ 0 };
+    uint64_t m_parseNanoseconds{ 0 };
+    uint64_t m_dispatchNanoseconds{ 0 };
+    uint64_t m_mapUpdateNanoseconds{ 0 };
+    uint64_t m_mapUpdates{ 0 };
+};
+
+int main(const int argc, const char* argv[])
+{
+    const std::vector<std::string> args(argv, argv + argc);
+    const auto options = ReplayBenchmark::parseOptions(args);
+    if (!options)
+        return 2;
+
+    ReplayBenchmark benchmark(*options);
+    if (!benchmark.init(argv[0]))
+        return 1;
+
+    const bool ok = benchmark.run();
+    benchmark.terminate();
+    return ok ? 0 : 1;
+}
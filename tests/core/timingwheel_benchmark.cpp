@@ -0,0 +1,127 @@
+// Compares the dispatcher timing wheel against the ordered multiset it replaced,
+// under a steady load of short scheduled events, long cycle events and cancellations.
+
+#include <framework/core/clock.h>
+#include <framework/core/scheduledevent.h>
+#include <framework/core/timingwheel.h>
+
+#include <parallel_hashmap/btree.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr int TICKS = 4000;
+    constexpr int EVENTS_PER_TICK = 64;
+    constexpr int CANCEL_EVERY = 4;
+
+    using Clock = std::chrono::steady_clock;
+
+    // events are due against g_clock, so every simulated tick waits for the next real millisecond
+    void nextTick()
+    {
+        const ticks_t current = g_clock.millis();
+        do {
+            g_clock.update();
+        } while (g_clock.millis() == current);
+    }
+
+    struct Workload
+    {
+        std::vector<int> delays;
+        std::vector<bool> cancels;
+    };
+
+    Workload makeWorkload()
+    {
+        std::mt19937 rng(1337);
+        std::uniform_int_distribution<int> shortDelay(1, 500);
+        std::uniform_int_distribution<int> longDelay(500, 120000);
+
+        Workload workload;
+        workload.delays.reserve(TICKS * EVENTS_PER_TICK);
+        for (int i = 0; i < TICKS * EVENTS_PER_TICK; ++i) {
+            workload.delays.emplace_back(i % 8 == 0 ? longDelay(rng) : shortDelay(rng));
+            workload.cancels.emplace_back(i % CANCEL_EVERY == 0);
+        }
+        return workload;
+    }
+
+    // the previous dispatcher path: canceled events stay in the set until they are due
+    double runMultiset(const Workload& workload, size_t& executed)
+    {
+        phmap::btree_multiset<ScheduledEventPtr, ScheduledEvent::Compare> events;
+        std::vector<ScheduledEventPtr> pending;
+
+        Clock::duration elapsed{};
+        for (int tick = 0, i = 0; tick < TICKS; ++tick) {
+            nextTick();
+            const auto start = Clock::now();
+            for (int n = 0; n < EVENTS_PER_TICK; ++n, ++i) {
+                auto event = std::make_shared<ScheduledEvent>("bench", [&executed] { ++executed; }, workload.delays[i], 1);
+                if (workload.cancels[i])
+                    pending.emplace_back(event);
+                events.insert(std::move(event));
+            }
+            for (const auto& event : pending)
+                event->cancel();
+            pending.clear();
+
+            auto it = events.begin();
+            while (it != events.end() && (*it)->remainingTicks() <= 0) {
+                (*it)->execute();
+                ++it;
+            }
+            events.erase(events.begin(), it);
+            elapsed += Clock::now() - start;
+        }
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+
+    double runWheel(const Workload& workload, size_t& executed)
+    {
+        TimingWheel wheel;
+        std::vector<ScheduledEventPtr> pending;
+        std::vector<ScheduledEventPtr> expired;
+
+        Clock::duration elapsed{};
+        for (int tick = 0, i = 0; tick < TICKS; ++tick) {
+            nextTick();
+            const auto start = Clock::now();
+            for (int n = 0; n < EVENTS_PER_TICK; ++n, ++i) {
+                auto event = ScheduledEvent::create("bench", [&executed] { ++executed; }, workload.delays[i], 1);
+                wheel.insert(event);
+                if (workload.cancels[i])
+                    pending.emplace_back(std::move(event));
+            }
+            for (const auto& event : pending)
+                event->cancel();
+            pending.clear();
+
+            wheel.advance(g_clock.millis(), expired);
+            for (const auto& event : expired)
+                event->execute();
+            expired.clear();
+            elapsed += Clock::now() - start;
+        }
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+}
+
+int main()
+{
+    const auto workload = makeWorkload();
+
+    size_t multisetExecuted = 0;
+    size_t wheelExecuted = 0;
+    const double multisetMs = runMultiset(workload, multisetExecuted);
+    const double wheelMs = runWheel(workload, wheelExecuted);
+
+    std::printf("%d ticks, %d events per tick, 1 in %d canceled\n", TICKS, EVENTS_PER_TICK, CANCEL_EVERY);
+    std::printf("btree multiset: %9.2f ms (%zu executed)\n", multisetMs, multisetExecuted);
+    std::printf("timing wheel:   %9.2f ms (%zu executed)\n", wheelMs, wheelExecuted);
+    return 0;
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include <framework/core/clock.h>
+#include <framework/core/scheduledevent.h>
+#include <framework/core/timingwheel.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // g_clock is never updated in tests, events are scheduled relative to its frozen time
+    ScheduledEventPtr makeEvent(std::vector<int>& order, const int id, const int delay, const int maxCycles = 1)
+    {
+        return ScheduledEvent::create("test", [&order, id] { order.emplace_back(id); }, delay, maxCycles);
+    }
+
+    void run(TimingWheel& wheel, const ticks_t now)
+    {
+        std::vector<ScheduledEventPtr> expired;
+        wheel.advance(now, expired);
+        for (const auto& event : expired) {
+            event->execute();
+            if (event->nextCycle())
+                wheel.insert(event);
+        }
+    }
+
+    TEST(TimingWheel, ExpiresInDueOrder)
+    {
+        const ticks_t base = g_clock.millis();
+        std::vector<int> order;
+        TimingWheel wheel;
+
+        wheel.insert(makeEvent(order, 3, 30));
+        wheel.insert(makeEvent(order, 1, 10));
+        wheel.insert(makeEvent(order, 2, 20));
+        EXPECT_EQ(wheel.size(), 3u);
+
+        run(wheel, base + 9);
+        EXPECT_TRUE(order.empty());
+
+        run(wheel, base + 20);
+        EXPECT_EQ(order, (std::vector{ 1, 2 }));
+
+        run(wheel, base + 100);
+        EXPECT_EQ(order, (std::vector{ 1, 2, 3 }));
+        EXPECT_EQ(wheel.size(), 0u);
+    }
+
+    TEST(TimingWheel, CancelRemovesImmediately)
+    {
+        const ticks_t base = g_clock.millis();
+        std::vector<int> order;
+        TimingWheel wheel;
+
+        const auto event = makeEvent(order, 1, 50);
+        std::weak_ptr<ScheduledEvent> weak = event;
+        wheel.insert(event);
+        wheel.insert(makeEvent(order, 2, 60));
+
+        event->cancel();
+        EXPECT_EQ(wheel.size(), 1u);
+
+        run(wheel, base + 100);
+        EXPECT_EQ(order, (std::vector{ 2 }));
+        EXPECT_FALSE(wheel.remove(event.get()));
+
+        // the wheel no longer holds a reference to it
+        EXPECT_EQ(weak.use_count(), 1);
+    }
+
+    TEST(TimingWheel, CascadesFromUpperLevels)
+    {
+        const ticks_t base = g_clock.millis();
+        std::vector<int> order;
+        TimingWheel wheel;
+
+        // level 1, level 2 and a delay crossing a level 1 boundary exactly
+        wheel.insert(makeEvent(order, 1, 300));
+        wheel.insert(makeEvent(order, 2, 512));
+        wheel.insert(makeEvent(order, 3, 70000));
+
+        for (ticks_t now = base; now < base + 70000; now += 7) {
+            run(wheel, now);
+            if (now < base + 300) EXPECT_TRUE(order.empty());
+        }
+        EXPECT_EQ(order, (std::vector{ 1, 2 }));
+
+        run(wheel, base + 70000);
+        EXPECT_EQ(order, (std::vector{ 1, 2, 3 }));
+    }
+
+    TEST(TimingWheel, EventIsNeverEarly)
+    {
+        const ticks_t base = g_clock.millis();
+        std::vector<int> order;
+        TimingWheel wheel;
+
+        constexpr int delays[] = { 1, 255, 256, 257, 65535, 65536, 65537, 200000 };
+        for (const int delay : delays)
+            wheel.insert(makeEvent(order, delay, delay));
+
+        for (ticks_t now = base; now <= base + 200000; ++now) {
+            run(wheel, now);
+            if (!order.empty()) {
+                EXPECT_EQ(order.back(), now - base);
+                order.clear();
+            }
+        }
+        EXPECT_EQ(wheel.size(), 0u);
+    }
+
+    TEST(TimingWheel, CycleEventsAreReinserted)
+    {
+        const ticks_t base = g_clock.millis();
+        std::vector<int> order;
+        TimingWheel wheel;
+
+        wheel.insert(makeEvent(order, 1, 100, 3));
+        for (ticks_t now = base; now <= base + 1000; now += 10)
+            run(wheel, now);
+
+        EXPECT_EQ(order, (std::vector{ 1, 1, 1 }));
+        EXPECT_EQ(wheel.size(), 0u);
+    }
+
+    TEST(TimingWheel, PostponeRelinksEvent)
+    {
+        const ticks_t base = g_clock.millis();
+        std::vector<int> order;
+        TimingWheel wheel;
+
+        const auto event = makeEvent(order, 1, 100);
+        wheel.insert(event);
+
+        run(wheel, base + 50);
+        event->postpone();
+
+        // postpone counts from the frozen clock, the due time stays base + 100
+        run(wheel, base + 99);
+        EXPECT_TRUE(order.empty());
+        run(wheel, base + 100);
+        EXPECT_EQ(order, (std::vector{ 1 }));
+    }
+
+    TEST(TimingWheel, ClearReleasesEvents)
+    {
+        std::vector<int> order;
+        TimingWheel wheel;
+
+        const auto event = makeEvent(order, 1, 100000);
+        wheel.insert(event);
+        wheel.clear();
+
+        EXPECT_EQ(wheel.size(), 0u);
+        EXPECT_EQ(event.use_count(), 1);
+        EXPECT_FALSE(wheel.remove(event.get()));
+    }
+
+    TEST(TimingWheel, ClearRestartsFromTheClock)
+    {
+        const ticks_t base = g_clock.millis();
+        std::vector<int> order;
+        TimingWheel wheel;
+
+        wheel.insert(makeEvent(order, 1, 10));
+        run(wheel, base + 1000);
+        wheel.clear();
+
+        // as after a dispatcher shutdown and init, the wheel must not count from where it stopped
+        wheel.insert(makeEvent(order, 2, 10));
+        run(wheel, base + 5);
+        EXPECT_EQ(order, (std::vector{ 1 }));
+        run(wheel, base + 10);
+        EXPECT_EQ(order, (std::vector{ 1, 2 }));
+    }
+
+    TEST(TimingWheel, EventsOutliveTheirWheel)
+    {
+        std::vector<int> order;
+        auto wheel = std::make_unique<TimingWheel>();
+
+        const auto waiting = makeEvent(order, 1, 100000);
+        const auto expired = makeEvent(order, 2, 0);
+        wheel->insert(waiting);
+        wheel->insert(expired);
+        run(*wheel, g_clock.millis());
+        wheel.reset();
+
+        // a script may still hold them and cancel or postpone them later
+        waiting->postpone();
+        waiting->cancel();
+        expired->cancel();
+        EXPECT_EQ(order, (std::vector{ 2 }));
+    }
+}
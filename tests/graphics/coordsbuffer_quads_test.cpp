@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "framework/graphics/coordsbuffer.h"
+
+TEST(CoordsBufferQuads, RectsWriteFourCornersEach)
+{
+    CoordsBuffer buffer;
+    buffer.addRect(Rect(0, 0, 32, 32), Rect(64, 0, 32, 32));
+    buffer.addRect(Rect(32, 0, 16, 16), Rect(0, 0, 16, 16));
+    buffer.addColor(Color::red);
+
+    ASSERT_TRUE(buffer.isQuadList());
+    ASSERT_EQ(buffer.getQuadCount(), 2);
+
+    std::vector<QuadVertex> quads;
+    buffer.writeQuads(quads);
+    ASSERT_EQ(quads.size(), 8u);
+
+    // top left, top right, bottom left, bottom right
+    EXPECT_EQ(quads[0].x, 0.f);
+    EXPECT_EQ(quads[0].y, 0.f);
+    EXPECT_EQ(quads[1].x, 32.f);
+    EXPECT_EQ(quads[2].y, 32.f);
+    EXPECT_EQ(quads[3].x, 32.f);
+    EXPECT_EQ(quads[3].y, 32.f);
+    EXPECT_EQ(quads[0].u, 64.f);
+    EXPECT_EQ(quads[3].u, 96.f);
+
+    EXPECT_EQ(quads[4].x, 32.f);
+    EXPECT_EQ(quads[7].x, 48.f);
+    EXPECT_EQ(quads[7].v, 16.f);
+    EXPECT_EQ(quads[7].color, Color::red.rgba());
+}
+
+TEST(CoordsBufferQuads, UncoloredCornersAreWhite)
+{
+    CoordsBuffer buffer;
+    buffer.addRect(Rect(0, 0, 32, 32));
+
+    ASSERT_TRUE(buffer.isQuadList());
+
+    std::vector<QuadVertex> quads;
+    buffer.writeQuads(quads);
+    ASSERT_EQ(quads.size(), 4u);
+    EXPECT_EQ(quads[2].color, Color::white.rgba());
+}
+
+TEST(CoordsBufferQuads, TrianglesLeaveTheQuadPath)
+{
+    CoordsBuffer quads;
+    quads.addRect(Rect(0, 0, 32, 32));
+
+    CoordsBuffer triangles;
+    triangles.addTriangle(Point(0, 0), Point(10, 0), Point(0, 10));
+    EXPECT_FALSE(triangles.isQuadList());
+
+    quads.append(&triangles);
+    EXPECT_FALSE(quads.isQuadList());
+
+    quads.clear();
+    quads.addRect(Rect(0, 0, 32, 32));
+    EXPECT_TRUE(quads.isQuadList());
+}
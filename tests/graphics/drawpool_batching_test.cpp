@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "framework/graphics/drawpool.h"
+#include "framework/graphics/coordsbuffer.h"
+#undef protected
+#undef private
+
+#include "framework/util/stats.h"
+
+namespace {
+
+// a pool without framebuffer or atlas, nothing in it needs a GL context
+class DrawPoolBatching : public ::testing::Test
+{
+protected:
+    void SetUp() override { pool.resetState(); }
+
+    const std::vector<DrawPool::DrawObject>& objects() const { return pool.m_objects[DrawOrder::FIRST]; }
+
+    void addFilledRect(const Rect& dest, const Color& color)
+    {
+        pool.add(color, nullptr, DrawPool::DrawMethod{ .type = DrawPool::DrawMethodType::RECT, .dest = dest });
+    }
+
+    DrawPool pool;
+};
+
+} // namespace
+
+TEST(CoordsBufferColors, ColorsOnlyTheNewVertices)
+{
+    CoordsBuffer buffer;
+    buffer.addRect(Rect(0, 0, 32, 32));
+    buffer.addColor(Color::red);
+    buffer.addRect(Rect(32, 0, 32, 32));
+    buffer.addColor(Color::red);
+    buffer.addRect(Rect(64, 0, 32, 32));
+    buffer.addColor(Color::blue);
+
+    ASSERT_TRUE(buffer.hasColors());
+    EXPECT_EQ(buffer.getVertexCount(), 18);
+    EXPECT_EQ(buffer.getColorArray()[0], Color::red.rgba());
+    EXPECT_EQ(buffer.getColorArray()[11], Color::red.rgba());
+    EXPECT_EQ(buffer.getColorArray()[12], Color::blue.rgba());
+    EXPECT_EQ(buffer.getColorRuns(), 2);
+}
+
+TEST(CoordsBufferColors, AppendKeepsColorsAligned)
+{
+    CoordsBuffer plain;
+    plain.addRect(Rect(0, 0, 32, 32));
+
+    CoordsBuffer colored;
+    colored.addRect(Rect(0, 0, 32, 32));
+    colored.addColor(Color::green);
+
+    // the uncolored vertices read as white once colors show up
+    plain.append(&colored);
+    ASSERT_TRUE(plain.hasColors());
+    EXPECT_EQ(plain.getColorArray()[0], Color::white.rgba());
+    EXPECT_EQ(plain.getColorArray()[6], Color::green.rgba());
+    EXPECT_EQ(plain.getColorRuns(), 2);
+
+    plain.clear();
+    EXPECT_FALSE(plain.hasColors());
+    EXPECT_EQ(plain.getColorRuns(), 1);
+}
+
+TEST_F(DrawPoolBatching, ColorsShareOneDraw)
+{
+    addFilledRect(Rect(0, 0, 32, 32), Color::red);
+    addFilledRect(Rect(32, 0, 32, 32), Color::green);
+    addFilledRect(Rect(64, 0, 32, 32), Color::red);
+
+    ASSERT_EQ(objects().size(), 1u);
+
+    const auto& draw = objects().front();
+    EXPECT_EQ(pool.m_frame.states[draw.state].color, Color::white);
+    EXPECT_EQ(draw.coords->getVertexCount(), 18);
+    EXPECT_EQ(draw.coords->getColorArray()[6], Color::green.rgba());
+    EXPECT_EQ(draw.coords->getColorRuns(), 3);
+}
+
+TEST_F(DrawPoolBatching, StatesAreInternedPerFrame)
+{
+    addFilledRect(Rect(0, 0, 32, 32), Color::red);
+    pool.setOpacity(0.5f);
+    addFilledRect(Rect(32, 0, 32, 32), Color::red);
+    pool.resetOpacity();
+    addFilledRect(Rect(64, 0, 32, 32), Color::red);
+
+    ASSERT_EQ(objects().size(), 3u);
+    EXPECT_EQ(pool.m_frame.states.size(), 2u);
+    EXPECT_EQ(objects()[0].state, objects()[2].state);
+    EXPECT_NE(objects()[0].coords, objects()[2].coords);
+}
+
+TEST_F(DrawPoolBatching, WarmFramesBuildWithoutAllocating)
+{
+    const auto& buildFrame = [this] {
+        pool.resetState();
+        addFilledRect(Rect(0, 0, 32, 32), Color::red);
+        pool.setOpacity(0.5f);
+        addFilledRect(Rect(32, 0, 32, 32), Color::green);
+        pool.resetOpacity();
+        pool.addAction([] {});
+        pool.release();
+    };
+
+    // the frame being built and the last released one trade buffers, both are warm after two frames
+    buildFrame();
+    buildFrame();
+
+    const auto allocations = g_stats.getDrawAllocations();
+    for (int i = 0; i < 10; ++i)
+        buildFrame();
+
+    EXPECT_EQ(g_stats.getDrawAllocations(), allocations);
+    EXPECT_EQ(pool.m_framesDraw[0].objects.size(), 3u);
+    EXPECT_EQ(pool.m_framesDraw[0].states.size(), 2u);
+}
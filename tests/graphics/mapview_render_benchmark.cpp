@@ -0,0 +1,197 @@
+// Renders a synthetic map scene through MapView and the draw pools into the recording painter, once with the
+// camera standing still, where the repaint is skipped, and once with the camera walking, where every frame is
+// built again. Reports draw calls, vertices, texture uploads and draw pool allocations per frame, and the time to
+// build a frame.
+//
+// usage: otclient_mapview_render_benchmark
+
+#define private public
+#define protected public
+#include "client/mapview.h"
+
+#include "client/gameconfig.h"
+#include "client/item.h"
+#include "client/map.h"
+#include "client/minimap.h"
+#include "client/thingtype.h"
+#include "client/thingtypemanager.h"
+#include "client/tile.h"
+#include "framework/graphics/drawpoolmanager.h"
+#include "framework/graphics/image.h"
+#include "framework/graphics/recordingpainter.h"
+#include "framework/graphics/texture.h"
+#include "framework/util/stats.h"
+
+#undef protected
+#undef private
+
+#include "synthetic_items.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using CommandType = RecordingPainter::CommandType;
+
+    constexpr int FRAMES = 500;
+    constexpr int WORLD_SIZE = 128;
+    constexpr uint16_t GROUND_TYPES = 4;
+    constexpr uint16_t ITEM_TYPES = 60;
+    const Position ORIGIN(32000, 32000, 7);
+
+    struct FrameStats
+    {
+        uint64_t draws{ 0 };
+        uint64_t unbatchedDraws{ 0 };
+        uint64_t vertices{ 0 };
+        uint64_t uploads{ 0 };
+        uint64_t allocations{ 0 };
+        double ms{ 0 };
+    };
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    RecordingPainter& painter() { return static_cast<RecordingPainter&>(*g_painter); }
+
+    void addItem(const uint16_t id, const Position& pos)
+    {
+        const auto item = std::make_shared<Item>();
+        item->m_clientId = id;
+        g_map.addThing(item, pos, -1);
+    }
+
+    // grounds in patches, a third of the tiles with an item on them
+    void buildWorld()
+    {
+        std::mt19937 rng(1337);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<int> itemId(1 + GROUND_TYPES, GROUND_TYPES + ITEM_TYPES);
+
+        for (int y = 0; y < WORLD_SIZE; ++y) {
+            for (int x = 0; x < WORLD_SIZE; ++x) {
+                const auto& pos = ORIGIN.translated(x, y);
+                addItem(1 + (x / 8 + y / 8) % GROUND_TYPES, pos);
+                if (percent(rng) < 33)
+                    addItem(itemId(rng), pos);
+            }
+        }
+    }
+
+    FrameStats renderFrame(const MapViewPtr& mapView)
+    {
+        const auto start = Clock::now();
+        const auto allocations = g_stats.getDrawAllocations();
+
+        // off the window corner, the mouse of a window that never opened stays out of the view
+        mapView->updateRect(Rect(Point(32, 32), mapView->m_visibleDimension * g_gameConfig.getSpriteSize()));
+        mapView->preLoad();
+
+        g_drawPool.preDraw(DrawPoolType::MAP, [&] {
+            mapView->drawFloor();
+        }, [&] {
+            mapView->registerEvents();
+        }, mapView->m_posInfo.rect, mapView->m_posInfo.srcRect, Color::black);
+
+        painter().clearCommands();
+        g_drawPool.draw();
+
+        return {
+            .draws = painter().count(CommandType::DRAW),
+            .unbatchedDraws = g_painter->getUnbatchedDrawCalls(),
+            .vertices = painter().getDrawnVertexCount(),
+            .uploads = painter().count(CommandType::UPLOAD_TEXTURE),
+            .allocations = g_stats.getDrawAllocations() - allocations,
+            .ms = elapsedMs(start)
+        };
+    }
+
+    FrameStats run(const MapViewPtr& mapView, const bool walk)
+    {
+        FrameStats total;
+        Position camera = mapView->getCameraPosition();
+        for (int i = 0; i < FRAMES; ++i) {
+            if (walk) {
+                camera.x = ORIGIN.x + 20 + i % (WORLD_SIZE - 40);
+                mapView->setCameraPosition(camera);
+            }
+
+            const auto frame = renderFrame(mapView);
+            total.draws += frame.draws;
+            total.unbatchedDraws += frame.unbatchedDraws;
+            total.vertices += frame.vertices;
+            total.uploads += frame.uploads;
+            total.allocations += frame.allocations;
+            total.ms += frame.ms;
+        }
+        return total;
+    }
+
+    void report(const char* name, const FrameStats& total)
+    {
+        std::printf("  %-9s %7.1f draws (%7.1f without batching), %9.1f vertices, %6.2f uploads, %6.2f allocations, %7.3f ms per frame\n",
+                    name, static_cast<double>(total.draws) / FRAMES, static_cast<double>(total.unbatchedDraws) / FRAMES,
+                    static_cast<double>(total.vertices) / FRAMES, static_cast<double>(total.uploads) / FRAMES,
+                    static_cast<double>(total.allocations) / FRAMES, total.ms / FRAMES);
+    }
+}
+
+int main()
+{
+    g_minimap.init();
+    g_map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    g_map.m_awareRange = { .left = 8, .top = 6, .right = 9, .bottom = 7 };
+
+    for (uint16_t id = 1; id <= GROUND_TYPES; ++id)
+        registerItemType(id, ThingFlagAttrGround);
+    for (uint16_t id = 1 + GROUND_TYPES; id <= GROUND_TYPES + ITEM_TYPES; ++id)
+        registerItemType(id, 0);
+
+    buildWorld();
+
+    g_painter = std::make_unique<RecordingPainter>();
+    g_drawPool.init(g_gameConfig.getSpriteSize());
+
+    const auto mapView = std::make_shared<MapView>();
+    mapView->setFloorFading(0);
+    mapView->setCameraPosition(ORIGIN.translated(20, WORLD_SIZE / 2));
+    mapView->m_pool->getFrameBuffer()->resize(mapView->m_rectDimension.size());
+    g_map.addMapView(mapView);
+
+    // uploads every texture in view, kept out of the averages
+    const auto warmup = renderFrame(mapView);
+    // the next frame is built while the first waits to be drawn, into a second set of pool buffers
+    renderFrame(mapView);
+    const auto still = run(mapView, false);
+    const auto walking = run(mapView, true);
+
+    std::printf("map view: %dx%d tiles in view, %d ground and %d item types, %d frames\n", mapView->m_visibleDimension.width(),
+                mapView->m_visibleDimension.height(), GROUND_TYPES, ITEM_TYPES, FRAMES);
+    std::printf("  first     %7llu draws (%7llu without batching), %9llu vertices, %6llu uploads, %6llu allocations, %7.3f ms\n",
+                static_cast<unsigned long long>(warmup.draws), static_cast<unsigned long long>(warmup.unbatchedDraws),
+                static_cast<unsigned long long>(warmup.vertices), static_cast<unsigned long long>(warmup.uploads),
+                static_cast<unsigned long long>(warmup.allocations), warmup.ms);
+    report("still", still);
+    report("walking", walking);
+
+    g_map.removeMapView(mapView);
+
+    // a still camera only composes the last frame again
+    if (still.draws != FRAMES || walking.draws <= still.draws) {
+        std::printf("mismatch: the repaint of an unchanged frame was not skipped\n");
+        return 1;
+    }
+
+    // the pool buffers are warm after the first frames, an unchanged scene builds into them without growing them
+    if (still.allocations != 0) {
+        std::printf("mismatch: building an unchanged frame allocated\n");
+        return 1;
+    }
+
+    return 0;
+}
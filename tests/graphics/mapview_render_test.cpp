@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "client/mapview.h"
+
+#include "client/gameconfig.h"
+#include "client/item.h"
+#include "client/map.h"
+#include "client/minimap.h"
+#include "client/thingtype.h"
+#include "client/thingtypemanager.h"
+#include "client/tile.h"
+#include "framework/graphics/drawpoolmanager.h"
+#include "framework/graphics/image.h"
+#include "framework/graphics/recordingpainter.h"
+#include "framework/graphics/texture.h"
+
+#undef protected
+#undef private
+
+#include "synthetic_items.h"
+
+namespace {
+
+using CommandType = RecordingPainter::CommandType;
+
+constexpr uint16_t GROUND_ID = 1;
+constexpr uint16_t FIRST_ITEM_ID = 2;
+constexpr uint16_t ITEM_TYPES = 3;
+
+ItemPtr createItem(const uint16_t id)
+{
+    const auto item = std::make_shared<Item>();
+    item->m_clientId = id;
+    return item;
+}
+
+RecordingPainter& painter() { return static_cast<RecordingPainter&>(*g_painter); }
+
+class MapViewRender : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        g_minimap.init();
+
+        // no GL context, the pools flush into the recorder
+        g_painter = std::make_unique<RecordingPainter>();
+        g_drawPool.init(g_gameConfig.getSpriteSize());
+    }
+
+    static void TearDownTestSuite()
+    {
+        g_drawPool.terminate();
+        g_painter = nullptr;
+        g_minimap.clean();
+    }
+
+    void SetUp() override
+    {
+        // fresh textures, so every test sees its own uploads
+        registerItemType(GROUND_ID, ThingFlagAttrGround);
+        for (uint16_t id = FIRST_ITEM_ID; id < FIRST_ITEM_ID + ITEM_TYPES; ++id)
+            registerItemType(id, 0);
+
+        g_map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+        g_map.m_awareRange = { .left = 8, .top = 6, .right = 9, .bottom = 7 };
+        g_map.m_centralPosition = center;
+
+        mapView = std::make_shared<MapView>();
+        mapView->setFloorFading(0);
+        mapView->setCameraPosition(center);
+        g_map.addMapView(mapView);
+
+        // MapView::updateGeometry leaves the resize to the next frame on the main dispatcher
+        mapView->m_pool->getFrameBuffer()->resize(mapView->m_rectDimension.size());
+    }
+
+    void TearDown() override
+    {
+        g_map.removeMapView(mapView);
+        mapView = nullptr;
+        g_map.m_floors.clear();
+    }
+
+    // grounds over the whole aware range, every other tile with an item of one of the first itemTypes types on it
+    void buildScene(const int itemTypes) const
+    {
+        const auto& range = g_map.getAwareRange();
+        for (int y = -range.top; y <= range.bottom; ++y) {
+            for (int x = -range.left; x <= range.right; ++x) {
+                const auto& pos = center.translated(x, y);
+                g_map.addThing(createItem(GROUND_ID), pos, -1);
+                if (itemTypes > 0 && (x + y) % 2 == 0)
+                    g_map.addThing(createItem(FIRST_ITEM_ID + std::abs(x) % itemTypes), pos, -1);
+            }
+        }
+    }
+
+    // what UIMap::draw and the frame loop do for the map pane
+    void renderFrame() const
+    {
+        // off the window corner, the mouse of a window that never opened stays out of the view
+        mapView->updateRect(Rect(Point(32, 32), mapView->m_visibleDimension * g_gameConfig.getSpriteSize()));
+        mapView->preLoad();
+
+        g_drawPool.preDraw(DrawPoolType::MAP, [this] {
+            mapView->drawFloor();
+        }, [this] {
+            mapView->registerEvents();
+        }, mapView->m_posInfo.rect, mapView->m_posInfo.srcRect, Color::black);
+
+        painter().clearCommands();
+        g_drawPool.draw();
+    }
+
+    // the draws of the map pool itself, without the framebuffer clear and composition strips
+    static std::vector<RecordingPainter::Command> batches()
+    {
+        std::vector<RecordingPainter::Command> draws;
+        for (const auto& command : painter().getCommands()) {
+            if (command.type == CommandType::DRAW && command.value == static_cast<uint32_t>(DrawMode::TRIANGLES))
+                draws.emplace_back(command);
+        }
+        return draws;
+    }
+
+    MapViewPtr mapView;
+    const Position center{ 32369, 32241, 7 };
+};
+
+} // namespace
+
+TEST_F(MapViewRender, GroundsAreOneBatch)
+{
+    buildScene(0);
+    renderFrame();
+
+    const auto draws = batches();
+    ASSERT_EQ(draws.size(), 1u);
+    EXPECT_NE(draws.front().textureId, 0u);
+    EXPECT_GE(draws.front().vertexCount, 6u * mapView->m_visibleDimension.area());
+    EXPECT_EQ(painter().count(CommandType::UPLOAD_TEXTURE), 1u);
+
+    // the map framebuffer is composed onto the screen without blending
+    EXPECT_EQ(painter().count(CommandType::BLENDING), 2u);
+}
+
+TEST_F(MapViewRender, ItemsBatchPerTextureAboveTheGrounds)
+{
+    buildScene(1);
+    renderFrame();
+
+    // grounds and items go to their own draw orders, so they do not break each other's batch
+    const auto draws = batches();
+    ASSERT_EQ(draws.size(), 2u);
+    EXPECT_NE(draws[0].textureId, draws[1].textureId);
+    EXPECT_GT(draws[0].vertexCount, draws[1].vertexCount);
+    EXPECT_EQ(painter().count(CommandType::UPLOAD_TEXTURE), 2u);
+}
+
+TEST_F(MapViewRender, TexturesAreUploadedOnce)
+{
+    buildScene(ITEM_TYPES);
+    renderFrame();
+
+    EXPECT_EQ(painter().count(CommandType::UPLOAD_TEXTURE), 1u + ITEM_TYPES);
+    for (const auto& command : painter().getCommands()) {
+        if (command.type == CommandType::UPLOAD_TEXTURE)
+            EXPECT_EQ(command.value, static_cast<uint32_t>(g_gameConfig.getSpriteSize() * g_gameConfig.getSpriteSize() * 4));
+    }
+
+    // a new item on screen forces a repaint, its texture is the only one left to upload
+    g_map.addThing(createItem(FIRST_ITEM_ID), center.translated(1, 0), -1);
+    renderFrame();
+
+    EXPECT_GT(batches().size(), 0u);
+    EXPECT_EQ(painter().count(CommandType::UPLOAD_TEXTURE), 0u);
+}
+
+TEST_F(MapViewRender, UnchangedSceneSkipsTheRepaint)
+{
+    buildScene(ITEM_TYPES);
+    renderFrame();
+    const auto firstFrame = batches();
+    ASSERT_GT(firstFrame.size(), 1u);
+
+    // same hashes, the framebuffer from the last frame is only composed again
+    renderFrame();
+    EXPECT_TRUE(batches().empty());
+    EXPECT_EQ(painter().count(CommandType::DRAW), 1u);
+    EXPECT_EQ(painter().count(CommandType::UPLOAD_TEXTURE), 0u);
+
+    g_map.addThing(createItem(FIRST_ITEM_ID), center.translated(1, 0), -1);
+    renderFrame();
+    EXPECT_FALSE(batches().empty());
+}
+
+TEST_F(MapViewRender, FilledTilesShareABatchWhateverTheirColor)
+{
+    const Color colors[] = { Color::red, Color::green, Color::blue };
+    for (int i = 0; i < 9; ++i) {
+        const auto& pos = center.translated(i - 4, 0);
+        g_map.addThing(createItem(GROUND_ID), pos, -1);
+        g_map.getTile(pos)->setFill(colors[i % 3]);
+    }
+
+    renderFrame();
+
+    const auto draws = batches();
+    ASSERT_EQ(draws.size(), 1u);
+    EXPECT_EQ(draws.front().textureId, 0u);
+    EXPECT_EQ(draws.front().vertexCount, 9u * 6);
+
+    // each color change would have been a draw call of its own
+    EXPECT_EQ(g_painter->getUnbatchedDrawCalls(), painter().count(CommandType::DRAW) + 8);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// Item types for the map view tests and benchmarks, drawn without loading any assets. The thing type internals
+// are filled in directly, so the client headers are opened up here the same way the including files do.
+
+#define private public
+#define protected public
+#include "client/gameconfig.h"
+#include "client/thingtype.h"
+#include "client/thingtypemanager.h"
+#include "framework/graphics/image.h"
+#include "framework/graphics/texture.h"
+#undef protected
+#undef private
+
+// a one sprite item type with its texture already composed
+inline void registerItemType(const uint16_t id, const uint32_t flags)
+{
+    auto& items = g_things.m_thingTypes[ThingCategoryItem];
+    if (items.size() <= id)
+        items.resize(id + 1);
+
+    const int spriteSize = g_gameConfig.getSpriteSize();
+    const Rect frame(0, 0, spriteSize, spriteSize);
+
+    const auto type = std::make_shared<ThingType>();
+    type->m_null = false;
+    type->m_id = id;
+    type->m_category = ThingCategoryItem;
+    type->m_flags = flags;
+    type->m_size = Size(1, 1);
+    type->m_realSize = spriteSize;
+    type->m_layers = 1;
+    type->m_numPatternX = type->m_numPatternY = type->m_numPatternZ = 1;
+    type->m_animationPhases = 1;
+    type->m_opacity = 1.f;
+    type->m_opaque = 1;
+
+    auto& textureData = type->m_textureData.emplace_back();
+    textureData.source = std::make_shared<Texture>(std::make_shared<Image>(frame.size()), false, false);
+    textureData.source->allowAtlasCache();
+    textureData.pos.push_back({ .rects = frame, .originRects = frame, .offsets = Point() });
+    textureData.boundsRevision = g_things.getThingBoundsRevision();
+
+    items[id] = type;
+}
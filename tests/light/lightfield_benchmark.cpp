@@ -0,0 +1,182 @@
+// Fills a map sized light field with synthetic torches and creature lights and compares the
+// binned LightField update against the former every-tile-against-every-light loop, for a full
+// recompute and for a frame where a single light moved.
+//
+// usage: otclient_light_field_benchmark [lights]
+
+#include <client/lightfield.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int TILE_SIZE = 32;
+    constexpr int RUNS = 200;
+    const Size MAP_SIZE(34, 26);
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct SyntheticLight
+    {
+        Point pos;
+        Light light;
+    };
+
+    struct SyntheticField
+    {
+        std::vector<SyntheticLight> lights;
+        std::vector<std::pair<Point, size_t>> shades; // shaded before the light at that index was added
+    };
+
+    SyntheticField makeField(const size_t count)
+    {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> x(0, MAP_SIZE.width() * TILE_SIZE - 1);
+        std::uniform_int_distribution<int> y(0, MAP_SIZE.height() * TILE_SIZE - 1);
+        std::uniform_int_distribution<int> intensity(1, 7);
+        std::uniform_int_distribution<int> color(1, 215);
+        std::uniform_int_distribution<int> shade(0, 3);
+
+        SyntheticField field;
+        for (size_t i = 0; i < count; ++i) {
+            field.lights.push_back({ Point(x(rng), y(rng)), Light(intensity(rng), color(rng)) });
+            if (shade(rng) == 0)
+                field.shades.emplace_back(Point(x(rng), y(rng)), i);
+        }
+        return field;
+    }
+
+    void fill(LightField& lightField, const SyntheticField& field)
+    {
+        lightField.clear();
+        size_t shade = 0;
+        for (size_t i = 0; i < field.lights.size(); ++i) {
+            for (; shade < field.shades.size() && field.shades[shade].second == i; ++shade)
+                lightField.resetShade(field.shades[shade].first);
+            lightField.addLight(field.lights[i].pos, field.lights[i].light, 1.f);
+        }
+    }
+
+    // LightView::updatePixels as it was before
+    void updateLegacy(const SyntheticField& field, const Color& globalLight, uint8_t* pixelData)
+    {
+        std::vector<size_t> tiles(MAP_SIZE.area(), 0);
+        size_t shade = 0;
+        for (size_t i = 0; i <= field.lights.size(); ++i) {
+            for (; shade < field.shades.size() && field.shades[shade].second == i; ++shade) {
+                const auto& pos = field.shades[shade].first;
+                tiles[(pos.y / TILE_SIZE) * MAP_SIZE.width() + (pos.x / TILE_SIZE)] = i;
+            }
+        }
+
+        const auto lightSize = field.lights.size();
+        const auto tileCenterOffset = TILE_SIZE / 2;
+        const auto invTileSize = 1.0f / TILE_SIZE;
+
+        for (int y = 0; y < MAP_SIZE.height(); ++y) {
+            for (int x = 0; x < MAP_SIZE.width(); ++x) {
+                const auto centerX = x * TILE_SIZE + tileCenterOffset;
+                const auto centerY = y * TILE_SIZE + tileCenterOffset;
+                const auto index = y * MAP_SIZE.width() + x;
+
+                auto r = globalLight.r();
+                auto g = globalLight.g();
+                auto b = globalLight.b();
+
+                for (auto i = tiles[index]; i < lightSize; ++i) {
+                    const auto& light = field.lights[i];
+
+                    const auto dx = centerX - light.pos.x;
+                    const auto dy = centerY - light.pos.y;
+                    const auto distanceSq = dx * dx + dy * dy;
+
+                    const auto lightRadiusSq = (light.light.intensity * TILE_SIZE) * (light.light.intensity * TILE_SIZE);
+                    if (distanceSq > lightRadiusSq) continue;
+
+                    const auto distanceNorm = std::sqrt(distanceSq) * invTileSize;
+                    float intensity = (-distanceNorm + light.light.intensity) * 0.2f;
+                    if (intensity < 0.01f) continue;
+
+                    intensity = std::min<float>(intensity, 1.0f);
+
+                    const auto& lightColor = Color::from8bit(light.light.color) * intensity;
+
+                    r = std::max<int>(r, lightColor.r());
+                    g = std::max<int>(g, lightColor.g());
+                    b = std::max<int>(b, lightColor.b());
+                }
+
+                const auto colorIndex = index * 4;
+                pixelData[colorIndex] = r;
+                pixelData[colorIndex + 1] = g;
+                pixelData[colorIndex + 2] = b;
+                pixelData[colorIndex + 3] = 255;
+            }
+        }
+    }
+
+    // the legacy loop takes the square root in double precision, allow one step of rounding
+    size_t countMismatches(const std::vector<uint8_t>& lhs, const std::vector<uint8_t>& rhs)
+    {
+        size_t mismatches = 0;
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            if (std::abs(lhs[i] - rhs[i]) > 1)
+                ++mismatches;
+        }
+        return mismatches;
+    }
+}
+
+int main(const int argc, const char* argv[])
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 300;
+    const Color globalLight = Color::from8bit(215, 40 / 255.f);
+
+    auto field = makeField(count);
+    std::vector<uint8_t> legacy(MAP_SIZE.area() * 4);
+    std::array<std::vector<uint8_t>, 2> pixels{ legacy, legacy };
+
+    LightField lightField;
+    lightField.resize(MAP_SIZE, TILE_SIZE);
+
+    auto start = Clock::now();
+    for (int i = 0; i < RUNS; ++i)
+        updateLegacy(field, globalLight, legacy.data());
+    const double legacyMs = elapsedMs(start) / RUNS;
+
+    fill(lightField, field);
+    start = Clock::now();
+    for (int i = 0; i < RUNS; ++i)
+        lightField.update(pixels[0].data(), nullptr, globalLight);
+    const double fullMs = elapsedMs(start) / RUNS;
+    const size_t fullMismatches = countMismatches(legacy, pixels[0]);
+
+    // a creature light walking one pixel per frame, everything else stays put
+    start = Clock::now();
+    for (int i = 0; i < RUNS; ++i) {
+        field.lights[count / 2].pos.x += i % 2 == 0 ? 1 : -1;
+        fill(lightField, field);
+        lightField.update(pixels[1].data(), pixels[0].data(), globalLight);
+        pixels[0].swap(pixels[1]);
+    }
+    const double partialMs = elapsedMs(start) / RUNS;
+    const size_t dirtyTiles = lightField.getLastDirtyTiles();
+
+    updateLegacy(field, globalLight, legacy.data());
+    const size_t partialMismatches = countMismatches(legacy, pixels[0]);
+
+    std::printf("%zu lights over %dx%d tiles\n", count, MAP_SIZE.width(), MAP_SIZE.height());
+    std::printf("legacy:        %8.3f ms\n", legacyMs);
+    std::printf("binned full:   %8.3f ms (%zu mismatching channels)\n", fullMs, fullMismatches);
+    std::printf("one light:     %8.3f ms (%zu dirty tiles, %zu mismatching channels)\n", partialMs, dirtyTiles, partialMismatches);
+    return fullMismatches == 0 && partialMismatches == 0 ? 0 : 1;
+}
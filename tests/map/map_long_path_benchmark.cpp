@@ -0,0 +1,134 @@
+// Routes across a whole explored floor, searched by Map::findPath over every tile and by the entrance
+// graph of PathFinder::findLongPath, cold, warm and after one tile of the route changed walkability.
+//
+// usage: otclient_map_long_path_benchmark
+
+#define private public
+#include "client/map.h"
+#include "client/minimap.h"
+#undef private
+
+#include "client/gameconfig.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RUNS = 20;
+    constexpr int WORLD_SIZE = 1024;
+    constexpr int WALL_SPACING = 40;
+    constexpr int LEGACY_COMPLEXITY = WORLD_SIZE * WORLD_SIZE;
+    constexpr int LONG_PATH_COMPLEXITY = 20000;
+    const Position ORIGIN(32000, 32000, 7);
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void setTile(const Position& pos, const bool walkable)
+    {
+        auto& block = g_minimap.getBlock(pos);
+        const auto& offset = g_minimap.getBlockOffset(Point(pos.x, pos.y));
+
+        MinimapTile tile;
+        tile.flags = MinimapTileWasSeen;
+        tile.color = 10;
+        if (!walkable)
+            tile.flags |= MinimapTileNotWalkable;
+
+        block.updateTile(pos.x - offset.x, pos.y - offset.y, tile);
+    }
+
+    // explored floor with long walls every WALL_SPACING columns, a gap every few rows, plus scattered obstacles
+    void buildWorld()
+    {
+        std::mt19937 rng(1337);
+        std::uniform_int_distribution<int> percent(0, 99);
+
+        for (int y = 0; y < WORLD_SIZE; ++y) {
+            for (int x = 0; x < WORLD_SIZE; ++x) {
+                const bool wall = x % WALL_SPACING == 0 && y % 24 > 2;
+                setTile(ORIGIN.translated(x, y), !wall && percent(rng) >= 8);
+            }
+        }
+    }
+
+    Position findWalkable(const int x, const int y)
+    {
+        for (int dx = 0; dx < WALL_SPACING; ++dx) {
+            const Position pos = ORIGIN.translated(x + dx, y);
+            if (!g_minimap.getTile(pos).hasFlag(MinimapTileNotWalkable))
+                return pos;
+        }
+        return ORIGIN.translated(x, y);
+    }
+}
+
+int main()
+{
+    g_minimap.init();
+    g_map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+
+    buildWorld();
+
+    const std::vector<std::pair<Position, Position>> routes{
+        { findWalkable(5, 10), findWalkable(600, 40) },
+        { findWalkable(10, 500), findWalkable(900, 700) },
+        { findWalkable(300, 900), findWalkable(320, 80) },
+        { findWalkable(800, 20), findWalkable(50, 980) },
+    };
+
+    PathFinder finder;
+
+    std::printf("long paths: %zu routes over a %dx%d explored floor, %d runs\n", routes.size(), WORLD_SIZE, WORLD_SIZE, RUNS);
+
+    bool mismatch = false;
+    double legacyMs = 0, coldMs = 0, warmMs = 0, changedMs = 0;
+    for (const auto& [from, to] : routes) {
+        auto start = Clock::now();
+        const auto [legacyPath, legacyResult] = g_map.findPath(from, to, LEGACY_COMPLEXITY);
+        const double routeLegacyMs = elapsedMs(start);
+
+        start = Clock::now();
+        const auto [coldPath, coldResult] = finder.findLongPath(from, to, LONG_PATH_COMPLEXITY);
+        const double routeColdMs = elapsedMs(start);
+
+        start = Clock::now();
+        for (int i = 0; i < RUNS; ++i)
+            finder.findLongPath(from, to, LONG_PATH_COMPLEXITY);
+        const double routeWarmMs = elapsedMs(start) / RUNS;
+
+        // a cell next to the route start turns into a wall and back, one block is rebuilt each time
+        double routeChangedMs = 0;
+        for (int i = 0; i < RUNS; ++i) {
+            setTile(from.translated(1, 1), i % 2 != 0);
+            start = Clock::now();
+            finder.findLongPath(from, to, LONG_PATH_COMPLEXITY);
+            routeChangedMs += elapsedMs(start);
+        }
+        routeChangedMs /= RUNS;
+
+        std::printf("  %5d,%5d -> %5d,%5d: findPath %9.3f ms (%zu steps), long path cold %8.3f ms, warm %7.3f ms, changed %7.3f ms (%zu steps)\n",
+                    from.x, from.y, to.x, to.y, routeLegacyMs, legacyPath.size(), routeColdMs, routeWarmMs, routeChangedMs, coldPath.size());
+
+        legacyMs += routeLegacyMs;
+        coldMs += routeColdMs;
+        warmMs += routeWarmMs;
+        changedMs += routeChangedMs;
+        mismatch |= legacyResult != coldResult;
+    }
+
+    std::printf("  total: findPath %9.3f ms, long path cold %8.3f ms, warm %7.3f ms, changed %7.3f ms\n", legacyMs, coldMs, warmMs, changedMs);
+
+    if (mismatch) {
+        std::printf("mismatch: the searches disagree on which routes exist\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#define private public
+#include "client/map.h"
+#include "client/minimap.h"
+#undef private
+
+#include "client/gameconfig.h"
+
+#include <framework/core/asyncdispatcher.h>
+#include <framework/core/eventdispatcher.h>
+
+namespace {
+
+constexpr int WORLD_SIZE = 256;
+constexpr int WALL_X = 100;
+constexpr int GAP_Y = 200;
+const Position ORIGIN(32000, 32000, 7);
+
+void setTile(const Position& pos, const bool walkable)
+{
+    MinimapTile tile;
+    tile.flags = MinimapTileWasSeen;
+    tile.color = 10;
+    if (!walkable)
+        tile.flags |= MinimapTileNotWalkable;
+
+    g_minimap.updateTile(pos, tile);
+}
+
+bool isWalkable(const Position& pos)
+{
+    const auto& tile = g_minimap.getTile(pos);
+    return tile.hasFlag(MinimapTileWasSeen) && !tile.hasFlag(MinimapTileNotWalkable);
+}
+
+// walks the path from start, every step has to land on a walkable cell
+Position walk(Position pos, const std::vector<Otc::Direction>& path)
+{
+    for (const auto dir : path) {
+        pos = pos.translatedToDirection(dir);
+        EXPECT_TRUE(isWalkable(pos)) << pos.x << "," << pos.y;
+    }
+    return pos;
+}
+
+class MapLongPath : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_minimap.init();
+
+        // a seen floor split by a wall with a single gap
+        for (int y = 0; y < WORLD_SIZE; ++y) {
+            for (int x = 0; x < WORLD_SIZE; ++x)
+                setTile(ORIGIN.translated(x, y), x != WALL_X || y == GAP_Y);
+        }
+    }
+
+    void TearDown() override { g_minimap.clean(); }
+
+    PathFinder finder;
+};
+
+} // namespace
+
+TEST_F(MapLongPath, StraightStepsAcrossOpenBlocks)
+{
+    const Position start = ORIGIN.translated(10, 10);
+    const Position goal = ORIGIN.translated(90, 150);
+
+    const auto& [path, result] = finder.findLongPath(start, goal, 10000);
+
+    ASSERT_EQ(result, Otc::PathFindResultOk);
+    EXPECT_EQ(walk(start, path), goal);
+    // diagonal steps cost more than two straight ones, the shortest walk has none
+    EXPECT_EQ(path.size(), 80u + 140u);
+}
+
+TEST_F(MapLongPath, RoutesThroughTheOnlyGap)
+{
+    const Position start = ORIGIN.translated(10, 10);
+    const Position goal = ORIGIN.translated(190, 20);
+
+    const auto& [path, result] = finder.findLongPath(start, goal, 10000);
+
+    ASSERT_EQ(result, Otc::PathFindResultOk);
+    EXPECT_EQ(walk(start, path), goal);
+
+    bool crossedGap = false;
+    Position pos = start;
+    for (const auto dir : path) {
+        pos = pos.translatedToDirection(dir);
+        crossedGap |= pos == ORIGIN.translated(WALL_X, GAP_Y);
+    }
+    EXPECT_TRUE(crossedGap);
+}
+
+TEST_F(MapLongPath, FollowsMinimapWalkabilityChanges)
+{
+    const Position start = ORIGIN.translated(10, 10);
+    const Position goal = ORIGIN.translated(190, 20);
+
+    ASSERT_EQ(std::get<1>(finder.findLongPath(start, goal, 10000)), Otc::PathFindResultOk);
+
+    setTile(ORIGIN.translated(WALL_X, GAP_Y), false);
+    EXPECT_EQ(std::get<1>(finder.findLongPath(start, goal, 10000)), Otc::PathFindResultNoWay);
+
+    setTile(ORIGIN.translated(WALL_X, 30), true);
+    const auto& [path, result] = finder.findLongPath(start, goal, 10000);
+    ASSERT_EQ(result, Otc::PathFindResultOk);
+    EXPECT_EQ(walk(start, path), goal);
+    EXPECT_LT(path.size(), 250u);
+}
+
+TEST_F(MapLongPath, RejectsUnreachableQueries)
+{
+    const Position start = ORIGIN.translated(10, 10);
+
+    EXPECT_EQ(std::get<1>(finder.findLongPath(start, start, 10000)), Otc::PathFindResultSamePosition);
+    EXPECT_EQ(std::get<1>(finder.findLongPath(start, ORIGIN.translated(20, 20, -1), 10000)), Otc::PathFindResultImpossible);
+    EXPECT_EQ(std::get<1>(finder.findLongPath(start, ORIGIN.translated(WALL_X, 10), 10000)), Otc::PathFindResultNoWay);
+    // never seen
+    EXPECT_EQ(std::get<1>(finder.findLongPath(start, ORIGIN.translated(WORLD_SIZE + 10, 10), 10000)), Otc::PathFindResultNoWay);
+    EXPECT_EQ(std::get<1>(finder.findLongPath(start, ORIGIN.translated(190, 20), 2)), Otc::PathFindResultTooFar);
+}
+
+class MapSnapshotPath : public MapLongPath
+{
+protected:
+    void SetUp() override
+    {
+        MapLongPath::SetUp();
+        g_map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    }
+
+    void TearDown() override
+    {
+        g_map.m_floors.clear();
+        MapLongPath::TearDown();
+    }
+};
+
+TEST_F(MapSnapshotPath, SearchesAreasTooLargeForTheDenseSlots)
+{
+    const Position start = ORIGIN.translated(10, 10);
+    const Position goal = ORIGIN.translated(90, 240);
+
+    const auto snapshot = finder.createSnapshot(start, goal);
+    ASSERT_NE(snapshot, nullptr);
+    ASSERT_GT(static_cast<size_t>(snapshot->getArea().width()) * snapshot->getArea().height(), 512u * 512u);
+
+    const auto result = PathFinder::findPath(*snapshot, start, goal);
+    ASSERT_EQ(result->status, Otc::PathFindResultOk);
+    EXPECT_EQ(walk(start, result->path), goal);
+}
+
+TEST_F(MapSnapshotPath, LeavesFarGoalsToTheLongPathSearch)
+{
+    const Position start = ORIGIN.translated(10, 10);
+    const Position far = start.translated((PathFinder::MAX_SNAPSHOT_SPAN + 1) * MMBLOCK_SIZE, 0);
+
+    EXPECT_FALSE(PathFinder::isInSnapshotRange(start, far));
+    EXPECT_EQ(finder.createSnapshot(start, far), nullptr);
+    EXPECT_TRUE(PathFinder::isInSnapshotRange(start, ORIGIN.translated(190, 20)));
+}
+
+class MapLongPathAsync : public MapLongPath
+{
+protected:
+    void SetUp() override
+    {
+        MapLongPath::SetUp();
+        g_dispatcher.init();
+    }
+
+    void TearDown() override
+    {
+        g_asyncDispatcher->wait();
+        g_dispatcher.shutdown();
+        g_map.m_pathFinder.clear();
+        MapLongPath::TearDown();
+    }
+};
+
+TEST_F(MapLongPathAsync, DeliversTheRouteThroughTheDispatcher)
+{
+    const Position start = ORIGIN.translated(10, 10);
+    const Position goal = ORIGIN.translated(190, 20);
+
+    PathFindResult_ptr result;
+    g_map.findLongPathAsync(start, goal, 10000, [&](const PathFindResult_ptr& ret) { result = ret; });
+
+    // searched on the pool, handed over on the next poll
+    g_asyncDispatcher->wait();
+    EXPECT_EQ(result, nullptr);
+    g_dispatcher.poll();
+
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->status, Otc::PathFindResultOk);
+    EXPECT_EQ(result->start, start);
+    EXPECT_EQ(result->destination, goal);
+    EXPECT_EQ(walk(start, result->path), goal);
+}
+
+TEST_F(MapLongPathAsync, MinimapChangesWhileTheSearchRuns)
+{
+    const Position start = ORIGIN.translated(10, 10);
+    const Position goal = ORIGIN.translated(190, 20);
+
+    PathFindResult_ptr result;
+    g_map.findLongPathAsync(start, goal, 10000, [&](const PathFindResult_ptr& ret) { result = ret; });
+
+    // recolour seen cells across the blocks the search packs until it is handed back, walkability stays
+    MinimapTile tile;
+    tile.flags = MinimapTileWasSeen;
+    for (int i = 0; !result; ++i) {
+        tile.color = static_cast<uint8_t>(i % 200);
+        for (int y = 0; y < WORLD_SIZE; y += 7) {
+            const int x = (i * 13 + y) % WORLD_SIZE;
+            if (x != WALL_X)
+                g_minimap.updateTile(ORIGIN.translated(x, y), tile);
+        }
+        g_dispatcher.poll();
+    }
+
+    ASSERT_EQ(result->status, Otc::PathFindResultOk);
+    EXPECT_EQ(walk(start, result->path), goal);
+}
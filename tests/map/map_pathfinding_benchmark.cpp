@@ -0,0 +1,219 @@
+// Autowalk paths over a minimap only floor, searched through the packed PathSnapshot and through
+// the node per allocation A* that read the live minimap from the pool thread before it.
+//
+// usage: otclient_map_pathfinding_benchmark
+
+#define private public
+#include "client/map.h"
+#include "client/minimap.h"
+#undef private
+
+#include "client/gameconfig.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RUNS = 5;
+    constexpr int WORLD_SIZE = 1024;
+    const Position ORIGIN(32000, 32000, 7);
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // explored floor with mixed ground speeds and scattered obstacles
+    void buildWorld()
+    {
+        std::mt19937 rng(1337);
+        std::uniform_int_distribution<int> percent(0, 99);
+
+        for (int y = 0; y < WORLD_SIZE; ++y) {
+            for (int x = 0; x < WORLD_SIZE; ++x) {
+                const Position pos = ORIGIN.translated(x, y);
+                auto& block = g_minimap.getBlock(pos);
+                const auto& offset = g_minimap.getBlockOffset(Point(pos.x, pos.y));
+
+                MinimapTile tile;
+                tile.flags = MinimapTileWasSeen;
+                tile.color = 10;
+                tile.speed = 10 + percent(rng) % 3 * 5;
+
+                if (percent(rng) < 8)
+                    tile.flags |= MinimapTileNotWalkable;
+
+                block.updateTile(pos.x - offset.x, pos.y - offset.y, tile);
+            }
+        }
+    }
+
+    struct LessNode
+    {
+        bool operator()(const Node* a, const Node* b) const { return b->totalCost < a->totalCost; }
+    };
+
+    // the search findPathAsync ran before the snapshots, without the on screen tiles
+    PathFindResult_ptr findPathLegacy(const Position& start, const Position& goal)
+    {
+        auto ret = std::make_shared<PathFindResult>();
+        ret->start = start;
+        ret->destination = goal;
+
+        stdext::map<Position, Node*, Position::Hasher> nodes;
+        std::priority_queue<Node*, std::vector<Node*>, LessNode> searchList;
+
+        const auto& initNode = new Node{ .cost = 1, .totalCost = 0, .pos = start, .prev = nullptr, .distance = 0, .unseen = 0 };
+        nodes[start] = initNode;
+        searchList.push(initNode);
+
+        int limit = 50000;
+        const float distance = start.distance(goal);
+
+        const Node* dstNode = nullptr;
+        while (!searchList.empty() && --limit) {
+            Node* node = searchList.top();
+            searchList.pop();
+            if (node->pos == goal) {
+                dstNode = node;
+                break;
+            }
+            if (node->pos.distance(goal) > distance + 10000)
+                continue;
+            for (int i = -1; i <= 1; ++i) {
+                for (int j = -1; j <= 1; ++j) {
+                    if (i == 0 && j == 0)
+                        continue;
+                    Position neighbor = node->pos.translated(i, j);
+                    auto it = nodes.find(neighbor);
+                    if (it == nodes.end()) {
+                        const auto& [block, tile] = g_minimap.threadGetTile(neighbor);
+                        const bool wasSeen = tile.hasFlag(MinimapTileWasSeen);
+                        const bool blocked = tile.hasFlag(MinimapTileNotWalkable) || tile.hasFlag(MinimapTileNotPathable) || tile.hasFlag(MinimapTileEmpty);
+                        float speed = tile.getSpeed();
+                        if (blocked && neighbor != goal) {
+                            it = nodes.emplace(neighbor, nullptr).first;
+                        } else {
+                            if (!wasSeen)
+                                speed = 2000;
+                            it = nodes.emplace(neighbor, new Node{ .cost = speed, .totalCost = 10000000.0f, .pos = neighbor, .prev = node,
+                                                                   .distance = node->distance + 1, .unseen = wasSeen ? 0 : 1 }).first;
+                        }
+                    }
+                    if (!it->second || it->second->unseen > 50)
+                        continue;
+
+                    const float diagonal = ((i == 0 || j == 0) ? 1.0f : g_gameConfig.getPlayerDiagonalWalkSpeed());
+                    float cost = it->second->cost * diagonal;
+                    cost += diagonal * (50.0f * std::max<float>(5.0f, it->second->pos.distance(goal)));
+                    if (node->totalCost + cost + 50 < it->second->totalCost) {
+                        it->second->totalCost = node->totalCost + cost;
+                        it->second->prev = node;
+                        if (it->second->unseen)
+                            it->second->unseen = node->unseen + 1;
+                        it->second->distance = node->distance + 1;
+                        searchList.push(it->second);
+                    }
+                }
+            }
+        }
+
+        if (dstNode) {
+            while (dstNode && dstNode->prev) {
+                if (dstNode->unseen)
+                    ret->path.clear();
+                else
+                    ret->path.push_back(dstNode->prev->pos.getDirectionFromPosition(dstNode->pos));
+                dstNode = dstNode->prev;
+            }
+            std::reverse(ret->path.begin(), ret->path.end());
+            ret->status = Otc::PathFindResultOk;
+        }
+        ret->complexity = 50000 - limit;
+
+        for (const auto& node : nodes)
+            delete node.second;
+
+        return ret;
+    }
+
+    Position findWalkable(const int x, const int y)
+    {
+        for (int dx = 0; dx < 16; ++dx) {
+            const Position pos = ORIGIN.translated(x + dx, y);
+            if (!g_minimap.getTile(pos).hasFlag(MinimapTileNotWalkable))
+                return pos;
+        }
+        return ORIGIN.translated(x, y);
+    }
+}
+
+int main()
+{
+    g_minimap.init();
+    g_map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+
+    buildWorld();
+
+    const std::vector<std::pair<Position, Position>> routes{
+        { findWalkable(5, 10), findWalkable(40, 30) },
+        { findWalkable(410, 500), findWalkable(500, 560) },
+        { findWalkable(300, 900), findWalkable(320, 800) },
+        // past the search limit, both give up after the same number of nodes
+        { findWalkable(800, 820), findWalkable(650, 980) },
+    };
+
+    PathFinder finder;
+
+    auto start = Clock::now();
+    for (const auto& [from, to] : routes)
+        finder.createSnapshot(from, to);
+    const double firstSnapshotMs = elapsedMs(start);
+
+    std::printf("pathfinding: %zu routes over a %dx%d explored floor, %d runs\n", routes.size(), WORLD_SIZE, WORLD_SIZE, RUNS);
+    std::printf("  snapshots, packing the minimap: %8.3f ms\n", firstSnapshotMs);
+
+    bool mismatch = false;
+    double legacyMs = 0, snapshotMs = 0, searchMs = 0;
+    for (const auto& [from, to] : routes) {
+        PathFindResult_ptr legacy, current;
+
+        start = Clock::now();
+        for (int i = 0; i < RUNS; ++i)
+            legacy = findPathLegacy(from, to);
+        const double routeLegacyMs = elapsedMs(start) / RUNS;
+
+        start = Clock::now();
+        PathSnapshotPtr snapshot;
+        for (int i = 0; i < RUNS; ++i)
+            snapshot = finder.createSnapshot(from, to);
+        const double routeSnapshotMs = elapsedMs(start) / RUNS;
+
+        start = Clock::now();
+        for (int i = 0; i < RUNS; ++i)
+            current = PathFinder::findPath(*snapshot, from, to);
+        const double routeSearchMs = elapsedMs(start) / RUNS;
+
+        std::printf("  %5d,%5d -> %5d,%5d: legacy %8.3f ms (%zu steps, %d nodes), snapshot %6.3f ms + search %8.3f ms (%zu steps, %d nodes)\n",
+                    from.x, from.y, to.x, to.y, routeLegacyMs, legacy->path.size(), legacy->complexity,
+                    routeSnapshotMs, routeSearchMs, current->path.size(), current->complexity);
+
+        legacyMs += routeLegacyMs;
+        snapshotMs += routeSnapshotMs;
+        searchMs += routeSearchMs;
+        mismatch |= legacy->status != current->status;
+    }
+
+    std::printf("  total per round: legacy %8.3f ms, snapshot %6.3f ms + search %8.3f ms\n", legacyMs, snapshotMs, searchMs);
+
+    if (mismatch) {
+        std::printf("mismatch: the searches disagree on which routes exist\n");
+        return 1;
+    }
+
+    return 0;
+}
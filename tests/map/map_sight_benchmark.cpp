@@ -0,0 +1,168 @@
+// Checks the line of sight from the center of the aware range to every creature around it, through the
+// tile lookups Map::isSightClear did before, through the sight flags one target at a time and through
+// Map::checkSightLines.
+//
+// usage: otclient_map_sight_benchmark
+
+#define private public
+#define protected public
+#include "client/map.h"
+
+#include "client/gameconfig.h"
+#include "client/item.h"
+#include "client/minimap.h"
+#include "client/thingtype.h"
+#include "client/thingtypemanager.h"
+#include "client/tile.h"
+
+#undef protected
+#undef private
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RUNS = 2000;
+    constexpr int TARGETS = 150;
+    constexpr int WALLS = 80;
+    constexpr uint16_t WALL_ID = 1;
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void registerWallType()
+    {
+        auto& items = g_things.m_thingTypes[ThingCategoryItem];
+        items.resize(WALL_ID + 1);
+
+        const auto type = std::make_shared<ThingType>();
+        type->m_null = false;
+        type->m_category = ThingCategoryItem;
+        type->m_flags = ThingFlagAttrBlockProjectile | ThingFlagAttrNotWalkable;
+        type->m_size = Size(1, 1);
+        type->m_realSize = 32;
+        type->m_layers = 1;
+        type->m_animationPhases = 1;
+        type->m_opacity = 1.f;
+        items[WALL_ID] = type;
+    }
+
+    // Map::isSightClear before the sight flags, straight from the tiles
+    bool isSightClearOnTiles(Map& map, const Position& fromPos, const Position& toPos)
+    {
+        if (fromPos == toPos)
+            return true;
+
+        Position start(fromPos.z > toPos.z ? toPos : fromPos);
+        const Position destination(fromPos.z > toPos.z ? fromPos : toPos);
+
+        const int8_t mx = start.x < destination.x ? 1 : start.x == destination.x ? 0 : -1;
+        const int8_t my = start.y < destination.y ? 1 : start.y == destination.y ? 0 : -1;
+
+        const int32_t A = destination.y - start.y;
+        const int32_t B = start.x - destination.x;
+        const int32_t C = -(A * destination.x + B * destination.y);
+
+        while (start.x != destination.x || start.y != destination.y) {
+            const int32_t move_hor = std::abs(A * (start.x + mx) + B * (start.y) + C);
+            const int32_t move_ver = std::abs(A * (start.x) + B * (start.y + my) + C);
+            const int32_t move_cross = std::abs(A * (start.x + mx) + B * (start.y + my) + C);
+
+            if (start.y != destination.y && (start.x == destination.x || move_hor > move_ver || move_hor > move_cross))
+                start.y += my;
+
+            if (start.x != destination.x && (start.y == destination.y || move_ver > move_hor || move_ver > move_cross))
+                start.x += mx;
+
+            const auto tile = map.getTile(Position(start.x, start.y, start.z));
+            if (tile && !tile->isLookPossible())
+                return false;
+        }
+
+        while (start.z != destination.z) {
+            const auto tile = map.getTile(Position(start.x, start.y, start.z));
+            if (tile && tile->getThingCount() > 0)
+                return false;
+            start.z++;
+        }
+
+        return true;
+    }
+}
+
+int main()
+{
+    g_minimap.init();
+    registerWallType();
+
+    // tiles report their sight changes to g_map
+    Map& map = g_map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    map.m_awareRange = { .left = 8, .top = 6, .right = 9, .bottom = 7 };
+
+    const Position center(32369, 32241, 7);
+    map.m_centralPosition = center;
+    map.updateBlockWindow();
+
+    const auto& range = map.m_awareRange;
+    for (int y = center.y - range.top; y <= center.y + range.bottom; ++y) {
+        for (int x = center.x - range.left; x <= center.x + range.right; ++x)
+            map.createTile(Position(x, y, center.z));
+    }
+
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<int> dx(-range.left, range.right);
+    std::uniform_int_distribution<int> dy(-range.top, range.bottom);
+
+    for (int i = 0; i < WALLS; ++i) {
+        const auto wall = std::make_shared<Item>();
+        wall->m_clientId = WALL_ID;
+        map.addThing(wall, Position(center.x + dx(rng), center.y + dy(rng), center.z), -1);
+    }
+
+    std::vector<Position> targets;
+    for (int i = 0; i < TARGETS; ++i)
+        targets.emplace_back(center.x + dx(rng), center.y + dy(rng), center.z);
+
+    size_t legacyClear = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < RUNS; ++i) {
+        for (const auto& target : targets)
+            legacyClear += isSightClearOnTiles(map, center, target);
+    }
+    const double legacyMs = elapsedMs(start);
+
+    size_t singleClear = 0;
+    start = Clock::now();
+    for (int i = 0; i < RUNS; ++i) {
+        for (const auto& target : targets)
+            singleClear += map.isSightClear(center, target);
+    }
+    const double singleMs = elapsedMs(start);
+
+    size_t batchClear = 0;
+    start = Clock::now();
+    for (int i = 0; i < RUNS; ++i) {
+        for (const bool clear : map.checkSightLines(center, targets))
+            batchClear += clear;
+    }
+    const double batchMs = elapsedMs(start);
+
+    std::printf("sight: %d targets, %d walls in a %dx%d range, %d runs\n", TARGETS, WALLS, range.horizontal(), range.vertical(), RUNS);
+    std::printf("  tile lookups:     %8.3f ms (%.2f us per batch)\n", legacyMs, legacyMs * 1000.0 / RUNS);
+    std::printf("  isSightClear:     %8.3f ms (%.2f us per batch)\n", singleMs, singleMs * 1000.0 / RUNS);
+    std::printf("  checkSightLines:  %8.3f ms (%.2f us per batch)\n", batchMs, batchMs * 1000.0 / RUNS);
+
+    if (legacyClear != singleClear || legacyClear != batchClear) {
+        std::printf("mismatch: %zu, %zu and %zu clear lines\n", legacyClear, singleClear, batchClear);
+        return 1;
+    }
+
+    return 0;
+}
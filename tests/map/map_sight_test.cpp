@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "client/map.h"
+
+#include "client/gameconfig.h"
+#include "client/item.h"
+#include "client/minimap.h"
+#include "client/tile.h"
+#include "client/thingtype.h"
+#include "client/thingtypemanager.h"
+
+#undef protected
+#undef private
+
+#include <random>
+
+namespace {
+
+constexpr uint16_t WALL_ID = 1;
+
+// a projectile blocking item type, without loading any assets
+void registerWallType()
+{
+    auto& items = g_things.m_thingTypes[ThingCategoryItem];
+    if (items.size() > WALL_ID)
+        return;
+
+    items.resize(WALL_ID + 1);
+
+    const auto type = std::make_shared<ThingType>();
+    type->m_null = false;
+    type->m_category = ThingCategoryItem;
+    type->m_flags = ThingFlagAttrBlockProjectile | ThingFlagAttrNotWalkable;
+    type->m_size = Size(1, 1);
+    type->m_realSize = 32;
+    type->m_layers = 1;
+    type->m_animationPhases = 1;
+    type->m_opacity = 1.f;
+    items[WALL_ID] = type;
+}
+
+ItemPtr createWall()
+{
+    const auto item = std::make_shared<Item>();
+    item->m_clientId = WALL_ID;
+    return item;
+}
+
+// Map::isSightClear before the sight flags, straight from the tiles
+bool isSightClearOnTiles(Map& map, const Position& fromPos, const Position& toPos)
+{
+    if (fromPos == toPos)
+        return true;
+
+    Position start(fromPos.z > toPos.z ? toPos : fromPos);
+    const Position destination(fromPos.z > toPos.z ? fromPos : toPos);
+
+    const int8_t mx = start.x < destination.x ? 1 : start.x == destination.x ? 0 : -1;
+    const int8_t my = start.y < destination.y ? 1 : start.y == destination.y ? 0 : -1;
+
+    const int32_t A = destination.y - start.y;
+    const int32_t B = start.x - destination.x;
+    const int32_t C = -(A * destination.x + B * destination.y);
+
+    while (start.x != destination.x || start.y != destination.y) {
+        const int32_t move_hor = std::abs(A * (start.x + mx) + B * (start.y) + C);
+        const int32_t move_ver = std::abs(A * (start.x) + B * (start.y + my) + C);
+        const int32_t move_cross = std::abs(A * (start.x + mx) + B * (start.y + my) + C);
+
+        if (start.y != destination.y && (start.x == destination.x || move_hor > move_ver || move_hor > move_cross))
+            start.y += my;
+
+        if (start.x != destination.x && (start.y == destination.y || move_ver > move_hor || move_ver > move_cross))
+            start.x += mx;
+
+        const auto tile = map.getTile(Position(start.x, start.y, start.z));
+        if (tile && !tile->isLookPossible())
+            return false;
+    }
+
+    while (start.z != destination.z) {
+        const auto tile = map.getTile(Position(start.x, start.y, start.z));
+        if (tile && tile->getThingCount() > 0)
+            return false;
+        start.z++;
+    }
+
+    return true;
+}
+
+class MapSight : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // walls show up on the minimap as they are added
+        g_minimap.init();
+        registerWallType();
+
+        map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    }
+
+    void TearDown() override
+    {
+        map.m_floors.clear();
+        g_minimap.clean();
+    }
+
+    // Thing::getTile goes through g_map, so removal is exercised on it
+    Map& map = g_map;
+    const Position center{ 32369, 32241, 7 };
+};
+
+} // namespace
+
+TEST_F(MapSight, WallBlocksUntilRemoved)
+{
+    const Position target = center.translated(4, 0);
+    const auto wall = createWall();
+    map.addThing(wall, center.translated(2, 0), -1);
+
+    EXPECT_FALSE(map.isSightClear(center, target));
+    EXPECT_TRUE(map.isSightClear(center, center.translated(0, 4)));
+
+    ASSERT_TRUE(map.removeThing(wall));
+    EXPECT_TRUE(map.isSightClear(center, target));
+}
+
+TEST_F(MapSight, ThingsOnTheFloorsInBetweenBlockSight)
+{
+    const Position below = center.translated(3, 3, 2);
+    map.addThing(createWall(), center.translated(3, 3, 1), -1);
+
+    EXPECT_FALSE(map.isSightClear(center, below));
+    EXPECT_EQ(map.checkSightLines(center, { below }), std::vector<bool>{ false });
+}
+
+TEST_F(MapSight, BatchMatchesSingleChecks)
+{
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<int> offset(-9, 9);
+    std::uniform_int_distribution<int> floor(-1, 1);
+
+    for (int i = 0; i < 60; ++i)
+        map.addThing(createWall(), center.translated(offset(rng), offset(rng), floor(rng)), -1);
+
+    std::vector<Position> targets;
+    for (int i = 0; i < 200; ++i)
+        targets.emplace_back(center.translated(offset(rng), offset(rng), floor(rng)));
+    targets.emplace_back(center);
+
+    const auto results = map.checkSightLines(center, targets);
+    ASSERT_EQ(results.size(), targets.size());
+
+    size_t blocked = 0;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const bool expected = isSightClearOnTiles(map, center, targets[i]);
+        EXPECT_EQ(map.isSightClear(center, targets[i]), expected) << i;
+        EXPECT_EQ(results[i], expected) << i;
+        blocked += !expected;
+    }
+
+    // the walls have to matter for the comparison to mean anything
+    EXPECT_GT(blocked, 0u);
+    EXPECT_LT(blocked, targets.size());
+}
+
+TEST_F(MapSight, FarTargetsAreCheckedOneByOne)
+{
+    map.addThing(createWall(), center.translated(2, 0), -1);
+
+    // far apart on several floors, a box around all of them would span the whole map
+    const std::vector<Position> targets = { center.translated(4, 0), Position(0, 0, 5), Position(65000, 65000, 9), center.translated(0, 4) };
+
+    const auto results = map.checkSightLines(center, targets);
+    ASSERT_EQ(results.size(), targets.size());
+    for (size_t i = 0; i < targets.size(); ++i)
+        EXPECT_EQ(results[i], map.isSightClear(center, targets[i])) << i;
+    EXPECT_FALSE(results[0]);
+    EXPECT_TRUE(results[3]);
+}
+
+TEST_F(MapSight, FollowsTileChangesFromLua)
+{
+    const Position target = center.translated(4, 0);
+    const auto& tile = map.getOrCreateTile(center.translated(2, 0));
+    const auto wall = createWall();
+
+    // what tile:addThing, tile:removeThing and tile:clean are bound to
+    map.addThingToTile(tile, wall, -1);
+    EXPECT_FALSE(map.isSightClear(center, target));
+    EXPECT_EQ(map.checkSightLines(center, { target }), std::vector<bool>{ false });
+
+    ASSERT_TRUE(map.removeThingFromTile(tile, wall));
+    EXPECT_TRUE(map.isSightClear(center, target));
+
+    map.addThingToTile(tile, createWall(), -1);
+    map.cleanTileThings(tile);
+    EXPECT_EQ(map.checkSightLines(center, { target }), std::vector<bool>{ true });
+}
+
+TEST_F(MapSight, FollowsThingsAddedToTheTileDirectly)
+{
+    const Position target = center.translated(0, 4);
+    const auto& tile = map.getOrCreateTile(center.translated(0, 2));
+
+    tile->addThing(createWall(), -1);
+    EXPECT_FALSE(map.isSightClear(center, target));
+    EXPECT_EQ(map.checkSightLines(center, { target }), std::vector<bool>{ false });
+
+    tile->clean();
+    EXPECT_TRUE(map.isSightClear(center, target));
+    EXPECT_EQ(map.checkSightLines(center, { target }), std::vector<bool>{ true });
+}
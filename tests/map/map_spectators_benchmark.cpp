@@ -0,0 +1,156 @@
+// Collects the spectators of the aware range, on every aware floor, through the creature index of
+// Map::getSpectatorsInRangeEx and through the tile by tile scan of the area it replaced.
+//
+// usage: otclient_map_spectators_benchmark
+
+#define private public
+#define protected public
+#include "client/map.h"
+
+#include "client/creature.h"
+#include "client/gameconfig.h"
+#include "client/tile.h"
+#include "client/thingtype.h"
+
+#undef protected
+#undef private
+
+#include <framework/core/logger.h>
+#include <framework/core/resourcemanager.h>
+#include <framework/graphics/texturemanager.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_set>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RUNS = 20000;
+    constexpr int CREATURES_PER_FLOOR = 12;
+
+    // no Lua callbacks on appear, disappear or move
+    class BenchCreature final : public Creature
+    {
+    public:
+        void onPositionChange(const Position&, const Position& oldPos) override { setOldPositionSilently(oldPos); }
+        void onAppear() override {}
+        void onDisappear() override {}
+
+        ThingType* getThingType() const override
+        {
+            static ThingType type;
+
+            static const bool initialized = [] {
+                type.m_null = false;
+                type.m_category = ThingCategoryCreature;
+                type.m_size = Size(1, 1);
+                type.m_realSize = 32;
+                type.m_layers = 1;
+                type.m_animationPhases = 1;
+                type.m_opacity = 1.f;
+                return true;
+            }();
+
+            (void)initialized;
+            return &type;
+        }
+    };
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::vector<CreaturePtr> getSpectatorsLegacy(Map& map, const Position& center, const AwareRange& range)
+    {
+        std::vector<CreaturePtr> creatures;
+        std::unordered_set<uint32_t> seenIds;
+
+        for (int z = map.getFirstAwareFloor(); z <= map.getLastAwareFloor(); ++z) {
+            for (int y = center.y - range.top; y <= center.y + range.bottom; ++y) {
+                for (int x = center.x - range.left; x <= center.x + range.right; ++x) {
+                    const auto& tile = map.getTile(Position(x, y, z));
+                    if (!tile || !tile->hasCreatures())
+                        continue;
+
+                    std::vector<CreaturePtr> tileCreatures;
+                    tile->appendSpectators(tileCreatures);
+                    for (const auto& creature : tileCreatures) {
+                        if (seenIds.insert(creature->getId()).second)
+                            creatures.emplace_back(creature);
+                    }
+                }
+            }
+        }
+
+        return creatures;
+    }
+}
+
+int main()
+{
+    g_logger.setLevel(Fw::LogFatal);
+    g_resources.init(".");
+    g_resources.addSearchPath(".");
+    g_textures.init();
+
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    map.m_awareRange = { .left = 8, .top = 6, .right = 9, .bottom = 7 };
+
+    const Position center(32369, 32241, 7);
+    map.m_centralPosition = center;
+    map.updateBlockWindow();
+
+    const auto& range = map.m_awareRange;
+
+    // ground everywhere on the surface, a handful of creatures walking around on each aware floor
+    for (int y = center.y - range.top; y <= center.y + range.bottom; ++y) {
+        for (int x = center.x - range.left; x <= center.x + range.right; ++x)
+            map.createTile(Position(x, y, center.z));
+    }
+
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<int> dx(-range.left, range.right);
+    std::uniform_int_distribution<int> dy(-range.top, range.bottom);
+
+    uint32_t id = 0;
+    for (int z = map.getFirstAwareFloor(); z <= map.getLastAwareFloor(); ++z) {
+        for (int i = 0; i < CREATURES_PER_FLOOR; ++i) {
+            const Position pos(center.x + dx(rng), center.y + dy(rng), z);
+            const auto creature = std::make_shared<BenchCreature>();
+            creature->setId(++id);
+            map.addThing(creature, pos, -1);
+            map.m_knownCreatures.try_emplace(creature->getId(), creature);
+        }
+    }
+
+    size_t legacyCount = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < RUNS; ++i)
+        legacyCount += getSpectatorsLegacy(map, center, range).size();
+    const double legacyMs = elapsedMs(start);
+
+    size_t indexCount = 0;
+    start = Clock::now();
+    for (int i = 0; i < RUNS; ++i)
+        indexCount += map.getSpectators(center, true).size();
+    const double indexMs = elapsedMs(start);
+
+    std::printf("spectators: %zu creatures on %d floors, %dx%d tiles each\n", map.m_knownCreatures.size(),
+                map.getLastAwareFloor() - map.getFirstAwareFloor() + 1, range.horizontal(), range.vertical());
+    std::printf("  tile scan:      %8.3f ms (%.2f us per query)\n", legacyMs, legacyMs * 1000.0 / RUNS);
+    std::printf("  creature index: %8.3f ms (%.2f us per query)\n", indexMs, indexMs * 1000.0 / RUNS);
+
+    if (legacyCount != indexCount) {
+        std::printf("mismatch: %zu vs %zu spectators\n", legacyCount, indexCount);
+        return 1;
+    }
+
+    g_textures.terminate();
+    g_resources.terminate();
+    return 0;
+}
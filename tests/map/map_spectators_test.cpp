@@ -310,8 +310,8 @@ TEST(MapSpectators, AggregatesCreaturesFromTiles)
     auto first = makeCreature(10, center);
     auto second = makeCreature(20, center);
 
-    tile->addThing(first, -1);
-    tile->addThing(second, -1);
+    map.addThing(first, center, -1);
+    map.addThing(second, center, -1);
 
     map.m_knownCreatures.try_emplace(first->getId(), first);
     map.m_knownCreatures.try_emplace(second->getId(), second);
@@ -370,10 +370,10 @@ TEST(MapSpectators, AggregationMatchesLegacyTraversal)
     auto third = makeCreature(50, center.translated(0, -1));
     auto fourth = makeCreature(60, center.translated(0, 0, 1));
 
-    centerTile->addThing(first, -1);
-    eastTile->addThing(second, -1);
-    northTile->addThing(third, -1);
-    aboveTile->addThing(fourth, -1);
+    map.addThing(first, centerTile->getPosition(), -1);
+    map.addThing(second, eastTile->getPosition(), -1);
+    map.addThing(third, northTile->getPosition(), -1);
+    map.addThing(fourth, aboveTile->getPosition(), -1);
 
     map.m_knownCreatures.try_emplace(first->getId(), first);
     map.m_knownCreatures.try_emplace(second->getId(), second);
@@ -405,9 +405,9 @@ TEST(MapSpectators, RangeFiltering)
     auto c2 = makeCreature(2, adjTile->getPosition());
     auto c3 = makeCreature(3, farTile->getPosition());
 
-    centerTile->addThing(c1, -1);
-    adjTile->addThing(c2, -1);
-    farTile->addThing(c3, -1);
+    map.addThing(c1, centerTile->getPosition(), -1);
+    map.addThing(c2, adjTile->getPosition(), -1);
+    map.addThing(c3, farTile->getPosition(), -1);
 
     map.m_knownCreatures.try_emplace(c1->getId(), c1);
     map.m_knownCreatures.try_emplace(c2->getId(), c2);
@@ -442,9 +442,9 @@ TEST(MapSpectators, CreatureOrderingIsDeterministic)
     auto middle = makeCreature(2, centerTile->getPosition());
     auto east = makeCreature(3, eastTile->getPosition());
 
-    westTile->addThing(west, -1);
-    centerTile->addThing(middle, -1);
-    eastTile->addThing(east, -1);
+    map.addThing(west, westTile->getPosition(), -1);
+    map.addThing(middle, centerTile->getPosition(), -1);
+    map.addThing(east, eastTile->getPosition(), -1);
 
     map.m_knownCreatures.try_emplace(west->getId(), west);
     map.m_knownCreatures.try_emplace(middle->getId(), middle);
@@ -476,9 +476,9 @@ TEST(MapSpectators, MultiFloorRangeIncludesVerticalNeighbors)
     auto middle = makeCreature(12, centerTile->getPosition());
     auto above = makeCreature(13, aboveTile->getPosition());
 
-    belowTile->addThing(below, -1);
-    centerTile->addThing(middle, -1);
-    aboveTile->addThing(above, -1);
+    map.addThing(below, belowTile->getPosition(), -1);
+    map.addThing(middle, centerTile->getPosition(), -1);
+    map.addThing(above, aboveTile->getPosition(), -1);
 
     map.m_knownCreatures.try_emplace(below->getId(), below);
     map.m_knownCreatures.try_emplace(middle->getId(), middle);
@@ -504,8 +504,8 @@ TEST(MapSpectators, UniqueCreatures)
 
     auto shared = makeCreature(42, firstTile->getPosition());
 
-    firstTile->addThing(shared, -1);
-    secondTile->addThing(shared, -1);
+    map.addThing(shared, firstTile->getPosition(), -1);
+    map.addThing(shared, secondTile->getPosition(), -1);
 
     map.m_knownCreatures.try_emplace(shared->getId(), shared);
 
@@ -513,3 +513,115 @@ TEST(MapSpectators, UniqueCreatures)
     ASSERT_EQ(1u, spectators.size());
     EXPECT_EQ(shared, spectators.front());
 }
+
+TEST(MapSpectators, IndexMatchesLegacyTraversalOnCrowdedArea)
+{
+    const Position center(1000, 1000, 7);
+
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    map.m_centralPosition = center;
+    map.m_awareRange = { .left = 8, .top = 6, .right = 9, .bottom = 7 };
+
+    // spread across cell borders, two creatures per tile
+    uint32_t id = 100;
+    for (int z = 5; z <= 9; ++z) {
+        for (int i = 0; i < 60; ++i) {
+            const int slot = i / 2;
+            const Position position = center.translated((slot * 7) % 31 - 15, (slot * 11) % 25 - 12, z - center.z);
+            auto creature = makeCreature(++id, position);
+            map.addThing(creature, position, -1);
+            map.m_knownCreatures.try_emplace(creature->getId(), creature);
+        }
+    }
+
+    for (const bool multiFloor : { false, true }) {
+        for (const int range : { 0, 1, 3, 7, 9, 16 }) {
+            const auto expected = emulateLegacySpectatorCollection(map, center, multiFloor, range, range + 1, range, range + 2);
+            const auto actual = map.getSpectatorsInRangeEx(center, multiFloor, range, range + 1, range, range + 2);
+            EXPECT_EQ(expected, actual) << "range " << range << " multiFloor " << multiFloor;
+        }
+    }
+}
+
+// Thing::getTile goes through g_map, so removal is exercised on it
+class GlobalMapSpectators : public testing::Test
+{
+protected:
+    static inline const Position CENTER{ 2000, 2000, 7 };
+
+    void SetUp() override
+    {
+        g_map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+        g_map.m_centralPosition = CENTER;
+    }
+
+    void TearDown() override
+    {
+        for (auto& floor : g_map.m_floors) {
+            floor.tileBlocks.clear();
+            floor.creatureCells.clear();
+        }
+        g_map.resetTileBlockTracking();
+        g_map.m_floors.clear();
+        g_map.m_centralPosition = {};
+    }
+};
+
+TEST_F(GlobalMapSpectators, IndexFollowsRemovalAndMoves)
+{
+    const Position center = CENTER;
+
+    auto walker = makeCreature(1, center);
+    auto idle = makeCreature(2, center.translated(1, 0));
+
+    g_map.addThing(walker, center, -1);
+    g_map.addThing(idle, center.translated(1, 0), -1);
+
+    EXPECT_EQ((std::vector<CreaturePtr>{ walker, idle }), g_map.getSpectatorsInRangeEx(center, false, 1, 1, 1, 1));
+
+    // step across a cell border, out of the queried range
+    const Position stepPos = center.translated(0, -Map::CREATURE_CELL_SIZE);
+    ASSERT_TRUE(g_map.removeThing(walker));
+    g_map.addThing(walker, stepPos, -1);
+
+    EXPECT_EQ((std::vector<CreaturePtr>{ idle }), g_map.getSpectatorsInRangeEx(center, false, 1, 1, 1, 1));
+    EXPECT_EQ((std::vector<CreaturePtr>{ walker }), g_map.getSpectatorsInRangeEx(stepPos, false, 0, 0, 0, 0));
+
+    ASSERT_TRUE(g_map.removeThing(idle));
+    EXPECT_TRUE(g_map.getSpectatorsInRangeEx(center, false, 1, 1, 1, 1).empty());
+
+    ASSERT_TRUE(g_map.removeThing(walker));
+    for (const auto& floor : g_map.m_floors)
+        EXPECT_TRUE(floor.creatureCells.empty());
+}
+
+TEST_F(GlobalMapSpectators, IndexFollowsTileChangesFromLua)
+{
+    const Position center = CENTER;
+    const auto& tile = g_map.createTile(center);
+
+    auto first = makeCreature(1, center);
+    auto second = makeCreature(2, center);
+
+    // what tile:addThing, tile:removeThing and tile:clean are bound to
+    g_map.addThingToTile(tile, first, -1);
+    g_map.addThingToTile(tile, second, -1);
+    EXPECT_EQ(expectedSpectatorsFromTile(*tile), g_map.getSpectatorsInRangeEx(center, false, 0, 0, 0, 0));
+
+    ASSERT_TRUE(g_map.removeThingFromTile(tile, first));
+    EXPECT_EQ((std::vector<CreaturePtr>{ second }), g_map.getSpectatorsInRangeEx(center, false, 0, 0, 0, 0));
+
+    g_map.addThingToTile(tile, first, -1);
+    g_map.cleanTileThings(tile);
+    EXPECT_TRUE(g_map.getSpectatorsInRangeEx(center, false, 0, 0, 0, 0).empty());
+    for (const auto& floor : g_map.m_floors)
+        EXPECT_TRUE(floor.creatureCells.empty());
+
+    // a tile the map does not hold stays out of the index
+    const auto detached = std::make_shared<Tile>(center.translated(1, 0));
+    g_map.addThingToTile(detached, first, -1);
+    EXPECT_TRUE(detached->hasCreatures());
+    for (const auto& floor : g_map.m_floors)
+        EXPECT_TRUE(floor.creatureCells.empty());
+}
@@ -0,0 +1,113 @@
+// Looks up every tile of the aware area, floor by floor as MapView::updateVisibleTiles does, through
+// Map::getTile (block window) and through the per floor block hash map it used before.
+//
+// usage: otclient_map_tile_lookup_benchmark
+
+#define private public
+#include "client/map.h"
+#undef private
+
+#include "client/gameconfig.h"
+#include "client/tile.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RUNS = 2000;
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    const TilePtr& getTileLegacy(Map& map, const Position& pos)
+    {
+        static const TilePtr nullTile;
+        if (!pos.isMapPosition())
+            return nullTile;
+
+        auto& tileBlocks = map.m_floors[pos.z].tileBlocks;
+        const auto it = tileBlocks.find(map.getBlockIndex(pos));
+        if (it != tileBlocks.end())
+            return it->second.get(pos);
+
+        return nullTile;
+    }
+
+    template<typename Lookup>
+    size_t scanAwareArea(Map& map, const Position& center, const AwareRange& range, Lookup&& lookup)
+    {
+        size_t found = 0;
+        for (int z = 0; z <= g_gameConfig.getMapSeaFloor(); ++z) {
+            for (int y = center.y - range.top; y <= center.y + range.bottom; ++y) {
+                for (int x = center.x - range.left; x <= center.x + range.right; ++x) {
+                    if (lookup(map, Position(x, y, z)))
+                        ++found;
+                }
+            }
+        }
+        return found;
+    }
+}
+
+int main()
+{
+    Map map;
+    map.m_floors.resize(g_gameConfig.getMapMaxZ() + 1);
+    map.m_awareRange = { .left = 8, .top = 6, .right = 9, .bottom = 7 };
+
+    // only the window part of setCentralPosition, the rest needs the dispatchers running
+    Position center(32369, 32241, 7);
+    map.m_centralPosition = center;
+    map.updateBlockWindow();
+
+    // dense ground on the surface floors, plus a sparse cached area further away
+    for (int z = 0; z <= g_gameConfig.getMapSeaFloor(); ++z) {
+        for (int y = center.y - 40; y <= center.y + 40; ++y) {
+            for (int x = center.x - 40; x <= center.x + 40; ++x) {
+                if (z == 7 || (x + y + z) % 3 == 0)
+                    map.createTile(Position(x, y, z));
+            }
+        }
+    }
+
+    const auto& range = map.m_awareRange;
+    const auto legacy = [](Map& m, const Position& pos) { return getTileLegacy(m, pos) != nullptr; };
+    const auto window = [](Map& m, const Position& pos) { return m.getTile(pos) != nullptr; };
+
+    size_t legacyFound = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < RUNS; ++i)
+        legacyFound += scanAwareArea(map, center.translated(i % 3, i % 2), range, legacy);
+    const double legacyMs = elapsedMs(start) / RUNS;
+
+    size_t windowFound = 0;
+    start = Clock::now();
+    for (int i = 0; i < RUNS; ++i)
+        windowFound += scanAwareArea(map, center.translated(i % 3, i % 2), range, window);
+    const double windowMs = elapsedMs(start) / RUNS;
+
+    // the scans above are shifted a little every run so they can't be hoisted out of the loop
+
+    // walking re-anchors the window every step
+    size_t walkingFound = 0;
+    start = Clock::now();
+    for (int i = 0; i < RUNS; ++i) {
+        center.x += i % 20 < 10 ? 1 : -1;
+        map.m_centralPosition = center;
+        map.updateBlockWindow();
+        walkingFound += scanAwareArea(map, center, range, window);
+    }
+    const double walkingMs = elapsedMs(start) / RUNS;
+
+    const size_t lookups = static_cast<size_t>(range.horizontal()) * range.vertical() * (g_gameConfig.getMapSeaFloor() + 1);
+    std::printf("%zu lookups per scan, %zu tiles found\n", lookups, legacyFound / RUNS);
+    std::printf("hash map:     %8.3f ms (%.1f ns/lookup)\n", legacyMs, legacyMs * 1e6 / lookups);
+    std::printf("block window: %8.3f ms (%.1f ns/lookup)\n", windowMs, windowMs * 1e6 / lookups);
+    std::printf("walking:      %8.3f ms per step and scan\n", walkingMs);
+    return legacyFound == windowFound && walkingFound > 0 ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+
+#define private public
+#include "client/satellitemap.h"
+#undef private
+
+#include <framework/core/asyncdispatcher.h>
+#include <framework/core/logger.h>
+#include <framework/core/resourcemanager.h>
+#include <framework/graphics/texture.h>
+
+#include <lzma.h>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+constexpr const char* CHUNK_DIR = "/satellite_streaming_test";
+constexpr int FLOOR = 7;
+constexpr int LOD = 16;
+// a LOD 16 chunk covers 256 tiles, 8 map blocks of 32 tiles
+constexpr int CHUNK_BLOCKS = 8;
+constexpr int FIRST_BLOCK = 1000;
+
+// a 512x512 32 bpp BMP, compressed the way CIP ships it: 32 header bytes, then an LZMA-alone stream
+std::string makeChunkFile()
+{
+    constexpr uint32_t side = 512;
+    constexpr uint32_t pixelBytes = side * side * 4;
+
+    std::vector<uint8_t> bmp(54 + pixelBytes, 0);
+    std::fill(bmp.begin() + 54, bmp.end(), 0x80);
+    const auto put = [&](const size_t off, const uint32_t value, const int bytes) {
+        for (int i = 0; i < bytes; ++i)
+            bmp[off + i] = static_cast<uint8_t>(value >> (8 * i));
+    };
+    bmp[0] = 'B';
+    bmp[1] = 'M';
+    put(2, bmp.size(), 4);
+    put(10, 54, 4);
+    put(14, 40, 4);
+    put(18, side, 4);
+    put(22, side, 4);
+    put(26, 1, 2);
+    put(28, 32, 2);
+    put(34, pixelBytes, 4);
+
+    lzma_options_lzma options;
+    lzma_lzma_preset(&options, 0);
+    lzma_stream strm = LZMA_STREAM_INIT;
+    if (lzma_alone_encoder(&strm, &options) != LZMA_OK)
+        return {};
+
+    std::string out(32, '\0');
+    std::array<uint8_t, 65536> buf{};
+    strm.next_in = bmp.data();
+    strm.avail_in = bmp.size();
+
+    lzma_ret ret = LZMA_OK;
+    while (ret == LZMA_OK) {
+        strm.next_out = buf.data();
+        strm.avail_out = buf.size();
+        ret = lzma_code(&strm, LZMA_FINISH);
+        out.append(reinterpret_cast<const char*>(buf.data()), buf.size() - strm.avail_out);
+    }
+    lzma_end(&strm);
+
+    return ret == LZMA_STREAM_END ? out : std::string();
+}
+
+class SatelliteEnvironment : public testing::Environment
+{
+public:
+    void SetUp() override
+    {
+        m_previousLogLevel = g_logger.getLevel();
+        g_logger.setLevel(Fw::LogFatal);
+        g_resources.init(".");
+        g_resources.addSearchPath(".");
+
+        // a row of four chunks on the surface, plus one that does not decode
+        const std::filesystem::path dir = std::string(".") + CHUNK_DIR;
+        std::filesystem::create_directories(dir);
+
+        const auto chunk = makeChunkFile();
+        for (int i = 0; i < 4; ++i) {
+            const auto name = fmt::format("satellite-{}-{}-{}-{}-test.bmp.lzma", LOD, FIRST_BLOCK + i * CHUNK_BLOCKS, FIRST_BLOCK, FLOOR);
+            std::ofstream(dir / name, std::ios::binary) << chunk;
+        }
+        std::ofstream(dir / fmt::format("satellite-{}-{}-{}-{}-broken.bmp.lzma", LOD, FIRST_BLOCK, FIRST_BLOCK + CHUNK_BLOCKS, FLOOR), std::ios::binary)
+            << std::string(64, 'x');
+    }
+
+    void TearDown() override
+    {
+        g_asyncDispatcher->wait();
+        g_satelliteMap.clear();
+        std::filesystem::remove_all(std::string(".") + CHUNK_DIR);
+        g_resources.terminate();
+        g_logger.setLevel(m_previousLogLevel);
+    }
+
+private:
+    Fw::LogLevel m_previousLogLevel{ Fw::LogFatal };
+};
+
+[[maybe_unused]] testing::Environment* const g_satelliteEnv = testing::AddGlobalTestEnvironment(new SatelliteEnvironment);
+
+class SatelliteStreaming : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_satelliteMap.clear();
+        g_satelliteMap.setMemoryBudget(256 * 1024 * 1024);
+        ASSERT_EQ(g_satelliteMap.loadFloors(CHUNK_DIR, FLOOR, FLOOR), 5);
+    }
+
+    static SatelliteMap::ChunkKey key(const int column, const int row = 0)
+    {
+        return { LOD, FIRST_BLOCK + column * CHUNK_BLOCKS, FIRST_BLOCK + row * CHUNK_BLOCKS, FLOOR };
+    }
+
+    static SatelliteMap::ChunkInfo& info(const SatelliteMap::ChunkKey& key) { return g_satelliteMap.m_chunks.at(key); }
+
+    // what a draw does for one visible chunk
+    static bool use(const SatelliteMap::ChunkKey& key)
+    {
+        return g_satelliteMap.useChunk(info(key), key, true);
+    }
+
+    static size_t decodedCount()
+    {
+        std::scoped_lock lock(g_satelliteMap.m_loadedMutex);
+        return g_satelliteMap.m_loadedChunks.size();
+    }
+
+    // frames go by until the loader threads are done and every decoded chunk is uploaded
+    static void settle()
+    {
+        g_asyncDispatcher->wait();
+        while (decodedCount() > 0) {
+            ++g_satelliteMap.drawState(true).frame;
+            g_satelliteMap.processLoadedChunks();
+        }
+    }
+};
+
+} // namespace
+
+TEST_F(SatelliteStreaming, ChunksLoadInTheBackground)
+{
+    const auto first = key(0);
+
+    // nothing to draw yet, the chunk is on its way
+    EXPECT_FALSE(use(first));
+    EXPECT_EQ(info(first).state, SatelliteMap::ChunkState::LOADING);
+    EXPECT_EQ(info(first).texture, nullptr);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (info(first).state == SatelliteMap::ChunkState::LOADING && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++g_satelliteMap.drawState(true).frame;
+        g_satelliteMap.processLoadedChunks();
+    }
+
+    ASSERT_EQ(info(first).state, SatelliteMap::ChunkState::RESIDENT);
+    ASSERT_NE(info(first).texture, nullptr);
+    EXPECT_EQ(info(first).texture->getWidth(), 512);
+    EXPECT_EQ(g_satelliteMap.m_residentBytes, SatelliteMap::CHUNK_BYTES);
+    EXPECT_EQ(g_satelliteMap.m_pendingLoads, 0);
+    EXPECT_TRUE(use(first));
+}
+
+TEST_F(SatelliteStreaming, BrokenChunksAreNotRetried)
+{
+    const auto broken = key(0, 1);
+
+    EXPECT_FALSE(use(broken));
+    settle();
+
+    EXPECT_EQ(info(broken).state, SatelliteMap::ChunkState::FAILED);
+    EXPECT_FALSE(use(broken));
+    EXPECT_EQ(g_satelliteMap.m_pendingLoads, 0);
+}
+
+TEST_F(SatelliteStreaming, UploadsAreSpreadOverFrames)
+{
+    for (int column = 0; column < 4; ++column)
+        use(key(column));
+    EXPECT_EQ(g_satelliteMap.m_pendingLoads, SatelliteMap::MAX_PENDING_LOADS);
+
+    g_asyncDispatcher->wait();
+    ASSERT_EQ(decodedCount(), 4u);
+
+    g_satelliteMap.processLoadedChunks();
+    EXPECT_EQ(g_satelliteMap.m_residentBytes, SatelliteMap::MAX_UPLOADS_PER_FRAME * SatelliteMap::CHUNK_BYTES);
+    EXPECT_EQ(decodedCount(), 4u - SatelliteMap::MAX_UPLOADS_PER_FRAME);
+
+    settle();
+    EXPECT_EQ(g_satelliteMap.m_residentBytes, 4 * SatelliteMap::CHUNK_BYTES);
+}
+
+TEST_F(SatelliteStreaming, LeastRecentlyDrawnChunksAreEvicted)
+{
+    for (int column = 0; column < 3; ++column)
+        use(key(column));
+    settle();
+    ASSERT_EQ(g_satelliteMap.m_lru.size(), 3u);
+
+    // the first chunk is drawn again, the second is now the oldest
+    g_satelliteMap.drawState(true).frame += 2;
+    use(key(2));
+    use(key(0));
+    g_satelliteMap.drawState(true).frame += 2;
+
+    g_satelliteMap.setMemoryBudget(2 * SatelliteMap::CHUNK_BYTES);
+    EXPECT_EQ(g_satelliteMap.m_residentBytes, 2 * SatelliteMap::CHUNK_BYTES);
+    EXPECT_EQ(info(key(1)).state, SatelliteMap::ChunkState::UNLOADED);
+    EXPECT_EQ(info(key(1)).texture, nullptr);
+    EXPECT_EQ(info(key(0)).state, SatelliteMap::ChunkState::RESIDENT);
+    EXPECT_EQ(info(key(2)).state, SatelliteMap::ChunkState::RESIDENT);
+
+    // an evicted chunk is simply requested again
+    EXPECT_FALSE(use(key(1)));
+    EXPECT_EQ(info(key(1)).state, SatelliteMap::ChunkState::LOADING);
+    settle();
+}
+
+TEST_F(SatelliteStreaming, ChunksDrawnLastFrameAreKept)
+{
+    for (int column = 0; column < 3; ++column)
+        use(key(column));
+    settle();
+
+    // every chunk was just drawn, the draw pool may still hold their textures
+    for (int column = 0; column < 3; ++column)
+        use(key(column));
+    g_satelliteMap.setMemoryBudget(SatelliteMap::CHUNK_BYTES);
+    EXPECT_EQ(g_satelliteMap.m_lru.size(), 3u);
+
+    g_satelliteMap.drawState(true).frame += 2;
+    g_satelliteMap.evictChunks();
+    EXPECT_EQ(g_satelliteMap.m_lru.size(), 1u);
+}
+
+TEST_F(SatelliteStreaming, MinimapFramesDoNotAgeSatelliteChunks)
+{
+    for (int column = 0; column < 3; ++column)
+        use(key(column));
+    settle();
+    for (int column = 0; column < 3; ++column)
+        use(key(column));
+
+    // the static minimap keeps drawing while the surface view is still showing these chunks
+    g_satelliteMap.drawState(false).frame += 10;
+    g_satelliteMap.setMemoryBudget(SatelliteMap::CHUNK_BYTES);
+    EXPECT_EQ(g_satelliteMap.m_lru.size(), 3u);
+
+    g_satelliteMap.drawState(true).frame += 2;
+    g_satelliteMap.evictChunks();
+    EXPECT_EQ(g_satelliteMap.m_lru.size(), 1u);
+}
+
+TEST_F(SatelliteStreaming, ClearDropsLoadsInFlight)
+{
+    use(key(0));
+    use(key(1));
+    g_satelliteMap.clear();
+    ASSERT_EQ(g_satelliteMap.loadFloors(CHUNK_DIR, FLOOR, FLOOR), 5);
+
+    // whatever the old loads deliver belongs to chunks that are gone
+    g_asyncDispatcher->wait();
+    for (int i = 0; i < 4; ++i)
+        g_satelliteMap.processLoadedChunks();
+
+    EXPECT_EQ(decodedCount(), 0u);
+    EXPECT_EQ(info(key(0)).state, SatelliteMap::ChunkState::UNLOADED);
+    EXPECT_EQ(g_satelliteMap.m_residentBytes, 0u);
+    EXPECT_EQ(g_satelliteMap.m_pendingLoads, 0);
+}
+
+TEST_F(SatelliteStreaming, PanningPrefetchesTheNextChunk)
+{
+    // scale 2 picks LOD 16, a chunk is 512 px wide and covers the screen
+    const Rect screen(0, 0, 256, 256);
+    const float scale = 2.f;
+    const Position camera(FIRST_BLOCK * 32 + 128, FIRST_BLOCK * 32 + 128, FLOOR);
+    ASSERT_EQ(SatelliteMap::pickLod(scale), LOD);
+    ASSERT_TRUE(SatelliteMap::getChunkRect(key(0), screen.center(), camera, scale).intersects(screen));
+    ASSERT_FALSE(SatelliteMap::getChunkRect(key(1), screen.center(), camera, scale).intersects(screen));
+
+    // standing still, nothing past the screen is requested
+    g_satelliteMap.prefetchChunks(true, FLOOR, FLOOR, screen, camera, scale);
+    g_satelliteMap.prefetchChunks(true, FLOOR, FLOOR, screen, camera, scale);
+    EXPECT_EQ(info(key(1)).state, SatelliteMap::ChunkState::UNLOADED);
+
+    // moving east, the chunk to the east is on its way before it shows up
+    g_satelliteMap.prefetchChunks(true, FLOOR, FLOOR, screen, camera.translated(1, 0), scale);
+    EXPECT_EQ(info(key(1)).state, SatelliteMap::ChunkState::LOADING);
+    EXPECT_EQ(info(key(2)).state, SatelliteMap::ChunkState::UNLOADED);
+    settle();
+    EXPECT_EQ(info(key(1)).state, SatelliteMap::ChunkState::RESIDENT);
+}
@@ -0,0 +1,329 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+#include "framework/sound/soundmanager.h"
+
+#include "framework/sound/combinedsoundsource.h"
+#include "framework/sound/soundsource.h"
+#include "framework/sound/soundstream.h"
+#include "framework/sound/streamsoundsource.h"
+
+#undef protected
+#undef private
+
+#include <framework/core/logger.h>
+#include <framework/core/resourcemanager.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+constexpr const char* SHORT_SOUND = "/Low_Health.ogg";
+constexpr const char* OTHER_SOUND = "/Low_Mana.ogg";
+constexpr const char* LONG_SOUND = "/alarm.ogg";
+
+class SoundEnvironment : public testing::Environment
+{
+public:
+    void SetUp() override
+    {
+        m_previousLogLevel = g_logger.getLevel();
+        g_logger.setLevel(Fw::LogFatal);
+        g_resources.init(".");
+        g_resources.addSearchPath(OTCLIENT_TEST_SOUNDS_DIR);
+
+        // OpenAL Soft mixes into nothing, in real time, so sources play and end as usual
+#ifdef _WIN32
+        _putenv_s("ALSOFT_DRIVERS", "null");
+#else
+        setenv("ALSOFT_DRIVERS", "null", 1);
+#endif
+        g_sounds.init();
+    }
+
+    void TearDown() override
+    {
+        g_sounds.terminate();
+        g_resources.terminate();
+        g_logger.setLevel(m_previousLogLevel);
+    }
+
+private:
+    Fw::LogLevel m_previousLogLevel{ Fw::LogFatal };
+};
+
+[[maybe_unused]] testing::Environment* const g_soundEnv = testing::AddGlobalTestEnvironment(new SoundEnvironment);
+
+class SoundManagerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if (!g_sounds.m_context || g_sounds.m_voices.empty())
+            GTEST_SKIP() << "no null audio device available";
+
+        g_sounds.m_audioEnabled = true;
+        g_sounds.stopAll();
+        g_sounds.m_sources.clear();
+        g_sounds.clearCache();
+        g_sounds.setCacheBudget(64 * 1024 * 1024);
+        g_sounds.m_channelVoiceLimits.clear();
+        g_sounds.m_voicesStolen = 0;
+        g_sounds.m_voicesDenied = 0;
+        g_sounds.m_cacheHits = 0;
+        g_sounds.m_cacheMisses = 0;
+        g_sounds.m_cacheEvictions = 0;
+    }
+
+    static uint64_t stat(const std::string& name) { return g_sounds.getCacheStats().at(name); }
+
+    // polls, as the frame loop would, until the condition holds or time runs out
+    template<typename Condition>
+    static bool pollUntil(Condition condition)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            g_sounds.poll();
+        }
+        return true;
+    }
+
+    // a bare source, voices are bound by hand without going through play()
+    static SoundSourcePtr makeSource(const int priority, const uint8_t channel = 0)
+    {
+        auto source = std::make_shared<SoundSource>();
+        source->setPriority(priority);
+        source->setChannel(channel);
+        return source;
+    }
+
+    // takes every voice in the pool with sources of the given priority
+    static std::vector<SoundSourcePtr> fillVoices(const int priority)
+    {
+        std::vector<SoundSourcePtr> sources;
+        for (size_t i = 0; i < g_sounds.m_voices.size(); ++i) {
+            auto source = makeSource(priority);
+            EXPECT_TRUE(source->bindVoice());
+            sources.emplace_back(std::move(source));
+        }
+        return sources;
+    }
+};
+
+} // namespace
+
+TEST_F(SoundManagerTest, StereoSplitDecodesOnce)
+{
+    const auto filename = g_sounds.resolveSoundFile(LONG_SOUND);
+    SoundStream stream(filename, { StreamSoundSource::DownMixLeft, StreamSoundSource::DownMixRight }, 16 * 1024 * 1024);
+
+    // driven by hand, the streaming thread never sees this stream
+    stream.start(0);
+    stream.start(1);
+    std::vector<char> left;
+    std::vector<char> right;
+    while (true) {
+        const bool decoded = stream.decode();
+        while (const auto& fragment = stream.pop(0))
+            left.insert(left.end(), fragment->samples.begin(), fragment->samples.end());
+        while (const auto& fragment = stream.pop(1))
+            right.insert(right.end(), fragment->samples.begin(), fragment->samples.end());
+        if (!decoded)
+            break;
+    }
+
+    ASSERT_TRUE(stream.isFinished(0));
+    ASSERT_TRUE(stream.isFinished(1));
+
+    std::vector<char> samples;
+    ALenum format = AL_NONE;
+    int rate = 0;
+    ASSERT_TRUE(stream.takeDecoded(samples, format, rate));
+    ASSERT_FALSE(samples.empty());
+    EXPECT_GT(rate, 0);
+
+    if (format == AL_FORMAT_STEREO16) {
+        EXPECT_EQ(left, SoundStream::extractChannel(samples.data(), samples.size(), 0));
+        EXPECT_EQ(right, SoundStream::extractChannel(samples.data(), samples.size(), 1));
+    } else {
+        // mono files reach both sides untouched
+        EXPECT_EQ(left, samples);
+        EXPECT_EQ(right, samples);
+    }
+}
+
+TEST_F(SoundManagerTest, StoppedStreamDropsQueuedFragments)
+{
+    SoundStream stream(g_sounds.resolveSoundFile(LONG_SOUND), { StreamSoundSource::NoDownMix }, 0);
+
+    // nothing is decoded before the stream is started
+    EXPECT_FALSE(stream.decode());
+
+    stream.start(0);
+    while (stream.decode()) {}
+    EXPECT_NE(stream.pop(0), nullptr);
+
+    stream.stop(0);
+    EXPECT_EQ(stream.pop(0), nullptr);
+    EXPECT_TRUE(stream.isFinished(0));
+
+    std::vector<char> samples;
+    ALenum format;
+    int rate;
+    EXPECT_FALSE(stream.takeDecoded(samples, format, rate));
+
+    // starting again rewinds
+    stream.start(0);
+    EXPECT_FALSE(stream.isFinished(0));
+    EXPECT_TRUE(stream.decode());
+    EXPECT_NE(stream.pop(0), nullptr);
+}
+
+TEST_F(SoundManagerTest, StoppedHalfLeavesTheOtherPlaying)
+{
+    SoundStream stream(g_sounds.resolveSoundFile(LONG_SOUND), { StreamSoundSource::DownMixLeft, StreamSoundSource::DownMixRight }, 0);
+
+    stream.start(0);
+    stream.start(1);
+    ASSERT_TRUE(stream.decode());
+
+    // the right half was denied a voice, the left one keeps its fragments and the decode goes on
+    stream.stop(1);
+    EXPECT_EQ(stream.pop(1), nullptr);
+    EXPECT_TRUE(stream.isFinished(1));
+    EXPECT_NE(stream.pop(0), nullptr);
+    EXPECT_FALSE(stream.isFinished(0));
+
+    while (stream.pop(0)) {}
+    EXPECT_TRUE(stream.decode());
+    EXPECT_NE(stream.pop(0), nullptr);
+    EXPECT_EQ(stream.pop(1), nullptr);
+
+    // the last one out stops the stream
+    stream.stop(0);
+    EXPECT_FALSE(stream.decode());
+    EXPECT_TRUE(stream.isFinished(0));
+}
+
+TEST_F(SoundManagerTest, PreloadFillsTheCache)
+{
+    g_sounds.preload(SHORT_SOUND);
+    ASSERT_TRUE(pollUntil([] { return stat("residentSounds") == 1; }));
+    EXPECT_GT(stat("residentBytes"), 0u);
+    EXPECT_EQ(stat("misses"), 0u);
+
+    // a cached sound plays straight from its buffers
+    const auto& source = g_sounds.play(SHORT_SOUND);
+    ASSERT_NE(source, nullptr);
+    EXPECT_EQ(stat("hits"), 1u);
+    EXPECT_EQ(std::dynamic_pointer_cast<StreamSoundSource>(source), nullptr);
+    EXPECT_GT(stat("voicesInUse"), 0u);
+
+    ASSERT_TRUE(pollUntil([] { return g_sounds.m_sources.empty(); }));
+    EXPECT_EQ(stat("voicesInUse"), 0u);
+}
+
+TEST_F(SoundManagerTest, StreamedSoundsEndUpInTheCache)
+{
+    const auto& source = g_sounds.play(OTHER_SOUND);
+    ASSERT_NE(source, nullptr);
+    EXPECT_EQ(stat("misses"), 1u);
+
+    // the first play streams the file, and its single decode is kept for the next one
+    ASSERT_TRUE(pollUntil([] { return stat("residentSounds") == 1; }));
+    ASSERT_TRUE(pollUntil([] { return g_sounds.m_sources.empty(); }));
+    EXPECT_EQ(stat("voicesInUse"), 0u);
+
+    ASSERT_NE(g_sounds.play(OTHER_SOUND), nullptr);
+    EXPECT_EQ(stat("hits"), 1u);
+}
+
+TEST_F(SoundManagerTest, CacheEvictsLeastRecentlyPlayed)
+{
+    g_sounds.preload(SHORT_SOUND);
+    ASSERT_TRUE(pollUntil([] { return stat("residentSounds") == 1; }));
+    const auto shortBytes = stat("residentBytes");
+
+    g_sounds.preload(OTHER_SOUND);
+    ASSERT_TRUE(pollUntil([] { return stat("residentSounds") == 2; }));
+    const auto otherBytes = stat("residentBytes") - shortBytes;
+
+    // playing the first sound makes the second one the least recently used
+    g_sounds.play(SHORT_SOUND);
+    g_sounds.setCacheBudget(std::max(shortBytes, otherBytes));
+
+    EXPECT_EQ(stat("evictions"), 1u);
+    EXPECT_EQ(stat("residentSounds"), 1u);
+    EXPECT_TRUE(g_sounds.m_cache.contains(g_sounds.resolveSoundFile(SHORT_SOUND)));
+    EXPECT_FALSE(g_sounds.m_cache.contains(g_sounds.resolveSoundFile(OTHER_SOUND)));
+}
+
+TEST_F(SoundManagerTest, HigherPriorityStealsTheOldestLowerVoice)
+{
+    const auto& background = fillVoices(0);
+
+    const auto& important = makeSource(1);
+    ASSERT_TRUE(important->bindVoice());
+    EXPECT_EQ(stat("voicesStolen"), 1u);
+
+    // the first voice handed out was the oldest
+    EXPECT_FALSE(background.front()->hasVoice());
+    for (size_t i = 1; i < background.size(); ++i)
+        EXPECT_TRUE(background[i]->hasVoice());
+
+    important->stop();
+    EXPECT_FALSE(important->hasVoice());
+    EXPECT_EQ(stat("voicesInUse"), background.size() - 1);
+}
+
+TEST_F(SoundManagerTest, LowerPriorityIsDeniedAFullPool)
+{
+    const auto& important = fillVoices(5);
+
+    const auto& background = makeSource(1);
+    EXPECT_FALSE(background->bindVoice());
+    EXPECT_FALSE(background->hasVoice());
+    EXPECT_EQ(stat("voicesDenied"), 1u);
+    EXPECT_EQ(stat("voicesStolen"), 0u);
+
+    for (const auto& source : important)
+        EXPECT_TRUE(source->hasVoice());
+}
+
+TEST_F(SoundManagerTest, ChannelLimitRecyclesItsOwnVoices)
+{
+    constexpr uint8_t EFFECTS = 3;
+    g_sounds.setChannelVoiceLimit(EFFECTS, 2);
+
+    const auto& first = makeSource(0, EFFECTS);
+    const auto& second = makeSource(0, EFFECTS);
+    const auto& third = makeSource(0, EFFECTS);
+    const auto& unlimited = makeSource(0);
+
+    ASSERT_TRUE(first->bindVoice());
+    ASSERT_TRUE(unlimited->bindVoice());
+    ASSERT_TRUE(second->bindVoice());
+
+    // the pool has room, but the channel does not
+    ASSERT_TRUE(third->bindVoice());
+    EXPECT_FALSE(first->hasVoice());
+    EXPECT_TRUE(second->hasVoice());
+    EXPECT_TRUE(unlimited->hasVoice());
+    EXPECT_EQ(stat("voicesStolen"), 1u);
+
+    // a channel full of higher priority voices turns the newcomer away
+    second->setPriority(2);
+    third->setPriority(2);
+    EXPECT_FALSE(first->bindVoice());
+    EXPECT_EQ(stat("voicesDenied"), 1u);
+
+    g_sounds.setChannelVoiceLimit(EFFECTS, 0);
+    EXPECT_EQ(g_sounds.getChannelVoiceLimit(EFFECTS), 0);
+    EXPECT_TRUE(first->bindVoice());
+}
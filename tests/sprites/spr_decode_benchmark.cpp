@@ -0,0 +1,122 @@
+// Decodes every sprite of a legacy .spr (10.98 layout: u32 signature, u32 count) the former way, one seek and
+// read through a file stream and one new image per sprite, then straight from the mapped file into a single
+// buffer, one after another and spread over g_asyncDispatcher. Both ways must produce the same pixels.
+//
+// usage: otclient_spr_decode_benchmark <Tibia.spr>
+
+#define private public
+#include <client/spritemanager.h>
+#undef private
+
+#include <client/gameconfig.h>
+#include <framework/core/asyncdispatcher.h>
+#include <framework/core/filestream.h>
+#include <framework/core/mappedfile.h>
+#include <framework/graphics/image.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc < 2) {
+        std::printf("usage: %s <Tibia.spr>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    const std::string contents{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    if (contents.size() < 8) {
+        std::printf("cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    g_sprites.m_spritesMapping = MappedFile::open(argv[1]);
+    if (!g_sprites.m_spritesMapping) {
+        std::printf("cannot map %s\n", argv[1]);
+        return 1;
+    }
+
+    g_sprites.m_spritesCount = stdext::readULE32(g_sprites.m_spritesMapping->data() + 4);
+    g_sprites.m_spritesOffset = 8;
+    g_sprites.indexSprites();
+    if (!g_sprites.isMapped()) {
+        std::printf("%s has a truncated sprite table\n", argv[1]);
+        return 1;
+    }
+
+    const uint32_t count = g_sprites.m_spritesCount;
+    const int spriteSize = g_gameConfig.getSpriteSize();
+    const size_t spriteBytes = static_cast<size_t>(spriteSize) * spriteSize * 4;
+
+    const auto stream = std::make_shared<FileStream>(argv[1], contents);
+
+    auto start = Clock::now();
+    std::vector<ImagePtr> streamed(count + 1);
+    for (uint32_t id = 1; id <= count; ++id)
+        streamed[id] = g_sprites.getSpriteImage(id, stream);
+    const double streamMs = elapsedMs(start);
+
+    std::vector<uint8_t> pixels(spriteBytes);
+    start = Clock::now();
+    size_t decoded = 0;
+    for (uint32_t id = 1; id <= count; ++id) {
+        bool hasTransparentPixel = false;
+        decoded += g_sprites.readSpritePixels(id, pixels.data(), hasTransparentPixel);
+    }
+    const double mappedMs = elapsedMs(start);
+
+    const size_t threads = g_asyncDispatcher->get_thread_count();
+    const uint32_t chunk = (count + threads - 1) / threads;
+
+    start = Clock::now();
+    BS::multi_future<void> tasks;
+    for (uint32_t first = 1; first <= count; first += chunk) {
+        tasks.emplace_back(g_asyncDispatcher->submit_task([first, last = std::min(count, first + chunk - 1), spriteBytes] {
+            thread_local std::vector<uint8_t> out(spriteBytes);
+            for (uint32_t id = first; id <= last; ++id) {
+                bool hasTransparentPixel = false;
+                g_sprites.readSpritePixels(id, out.data(), hasTransparentPixel);
+            }
+        }));
+    }
+    tasks.wait();
+    const double parallelMs = elapsedMs(start);
+
+    size_t mismatches = 0;
+    for (uint32_t id = 1; id <= count; ++id) {
+        bool hasTransparentPixel = false;
+        const bool read = g_sprites.readSpritePixels(id, pixels.data(), hasTransparentPixel);
+        const auto& image = streamed[id];
+        if (read != (image != nullptr))
+            ++mismatches;
+        else if (image && (hasTransparentPixel != image->hasTransparentPixel() || std::memcmp(pixels.data(), image->getPixelData(), spriteBytes) != 0))
+            ++mismatches;
+    }
+
+    std::printf("%u sprites (%zu blank), %zu threads\n", count, count - decoded, threads);
+    std::printf("file stream:     %9.2f ms (%.3f us/sprite)\n", streamMs, streamMs * 1000 / count);
+    std::printf("mapped:          %9.2f ms (%.3f us/sprite)\n", mappedMs, mappedMs * 1000 / count);
+    std::printf("mapped parallel: %9.2f ms (%.3f us/sprite)\n", parallelMs, parallelMs * 1000 / count);
+
+    if (mismatches > 0) {
+        std::printf("mismatch: %zu sprites decode differently from the mapped file\n", mismatches);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#define private public
+#include <client/spritemanager.h>
+#undef private
+
+#include <client/gameconfig.h>
+#include <framework/core/mappedfile.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+    void writeU16(std::vector<uint8_t>& out, const uint16_t value)
+    {
+        out.push_back(value & 0xFF);
+        out.push_back(value >> 8);
+    }
+
+    void writeU32(std::vector<uint8_t>& out, const uint32_t value)
+    {
+        writeU16(out, value & 0xFFFF);
+        writeU16(out, value >> 16);
+    }
+
+    class SprDecode : public ::testing::Test
+    {
+    protected:
+        void TearDown() override
+        {
+            g_sprites.m_spritesMapping = nullptr;
+            g_sprites.m_spriteAddresses.clear();
+            g_sprites.m_spritesCount = 0;
+            std::filesystem::remove(m_path);
+        }
+
+        // maps a 10.98 layout .spr holding the given sprite table followed by the sprite data
+        void mapSpr(const std::vector<uint32_t>& table, const std::vector<uint8_t>& sprites)
+        {
+            std::vector<uint8_t> contents;
+            writeU32(contents, 0x12345678);
+            writeU32(contents, static_cast<uint32_t>(table.size()));
+            for (const auto address : table)
+                writeU32(contents, address);
+            contents.insert(contents.end(), sprites.begin(), sprites.end());
+
+            std::ofstream(m_path, std::ios::binary).write(reinterpret_cast<const char*>(contents.data()), contents.size());
+
+            g_sprites.m_spritesMapping = MappedFile::open(m_path);
+            ASSERT_NE(g_sprites.m_spritesMapping, nullptr);
+            g_sprites.m_spritesCount = static_cast<uint32_t>(table.size());
+            g_sprites.m_spritesOffset = 8;
+            g_sprites.indexSprites();
+        }
+
+        std::filesystem::path m_path = std::filesystem::temp_directory_path() / "otclient_spr_decode_test.spr";
+    };
+
+} // namespace
+
+TEST_F(SprDecode, CorruptTableEntriesReadAsBlank)
+{
+    // one red pixel, then the rest of the sprite left transparent
+    std::vector<uint8_t> sprite = { 0xFF, 0x00, 0xFF };
+    writeU16(sprite, 7);
+    writeU16(sprite, 0);
+    writeU16(sprite, 1);
+    sprite.insert(sprite.end(), { 0xFF, 0x00, 0x00 });
+
+    constexpr uint32_t first = 8 + 4 * 4;
+    const uint32_t end = first + static_cast<uint32_t>(sprite.size());
+    // a valid entry, one that wraps a 32 bit address check, one too close to the end and an empty one
+    mapSpr({ first, 0xFFFFFFFC, end - 4, 0 }, sprite);
+    ASSERT_TRUE(g_sprites.isMapped());
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(g_gameConfig.getSpriteSize()) * g_gameConfig.getSpriteSize() * 4);
+    bool hasTransparentPixel = false;
+
+    ASSERT_TRUE(g_sprites.readSpritePixels(1, pixels.data(), hasTransparentPixel));
+    EXPECT_EQ(pixels[0], 0xFF);
+    EXPECT_EQ(pixels[1], 0x00);
+    EXPECT_EQ(pixels[2], 0x00);
+    EXPECT_EQ(pixels[3], 0xFF);
+
+    for (int id = 2; id <= 4; ++id)
+        EXPECT_FALSE(g_sprites.readSpritePixels(id, pixels.data(), hasTransparentPixel)) << id;
+    EXPECT_FALSE(g_sprites.readSpritePixels(5, pixels.data(), hasTransparentPixel));
+}
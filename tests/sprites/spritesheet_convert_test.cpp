@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <client/spriteappearances.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t KEY_COLOR = 0x00FF00FF;
+
+    // the plain per pixel conversion the vector paths have to match
+    uint32_t convertReference(const uint32_t bgra)
+    {
+        if ((bgra & 0x00FFFFFF) == KEY_COLOR)
+            return 0;
+        return (bgra & 0xFF00FF00) | ((bgra >> 16) & 0xFF) | ((bgra & 0xFF) << 16);
+    }
+
+    std::vector<uint32_t> makePixels(const size_t count, const uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<uint32_t> pixels(count);
+        for (auto& px : pixels) {
+            px = rng();
+            // about one in four is the colour key, with any alpha
+            if (rng() % 4 == 0)
+                px = (px & 0xFF000000) | KEY_COLOR;
+        }
+        return pixels;
+    }
+
+    uint32_t readPixel(const std::vector<uint8_t>& bytes, const size_t offset, const size_t index)
+    {
+        uint32_t px;
+        std::memcpy(&px, bytes.data() + offset + index * 4, 4);
+        return px;
+    }
+
+} // namespace
+
+TEST(SpriteSheetConvert, RowMatchesScalarForAnyCountAndAlignment)
+{
+    constexpr uint32_t GUARD = 0xDEADBEEF;
+
+    for (size_t count = 0; count <= 37; ++count) {
+        for (size_t offset = 0; offset < 4; ++offset) {
+            const auto pixels = makePixels(count, static_cast<uint32_t>(count * 4 + offset));
+
+            // byte offsets off the 16 byte grid on both sides, guard words around the output
+            std::vector<uint8_t> src(offset + count * 4 + 16);
+            std::vector<uint8_t> dst(offset + (count + 1) * 4 + 16);
+            std::memcpy(src.data() + offset, pixels.data(), count * 4);
+            std::memcpy(dst.data() + offset + count * 4, &GUARD, 4);
+
+            SpriteAppearances::convertSheetRow(src.data() + offset, dst.data() + offset, count);
+
+            for (size_t i = 0; i < count; ++i)
+                ASSERT_EQ(readPixel(dst, offset, i), convertReference(pixels[i])) << "count " << count << ", offset " << offset << ", pixel " << i;
+            ASSERT_EQ(readPixel(dst, offset, count), GUARD) << "count " << count << ", offset " << offset;
+        }
+    }
+}
+
+TEST(SpriteSheetConvert, KeyColorIsClearedWhateverTheAlpha)
+{
+    const std::vector<uint32_t> pixels = { 0x00FF00FF, 0xFFFF00FF, 0x80FF00FF, 0xFFFF00FE, 0xFFFE00FF, 0x01FF00FF, 0xFF00FF00 };
+    std::vector<uint32_t> converted(pixels.size());
+
+    SpriteAppearances::convertSheetRow(reinterpret_cast<const uint8_t*>(pixels.data()), reinterpret_cast<uint8_t*>(converted.data()), pixels.size());
+
+    const std::vector<uint32_t> expected = { 0, 0, 0, 0xFFFE00FF, 0xFFFF00FE, 0, 0xFF00FF00 };
+    EXPECT_EQ(converted, expected);
+}
+
+TEST(SpriteSheetConvert, SheetIsFlippedAndConverted)
+{
+    constexpr size_t SIZE = SpriteSheet::SIZE;
+    const auto bmp = makePixels(SIZE * SIZE, 7);
+    std::vector<uint32_t> pixels(SIZE * SIZE);
+
+    SpriteAppearances::convertSheetPixels(reinterpret_cast<const uint8_t*>(bmp.data()), reinterpret_cast<uint8_t*>(pixels.data()));
+
+    for (size_t y = 0; y < SIZE; ++y) {
+        for (size_t x = 0; x < SIZE; ++x)
+            ASSERT_EQ(pixels[y * SIZE + x], convertReference(bmp[(SIZE - 1 - y) * SIZE + x])) << "x " << x << ", y " << y;
+    }
+}
@@ -0,0 +1,124 @@
+// Decodes every sprite sheet of an asset directory, one after another and then spread over
+// g_asyncDispatcher, and compares the pixel conversion against the former three pass version.
+//
+// usage: otclient_sprite_decode_benchmark <assets directory>
+
+#include <client/spriteappearances.h>
+#include <framework/core/asyncdispatcher.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::vector<std::vector<uint8_t>> readSheets(const std::filesystem::path& dir)
+    {
+        std::vector<std::vector<uint8_t>> sheets;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            if (!entry.is_regular_file() || !entry.path().string().ends_with(".bmp.lzma"))
+                continue;
+
+            std::ifstream in(entry.path(), std::ios::binary);
+            sheets.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        return sheets;
+    }
+
+    // the pixel pass as it was before: swap and colour key over the sheet, then a row flip
+    void convertLegacy(const uint8_t* bmp, uint8_t* pixels)
+    {
+        std::memcpy(pixels, bmp, BYTES_IN_SPRITE_SHEET);
+
+        for (int i = 0; i < BYTES_IN_SPRITE_SHEET; i += 4) {
+            std::swap(pixels[i], pixels[i + 2]);
+
+            const uint32_t rgb = pixels[i] | (pixels[i + 1] << 8) | (pixels[i + 2] << 16);
+            if (rgb == 0xFF00FF)
+                std::memset(pixels + i, 0, 4);
+        }
+
+        uint8_t tempLine[SPRITE_SHEET_WIDTH_BYTES];
+        for (int y = 0; y < SpriteSheet::SIZE / 2; ++y) {
+            uint8_t* top = pixels + y * SPRITE_SHEET_WIDTH_BYTES;
+            uint8_t* bottom = pixels + (SpriteSheet::SIZE - 1 - y) * SPRITE_SHEET_WIDTH_BYTES;
+
+            std::memcpy(tempLine, top, SPRITE_SHEET_WIDTH_BYTES);
+            std::memcpy(top, bottom, SPRITE_SHEET_WIDTH_BYTES);
+            std::memcpy(bottom, tempLine, SPRITE_SHEET_WIDTH_BYTES);
+        }
+    }
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc < 2) {
+        std::printf("usage: %s <assets directory>\n", argv[0]);
+        return 1;
+    }
+
+    const auto sheets = readSheets(argv[1]);
+    if (sheets.empty()) {
+        std::printf("no .bmp.lzma sheets found in %s\n", argv[1]);
+        return 1;
+    }
+
+    auto pixels = std::make_unique<uint8_t[]>(BYTES_IN_SPRITE_SHEET);
+
+    auto start = Clock::now();
+    size_t failed = 0;
+    for (const auto& sheet : sheets) {
+        try {
+            SpriteAppearances::decodeSpriteSheet(sheet, pixels.get());
+        } catch (const std::exception&) {
+            ++failed;
+        }
+    }
+    const double sequentialMs = elapsedMs(start);
+
+    start = Clock::now();
+    BS::multi_future<void> tasks;
+    for (const auto& sheet : sheets) {
+        tasks.emplace_back(g_asyncDispatcher->submit_task([&sheet] {
+            thread_local auto out = std::make_unique<uint8_t[]>(BYTES_IN_SPRITE_SHEET);
+            try {
+                SpriteAppearances::decodeSpriteSheet(sheet, out.get());
+            } catch (const std::exception&) {}
+        }));
+    }
+    tasks.wait();
+    const double parallelMs = elapsedMs(start);
+
+    // pixel pass alone, over a synthetic bitmap so it does not depend on the asset contents
+    constexpr int PIXEL_RUNS = 200;
+    std::vector<uint8_t> bmp(BYTES_IN_SPRITE_SHEET);
+    for (size_t i = 0; i < bmp.size(); ++i)
+        bmp[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+
+    start = Clock::now();
+    for (int i = 0; i < PIXEL_RUNS; ++i)
+        convertLegacy(bmp.data(), pixels.get());
+    const double legacyMs = elapsedMs(start) / PIXEL_RUNS;
+
+    start = Clock::now();
+    for (int i = 0; i < PIXEL_RUNS; ++i)
+        SpriteAppearances::convertSheetPixels(bmp.data(), pixels.get());
+    const double kernelMs = elapsedMs(start) / PIXEL_RUNS;
+
+    std::printf("%zu sheets (%zu failed), %zu threads\n", sheets.size(), failed, g_asyncDispatcher->get_thread_count());
+    std::printf("sequential decode: %9.2f ms (%.3f ms/sheet)\n", sequentialMs, sequentialMs / sheets.size());
+    std::printf("parallel decode:   %9.2f ms\n", parallelMs);
+    std::printf("pixel pass:        %9.3f ms legacy, %.3f ms single sweep\n", legacyMs, kernelMs);
+    return failed == sheets.size() ? 1 : 0;
+}
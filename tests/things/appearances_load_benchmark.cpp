@@ -0,0 +1,147 @@
+// Loads the appearances of an asset directory the way it was done before (istream parse, one thread),
+// through the mapped parse spread over g_asyncDispatcher, and from the snapshot written by the first
+// load with a snapshot directory set, then checks the snapshot gave back the same tables.
+//
+// usage: otclient_appearances_load_benchmark <assets directory>
+
+#include <client/animator.h>
+#include <client/thingtype.h>
+#include <client/thingtypemanager.h>
+
+#include <framework/core/asyncdispatcher.h>
+#include <framework/core/logger.h>
+#include <framework/core/resourcemanager.h>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::string findAppearancesFile()
+    {
+        const auto& catalog = nlohmann::json::parse(g_resources.readFileContents("/catalog-content.json"));
+        for (const auto& obj : catalog) {
+            if (obj["type"] == "appearances")
+                return obj["file"].get<std::string>();
+        }
+        return {};
+    }
+
+    // the load as it was before: the whole file copied into a stream, parsed from it and unserialized in one go
+    size_t loadLegacy(const std::string& appearancesFile)
+    {
+        std::stringstream fin;
+        g_resources.readFileStream("/" + appearancesFile, fin);
+
+        auto appearancesLib = appearances::Appearances();
+        if (!appearancesLib.ParseFromIstream(&fin))
+            return 0;
+
+        size_t count = 0;
+        const google::protobuf::RepeatedPtrField<appearances::Appearance>* lists[] = { &appearancesLib.object(), &appearancesLib.outfit(), &appearancesLib.effect(), &appearancesLib.missile() };
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+            std::vector<ThingTypePtr> things;
+            for (const auto& appearance : *lists[category]) {
+                const auto& type = std::make_shared<ThingType>();
+                type->unserializeAppearance(appearance.id(), static_cast<ThingCategory>(category), appearance);
+                things.emplace_back(type);
+            }
+            count += things.size();
+        }
+        return count;
+    }
+
+    // what is expected to survive a snapshot, folded into a number
+    uint64_t fingerprint()
+    {
+        uint64_t hash = 1469598103934665603ull;
+        const auto mix = [&hash](const uint64_t value) { hash = (hash ^ value) * 1099511628211ull; };
+
+        for (int category = ThingCategoryItem; category < ThingLastCategory; ++category) {
+            const auto& things = g_things.getThingTypes(static_cast<ThingCategory>(category));
+            mix(things.size());
+            for (const auto& type : things) {
+                if (type->isNull())
+                    continue;
+
+                mix(type->getId());
+                mix(std::hash<std::string>{}(type->getName()));
+                mix(type->getAnimationPhases());
+                mix(type->getSize().width());
+                mix(type->getMarketData().tradeAs);
+                mix(type->getAnimator() ? type->getAnimator()->getTotalDuration() : 0);
+                for (const uint32_t spriteId : type->getSprites())
+                    mix(spriteId);
+            }
+        }
+        return hash;
+    }
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc < 2) {
+        std::printf("usage: %s <assets directory>\n", argv[0]);
+        return 1;
+    }
+
+    g_logger.setLevel(Fw::LogFatal);
+    g_resources.init(argv[0]);
+    g_resources.addSearchPath(argv[1]);
+    g_things.init();
+
+    const auto& appearancesFile = findAppearancesFile();
+    if (appearancesFile.empty()) {
+        std::printf("no appearances listed in %s/catalog-content.json\n", argv[1]);
+        return 1;
+    }
+
+    // once untimed, so every variant reads the files from the page cache
+    if (!g_things.loadAppearances("/")) {
+        std::printf("unable to load the appearances of %s\n", argv[1]);
+        return 1;
+    }
+    const uint64_t expected = fingerprint();
+
+    auto start = Clock::now();
+    const size_t count = loadLegacy(appearancesFile);
+    const double legacyMs = elapsedMs(start);
+
+    start = Clock::now();
+    g_things.loadAppearances("/");
+    const double parallelMs = elapsedMs(start);
+
+    const auto snapshotDir = std::filesystem::temp_directory_path() / "otclient_appearances_benchmark";
+    std::filesystem::remove_all(snapshotDir);
+    g_things.setSnapshotDir(snapshotDir.string());
+
+    start = Clock::now();
+    g_things.loadAppearances("/");
+    const double firstStartMs = elapsedMs(start);
+
+    start = Clock::now();
+    g_things.loadAppearances("/");
+    const double snapshotMs = elapsedMs(start);
+    const bool matches = fingerprint() == expected;
+
+    std::filesystem::remove_all(snapshotDir);
+
+    std::printf("%zu appearances, %zu threads\n", count, g_asyncDispatcher->get_thread_count());
+    std::printf("istream parse, serial:     %9.2f ms\n", legacyMs);
+    std::printf("mapped parse, parallel:    %9.2f ms\n", parallelMs);
+    std::printf("parse and write snapshot:  %9.2f ms\n", firstStartMs);
+    std::printf("from snapshot:             %9.2f ms (%s)\n", snapshotMs, matches ? "same tables" : "TABLES DIFFER");
+    return matches ? 0 : 1;
+}
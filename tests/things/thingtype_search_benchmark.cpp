@@ -0,0 +1,129 @@
+// Runs the name, attribute and race lookups of ThingTypeManager over the appearances and the static data
+// of an asset directory (the full 12.x item set), through the indexes and through the linear scans they replaced.
+//
+// usage: otclient_thingtype_search_benchmark <assets directory>
+
+#include <client/thingtype.h>
+#include <client/thingtypemanager.h>
+
+#include <framework/core/logger.h>
+#include <framework/core/resourcemanager.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int RUNS = 200;
+
+    double elapsedMs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // the scans as they were: lowercasing every name of the category on every call
+    size_t scanByString(const std::string& text)
+    {
+        std::string lowered = text;
+        stdext::tolower(lowered);
+
+        size_t found = 0;
+        for (const auto& type : g_things.getThingTypes(ThingCategoryItem)) {
+            std::string name = type->getName();
+            stdext::tolower(name);
+            if (!type->isNull() && name.find(lowered) != std::string::npos)
+                ++found;
+        }
+        return found;
+    }
+
+    size_t scanByAttr(const ThingAttr attr)
+    {
+        ThingTypeList ret;
+        for (const auto& type : g_things.getThingTypes(ThingCategoryItem))
+            if (type->hasAttr(attr))
+                ret.emplace_back(type);
+        return ret.size();
+    }
+
+    const RaceType* scanRace(const uint32_t raceId)
+    {
+        for (const auto& race : g_things.getAllRaces()) {
+            if (race.raceId == raceId)
+                return &race;
+        }
+        return nullptr;
+    }
+
+    template<typename F>
+    double timeRuns(F&& run)
+    {
+        const auto start = Clock::now();
+        for (int i = 0; i < RUNS; ++i)
+            run();
+        return elapsedMs(start) / RUNS;
+    }
+}
+
+int main(const int argc, const char* argv[])
+{
+    if (argc < 2) {
+        std::printf("usage: %s <assets directory>\n", argv[0]);
+        return 1;
+    }
+
+    g_logger.setLevel(Fw::LogFatal);
+    g_resources.init(argv[0]);
+    g_resources.addSearchPath(argv[1]);
+    g_things.init();
+
+    if (!g_things.loadAppearances("/")) {
+        std::printf("unable to load the appearances of %s\n", argv[1]);
+        return 1;
+    }
+    const bool races = g_things.loadStaticData("/");
+
+    const auto buildStart = Clock::now();
+    g_things.countThingTypesByString("", ThingCategoryItem);
+    const double buildMs = elapsedMs(buildStart);
+
+    std::printf("%zu item slots, %zu races, first lookup (index build) %.2f ms\n", g_things.getThingTypes(ThingCategoryItem).size(), g_things.getAllRaces().size(), buildMs);
+    std::printf("%-28s %12s %12s %8s\n", "lookup", "scan ms", "index ms", "found");
+
+    // a search box being typed into, then a few whole words
+    for (const std::string text : { "s", "sw", "swo", "sword", "dragon", "magic plate armor", "of the" }) {
+        size_t scanned = 0;
+        size_t indexed = 0;
+        const double scanMs = timeRuns([&] { scanned = scanByString(text); });
+        const double indexMs = timeRuns([&] { indexed = g_things.countThingTypesByString(text, ThingCategoryItem); });
+        std::printf("string '%s'%*s %12.4f %12.4f %8zu%s\n", text.c_str(), static_cast<int>(18 - text.size()), "", scanMs, indexMs, indexed, scanned > indexed ? " (scan found more)" : "");
+    }
+
+    for (const auto& [attr, label] : { std::pair{ ThingAttrMarket, "market" }, std::pair{ ThingAttrContainer, "container" }, std::pair{ ThingAttrGround, "ground" } }) {
+        size_t scanned = 0;
+        size_t indexed = 0;
+        const double scanMs = timeRuns([&] { scanned = scanByAttr(attr); });
+        const double indexMs = timeRuns([&] { indexed = g_things.findThingTypeByAttr(attr, ThingCategoryItem).size(); });
+        std::printf("attr %-23s %12.4f %12.4f %8zu%s\n", label, scanMs, indexMs, indexed, scanned != indexed ? " (MISMATCH)" : "");
+    }
+
+    if (races && !g_things.getAllRaces().empty()) {
+        const auto& all = g_things.getAllRaces();
+        size_t mismatches = 0;
+        const double scanMs = timeRuns([&] {
+            for (size_t i = 0; i < all.size(); i += 16)
+                scanRace(all[i].raceId);
+        });
+        const double indexMs = timeRuns([&] {
+            for (size_t i = 0; i < all.size(); i += 16)
+                mismatches += g_things.getRaceData(all[i].raceId).raceId != all[i].raceId;
+        });
+        std::printf("race by id (every 16th)      %12.4f %12.4f %8zu%s\n", scanMs, indexMs, (all.size() + 15) / 16, mismatches ? " (MISMATCH)" : "");
+    }
+
+    return 0;
+}
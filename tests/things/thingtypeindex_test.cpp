@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <client/thingtypeindex.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+    using Ids = std::vector<uint32_t>;
+
+    NameIndex makeItems()
+    {
+        NameIndex index;
+        index.add(3, "Magic Plate Armor");
+        index.add(7, "plate legs");
+        index.add(9, "Golden Armor");
+        index.add(9, "golden armour");
+        index.add(12, "ARMOR RACK");
+        index.add(20, "mace");
+        return index;
+    }
+
+    Ids scan(const std::vector<std::pair<uint32_t, std::string>>& names, const std::string& text)
+    {
+        Ids ids;
+        for (const auto& [id, name] : names) {
+            std::string lowered = name;
+            stdext::tolower(lowered);
+            if (lowered.find(text) != std::string::npos && (ids.empty() || ids.back() != id))
+                ids.emplace_back(id);
+        }
+        return ids;
+    }
+
+    TEST(NameIndex, FindsWholeNamesRegardlessOfCase)
+    {
+        const auto index = makeItems();
+
+        const auto ids = index.find("magic plate ARMOR");
+        EXPECT_EQ(Ids(ids.begin(), ids.end()), Ids{ 3 });
+        EXPECT_TRUE(index.find("magic plate").empty());
+        EXPECT_EQ(index.find("Golden Armour").size(), 1u);
+    }
+
+    TEST(NameIndex, SearchesSubstringsInIdOrderOnce)
+    {
+        const auto index = makeItems();
+
+        EXPECT_EQ(index.search("armor"), (Ids{ 3, 9, 12 }));
+        EXPECT_EQ(index.search("golden arm"), Ids{ 9 });
+        EXPECT_EQ(index.search("plate"), (Ids{ 3, 7 }));
+        EXPECT_EQ(index.search("ac"), (Ids{ 12, 20 }));
+        EXPECT_EQ(index.search("a").size(), 5u);
+        EXPECT_EQ(index.search("").size(), 5u);
+        EXPECT_TRUE(index.search("dragon").empty());
+        EXPECT_TRUE(index.search("armorx").empty());
+        EXPECT_EQ(index.count("armor"), 3u);
+    }
+
+    TEST(NameIndex, PagesSearchResults)
+    {
+        const auto index = makeItems();
+
+        EXPECT_EQ(index.search("a", 0, 2), (Ids{ 3, 7 }));
+        EXPECT_EQ(index.search("a", 2, 2), (Ids{ 9, 12 }));
+        EXPECT_EQ(index.search("a", 4, 2), Ids{ 20 });
+        EXPECT_TRUE(index.search("a", 5, 2).empty());
+        EXPECT_EQ(index.search("armor", 1, 0), (Ids{ 9, 12 }));
+    }
+
+    TEST(NameIndex, MatchesLinearScan)
+    {
+        std::vector<std::pair<uint32_t, std::string>> names;
+        const char* words[] = { "dragon", "scale", "mail", "ring", "of", "healing", "ham", "fire", "sword", "the" };
+        uint32_t seed = 7;
+        for (uint32_t id = 1; id <= 500; ++id) {
+            std::string name;
+            const int count = 1 + id % 3;
+            for (int w = 0; w < count; ++w) {
+                seed = seed * 1103515245u + 12345u;
+                if (!name.empty())
+                    name += ' ';
+                name += words[(seed >> 16) % std::size(words)];
+            }
+            names.emplace_back(id, name);
+        }
+
+        NameIndex index;
+        for (const auto& [id, name] : names)
+            index.add(id, name);
+
+        for (const std::string text : { "dra", "ring of", "g of h", "e s", "am", "h", "fire sword", "sword fire", "xyz" })
+            EXPECT_EQ(index.search(text), scan(names, text)) << text;
+    }
+
+    TEST(IdBitset, ListsAndPagesSetIds)
+    {
+        IdBitset ids;
+        ids.resize(200);
+        for (const uint32_t id : { 1u, 63u, 64u, 130u, 199u })
+            ids.set(id, true);
+
+        EXPECT_EQ(ids.count(), 5u);
+        EXPECT_TRUE(ids.test(64));
+        EXPECT_FALSE(ids.test(65));
+        EXPECT_FALSE(ids.test(5000));
+        EXPECT_EQ(ids.ids(), (Ids{ 1, 63, 64, 130, 199 }));
+        EXPECT_EQ(ids.ids(2, 2), (Ids{ 64, 130 }));
+        EXPECT_EQ(ids.ids(3), (Ids{ 130, 199 }));
+
+        ids.set(63, false);
+        ids.set(300, true);
+        EXPECT_EQ(ids.ids(), (Ids{ 1, 64, 130, 199, 300 }));
+    }
+}